@@ -157,14 +157,14 @@ int main(int argc, char* argv[])
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-05;
     ml->num_variables = num_variables;
-    ml->track_times = true;
+    init_profile();
     t0 = MPI_Wtime();
     ml->setup(A);
     tfinal = MPI_Wtime() - t0;
     MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     if (rank == 0) printf("Total Setup Time: %e\n", t0);
     ml->print_hierarchy();
-    ml->print_setup_times();
+    ml->reset_comm_volume();
 
     MPI_Barrier(MPI_COMM_WORLD);
     ParVector rss_sol = ParVector(x);
@@ -174,7 +174,9 @@ int main(int argc, char* argv[])
     MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     if (rank == 0) printf("Total Solve Time: %e\n", t0);
     ml->print_residuals(iter);
-    ml->print_solve_times();
+    finalize_profile();
+    print_profile("AMG");
+    ml->print_comm_volume();
     delete ml;
 
     // Smoothed Aggregation AMG
@@ -183,14 +185,14 @@ int main(int argc, char* argv[])
             Symmetric, SOR);
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-05;
-    ml->track_times = true;
+    init_profile();
     t0 = MPI_Wtime();
     ml->setup(A);
     tfinal = MPI_Wtime() - t0;
     MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     if (rank == 0) printf("Total Setup Time: %e\n", t0);
     ml->print_hierarchy();
-    ml->print_setup_times();
+    ml->reset_comm_volume();
 
     ParVector sas_sol = ParVector(x);
     t0 = MPI_Wtime();
@@ -199,7 +201,9 @@ int main(int argc, char* argv[])
     MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     if (rank == 0) printf("Total Solve Time: %e\n", t0);
     ml->print_residuals(iter);
-    ml->print_solve_times();
+    finalize_profile();
+    print_profile("AMG");
+    ml->print_comm_volume();
     delete ml;
 
     delete A;
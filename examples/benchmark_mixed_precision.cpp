@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include <mpi.h>
+#include <math.h>
+#include <stdlib.h>
+#include <iostream>
+#include <assert.h>
+
+#include "raptor.hpp"
+
+// Compares the all-double AMG cycle with the mixed precision cycle
+// (coarse operators and interpolation stored in single precision),
+// reporting iteration counts and time-to-solution of each
+//
+// Usage: ./benchmark_mixed_precision [system] [n] [n_tests]
+//   system 0: 3D 27-point Laplacian (n^3 rows)
+//   system 1: 2D rotated anisotropic diffusion (n^2 rows)
+int main(int argc, char* argv[])
+{
+    MPI_Init(&argc, &argv);
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int system = 0;
+    int n = 25;
+    int n_tests = 5;
+    if (argc > 1) system = atoi(argv[1]);
+    if (argc > 2) n = atoi(argv[2]);
+    if (argc > 3) n_tests = atoi(argv[3]);
+
+    coarsen_t coarsen_type = HMIS;
+    interp_t interp_type = Extended;
+
+    int dim;
+    double* stencil = NULL;
+    aligned_vector<int> grid;
+    if (system == 0)
+    {
+        dim = 3;
+        grid.resize(dim, n);
+        stencil = laplace_stencil_27pt();
+    }
+    else
+    {
+        coarsen_type = Falgout;
+        interp_type = ModClassical;
+        dim = 2;
+        grid.resize(dim, n);
+        stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    }
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid.data(), dim);
+    delete[] stencil;
+
+    ParVector x(A->global_num_cols, A->on_proc_num_cols);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_rand_values();
+    A->mult(x, b);
+
+    double t0, tfinal;
+    for (int mixed = 0; mixed < 2; mixed++)
+    {
+        ParMultilevel* ml = new ParRugeStubenSolver(0.25, coarsen_type,
+                interp_type, Classical, SOR);
+        ml->max_iterations = 1000;
+        ml->solve_tol = 1e-07;
+        ml->mixed_precision = mixed;
+        ml->setup(A);
+
+        int iter = 0;
+        double solve_t = 0;
+        for (int test = 0; test < n_tests; test++)
+        {
+            x.set_const_value(0.0);
+            MPI_Barrier(MPI_COMM_WORLD);
+            t0 = MPI_Wtime();
+            iter = ml->solve(x, b);
+            tfinal = MPI_Wtime() - t0;
+            MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+            solve_t += t0;
+        }
+
+        aligned_vector<double>& res = ml->get_residuals();
+        if (rank == 0)
+        {
+            printf("%s cycle: %d levels, %d iterations, final residual %e, "
+                    "solve time %e\n", mixed ? "Mixed precision" : "Double precision",
+                    ml->num_levels, iter, res[iter], solve_t / n_tests);
+        }
+        delete ml;
+    }
+
+    delete A;
+
+    MPI_Finalize();
+    return 0;
+}
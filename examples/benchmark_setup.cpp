@@ -149,11 +149,9 @@ int main(int argc, char *argv[])
 
     MPI_Reduce(&raptor_setup, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     if (rank == 0) printf("Raptor Setup Time: %e\n", t0);
-    ml->print_setup_times();
 
     MPI_Reduce(&raptor_solve, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     if (rank == 0) printf("Raptor Solve Time: %e\n", t0);
-    ml->print_solve_times();
 
     for (int i = 0; i < ml->num_levels - 1; i++)
     {
@@ -159,14 +159,13 @@ int main(int argc, char* argv[])
         ml->prolong_smooth_steps = i;
         ml->max_iterations = 1000;
         ml->solve_tol = 1e-07;
-        ml->track_times = true;
+        init_profile();
         t0 = MPI_Wtime();
         ml->setup(A);
         tfinal = MPI_Wtime() - t0;
         MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
         if (rank == 0) printf("Total Setup Time: %e\n", t0);
         ml->print_hierarchy();
-        ml->print_setup_times();
 
         ParVector sas_sol = ParVector(x);
         t0 = MPI_Wtime();
@@ -175,7 +174,8 @@ int main(int argc, char* argv[])
         MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
         if (rank == 0) printf("Total Solve Time: %e\n", t0);
         ml->print_residuals(iter);
-        ml->print_solve_times();
+        finalize_profile();
+        print_profile("AMG");
         delete ml;
 
         // TAPSmoothed Aggregation AMG
@@ -185,7 +185,7 @@ int main(int argc, char* argv[])
         ml->prolong_smooth_steps = i;
         ml->max_iterations = 1000;
         ml->solve_tol = 1e-07;
-        ml->track_times = true;
+        init_profile();
         ml->tap_amg = 0;
         t0 = MPI_Wtime();
         ml->setup(A);
@@ -193,7 +193,6 @@ int main(int argc, char* argv[])
         MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
         if (rank == 0) printf("Total Setup Time: %e\n", t0);
         ml->print_hierarchy();
-        ml->print_setup_times();
 
         ParVector tap_sas_sol = ParVector(x);
         t0 = MPI_Wtime();
@@ -202,7 +201,8 @@ int main(int argc, char* argv[])
         MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
         if (rank == 0) printf("Total Solve Time: %e\n", t0);
         ml->print_residuals(iter);
-        ml->print_solve_times();
+        finalize_profile();
+        print_profile("AMG");
         delete ml;
     }
 
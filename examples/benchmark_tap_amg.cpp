@@ -248,7 +248,6 @@ if (rank == 0) printf("A global n %d, nnz %lu\n", A->global_num_rows, nnz);
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
     ml->num_variables = num_variables;
-    ml->track_times = false;
     ml->store_residuals = false;
     ml->setup(A);
     tfinal = MPI_Wtime() - t0;
@@ -276,7 +275,6 @@ if (rank == 0) printf("A global n %d, nnz %lu\n", A->global_num_rows, nnz);
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
     ml->num_variables = num_variables;
-    ml->track_times = false;
     ml->store_residuals = false;
     ml->tap_amg = 3;
     ml->setup(A);
@@ -312,7 +310,6 @@ if (rank == 0) printf("A global n %d, nnz %lu\n", A->global_num_rows, nnz);
     form_hypre_weights(&ml->weights, A->local_num_rows);
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
-    ml->track_times = false;
     ml->store_residuals = false;
     t0 = MPI_Wtime();
     ml->setup(A);
@@ -338,7 +335,6 @@ if (rank == 0) printf("A global n %d, nnz %lu\n", A->global_num_rows, nnz);
     form_hypre_weights(&ml->weights, A->local_num_rows);
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
-    ml->track_times = false;
     ml->store_residuals = false;
     ml->tap_amg = 3;
     t0 = MPI_Wtime();
@@ -68,8 +68,8 @@ void time_spgemm(ParCSRMatrix* A, ParCSRMatrix* P, bool tap)
     }
     finalize_profile();
     average_profile(n_tests);
-    double tfinal = total_t / n_tests;
-    double comm_t = p2p_t / n_tests;
+    double tfinal = get_profile_value(ProfileTime) / n_tests;
+    double comm_t = get_profile_value(ProfileP2P) / n_tests;
 
     if (tap)
     {
@@ -105,8 +105,8 @@ void time_spgemm_T(ParCSRMatrix* A, ParCSCMatrix* P, bool tap)
     }
     finalize_profile();
     average_profile(n_tests);
-    tfinal = total_t / n_tests;
-    comm_t = p2p_t / n_tests;
+    tfinal = get_profile_value(ProfileTime) / n_tests;
+    comm_t = get_profile_value(ProfileP2P) / n_tests;
 
     if (tap)
     {
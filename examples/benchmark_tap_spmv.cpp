@@ -249,6 +249,19 @@ int main(int argc, char *argv[])
         MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
         if (rank == 0) printf("TAPSpMV Time: %e\n", t0);
 
+        // Time SpMV with neighborhood collectives on Level i
+        Al->init_neighbor_comm();
+        clear_cache(cache_array);
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        for (int i = 0; i < 100; i++)
+        {
+            Al->mult(xl, bl);
+        }
+        tfinal = (MPI_Wtime() - t0) / 100;
+        MPI_Reduce(&tfinal, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (rank == 0) printf("NeighborSpMV Time: %e\n", t0);
+
         // Gather number of messages / size (by inter/intra)
         int n_inter = 0;
         int n_intra = 0;
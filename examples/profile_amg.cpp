@@ -490,7 +490,6 @@ int main(int argc, char* argv[])
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
     ml->num_variables = num_variables;
-    ml->track_times = false;
     ml->setup(A);
     for (int i = 0; i < ml->num_levels - 1; i++)
     {
@@ -161,7 +161,7 @@ int main(int argc, char* argv[])
     // Ruge-Stuben AMG
     if (rank == 0) printf("Ruge Stuben Solver: \n");
     ml = new ParRugeStubenSolver(strong_threshold, coarsen_type, interp_type, Classical, SOR);
-    ml->track_times = true;
+    init_profile();
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
     ml->num_variables = num_variables;
@@ -174,14 +174,14 @@ int main(int argc, char* argv[])
     MPI_Barrier(MPI_COMM_WORLD);
     iter = ml->solve(rss_sol, b);
 
-    ml->print_setup_times();
-    ml->print_solve_times();
+    finalize_profile();
+    print_profile("AMG");
     delete ml;
 
     // TAP Ruge-Stuben AMG
     if (rank == 0) printf("\n\nTAP Ruge Stuben Solver: \n");
     ml = new ParRugeStubenSolver(strong_threshold, coarsen_type, interp_type, Classical, SOR);
-    ml->track_times = true;
+    init_profile();
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
     ml->num_variables = num_variables;
@@ -195,8 +195,8 @@ int main(int argc, char* argv[])
     MPI_Barrier(MPI_COMM_WORLD);
     iter = ml->solve(tap_rss_sol, b);
 
-    ml->print_setup_times();
-    ml->print_solve_times();
+    finalize_profile();
+    print_profile("AMG");
     delete ml;
 
 
@@ -212,7 +212,7 @@ int main(int argc, char* argv[])
     if (rank == 0) printf("\n\nSmoothed Aggregation Solver:\n");
     ml = new ParSmoothedAggregationSolver(strong_threshold, MIS, JacobiProlongation, 
             Symmetric, SOR);
-    ml->track_times = true;
+    init_profile();
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
     ml->store_residuals = false;
@@ -224,15 +224,15 @@ int main(int argc, char* argv[])
     MPI_Barrier(MPI_COMM_WORLD);
     iter = ml->solve(sas_sol, b);
 
-    ml->print_setup_times();
-    ml->print_solve_times();
+    finalize_profile();
+    print_profile("AMG");
     delete ml;
 
     // TAPSmoothed Aggregation AMG
     if (rank == 0) printf("\n\nTAP Smoothed Aggregation Solver:\n");
     ml = new ParSmoothedAggregationSolver(strong_threshold, MIS, JacobiProlongation,
             Symmetric, SOR);
-    ml->track_times = true;
+    init_profile();
     ml->max_iterations = 1000;
     ml->solve_tol = 1e-07;
     ml->store_residuals = false;
@@ -245,8 +245,8 @@ int main(int argc, char* argv[])
     MPI_Barrier(MPI_COMM_WORLD);
     iter = ml->solve(tap_sas_sol, b);
 
-    ml->print_setup_times();
-    ml->print_solve_times();
+    finalize_profile();
+    print_profile("AMG");
     delete ml;
 
     delete A;
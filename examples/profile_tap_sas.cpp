@@ -150,7 +150,6 @@ int main(int argc, char* argv[])
     ml->tap_amg = 0;
     ml->solve_tol = 1e-07;
     ml->num_variables = num_variables;
-    ml->track_times = false;
     ml->setup(A);
 
     aligned_vector<double> B(A->local_num_rows);
@@ -284,7 +284,6 @@ int main(int argc, char* argv[])
     if (rank == 0) printf("Ruge Stuben Solver:\n");
     ml = new ParRugeStubenSolver(strong_threshold, coarsen_type, interp_type, Classical, SOR);
     ml->tap_amg = 0;
-    ml->track_times = false;
     ml->setup(A);
     time_steps(ml);
     delete ml;
@@ -292,7 +291,6 @@ int main(int argc, char* argv[])
     if (rank == 0) printf("\n\nSmoothed Aggregation Solver:\n");
     ml = new ParSmoothedAggregationSolver(strong_threshold);
     ml->tap_amg = 0;
-    ml->track_times = false;
     ml->setup(A);
     time_steps(ml);
     delete ml;
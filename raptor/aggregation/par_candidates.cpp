@@ -23,7 +23,6 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
 
     // Calculate off_proc_column_map and num off_proc cols
     int off_proc_num_cols;
-    std::set<int> off_proc_col_set;
     aligned_vector<int> off_proc_column_map;
     for (aligned_vector<int>::const_iterator it = aggregates.begin();
             it != aggregates.end(); ++it)
@@ -32,17 +31,16 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
 
         if (*it < A->partition->first_local_col || *it > A->partition->last_local_col)
         {
-            off_proc_col_set.insert(*it);
+            off_proc_column_map.emplace_back(*it);
         }
     } 
-    std::map<int, int> global_to_local;
-    for (std::set<int>::iterator it = off_proc_col_set.begin();
-            it != off_proc_col_set.end(); ++it)
+    sort_unique(off_proc_column_map);
+    off_proc_num_cols = off_proc_column_map.size();
+    IntMap global_to_local(off_proc_num_cols);
+    for (int i = 0; i < off_proc_num_cols; i++)
     {
-        global_to_local[*it] = off_proc_column_map.size();
-        off_proc_column_map.emplace_back(*it);
+        global_to_local[off_proc_column_map[i]] = i;
     }
-    off_proc_num_cols = off_proc_column_map.size();
 
     aligned_vector<int> on_proc_cols(A->on_proc_num_cols, 0);
     // Create AggOp matrices
@@ -66,7 +64,7 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
             }
             else
             {
-                AggOp_off->idx2.emplace_back(global_to_local[global_col]);
+                AggOp_off->idx2.emplace_back(global_to_local.find(global_col));
                 AggOp_off->vals.emplace_back(1.0);
             }
         }
@@ -78,8 +76,8 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
     delete[] on_proc_partition_to_col;
 
     // Initialize CSC Matrix for tentative interpolation
-    int global_num_cols;
-    RAPtor_MPI_Allreduce(&n_aggs, &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    index_t global_num_cols = n_aggs;
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &global_num_cols, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
     ParCSCMatrix* T_csc = new ParCSCMatrix(A->partition, A->global_num_rows, global_num_cols, 
             A->local_num_rows, n_aggs, off_proc_num_cols);
         
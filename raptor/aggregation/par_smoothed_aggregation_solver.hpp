@@ -57,7 +57,6 @@ namespace raptor
             ParCSRMatrix* S;
             ParCSRMatrix* T;
             ParCSRMatrix* P;
-            ParCSRMatrix* AP;
 
             aligned_vector<int> states;
             aligned_vector<int> off_proc_states;
@@ -66,10 +65,15 @@ namespace raptor
             int n_aggs;
 
             // Form strength of connection
+            profile_begin("strength");
+            profile_add_nnz(A->local_nnz);
             S = A->strength(strength_type, strong_threshold, tap_level, 
                     1, NULL);
+            profile_end();
 
             // Aggregate Nodes
+            profile_begin("aggregate");
+            profile_add_nnz(S->local_nnz);
             switch (agg_type)
             {
                 case MIS:
@@ -78,8 +82,11 @@ namespace raptor
                             aggregates, tap_level);
                     break;
             }
+            profile_end();
 
             // Form tentative interpolation
+            profile_begin("interp");
+            profile_add_nnz(A->local_nnz);
             T = fit_candidates(A, n_aggs, aggregates, B, R, 
                     num_candidates, false, interp_tol);
             
@@ -92,13 +99,15 @@ namespace raptor
                     break;
             }
             levels[level_ctr]->P = P;
+            profile_end();
 
             // Form coarse grid operator
             levels.emplace_back(new ParLevel());
 
-            AP = A->mult(levels[level_ctr]->P, tap_level);
-
-            A = AP->mult_T(P, tap_level);
+            profile_begin("RAP");
+            profile_add_nnz(A->local_nnz + 2.0 * P->local_nnz);
+            A = A->RAP(P, tap_level);
+            profile_end();
 
             level_ctr++;
             levels[level_ctr]->A = A;
@@ -123,11 +132,16 @@ namespace raptor
 
             std::copy(R.begin(), R.end(), B.begin());
 
-            delete AP;
             delete T;
             delete S;
         }    
 
+        // Move candidates of each coarse row with an agglomerated level
+        void agglomerate_data(ParCSRMatrix* A, ParCSRMatrix* Ac)
+        {
+            agglomerate_values(B, num_candidates, A, Ac, RAPtor_MPI_DOUBLE);
+        }
+
 
         agg_t agg_type;
         prolong_t prolong_type;
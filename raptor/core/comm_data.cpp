@@ -2,6 +2,7 @@
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 
 #include "core/comm_data.hpp"
+#include "core/topology.hpp"
 
 namespace raptor 
 {
@@ -15,6 +16,11 @@ aligned_vector<int>& CommData::get_buffer<int>(const int block_size)
 {
     return int_buffer;
 }
+template<>
+aligned_vector<float>& CommData::get_buffer<float>(const int block_size)
+{
+    return float_buffer;
+}
 template<> 
 aligned_vector<char>& CommData::get_buffer<char>(const int block_size)
 {
@@ -31,6 +37,11 @@ RAPtor_MPI_Datatype CommData::get_type<double>()
 {
     return RAPtor_MPI_DOUBLE;
 }
+template<>
+RAPtor_MPI_Datatype CommData::get_type<float>()
+{
+    return RAPtor_MPI_FLOAT;
+}
 
 template<>
 void CommData::send<int>(const int* values, int key, RAPtor_MPI_Comm mpi_comm, const int block_size, 
@@ -85,4 +96,159 @@ void CommData::recv<double>(int key, RAPtor_MPI_Comm mpi_comm,
 
 
 
+
+// A process leaving the barrier may start the next exchange
+// before others have left, so consecutive exchanges on a communicator
+// alternate between two duplicates of it.  The duplicates, along with
+// the number of exchanges performed, are cached as an attribute of the
+// communicator (every process of which joins each exchange), so that
+// exchange messages never match other traffic on mpi_comm.
+struct NBXComms
+{
+    RAPtor_MPI_Comm comms[2];
+    long epoch;
+};
+
+static int nbx_delete_attr(RAPtor_MPI_Comm comm, int keyval, void* attribute_val,
+        void* extra_state)
+{
+    NBXComms* nbx = (NBXComms*) attribute_val;
+    RAPtor_MPI_Comm_free(&(nbx->comms[0]));
+    RAPtor_MPI_Comm_free(&(nbx->comms[1]));
+    delete nbx;
+    return RAPtor_MPI_SUCCESS;
+}
+
+static RAPtor_MPI_Comm nbx_comm(RAPtor_MPI_Comm mpi_comm)
+{
+    static int nbx_keyval = RAPtor_MPI_KEYVAL_INVALID;
+    if (nbx_keyval == RAPtor_MPI_KEYVAL_INVALID)
+    {
+        RAPtor_MPI_Comm_create_keyval(RAPtor_MPI_COMM_NULL_COPY_FN, nbx_delete_attr,
+                &nbx_keyval, NULL);
+    }
+
+    NBXComms* nbx;
+    int flag;
+    RAPtor_MPI_Comm_get_attr(mpi_comm, nbx_keyval, &nbx, &flag);
+    if (!flag)
+    {
+        nbx = new NBXComms();
+        RAPtor_MPI_Comm_dup(mpi_comm, &(nbx->comms[0]));
+        RAPtor_MPI_Comm_dup(mpi_comm, &(nbx->comms[1]));
+        nbx->epoch = 0;
+        RAPtor_MPI_Comm_set_attr(mpi_comm, nbx_keyval, nbx);
+    }
+
+    return nbx->comms[nbx->epoch++ % 2];
+}
+
+template <typename T>
+void nbx_exchange_helper(int n_sends, const int* send_procs, const int* send_ptr,
+        const T* send_vals, aligned_vector<int>& recv_procs, 
+        aligned_vector<int>& recv_ptr, aligned_vector<T>& recv_vals,
+        int key, RAPtor_MPI_Comm mpi_comm, RAPtor_MPI_Datatype type)
+{
+    RAPtor_MPI_Comm nbx_mpi_comm = nbx_comm(mpi_comm);
+
+    int proc, count, size;
+    int msg_avail, sends_done;
+    int barrier_done = 0;
+    bool barrier_active = false;
+    RAPtor_MPI_Request barrier_request;
+    RAPtor_MPI_Status recv_status;
+    aligned_vector<RAPtor_MPI_Request> requests(n_sends);
+
+    for (int i = 0; i < n_sends; i++)
+    {
+        RAPtor_MPI_Issend(&(send_vals[send_ptr[i]]), send_ptr[i+1] - send_ptr[i],
+                type, send_procs[i], key, nbx_mpi_comm, &(requests[i]));
+    }
+
+    while (!barrier_done)
+    {
+        RAPtor_MPI_Iprobe(RAPtor_MPI_ANY_SOURCE, key, nbx_mpi_comm, &msg_avail, &recv_status);
+        if (msg_avail)
+        {
+            proc = recv_status.RAPtor_MPI_SOURCE;
+            RAPtor_MPI_Get_count(&recv_status, type, &count);
+            size = recv_vals.size();
+            recv_vals.resize(size + count);
+            RAPtor_MPI_Recv(recv_vals.data() + size, count, type, proc, key,
+                    nbx_mpi_comm, &recv_status);
+            recv_procs.emplace_back(proc);
+            recv_ptr.emplace_back(size + count);
+        }
+
+        if (barrier_active)
+        {
+            RAPtor_MPI_Test(&barrier_request, &barrier_done, RAPtor_MPI_STATUS_IGNORE);
+        }
+        else
+        {
+            RAPtor_MPI_Testall(n_sends, requests.data(), &sends_done, 
+                    RAPtor_MPI_STATUSES_IGNORE);
+            if (sends_done)
+            {
+                RAPtor_MPI_Ibarrier(nbx_mpi_comm, &barrier_request);
+                barrier_active = true;
+            }
+        }
+    }
+}
+
+void nbx_exchange(int n_sends, const int* send_procs, const int* send_ptr,
+        const int* send_vals, aligned_vector<int>& recv_procs, 
+        aligned_vector<int>& recv_ptr, aligned_vector<int>& recv_vals,
+        int key, RAPtor_MPI_Comm mpi_comm)
+{
+    nbx_exchange_helper(n_sends, send_procs, send_ptr, send_vals, recv_procs,
+            recv_ptr, recv_vals, key, mpi_comm, RAPtor_MPI_INT);
+}
+
+#ifdef USING_BIG_INDEX
+void nbx_exchange(int n_sends, const int* send_procs, const int* send_ptr,
+        const index_t* send_vals, aligned_vector<int>& recv_procs, 
+        aligned_vector<int>& recv_ptr, aligned_vector<index_t>& recv_vals,
+        int key, RAPtor_MPI_Comm mpi_comm)
+{
+    nbx_exchange_helper(n_sends, send_procs, send_ptr, send_vals, recv_procs,
+            recv_ptr, recv_vals, key, mpi_comm, RAPtor_MPI_INDEX_T);
+}
+#endif
+
+void CommData::add_volume(Topology* topology, RAPtor_MPI_Comm mpi_comm,
+        CommVolume& sends, CommVolume& recvs)
+{
+    int n_sends = send_msg_counts.size();
+    int n_recvs = recv_msg_counts.size();
+    int n = n_sends > n_recvs ? n_sends : n_recvs;
+    if (n == 0) return;
+
+    // Topology maps ranks in RAPtor_MPI_COMM_WORLD to nodes, so
+    // translate procs from ranks in mpi_comm
+    int rank, rank_node;
+    RAPtor_MPI_Group group, world_group;
+    aligned_vector<int> world_procs(n);
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_group(mpi_comm, &group);
+    RAPtor_MPI_Comm_group(RAPtor_MPI_COMM_WORLD, &world_group);
+    RAPtor_MPI_Group_translate_ranks(group, n, procs.data(), world_group,
+            world_procs.data());
+    RAPtor_MPI_Group_free(&group);
+    RAPtor_MPI_Group_free(&world_group);
+
+    rank_node = topology->get_node(rank);
+    for (int i = 0; i < n_sends; i++)
+    {
+        sends.add(topology->get_node(world_procs[i]) == rank_node, 
+                send_msg_counts[i], send_msg_bytes[i]);
+    }
+    for (int i = 0; i < n_recvs; i++)
+    {
+        recvs.add(topology->get_node(world_procs[i]) == rank_node,
+                recv_msg_counts[i], recv_msg_bytes[i]);
+    }
+}
+
 }
@@ -17,6 +17,85 @@
  **************************************************************/
 namespace raptor
 {
+/**************************************************************
+ *****   Sparse Dynamic Exchange (NBX)
+ **************************************************************
+ ***** Sends send_vals[send_ptr[i]:send_ptr[i+1]] to each process
+ ***** send_procs[i], and receives all messages sent to this 
+ ***** process without knowing the senders in advance.  Sends are
+ ***** synchronous, and once all have been matched a non-blocking
+ ***** barrier is started.  The exchange is complete once the 
+ ***** barrier completes, so the cost depends on the number of 
+ ***** messages rather than the number of processes.
+ *****
+ ***** Received messages are appended to recv_procs, recv_ptr, and
+ ***** recv_vals (recv_ptr must hold the initial offset, e.g. 0)
+ **************************************************************/
+void nbx_exchange(int n_sends, const int* send_procs, const int* send_ptr,
+        const int* send_vals, aligned_vector<int>& recv_procs, 
+        aligned_vector<int>& recv_ptr, aligned_vector<int>& recv_vals,
+        int key, RAPtor_MPI_Comm mpi_comm);
+#ifdef USING_BIG_INDEX
+void nbx_exchange(int n_sends, const int* send_procs, const int* send_ptr,
+        const index_t* send_vals, aligned_vector<int>& recv_procs, 
+        aligned_vector<int>& recv_ptr, aligned_vector<index_t>& recv_vals,
+        int key, RAPtor_MPI_Comm mpi_comm);
+#endif
+
+class Topology;
+
+/**************************************************************
+ *****   CommVolume
+ **************************************************************
+ ***** Number of messages and bytes communicated, split into
+ ***** messages with processes on the same node as this process
+ ***** (intra-node) and on other nodes (inter-node)
+ **************************************************************/
+class CommVolume
+{
+public:
+    CommVolume()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        intra_node_msgs = 0;
+        inter_node_msgs = 0;
+        intra_node_bytes = 0;
+        inter_node_bytes = 0;
+    }
+
+    void add(bool intra_node, long n_msgs, long bytes)
+    {
+        if (intra_node)
+        {
+            intra_node_msgs += n_msgs;
+            intra_node_bytes += bytes;
+        }
+        else
+        {
+            inter_node_msgs += n_msgs;
+            inter_node_bytes += bytes;
+        }
+    }
+
+    CommVolume& operator+=(const CommVolume& other)
+    {
+        intra_node_msgs += other.intra_node_msgs;
+        inter_node_msgs += other.inter_node_msgs;
+        intra_node_bytes += other.intra_node_bytes;
+        inter_node_bytes += other.inter_node_bytes;
+        return *this;
+    }
+
+    long intra_node_msgs;
+    long inter_node_msgs;
+    long intra_node_bytes;
+    long inter_node_bytes;
+};
+
     // Forward Declaration
 class CommData
 {
@@ -33,6 +112,8 @@ public:
         num_msgs = 0;
         size_msgs = 0;
         indptr.emplace_back(0);
+        persistent_block_size = 0;
+        persistent_buffer = NULL;
     }
 
     CommData(CommData* data)
@@ -54,6 +135,9 @@ public:
             buffer.resize(size_msgs);
             int_buffer.resize(size_msgs);
         }
+
+        persistent_block_size = 0;
+        persistent_buffer = NULL;
     }
 
     /**************************************************************
@@ -63,6 +147,7 @@ public:
     **************************************************************/
     virtual ~CommData()
     {
+        free_persistent();
     };
 
     virtual void add_msg(int proc, int msg_size, int* msg_indices = NULL) = 0;
@@ -102,6 +187,9 @@ public:
     virtual void double_send(const double* values, int key, RAPtor_MPI_Comm mpi_comm, const int block_size,
             std::function<double(double, double)> init_result_func,
             double init_result_func_val) = 0;
+    // Sends double values rounded to single precision
+    virtual void float_send(const double* values, int key, RAPtor_MPI_Comm mpi_comm,
+            const int block_size = 1) = 0;
 
     template <typename T>
     void send(const T* values, int key, RAPtor_MPI_Comm mpi_comm,
@@ -121,12 +209,6 @@ public:
             const double* values, 
             int key, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1) = 0;
-    virtual void send(char* send_buffer,
-            const int* rowptr, 
-            const int* col_indices,
-            double const* const* values, 
-            int key, RAPtor_MPI_Comm mpi_comm, 
-            const int block_size = 1) = 0;
     virtual int get_msg_size(const int* rowptr, 
             const bool has_vals, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1) = 0;
@@ -141,7 +223,7 @@ public:
         int size = size_msgs * block_size;
         RAPtor_MPI_Datatype datatype = get_type<T>();
         aligned_vector<T>& buf = get_buffer<T>();
-        if (buf.size() < size) buf.resize(size);
+        if ((int) buf.size() < size) buf.resize(size);
 
         for (int i = 0; i < num_msgs; i++)
         {
@@ -150,6 +232,7 @@ public:
             end = indptr[i+1];
             RAPtor_MPI_Irecv(&(buf[start*block_size]), (end - start) * block_size, datatype,
                     proc, key, mpi_comm, &(requests[i]));
+            count_recv(i, (end - start) * block_size * sizeof(T));
         }
     }   
 
@@ -198,6 +281,7 @@ public:
             }
             RAPtor_MPI_Recv(&(recv_buffer[0]), count, RAPtor_MPI_PACKED, proc, key,
                     mpi_comm, &recv_status);
+            count_recv(i, count);
 
             // Go through recv, adding indices to matrix recv_mat
             ctr = 0;
@@ -213,24 +297,11 @@ public:
                 
                 if (vals)
                 {
-                    if (block_size > 1)
-                    {
-                        BSRMatrix* recv_mat_bsr = (BSRMatrix*) recv_mat;
-                        recv_mat_bsr->block_vals.resize(recv_size + row_size);
-                        for (int i = 0; i < row_size; i++)
-                        {
-                            recv_mat_bsr->block_vals[recv_size + i] = new double[block_size];
-                            RAPtor_MPI_Unpack(recv_buffer.data(), count, &ctr, 
-                                    recv_mat_bsr->block_vals[recv_size + i],
-                                    block_size, RAPtor_MPI_DOUBLE, mpi_comm);
-                        }
-                    }
-                    else
-                    {
-                        recv_mat->vals.resize(recv_size + row_size);
-                        RAPtor_MPI_Unpack(recv_buffer.data(), count, &ctr, &recv_mat->vals[recv_size],
-                                row_size, RAPtor_MPI_DOUBLE, mpi_comm);
-                    }
+                    // Block values are stored contiguously in vals
+                    recv_mat->vals.resize((recv_size + row_size) * block_size);
+                    RAPtor_MPI_Unpack(recv_buffer.data(), count, &ctr, 
+                            &recv_mat->vals[recv_size * block_size],
+                            row_size * block_size, RAPtor_MPI_DOUBLE, mpi_comm);
                 }
                 recv_size += row_size;
             }
@@ -254,22 +325,119 @@ public:
         }
     }
 
-    void pack_values(const double* values, int row_start, int size, char* send_buffer,
-           int bytes, int* ctr, RAPtor_MPI_Comm mpi_comm, int block_size)
+    /**************************************************************
+    *****   Persistent Communication
+    **************************************************************
+    ***** Creates persistent requests for sending and receiving 
+    ***** each message (block_size doubles per index) from buffer.
+    ***** Both directions are created, as forward communication
+    ***** sends from send_data and recvs into recv_data, while 
+    ***** transpose communication does the opposite.  Requests are
+    ***** only recreated when the block size changes or buffer has
+    ***** been reallocated.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** key : int
+    *****    Tag used for all persistent messages
+    ***** mpi_comm : RAPtor_MPI_Comm
+    *****    Communicator messages are sent over
+    ***** block_size : int (optional)
+    *****    Number of values communicated per index (default 1)
+    **************************************************************/
+    void init_persistent(int key, RAPtor_MPI_Comm mpi_comm, const int block_size = 1)
+    {
+        int size = size_msgs * block_size;
+        if (buffer.size() < size) buffer.resize(size);
+        if (block_size == persistent_block_size && buffer.data() == persistent_buffer)
+            return;
+
+        free_persistent();
+        persistent_send_requests.resize(num_msgs);
+        persistent_recv_requests.resize(num_msgs);
+
+        int proc, start, end;
+        for (int i = 0; i < num_msgs; i++)
+        {
+            proc = procs[i];
+            start = indptr[i] * block_size;
+            end = indptr[i+1] * block_size;
+            RAPtor_MPI_Send_init(&(buffer[start]), end - start, RAPtor_MPI_DOUBLE,
+                    proc, key, mpi_comm, &(persistent_send_requests[i]));
+            RAPtor_MPI_Recv_init(&(buffer[start]), end - start, RAPtor_MPI_DOUBLE,
+                    proc, key, mpi_comm, &(persistent_recv_requests[i]));
+        }
+        persistent_block_size = block_size;
+        persistent_buffer = buffer.data();
+    }
+
+    void free_persistent()
+    {
+        for (int i = 0; i < (int) persistent_send_requests.size(); i++)
+        {
+            RAPtor_MPI_Request_free(&(persistent_send_requests[i]));
+            RAPtor_MPI_Request_free(&(persistent_recv_requests[i]));
+        }
+        persistent_send_requests.clear();
+        persistent_recv_requests.clear();
+        persistent_block_size = 0;
+        persistent_buffer = NULL;
+    }
+
+    void start_persistent_send()
+    {
+        if (num_msgs)
+        {
+            RAPtor_MPI_Startall(num_msgs, persistent_send_requests.data());
+            if (profile) profile_send(num_msgs, 
+                    ((double) size_msgs) * persistent_block_size * sizeof(double));
+            for (int i = 0; i < num_msgs; i++)
+            {
+                count_send(i, (indptr[i+1] - indptr[i]) * persistent_block_size 
+                        * sizeof(double));
+            }
+        }
+    }
+    void start_persistent_recv()
     {
-        RAPtor_MPI_Pack(&(values[row_start]), size, RAPtor_MPI_DOUBLE, send_buffer, 
-                bytes, ctr, mpi_comm);
+        if (num_msgs)
+        {
+            RAPtor_MPI_Startall(num_msgs, persistent_recv_requests.data());
+            if (profile) profile_recv(
+                    ((double) size_msgs) * persistent_block_size * sizeof(double));
+            for (int i = 0; i < num_msgs; i++)
+            {
+                count_recv(i, (indptr[i+1] - indptr[i]) * persistent_block_size 
+                        * sizeof(double));
+            }
+        }
     }
-    void pack_values(double const* const* values, int row_start, int size, 
-            char* send_buffer, int bytes, int* ctr, RAPtor_MPI_Comm mpi_comm, int block_size)
+    void wait_persistent_send()
     {
-        for (int i = 0; i < size; i++)
+        if (num_msgs)
         {
-            RAPtor_MPI_Pack(values[row_start + i], block_size, RAPtor_MPI_DOUBLE, send_buffer,
-                    bytes, ctr, mpi_comm);
+            RAPtor_MPI_Waitall(num_msgs, persistent_send_requests.data(), 
+                    RAPtor_MPI_STATUSES_IGNORE);
+        }
+    }
+    void wait_persistent_recv()
+    {
+        if (num_msgs)
+        {
+            RAPtor_MPI_Waitall(num_msgs, persistent_recv_requests.data(), 
+                    RAPtor_MPI_STATUSES_IGNORE);
         }
     }
 
+    // Values are contiguous, with block_size values per nonzero
+    // (block_size == 1 for CSR, b_rows*b_cols for BSR)
+    void pack_values(const double* values, int row_start, int size, char* send_buffer,
+           int bytes, int* ctr, RAPtor_MPI_Comm mpi_comm, int block_size)
+    {
+        RAPtor_MPI_Pack(&(values[row_start * block_size]), size * block_size, 
+                RAPtor_MPI_DOUBLE, send_buffer, bytes, ctr, mpi_comm);
+    }
+
     template <typename T>
     void unpack(aligned_vector<T>& buffer, RAPtor_MPI_Comm mpi_comm, const int block_size = 1)
     {
@@ -288,6 +456,62 @@ public:
         pack_buffer.resize(size_msgs);
     }
 
+    // Count a message of the given bytes sent to procs[i]
+    void count_send(int i, long bytes)
+    {
+        if ((int) send_msg_counts.size() < num_msgs)
+        {
+            send_msg_counts.resize(num_msgs, 0);
+            send_msg_bytes.resize(num_msgs, 0);
+        }
+        send_msg_counts[i]++;
+        send_msg_bytes[i] += bytes;
+    }
+    // Count a message of the given bytes received from procs[i]
+    void count_recv(int i, long bytes)
+    {
+        if ((int) recv_msg_counts.size() < num_msgs)
+        {
+            recv_msg_counts.resize(num_msgs, 0);
+            recv_msg_bytes.resize(num_msgs, 0);
+        }
+        recv_msg_counts[i]++;
+        recv_msg_bytes[i] += bytes;
+    }
+
+    /**************************************************************
+    *****   Communication Volume
+    **************************************************************
+    ***** Every message this CommData sends or receives (vector,
+    ***** conditional, matrix, and persistent communication) is
+    ***** counted as it is posted, along with its size in bytes,
+    ***** for the corresponding process in procs.  add_volume
+    ***** classifies these counts as intra-node or inter-node with
+    ***** a Topology, so that the volume of each communication
+    ***** package is available without recomputing its pattern.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** topology : Topology*
+    *****    Topology mapping processes to nodes
+    ***** mpi_comm : RAPtor_MPI_Comm
+    *****    Communicator messages are sent over (procs are ranks
+    *****    in mpi_comm)
+    ***** sends : CommVolume&
+    *****    Volume to which sent messages are added
+    ***** recvs : CommVolume&
+    *****    Volume to which received messages are added
+    **************************************************************/
+    void add_volume(Topology* topology, RAPtor_MPI_Comm mpi_comm,
+            CommVolume& sends, CommVolume& recvs);
+    void reset_volume()
+    {
+        send_msg_counts.clear();
+        send_msg_bytes.clear();
+        recv_msg_counts.clear();
+        recv_msg_bytes.clear();
+    }
+
     int num_msgs;
     int size_msgs;
     aligned_vector<int> procs;
@@ -295,8 +519,21 @@ public:
     aligned_vector<RAPtor_MPI_Request> requests;
     aligned_vector<double> buffer;
     aligned_vector<int> int_buffer;
+    aligned_vector<float> float_buffer;
     aligned_vector<char> pack_buffer;
 
+    // Persistent requests, bound to buffer
+    aligned_vector<RAPtor_MPI_Request> persistent_send_requests;
+    aligned_vector<RAPtor_MPI_Request> persistent_recv_requests;
+    int persistent_block_size;
+    double* persistent_buffer;
+
+    // Messages and bytes sent to / received from each of procs
+    aligned_vector<long> send_msg_counts;
+    aligned_vector<long> send_msg_bytes;
+    aligned_vector<long> recv_msg_counts;
+    aligned_vector<long> recv_msg_bytes;
+
 };
 
 class ContigData : public CommData
@@ -413,6 +650,33 @@ public:
         send(values, key, mpi_comm, states, compare_func, n_send_ptr, block_size);
     }        
 
+    void float_send(const double* values, int key, RAPtor_MPI_Comm mpi_comm,
+            const int block_size = 1)
+    {
+        if (num_msgs == 0) return;
+
+        int start, end;
+        int proc;
+        int size = size_msgs * block_size;
+
+        aligned_vector<float>& buf = float_buffer;
+        if ((int) buf.size() < size) buf.resize(size);
+
+        for (int i = 0; i < num_msgs; i++)
+        {
+            proc = procs[i];
+            start = indptr[i] * block_size;
+            end = indptr[i+1] * block_size;
+            for (int j = start; j < end; j++)
+            {
+                buf[j] = values[j];
+            }
+            RAPtor_MPI_Isend(&(buf[start]), end - start, RAPtor_MPI_FLOAT, 
+                    proc, key, mpi_comm, &(requests[i]));
+            count_send(i, (end - start) * sizeof(float));
+        }
+    }
+
     template <typename T>
     void send(const T* values, int key, RAPtor_MPI_Comm mpi_comm, const int block_size = 1,
             std::function<T(T, T)> init_result_func = &sum_func<T, T>,
@@ -433,6 +697,7 @@ public:
             end = indptr[i+1];
             RAPtor_MPI_Isend(&(values[start*block_size]), (end - start) * block_size,
                     datatype, proc, key, mpi_comm, &(requests[i]));
+            count_send(i, (end - start) * block_size * sizeof(T));
         }
     }
 
@@ -491,6 +756,7 @@ public:
             {
                 RAPtor_MPI_Isend(&(buf[prev_ctr]), size, datatype, 
                         proc, key, mpi_comm, &(requests[n_sends++]));
+                count_send(i, size * sizeof(T));
                 prev_ctr = ctr;
             }
         }        
@@ -508,16 +774,6 @@ public:
                 mpi_comm, block_size);
     }
 
-    void send(char* send_buffer,
-        const int* rowptr,
-        const int* col_indices,
-        double const* const* values,
-        int key, RAPtor_MPI_Comm mpi_comm,
-        const int block_size = 1)     
-    {
-        send_helper(send_buffer, rowptr, col_indices, values, key,
-                mpi_comm, block_size);
-    }
 
     int get_msg_size(const int* rowptr, const bool has_vals, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1)
@@ -545,7 +801,7 @@ public:
         return bytes;
     }
 
-    // values can be double* (CSRMatrix) or double** (BSRMatrix)
+    // values are contiguous, block_size values per nonzero
     template <typename T>
     void send_helper(char* send_buffer,
         const int* rowptr,
@@ -587,6 +843,7 @@ public:
             }
             RAPtor_MPI_Isend(&(send_buffer[prev_ctr]), ctr - prev_ctr, RAPtor_MPI_PACKED, proc, 
                     key, mpi_comm, &(requests[i]));
+            count_send(i, ctr - prev_ctr);
             prev_ctr = ctr;
         }
     } 
@@ -653,6 +910,7 @@ public:
             {
                 RAPtor_MPI_Irecv(&(buf[prev_ctr]), ctr - prev_ctr, datatype,
                         proc, key, mpi_comm, &(requests[n_recvs++]));
+                count_recv(i, (ctr - prev_ctr) * sizeof(T));
                 prev_ctr = ctr;
             }
         }
@@ -742,6 +1000,61 @@ public:
         size_msgs += msg_size;
     }
 
+    /**************************************************************
+    *****   NonContigData Probe NBX
+    **************************************************************
+    ***** Sends values[indptr[i]:indptr[i+1]] to each process in 
+    ***** dest_data, and forms this NonContigData from the messages
+    ***** received, discovering the sending processes with NBX
+    ***** rather than a global reduction of message counts.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** dest_data : CommData*
+    *****    Processes (and message offsets) to which values are sent
+    ***** values : const int*
+    *****    Values to send, contiguous for each message
+    **************************************************************/
+    void probe_nbx(CommData* dest_data, const int* values, int key, 
+            RAPtor_MPI_Comm mpi_comm)
+    {
+        nbx_exchange(dest_data->num_msgs, dest_data->procs.data(), 
+                dest_data->indptr.data(), values, procs, indptr, indices,
+                key, mpi_comm);
+        num_msgs = procs.size();
+        size_msgs = indices.size();
+        finalize();
+    }
+
+    // Sends global indices (e.g. an off_proc_column_map), storing each
+    // received index relative to first_local (local to this process)
+    void probe_nbx(CommData* dest_data, const index_t* values, 
+            index_t first_local, int key, RAPtor_MPI_Comm mpi_comm)
+    {
+#ifdef USING_BIG_INDEX
+        aligned_vector<index_t> global_indices;
+        nbx_exchange(dest_data->num_msgs, dest_data->procs.data(), 
+                dest_data->indptr.data(), values, procs, indptr, global_indices,
+                key, mpi_comm);
+        indices.resize(global_indices.size());
+        for (int i = 0; i < (int) global_indices.size(); i++)
+        {
+            indices[i] = global_indices[i] - first_local;
+        }
+#else
+        nbx_exchange(dest_data->num_msgs, dest_data->procs.data(), 
+                dest_data->indptr.data(), values, procs, indptr, indices,
+                key, mpi_comm);
+        for (int i = 0; i < (int) indices.size(); i++)
+        {
+            indices[i] -= first_local;
+        }
+#endif
+        num_msgs = procs.size();
+        size_msgs = indices.size();
+        finalize();
+    }
+
     void probe(int size, int key, RAPtor_MPI_Comm mpi_comm)
     {
         int proc, count;
@@ -794,6 +1107,38 @@ public:
         send(values, key, mpi_comm, states, compare_func, n_send_ptr, block_size);
     }     
 
+    void float_send(const double* values, int key, RAPtor_MPI_Comm mpi_comm,
+            const int block_size = 1)
+    {
+        if (num_msgs == 0) return;
+
+        int start, end;
+        int proc, idx, pos;
+        int size = size_msgs * block_size;
+
+        aligned_vector<float>& buf = float_buffer;
+        if ((int) buf.size() < size) buf.resize(size);
+
+        for (int i = 0; i < num_msgs; i++)
+        {
+            proc = procs[i];
+            start = indptr[i];
+            end = indptr[i+1];
+            for (int j = start; j < end; j++)
+            {
+                idx = indices[j] * block_size;
+                pos = j * block_size;
+                for (int k = 0; k < block_size; k++)
+                {
+                    buf[pos + k] = values[idx + k];
+                }
+            }
+            RAPtor_MPI_Isend(&(buf[start*block_size]), (end - start) * block_size,
+                    RAPtor_MPI_FLOAT, proc, key, mpi_comm, &(requests[i]));
+            count_send(i, (end - start) * block_size * sizeof(float));
+        }
+    }
+
     template <typename T>
     void send(const T* values, int key, RAPtor_MPI_Comm mpi_comm, const int block_size = 1,
             std::function<T(T, T)> init_result_func = &sum_func<T, T>,
@@ -826,6 +1171,7 @@ public:
             }
             RAPtor_MPI_Isend(&(buf[start*block_size]), (end - start) * block_size,
                     datatype, proc, key, mpi_comm, &(requests[i]));
+            count_send(i, (end - start) * block_size * sizeof(T));
         }
     }
 
@@ -885,6 +1231,7 @@ public:
             {
                 RAPtor_MPI_Isend(&(buf[prev_ctr]), ctr - prev_ctr, datatype, 
                         proc, key, mpi_comm, &(requests[n_sends++]));
+                count_send(i, (ctr - prev_ctr) * sizeof(T));
                 prev_ctr = ctr;
             }
         }
@@ -903,16 +1250,6 @@ public:
                 mpi_comm, block_size);
     }
 
-    void send(char* send_buffer,
-        const int* rowptr,
-        const int* col_indices,
-        double const* const* values,
-        int key, RAPtor_MPI_Comm mpi_comm,
-        const int block_size = 1)     
-    {
-        send_helper(send_buffer, rowptr, col_indices, values, key,
-                mpi_comm, block_size);
-    }
 
     int get_msg_size(const int* rowptr, const bool has_vals, RAPtor_MPI_Comm mpi_comm,
             const int block_size = 1)
@@ -986,6 +1323,7 @@ public:
             }
             RAPtor_MPI_Isend(&(send_buffer[prev_ctr]), ctr - prev_ctr, RAPtor_MPI_PACKED, proc, 
                     key, mpi_comm, &(requests[i]));
+            count_send(i, ctr - prev_ctr);
             prev_ctr = ctr;
         }
     }
@@ -1053,6 +1391,7 @@ public:
             {
                 RAPtor_MPI_Irecv(&(buf[prev_ctr]), ctr - prev_ctr, datatype, proc,
                         key, mpi_comm, &(requests[n_recvs++]));
+                count_recv(i, (ctr - prev_ctr) * sizeof(T));
                 prev_ctr = ctr;
             }
         }
@@ -1163,6 +1502,53 @@ public:
         send(values, key, mpi_comm, states, compare_func, n_send_ptr, block_size);
     }     
 
+    void float_send(const double* values, int key, RAPtor_MPI_Comm mpi_comm,
+            const int block_size = 1)
+    {
+        if (num_msgs == 0) return;
+
+        int start, end;
+        int proc, idx, pos;
+        int idx_start, idx_end;
+        int size = size_msgs * block_size;
+
+        aligned_vector<float>& buf = float_buffer;
+        if ((int) buf.size() < size) buf.resize(size);
+
+        // Duplicate values are summed in double before rounding
+        aligned_vector<double>& tmp = float_sum_buffer;
+        tmp.resize(block_size);
+
+        for (int i = 0; i < num_msgs; i++)
+        {
+            proc = procs[i];
+            start = indptr[i];
+            end = indptr[i+1];
+            for (int j = start; j < end; j++)
+            {
+                idx_start = indptr_T[j];
+                idx_end = indptr_T[j+1];
+                std::fill(tmp.begin(), tmp.end(), 0.0);
+                for (int k = idx_start; k < idx_end; k++)
+                {
+                    idx = indices[k] * block_size;
+                    for (int l = 0; l < block_size; l++)
+                    {
+                        tmp[l] += values[idx+l];
+                    }
+                }
+                pos = j * block_size;
+                for (int k = 0; k < block_size; k++)
+                {
+                    buf[pos + k] = tmp[k];
+                }
+            }
+            RAPtor_MPI_Isend(&(buf[start * block_size]), (end - start) * block_size,
+                   RAPtor_MPI_FLOAT, proc, key, mpi_comm, &(requests[i]));
+            count_send(i, (end - start) * block_size * sizeof(float));
+        }
+    }
+
     template <typename T>
     void send(const T* values, int key, RAPtor_MPI_Comm mpi_comm, const int block_size = 1,
             std::function<T(T, T)> init_result_func = &sum_func<T, T>,
@@ -1209,6 +1595,7 @@ public:
             }
             RAPtor_MPI_Isend(&(buf[start * block_size]), (end - start) * block_size,
                    datatype, proc, key, mpi_comm, &(requests[i]));
+            count_send(i, (end - start) * block_size * sizeof(T));
         }
     }
 
@@ -1220,25 +1607,15 @@ public:
 
     }
 
-    void append_val(aligned_vector<double>& vec, const double val, int block_size)
-    {
-        vec.emplace_back(val);
-    }
-    void append_val(aligned_vector<double>& vec, const double* val, int block_size)
-    {
-        for (int i = 0; i < block_size; i++)
-            vec.emplace_back(val[i]);
-    }
-    
-    template <typename T>
     void combine_entries(int j, const int* rowptr, const int* col_indices, 
-            const T& values, int block_size, aligned_vector<int>& send_indices, 
+            const double* values, int block_size, aligned_vector<int>& send_indices, 
             aligned_vector<double>& send_values, int* size_ptr)
     {
         int idx_start, idx_end;
         int row_start, row_end;
         int size, row, idx, ctr;
-        int pos = 0;
+
+        aligned_vector<double> tmp_values;
 
         idx_start = indptr_T[j];
         idx_end = indptr_T[j+1];
@@ -1250,15 +1627,33 @@ public:
             for (int l = row_start; l < row_end; l++)
             {
                 send_indices.emplace_back(col_indices[l]);
-                append_val(send_values, values[l], block_size);
+                tmp_values.insert(tmp_values.end(), &values[l * block_size],
+                        &values[(l+1) * block_size]);
             }
         }
         if (send_indices.size())
         {
-            vec_sort(send_indices, send_values);
-            size = 1;
+            // Sort indices, moving (block) values with them
+            int n = send_indices.size();
+            aligned_vector<int> p(n);
+            std::iota(p.begin(), p.end(), 0);
+            std::sort(p.begin(), p.end(), 
+                    [&](const int a, const int b)
+                    {
+                        return send_indices[a] < send_indices[b];
+                    });
+            aligned_vector<int> tmp_indices(send_indices);
+            send_values.resize(n * block_size);
+            for (int k = 0; k < n; k++)
+            {
+                send_indices[k] = tmp_indices[p[k]];
+                std::copy(&tmp_values[p[k] * block_size], 
+                        &tmp_values[p[k] * block_size] + block_size,
+                        &send_values[k * block_size]);
+            }
 
-            for (int k = 1; k < send_indices.size(); k++)
+            size = 1;
+            for (int k = 1; k < n; k++)
             {
                 ctr = k * block_size;
                 if (send_indices[k] != send_indices[size - 1])
@@ -1333,15 +1728,6 @@ public:
     {
         send_helper(send_buffer, rowptr, col_indices, values, key, mpi_comm, block_size);
     }
-    void send(char* send_buffer,
-            const int* rowptr, 
-            const int* col_indices,
-            double const* const* values, 
-            int key, RAPtor_MPI_Comm mpi_comm, 
-            const int block_size = 1)
-    {
-        send_helper(send_buffer, rowptr, col_indices, values, key, mpi_comm, block_size);
-    }
 
     int get_msg_size(const int* rowptr, const bool has_vals, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1)
@@ -1416,18 +1802,22 @@ public:
 
                 if (values)
                 {
-                    pack_values(send_values.data(), row_start, size, send_buffer, bytes, &ctr, 
+                    pack_values(send_values.data(), 0, size, send_buffer, bytes, &ctr, 
                             mpi_comm, block_size);
                 }
             }
             RAPtor_MPI_Isend(&(send_buffer[prev_ctr]), ctr - prev_ctr, RAPtor_MPI_PACKED, proc, 
                     key, mpi_comm, &(requests[i]));
+            count_send(i, ctr - prev_ctr);
             prev_ctr = ctr;
         }
     }
 
      aligned_vector<int> indptr_T;
 
+     // Scratch for summing duplicates in float_send
+     aligned_vector<double> float_sum_buffer;
+
 }; 
 
 }
@@ -201,3 +201,9 @@ void CommPkg::init_comm(ParVector& v, const int block_size)
     init_double_comm(v.local.data(), block_size);
 }
 
+aligned_vector<double>& CommPkg::communicate_float(ParVector& v, const int block_size)
+{
+    init_float_comm(v.local.data(), block_size);
+    return complete_float_comm(block_size);
+}
+
@@ -72,20 +72,16 @@ namespace raptor
         }
 
         // Matrix Communication
+        // Values are contiguous, with b_rows*b_cols values per nonzero
+        // when communicating block (BSR) matrices
         // TODO -- Block transpose communication
         //      -- Should b_rows / b_cols be switched?
         virtual CSRMatrix* communicate(const aligned_vector<int>& rowptr, 
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true) = 0;
-        virtual CSRMatrix* communicate(const aligned_vector<int>& rowptr, 
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values,
-                const int b_rows = 1, const int b_cols = 1, const bool has_vals = true) = 0;
         virtual void init_mat_comm(aligned_vector<char>& send_buffer, const aligned_vector<int>& rowptr, 
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true) = 0;
-        virtual void init_mat_comm(aligned_vector<char>& send_buffer, const aligned_vector<int>& rowptr, 
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values,
-                const int b_rows = 1, const int b_cols = 1, const bool has_vals = true) = 0;
         virtual CSRMatrix* complete_mat_comm(const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true) = 0;
 
@@ -93,18 +89,10 @@ namespace raptor
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1,
                 const bool has_vals = true) = 0;
-        virtual CSRMatrix* communicate_T(const aligned_vector<int>& rowptr,
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values, 
-                const int n_result_rows, const int b_rows = 1, const int b_cols = 1,
-                const bool has_vals = true) = 0;
         virtual void init_mat_comm_T(aligned_vector<char>& send_buffer, 
                 const aligned_vector<int>& rowptr, const aligned_vector<int>& col_indices, 
                 const aligned_vector<double>& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) = 0;
-        virtual void init_mat_comm_T(aligned_vector<char>& send_buffer,
-                const aligned_vector<int>& rowptr, const aligned_vector<int>& col_indices, 
-                const aligned_vector<double*>& values, const int b_rows = 1, 
-                const int b_cols = 1, const bool has_vals = true) = 0;
         virtual CSRMatrix* complete_mat_comm_T(const int n_result_rows, 
                 const int b_rows = 1, const int b_cols = 1,
                 const bool has_vals = true) = 0;
@@ -113,9 +101,9 @@ namespace raptor
         {
             return A->vals;
         }
-        aligned_vector<double*> get_vals(BSRMatrix* A)
+        aligned_vector<double>& get_vals(BSRMatrix* A)
         {
-            return A->block_vals;
+            return A->vals;
         }
 
         CSRMatrix* communicate_sparsity(ParCSRMatrix* A)
@@ -163,6 +151,20 @@ namespace raptor
         virtual aligned_vector<double>& complete_double_comm(const int block_size) = 0;
         virtual aligned_vector<int>& complete_int_comm(const int block_size) = 0;
 
+        // Single Precision Vector Communication
+        // Double values are rounded to float for the exchange, and 
+        // received values are returned in double.  Communication
+        // packages without a single precision path send doubles.
+        aligned_vector<double>& communicate_float(ParVector& v, const int block_size = 1);
+        virtual void init_float_comm(const double* values, const int block_size)
+        {
+            init_double_comm(values, block_size);
+        }
+        virtual aligned_vector<double>& complete_float_comm(const int block_size)
+        {
+            return complete_double_comm(block_size);
+        }
+
         // Transpose Communication
         template<typename T, typename U>
         void communicate_T(const aligned_vector<T>& values, aligned_vector<U>& result,
@@ -248,6 +250,26 @@ namespace raptor
         virtual void complete_int_comm_T(const int block_size,
                 std::function<int(int, int)> init_result_func = &sum_func<int, int>,
                 int init_result_func_val = 0) = 0;
+        virtual void init_float_comm_T(const double* values, const int block_size)
+        {
+            init_double_comm_T(values, block_size);
+        }
+        virtual void complete_float_comm_T(aligned_vector<double>& result,
+                const int block_size)
+        {
+            complete_double_comm_T(result, block_size);
+        }
+
+        /**************************************************************
+        *****   Communication Volume
+        **************************************************************
+        ***** Adds the messages and bytes this process has sent and
+        ***** received through this package (since it was created or
+        ***** last reset) to sends and recvs, split into intra-node
+        ***** and inter-node messages by the package's Topology
+        **************************************************************/
+        virtual void get_comm_volume(CommVolume& sends, CommVolume& recvs) = 0;
+        virtual void reset_comm_volume() = 0;
 
         // Helper methods
         template <typename T> aligned_vector<T>& get_buffer();
@@ -319,6 +341,8 @@ namespace raptor
         {
             mpi_comm = _comm;
             key = _key;
+            persistent = false;
+            persistent_active = false;
             send_data = new NonContigData();
             if (r_data)
                 recv_data = r_data;
@@ -332,6 +356,8 @@ namespace raptor
         {
             mpi_comm = _comm;
             key = _key;
+            persistent = false;
+            persistent_active = false;
             send_data = new NonContigData();
             if (r_data)
                 recv_data = r_data;
@@ -346,13 +372,13 @@ namespace raptor
         *****
         ***** Parameters
         ***** -------------
-        ***** off_proc_column_map : aligned_vector<int>&
+        ***** off_proc_column_map : aligned_vector<index_t>&
         *****    Maps local off_proc columns indices to global
         ***** _key : int (optional)
         *****    Tag to be used in RAPtor_MPI Communication (default 9999)
         **************************************************************/
         ParComm(Partition* partition,
-                const aligned_vector<int>& off_proc_column_map,
+                const aligned_vector<index_t>& off_proc_column_map,
                 int _key = 9999,
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD,
                 CommData* r_data = NULL) : CommPkg(partition)
@@ -362,8 +388,8 @@ namespace raptor
         }
 
         ParComm(Partition* partition,
-                const aligned_vector<int>& off_proc_column_map,
-                const aligned_vector<int>& on_proc_column_map,
+                const aligned_vector<index_t>& off_proc_column_map,
+                const aligned_vector<index_t>& on_proc_column_map,
                 int _key = 9999, 
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD,
                 CommData* r_data = NULL) : CommPkg(partition)
@@ -379,7 +405,7 @@ namespace raptor
             {
                 part_col_to_new.resize(partition->local_num_cols, -1);
             }
-            for (aligned_vector<int>::const_iterator it = on_proc_column_map.begin();
+            for (aligned_vector<index_t>::const_iterator it = on_proc_column_map.begin();
                     it != on_proc_column_map.end(); ++it)
             {
                 part_col_to_new[*it - partition->first_local_col] = ctr++;
@@ -395,7 +421,7 @@ namespace raptor
         }
 
         void init_par_comm(Partition* partition,
-                const aligned_vector<int>& off_proc_column_map,
+                const aligned_vector<index_t>& off_proc_column_map,
                 int _key, RAPtor_MPI_Comm comm,
                 CommData* r_data = NULL)
         {
@@ -406,6 +432,8 @@ namespace raptor
 
             // Initialize class variables
             key = _key;
+            persistent = false;
+            persistent_active = false;
 
             send_data = new NonContigData();
 
@@ -450,22 +478,12 @@ namespace raptor
             }
 
             // For each process I recv from, send the global column indices
-            // for which I must recv corresponding rows 
-            aligned_vector<int> recv_sizes(num_procs, 0);
-            for (int i = 0; i < recv_data->num_msgs; i++)
-                recv_sizes[recv_data->procs[i]] = 
-                    recv_data->indptr[i+1] - recv_data->indptr[i];
-            RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, recv_sizes.data(), num_procs, RAPtor_MPI_INT,
-                    RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
-            if (profile) vec_t -= RAPtor_MPI_Wtime();
-            recv_data->send(off_proc_column_map.data(), tag, comm);
-            send_data->probe(recv_sizes[rank], tag, comm);
-            recv_data->waitall();
-            if (profile) vec_t += RAPtor_MPI_Wtime();
-            for (int i = 0; i < send_data->size_msgs; i++)
-            {
-                send_data->indices[i] -= partition->first_local_col;
-            }
+            // for which I must recv corresponding rows (processes to send
+            // to are discovered with NBX)
+            if (profile) profile_start(ProfileVecComm);
+            send_data->probe_nbx(recv_data, off_proc_column_map.data(), 
+                    partition->first_local_col, tag, comm);
+            if (profile) profile_stop(ProfileVecComm);
         }
 
         ParComm(ParComm* comm) : CommPkg(comm->topology)
@@ -474,12 +492,16 @@ namespace raptor
             send_data = comm->send_data->copy();
             recv_data = comm->recv_data->copy();
             key = comm->key;
+            persistent = false;
+            persistent_active = false;
         }
 
         ParComm(ParComm* comm, const aligned_vector<int>& off_proc_col_to_new)
             : CommPkg(comm->topology)
         {
             mpi_comm = comm->mpi_comm;
+            persistent = false;
+            persistent_active = false;
             bool comm_proc;
             int proc, start, end;
             int idx, new_idx;
@@ -499,6 +521,8 @@ namespace raptor
             : CommPkg(comm->topology)
         {
             mpi_comm = comm->mpi_comm;
+            persistent = false;
+            persistent_active = false;
             bool comm_proc;
             int proc, start, end;
             int idx, new_idx;
@@ -582,7 +606,10 @@ namespace raptor
         // Standard Communication
         void init_double_comm(const double* values, const int block_size = 1)
         {
-            initialize(values, block_size);
+            if (persistent)
+                persistent_initialize(values, block_size);
+            else
+                initialize(values, block_size);
         }
         void init_int_comm(const int* values, const int block_size = 1)
         {
@@ -596,6 +623,28 @@ namespace raptor
         {
             return complete<int>(block_size);
         }
+        void init_float_comm(const double* values, const int block_size = 1)
+        {
+            if (profile) profile_start(ProfileVecComm);
+            send_data->float_send(values, key, mpi_comm, block_size);
+            recv_data->recv<float>(key, mpi_comm, block_size);
+            if (profile) profile_stop(ProfileVecComm);
+        }
+        aligned_vector<double>& complete_float_comm(const int block_size = 1)
+        {
+            aligned_vector<float>& float_buf = complete<float>(block_size);
+
+            // Copy single precision values into double buffer
+            int size = recv_data->size_msgs * block_size;
+            aligned_vector<double>& buf = recv_data->get_buffer<double>();
+            if ((int) buf.size() < size) buf.resize(size);
+            for (int i = 0; i < size; i++)
+            {
+                buf[i] = float_buf[i];
+            }
+
+            return buf;
+        }
         template<typename T>
         aligned_vector<T>& communicate(const aligned_vector<T>& values,
                 const int block_size = 1)
@@ -614,19 +663,28 @@ namespace raptor
             int start, end;
             int proc, pos, idx;
 
-            if (profile) vec_t -= RAPtor_MPI_Wtime();
+            if (profile) profile_start(ProfileVecComm);
             send_data->send(values, key, mpi_comm, block_size);
             recv_data->recv<T>(key, mpi_comm, block_size);
-            if (profile) vec_t += RAPtor_MPI_Wtime();
+            if (profile) profile_stop(ProfileVecComm);
         }
 
         template<typename T>
         aligned_vector<T>& complete(const int block_size = 1)
         {
-            if (profile) vec_t -= RAPtor_MPI_Wtime();
-            send_data->waitall();
-            recv_data->waitall();
-            if (profile) vec_t += RAPtor_MPI_Wtime();
+            if (profile) profile_start(ProfileVecComm);
+            if (persistent_active)
+            {
+                send_data->wait_persistent_send();
+                recv_data->wait_persistent_recv();
+                persistent_active = false;
+            }
+            else
+            {
+                send_data->waitall();
+                recv_data->waitall();
+            }
+            if (profile) profile_stop(ProfileVecComm);
             key++;
 
             // Extract packed data to appropriate buffer
@@ -642,7 +700,10 @@ namespace raptor
                     &sum_func<double, double>, 
                     double init_result_func_val = 0)
         {
-            initialize_T(values, block_size, init_result_func, init_result_func_val);
+            if (persistent)
+                persistent_initialize_T(values, block_size);
+            else
+                initialize_T(values, block_size, init_result_func, init_result_func_val);
         }
         void init_int_comm_T(const int* values,
                 const int block_size = 1,
@@ -699,6 +760,31 @@ namespace raptor
         {
             complete_T<int>(block_size, init_result_func, init_result_func_val);
         }
+        void init_float_comm_T(const double* values, const int block_size = 1)
+        {
+            if (profile) profile_start(ProfileVecComm);
+            recv_data->float_send(values, key, mpi_comm, block_size);
+            send_data->recv<float>(key, mpi_comm, block_size);
+            if (profile) profile_stop(ProfileVecComm);
+        }
+        void complete_float_comm_T(aligned_vector<double>& result,
+                const int block_size = 1)
+        {
+            complete_T<float>(block_size);
+
+            // Sum single precision values into result in double
+            int idx, pos;
+            aligned_vector<float>& sendbuf = send_data->get_buffer<float>();
+            for (int i = 0; i < send_data->size_msgs; i++)
+            {
+                idx = send_data->indices[i] * block_size;
+                pos = i * block_size;
+                for (int j = 0; j < block_size; j++)
+                {
+                    result[idx + j] += sendbuf[pos + j];
+                }
+            }
+        }
         template<typename T, typename U>
         void communicate_T(const aligned_vector<T>& values, aligned_vector<U>& result,
                 const int block_size = 1,
@@ -744,10 +830,10 @@ namespace raptor
             int start, end;
             int proc, idx, pos;
 
-            if (profile) vec_t -= RAPtor_MPI_Wtime();
+            if (profile) profile_start(ProfileVecComm);
             recv_data->send(values, key, mpi_comm, block_size, init_result_func, init_result_func_val);
             send_data->recv<T>(key, mpi_comm, block_size);
-            if (profile) vec_t += RAPtor_MPI_Wtime();
+            if (profile) profile_stop(ProfileVecComm);
         }
 
         template<typename T, typename U>
@@ -779,15 +865,98 @@ namespace raptor
                 std::function<T(T, T)> init_result_func = &sum_func<T, T>,
                 T init_result_func_val = 0)
         {
-            if (profile) vec_t -= RAPtor_MPI_Wtime();
-            send_data->waitall();
-            recv_data->waitall();
-            if (profile) vec_t += RAPtor_MPI_Wtime();
+            if (profile) profile_start(ProfileVecComm);
+            if (persistent_active)
+            {
+                recv_data->wait_persistent_send();
+                send_data->wait_persistent_recv();
+                persistent_active = false;
+            }
+            else
+            {
+                send_data->waitall();
+                recv_data->waitall();
+            }
+            if (profile) profile_stop(ProfileVecComm);
             key++;
             
             aligned_vector<T>& buf = send_data->get_buffer<T>();
         }
 
+        /**************************************************************
+        *****   ParComm Init Persistent Communication
+        **************************************************************
+        ***** Creates persistent requests for communicating double
+        ***** values, which are then started with MPI_Startall by every
+        ***** following forward or transpose double communication,
+        ***** rather than posting new Isends and Irecvs each time.
+        ***** Requests are recreated if a different block size is
+        ***** communicated.  Only available when recv values are 
+        ***** stored contiguously (ContigData).
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** block_size : int (optional)
+        *****    Number of values communicated per index (default 1)
+        **************************************************************/
+        void init_persistent_comm(const int block_size = 1)
+        {
+            if (dynamic_cast<ContigData*>(recv_data) == NULL) return;
+
+            persistent = true;
+            persistent_key = key;
+            send_data->init_persistent(persistent_key, mpi_comm, block_size);
+            recv_data->init_persistent(persistent_key, mpi_comm, block_size);
+        }
+
+        void free_persistent_comm()
+        {
+            persistent = false;
+            send_data->free_persistent();
+            recv_data->free_persistent();
+        }
+
+        void persistent_initialize(const double* values, const int block_size = 1)
+        {
+            if (profile) profile_start(ProfileVecComm);
+            send_data->init_persistent(persistent_key, mpi_comm, block_size);
+            recv_data->init_persistent(persistent_key, mpi_comm, block_size);
+            recv_data->start_persistent_recv();
+
+            int idx, pos;
+            aligned_vector<double>& buf = send_data->buffer;
+            for (int i = 0; i < send_data->size_msgs; i++)
+            {
+                idx = send_data->indices[i] * block_size;
+                pos = i * block_size;
+                for (int j = 0; j < block_size; j++)
+                {
+                    buf[pos + j] = values[idx + j];
+                }
+            }
+            send_data->start_persistent_send();
+            persistent_active = true;
+            if (profile) profile_stop(ProfileVecComm);
+        }
+
+        void persistent_initialize_T(const double* values, const int block_size = 1)
+        {
+            if (profile) profile_start(ProfileVecComm);
+            send_data->init_persistent(persistent_key, mpi_comm, block_size);
+            recv_data->init_persistent(persistent_key, mpi_comm, block_size);
+            send_data->start_persistent_recv();
+
+            int size = recv_data->size_msgs * block_size;
+            aligned_vector<double>& buf = recv_data->buffer;
+            for (int i = 0; i < size; i++)
+            {
+                buf[i] = values[i];
+            }
+            recv_data->start_persistent_send();
+            persistent_active = true;
+            if (profile) profile_stop(ProfileVecComm);
+        }
+
         // Conditional communication
         template <typename T>
         aligned_vector<T>& conditional_comm(
@@ -801,14 +970,14 @@ namespace raptor
             int key = 325493;
             bool comparison;
             
-            if (profile) vec_t -= RAPtor_MPI_Wtime();
+            if (profile) profile_start(ProfileVecComm);
             send_data->send(vals.data(), key, mpi_comm, states, compare_func, &n_sends, block_size);
             recv_data->recv<T>(key, mpi_comm, off_proc_states, 
                     compare_func, &ctr, &n_recvs, block_size);
 
             send_data->waitall(n_sends);
             recv_data->waitall(n_recvs);
-            if (profile) vec_t += RAPtor_MPI_Wtime();
+            if (profile) profile_stop(ProfileVecComm);
 
             aligned_vector<T>& recvbuf = recv_data->get_buffer<T>();
 
@@ -858,14 +1027,14 @@ namespace raptor
             int key = 453246;
             bool comparison;
 
-            if (profile) vec_t -= RAPtor_MPI_Wtime();
+            if (profile) profile_start(ProfileVecComm);
             recv_data->send(vals.data(), key, mpi_comm, off_proc_states, compare_func,
                     &n_sends, block_size);
             send_data->recv<T>(key, mpi_comm, states, compare_func, &ctr, &n_recvs, block_size);
             
             recv_data->waitall(n_sends);
             send_data->waitall(n_recvs);
-            if (profile) vec_t += RAPtor_MPI_Wtime();
+            if (profile) profile_stop(ProfileVecComm);
 
             aligned_vector<T>& sendbuf = send_data->get_buffer<T>();
 
@@ -897,15 +1066,9 @@ namespace raptor
         CSRMatrix* communicate(const aligned_vector<int>& rowptr, 
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
-        CSRMatrix* communicate(const aligned_vector<int>& rowptr, 
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values,
-                const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         void init_mat_comm(aligned_vector<char>& send_buffer, const aligned_vector<int>& rowptr, 
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
-        void init_mat_comm(aligned_vector<char>& send_buffer, const aligned_vector<int>& rowptr, 
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values,
-                const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         CSRMatrix* complete_mat_comm(const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
 
@@ -913,18 +1076,10 @@ namespace raptor
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
-        CSRMatrix* communicate_T(const aligned_vector<int>& rowptr, 
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values, 
-                const int n_result_rows, const int b_rows = 1, const int b_cols = 1, 
-                const bool has_vals = true);
         void init_mat_comm_T(aligned_vector<char>& send_buffer, 
                 const aligned_vector<int>& rowptr, const aligned_vector<int>& col_indices, 
                 const aligned_vector<double>& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) ;
-        void init_mat_comm_T(aligned_vector<char>& send_buffer,
-                const aligned_vector<int>& rowptr, const aligned_vector<int>& col_indices, 
-                const aligned_vector<double*>& values, const int b_rows = 1, 
-                const int b_cols = 1, const bool has_vals = true) ;
         CSRMatrix* complete_mat_comm_T(const int n_result_rows, 
                 const int b_rows = 1, const int b_cols = 1,
                 const bool has_vals = true) ;
@@ -958,6 +1113,18 @@ namespace raptor
             CommPkg::init_comm(v, block_size);
         }
 
+        // Communication Volume
+        void get_comm_volume(CommVolume& sends, CommVolume& recvs)
+        {
+            send_data->add_volume(topology, mpi_comm, sends, recvs);
+            recv_data->add_volume(topology, mpi_comm, sends, recvs);
+        }
+        void reset_comm_volume()
+        {
+            send_data->reset_volume();
+            recv_data->reset_volume();
+        }
+
         // Helper Methods
         aligned_vector<double>& get_double_buffer()
         {
@@ -972,6 +1139,415 @@ namespace raptor
         NonContigData* send_data;
         CommData* recv_data;
         RAPtor_MPI_Comm mpi_comm;
+
+        // Persistent double communication
+        bool persistent;
+        bool persistent_active;
+        int persistent_key;
+    };
+
+
+
+    /**************************************************************
+    *****   NeighborComm Class
+    **************************************************************
+    ***** This class holds the same send and recv data as ParComm,
+    ***** but exchanges vector values with MPI-3 neighborhood
+    ***** collectives.  A distributed graph communicator is created
+    ***** once per communication package (and a second one for the
+    ***** transpose direction), and each halo exchange is a single
+    ***** MPI_Ineighbor_alltoallv, which allows the MPI library to
+    ***** schedule and aggregate the point-to-point messages.
+    *****
+    ***** Matrix and conditional communication are inherited from
+    ***** ParComm and remain point-to-point.  Received values are
+    ***** stored contiguously, as with ContigData.
+    *****
+    ***** Attributes
+    ***** -------------
+    ***** neighbor_comm : RAPtor_MPI_Comm
+    *****    Distributed graph communicator, with recv_data->procs
+    *****    as sources and send_data->procs as destinations
+    ***** neighbor_comm_T : RAPtor_MPI_Comm
+    *****    Distributed graph communicator for transpose
+    *****    communication (sources and destinations reversed)
+    ***** send_counts, send_displs : aligned_vector<int>
+    *****    Sizes and offsets of each send message, for the 
+    *****    block size last communicated
+    ***** recv_counts, recv_displs : aligned_vector<int>
+    *****    Sizes and offsets of each recv message, for the 
+    *****    block size last communicated
+    **************************************************************/
+    class NeighborComm : public ParComm
+    {
+      public:
+        /**************************************************************
+        *****   NeighborComm Class Constructor
+        **************************************************************
+        ***** Initializes a NeighborComm object with the messages 
+        ***** of an existing ParComm
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** comm : ParComm*
+        *****    Communication package to copy send and recv data from
+        **************************************************************/
+        NeighborComm(ParComm* comm) : ParComm(comm)
+        {
+            init_neighbor_comm();
+        }
+
+        NeighborComm(Partition* partition,
+                const aligned_vector<index_t>& off_proc_column_map,
+                int _key = 9999,
+                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD)
+            : ParComm(partition, off_proc_column_map, _key, comm)
+        {
+            init_neighbor_comm();
+        }
+
+        NeighborComm(Partition* partition,
+                const aligned_vector<index_t>& off_proc_column_map,
+                const aligned_vector<index_t>& on_proc_column_map,
+                int _key = 9999, 
+                RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD)
+            : ParComm(partition, off_proc_column_map, on_proc_column_map, 
+                    _key, comm)
+        {
+            init_neighbor_comm();
+        }
+
+        void init_neighbor_comm()
+        {
+            RAPtor_MPI_Dist_graph_create_adjacent(mpi_comm, 
+                    recv_data->num_msgs, recv_data->procs.data(), 
+                    RAPtor_MPI_UNWEIGHTED, send_data->num_msgs, 
+                    send_data->procs.data(), RAPtor_MPI_UNWEIGHTED, 
+                    RAPtor_MPI_INFO_NULL, 0, &neighbor_comm);
+            RAPtor_MPI_Dist_graph_create_adjacent(mpi_comm, 
+                    send_data->num_msgs, send_data->procs.data(), 
+                    RAPtor_MPI_UNWEIGHTED, recv_data->num_msgs, 
+                    recv_data->procs.data(), RAPtor_MPI_UNWEIGHTED, 
+                    RAPtor_MPI_INFO_NULL, 0, &neighbor_comm_T);
+
+            // Count arrays are never empty, so valid pointers are
+            // passed to MPI when a process has no neighbors
+            send_counts.resize(send_data->num_msgs + 1);
+            send_displs.resize(send_data->num_msgs + 1);
+            recv_counts.resize(recv_data->num_msgs + 1);
+            recv_displs.resize(recv_data->num_msgs + 1);
+            comm_block_size = 0;
+            set_counts(1);
+        }
+
+        /**************************************************************
+        *****   NeighborComm Class Destructor
+        **************************************************************
+        ***** 
+        **************************************************************/
+        ~NeighborComm()
+        {
+            RAPtor_MPI_Comm_free(&neighbor_comm);
+            RAPtor_MPI_Comm_free(&neighbor_comm_T);
+        }
+
+        // Standard Communication
+        void init_double_comm(const double* values, const int block_size = 1)
+        {
+            neighbor_initialize(values, block_size);
+        }
+        void init_int_comm(const int* values, const int block_size = 1)
+        {
+            neighbor_initialize(values, block_size);
+        }
+        aligned_vector<double>& complete_double_comm(const int block_size = 1)
+        {
+            return neighbor_complete<double>();
+        }
+        aligned_vector<int>& complete_int_comm(const int block_size = 1)
+        {
+            return neighbor_complete<int>();
+        }
+        void init_float_comm(const double* values, const int block_size = 1)
+        {
+            if (profile) profile_start(ProfileVecComm);
+            set_counts(block_size);
+            int send_size = send_data->size_msgs * block_size;
+            int recv_size = recv_data->size_msgs * block_size;
+            aligned_vector<float>& sendbuf = send_data->float_buffer;
+            aligned_vector<float>& recvbuf = recv_data->float_buffer;
+            if ((int) sendbuf.size() < send_size) sendbuf.resize(send_size);
+            if ((int) recvbuf.size() < recv_size) recvbuf.resize(recv_size);
+
+            int idx, pos;
+            for (int i = 0; i < send_data->size_msgs; i++)
+            {
+                idx = send_data->indices[i] * block_size;
+                pos = i * block_size;
+                for (int j = 0; j < block_size; j++)
+                {
+                    sendbuf[pos + j] = values[idx + j];
+                }
+            }
+
+            RAPtor_MPI_Ineighbor_alltoallv(sendbuf.data(), send_counts.data(), 
+                    send_displs.data(), RAPtor_MPI_FLOAT, recvbuf.data(), 
+                    recv_counts.data(), recv_displs.data(), RAPtor_MPI_FLOAT, 
+                    neighbor_comm, &neighbor_request);
+            count_exchange(send_data, recv_data, block_size * sizeof(float));
+            if (profile) profile_stop(ProfileVecComm);
+        }
+        aligned_vector<double>& complete_float_comm(const int block_size = 1)
+        {
+            neighbor_wait();
+            aligned_vector<float>& float_buf = recv_data->float_buffer;
+
+            // Copy single precision values into double buffer
+            int size = recv_data->size_msgs * block_size;
+            aligned_vector<double>& buf = recv_data->get_buffer<double>();
+            if (buf.size() < size) buf.resize(size);
+            for (int i = 0; i < size; i++)
+            {
+                buf[i] = float_buf[i];
+            }
+
+            return buf;
+        }
+
+        // Transpose Communication
+        void init_double_comm_T(const double* values,
+                const int block_size = 1,
+                std::function<double(double, double)> init_result_func = 
+                    &sum_func<double, double>, 
+                    double init_result_func_val = 0)
+        {
+            neighbor_initialize_T(values, block_size);
+        }
+        void init_int_comm_T(const int* values,
+                const int block_size = 1,
+                std::function<int(int, int)> init_result_func = 
+                    &sum_func<int, int>, 
+                    int init_result_func_val = 0)
+        {
+            neighbor_initialize_T(values, block_size);
+        }
+        void complete_double_comm_T(aligned_vector<double>& result,
+                const int block_size = 1,
+                std::function<double(double, double)> result_func = &sum_func<double, double>,
+                std::function<double(double, double)> init_result_func = 
+                    &sum_func<double, double>,
+                    double init_result_func_val = 0)
+        {
+            neighbor_complete_T<double>(result, block_size, result_func);
+        }
+        void complete_double_comm_T(aligned_vector<int>& result,
+                const int block_size = 1,
+                std::function<int(int, double)> result_func = &sum_func<double, int>,
+                std::function<double(double, double)> init_result_func = 
+                    &sum_func<double, double>,
+                    double init_result_func_val = 0)
+        {
+            neighbor_complete_T<double>(result, block_size, result_func);
+        }
+        void complete_int_comm_T(aligned_vector<double>& result,
+                const int block_size = 1,
+                std::function<double(double, int)> result_func = &sum_func<int, double>,
+                std::function<int(int, int)> init_result_func = &sum_func<int, int>,
+                int init_result_func_val = 0)
+        {
+            neighbor_complete_T<int>(result, block_size, result_func);
+        }
+        void complete_int_comm_T(aligned_vector<int>& result,
+                const int block_size = 1,
+                std::function<int(int, int)> result_func = &sum_func<int, int>,
+                std::function<int(int, int)> init_result_func = &sum_func<int, int>,
+                int init_result_func_val = 0)
+        {
+            neighbor_complete_T<int>(result, block_size, result_func);
+        }
+        void complete_double_comm_T(const int block_size = 1,
+                std::function<double(double, double)> init_result_func =
+                &sum_func<double, double>, 
+                double init_result_func_val = 0)
+        {
+            neighbor_wait();
+        }
+        void complete_int_comm_T(const int block_size = 1,
+                std::function<int(int, int)> init_result_func = &sum_func<int, int>,
+                int init_result_func_val = 0)
+        {
+            neighbor_wait();
+        }
+        void init_float_comm_T(const double* values, const int block_size = 1)
+        {
+            if (profile) profile_start(ProfileVecComm);
+            set_counts(block_size);
+            int send_size = send_data->size_msgs * block_size;
+            int recv_size = recv_data->size_msgs * block_size;
+            aligned_vector<float>& sendbuf = recv_data->float_buffer;
+            aligned_vector<float>& recvbuf = send_data->float_buffer;
+            if ((int) sendbuf.size() < recv_size) sendbuf.resize(recv_size);
+            if ((int) recvbuf.size() < send_size) recvbuf.resize(send_size);
+            for (int i = 0; i < recv_size; i++)
+            {
+                sendbuf[i] = values[i];
+            }
+
+            RAPtor_MPI_Ineighbor_alltoallv(sendbuf.data(), recv_counts.data(), 
+                    recv_displs.data(), RAPtor_MPI_FLOAT, recvbuf.data(), 
+                    send_counts.data(), send_displs.data(), RAPtor_MPI_FLOAT, 
+                    neighbor_comm_T, &neighbor_request);
+            count_exchange(recv_data, send_data, block_size * sizeof(float));
+            if (profile) profile_stop(ProfileVecComm);
+        }
+        void complete_float_comm_T(aligned_vector<double>& result,
+                const int block_size = 1)
+        {
+            neighbor_wait();
+
+            // Sum single precision values into result in double
+            int idx, pos;
+            aligned_vector<float>& recvbuf = send_data->float_buffer;
+            for (int i = 0; i < send_data->size_msgs; i++)
+            {
+                idx = send_data->indices[i] * block_size;
+                pos = i * block_size;
+                for (int j = 0; j < block_size; j++)
+                {
+                    result[idx + j] += recvbuf[pos + j];
+                }
+            }
+        }
+
+        // Neighborhood Collective Helpers
+        void set_counts(const int block_size)
+        {
+            if (block_size == comm_block_size) return;
+            comm_block_size = block_size;
+
+            for (int i = 0; i < send_data->num_msgs; i++)
+            {
+                send_displs[i] = send_data->indptr[i] * block_size;
+                send_counts[i] = (send_data->indptr[i+1] - send_data->indptr[i])
+                    * block_size;
+            }
+            for (int i = 0; i < recv_data->num_msgs; i++)
+            {
+                recv_displs[i] = recv_data->indptr[i] * block_size;
+                recv_counts[i] = (recv_data->indptr[i+1] - recv_data->indptr[i])
+                    * block_size;
+            }
+        }
+
+        template<typename T>
+        void neighbor_initialize(const T* values, const int block_size = 1)
+        {
+            if (profile) profile_start(ProfileVecComm);
+            set_counts(block_size);
+            int send_size = send_data->size_msgs * block_size;
+            int recv_size = recv_data->size_msgs * block_size;
+            RAPtor_MPI_Datatype datatype = CommData::get_type<T>();
+            aligned_vector<T>& sendbuf = send_data->get_buffer<T>();
+            aligned_vector<T>& recvbuf = recv_data->get_buffer<T>();
+            if (sendbuf.size() < send_size) sendbuf.resize(send_size);
+            if (recvbuf.size() < recv_size) recvbuf.resize(recv_size);
+
+            int idx, pos;
+            for (int i = 0; i < send_data->size_msgs; i++)
+            {
+                idx = send_data->indices[i] * block_size;
+                pos = i * block_size;
+                for (int j = 0; j < block_size; j++)
+                {
+                    sendbuf[pos + j] = values[idx + j];
+                }
+            }
+
+            RAPtor_MPI_Ineighbor_alltoallv(sendbuf.data(), send_counts.data(), 
+                    send_displs.data(), datatype, recvbuf.data(), 
+                    recv_counts.data(), recv_displs.data(), datatype, 
+                    neighbor_comm, &neighbor_request);
+            count_exchange(send_data, recv_data, block_size * sizeof(T));
+            if (profile) profile_stop(ProfileVecComm);
+        }
+
+        // Counts each message of an exchange from send_from to recv_to,
+        // with bytes per index (see CommData::count_send)
+        void count_exchange(CommData* send_from, CommData* recv_to, int bytes)
+        {
+            for (int i = 0; i < send_from->num_msgs; i++)
+            {
+                send_from->count_send(i, 
+                        (send_from->indptr[i+1] - send_from->indptr[i]) * bytes);
+            }
+            for (int i = 0; i < recv_to->num_msgs; i++)
+            {
+                recv_to->count_recv(i, 
+                        (recv_to->indptr[i+1] - recv_to->indptr[i]) * bytes);
+            }
+        }
+
+        template<typename T>
+        aligned_vector<T>& neighbor_complete()
+        {
+            neighbor_wait();
+            return recv_data->get_buffer<T>();
+        }
+
+        void neighbor_wait()
+        {
+            if (profile) profile_start(ProfileVecComm);
+            RAPtor_MPI_Wait(&neighbor_request, RAPtor_MPI_STATUS_IGNORE);
+            if (profile) profile_stop(ProfileVecComm);
+        }
+
+        template<typename T>
+        void neighbor_initialize_T(const T* values, const int block_size = 1)
+        {
+            if (profile) profile_start(ProfileVecComm);
+            set_counts(block_size);
+            int send_size = send_data->size_msgs * block_size;
+            RAPtor_MPI_Datatype datatype = CommData::get_type<T>();
+            aligned_vector<T>& recvbuf = send_data->get_buffer<T>();
+            if (recvbuf.size() < send_size) recvbuf.resize(send_size);
+
+            // Values are ordered by recv message, so are sent in place
+            RAPtor_MPI_Ineighbor_alltoallv(values, recv_counts.data(), 
+                    recv_displs.data(), datatype, recvbuf.data(), 
+                    send_counts.data(), send_displs.data(), datatype, 
+                    neighbor_comm_T, &neighbor_request);
+            count_exchange(recv_data, send_data, block_size * sizeof(T));
+            if (profile) profile_stop(ProfileVecComm);
+        }
+
+        template<typename T, typename U>
+        void neighbor_complete_T(aligned_vector<U>& result, 
+                const int block_size,
+                std::function<U(U, T)> result_func)
+        {
+            neighbor_wait();
+
+            int idx, pos;
+            aligned_vector<T>& recvbuf = send_data->get_buffer<T>();
+            for (int i = 0; i < send_data->size_msgs; i++)
+            {
+                idx = send_data->indices[i] * block_size;
+                pos = i * block_size;
+                for (int j = 0; j < block_size; j++)
+                {
+                    result[idx + j] = result_func(result[idx + j], recvbuf[pos + j]);
+                }
+            }
+        }
+
+        RAPtor_MPI_Comm neighbor_comm;
+        RAPtor_MPI_Comm neighbor_comm_T;
+        RAPtor_MPI_Request neighbor_request;
+        aligned_vector<int> send_counts;
+        aligned_vector<int> send_displs;
+        aligned_vector<int> recv_counts;
+        aligned_vector<int> recv_displs;
+        int comm_block_size;
     };
 
 
@@ -1046,7 +1622,7 @@ namespace raptor
         *****
         ***** Parameters
         ***** -------------
-        ***** off_proc_column_map : aligned_vector<int>&
+        ***** off_proc_column_map : aligned_vector<index_t>&
         *****    Maps local off_proc columns indices to global
         ***** global_num_cols : int
         *****    Number of global columns in matrix
@@ -1054,7 +1630,7 @@ namespace raptor
         *****    Number of columns local to rank
         **************************************************************/
         TAPComm(Partition* partition, 
-                const aligned_vector<int>& off_proc_column_map,
+                const aligned_vector<index_t>& off_proc_column_map,
                 bool form_S = true,
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD)
                 : CommPkg(partition)
@@ -1070,8 +1646,8 @@ namespace raptor
         }
 
         TAPComm(Partition* partition,
-                const aligned_vector<int>& off_proc_column_map,
-                const aligned_vector<int>& on_proc_column_map,
+                const aligned_vector<index_t>& off_proc_column_map,
+                const aligned_vector<index_t>& on_proc_column_map,
                 bool form_S = true,
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD)
                 : CommPkg(partition)
@@ -1315,7 +1891,7 @@ namespace raptor
         }
 
         void init_tap_comm(Partition* partition,
-                const aligned_vector<int>& off_proc_column_map,
+                const aligned_vector<index_t>& off_proc_column_map,
                 RAPtor_MPI_Comm comm)
         {
             // Get RAPtor_MPI Information
@@ -1380,7 +1956,7 @@ namespace raptor
         }
 
         void init_tap_comm_simple(Partition* partition,
-                const aligned_vector<int>& off_proc_column_map,
+                const aligned_vector<index_t>& off_proc_column_map,
                 RAPtor_MPI_Comm comm)
         {
             // Get RAPtor_MPI Information
@@ -1442,7 +2018,7 @@ namespace raptor
         }
 
         // Helper methods for forming TAPComm:
-        void split_off_proc_cols(const aligned_vector<int>& off_proc_column_map,
+        void split_off_proc_cols(const aligned_vector<index_t>& off_proc_column_map,
                 const aligned_vector<int>& off_proc_col_to_proc,
                 aligned_vector<int>& on_node_column_map,
                 aligned_vector<int>& on_node_col_to_proc,
@@ -1752,15 +2328,9 @@ namespace raptor
         CSRMatrix* communicate(const aligned_vector<int>& rowptr, 
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
-        CSRMatrix* communicate(const aligned_vector<int>& rowptr, 
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values,
-                const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         void init_mat_comm(aligned_vector<char>& send_buffer, const aligned_vector<int>& rowptr, 
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
-        void init_mat_comm(aligned_vector<char>& send_buffer, const aligned_vector<int>& rowptr, 
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values,
-                const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         CSRMatrix* complete_mat_comm(const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
 
@@ -1768,18 +2338,10 @@ namespace raptor
                 const aligned_vector<int>& col_indices, const aligned_vector<double>& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
-        CSRMatrix* communicate_T(const aligned_vector<int>& rowptr, 
-                const aligned_vector<int>& col_indices, const aligned_vector<double*>& values, 
-                const int n_result_rows, const int b_rows = 1, const int b_cols = 1, 
-                const bool has_vals = true);
         void init_mat_comm_T(aligned_vector<char>& send_buffer, 
                 const aligned_vector<int>& rowptr, const aligned_vector<int>& col_indices, 
                 const aligned_vector<double>& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) ;
-        void init_mat_comm_T(aligned_vector<char>& send_buffer,
-                const aligned_vector<int>& rowptr, const aligned_vector<int>& col_indices, 
-                const aligned_vector<double*>& values, const int b_rows = 1, 
-                const int b_cols = 1, const bool has_vals = true) ;
         CSRMatrix* complete_mat_comm_T(const int n_result_rows, 
                 const int b_rows = 1, const int b_cols = 1,
                 const bool has_vals = true);
@@ -1813,6 +2375,31 @@ namespace raptor
             CommPkg::init_comm(v, block_size);
         }
 
+        // Communication Volume, summed over the intra-node and
+        // inter-node steps
+        void get_comm_volume(CommVolume& sends, CommVolume& recvs)
+        {
+            if (local_S_par_comm)
+                local_S_par_comm->get_comm_volume(sends, recvs);
+            if (local_R_par_comm)
+                local_R_par_comm->get_comm_volume(sends, recvs);
+            if (local_L_par_comm)
+                local_L_par_comm->get_comm_volume(sends, recvs);
+            if (global_par_comm)
+                global_par_comm->get_comm_volume(sends, recvs);
+        }
+        void reset_comm_volume()
+        {
+            if (local_S_par_comm)
+                local_S_par_comm->reset_comm_volume();
+            if (local_R_par_comm)
+                local_R_par_comm->reset_comm_volume();
+            if (local_L_par_comm)
+                local_L_par_comm->reset_comm_volume();
+            if (global_par_comm)
+                global_par_comm->reset_comm_volume();
+        }
+
         // Helper Methods
         aligned_vector<double>& get_double_buffer()
         {
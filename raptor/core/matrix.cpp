@@ -13,7 +13,7 @@ using namespace raptor;
 ***** and column according to each nonzero
 **************************************************************/
 template <typename T>
-void print_helper(const COOMatrix* A, const aligned_vector<T>& vals)
+void print_helper(const COOMatrix* A, const T& vals)
 {
     int row, col;
     double val;
@@ -26,7 +26,7 @@ void print_helper(const COOMatrix* A, const aligned_vector<T>& vals)
     }
 }
 template <typename T>
-void print_helper(const CSRMatrix* A, const aligned_vector<T>& vals)
+void print_helper(const CSRMatrix* A, const T& vals)
 {
     int col, start, end;
 
@@ -42,7 +42,7 @@ void print_helper(const CSRMatrix* A, const aligned_vector<T>& vals)
     }
 }
 template <typename T>
-void print_helper(const CSCMatrix* A, const aligned_vector<T>& vals)
+void print_helper(const CSCMatrix* A, const T& vals)
 {
     int row, start, end;
 
@@ -58,7 +58,7 @@ void print_helper(const CSCMatrix* A, const aligned_vector<T>& vals)
     }
 }
 template <typename T>
-void bcoo_print_helper(const BCOOMatrix* A, const aligned_vector<T>& vals)
+void bcoo_print_helper(const BCOOMatrix* A, const T& vals)
 {
     int row, col;
     double val;
@@ -71,7 +71,7 @@ void bcoo_print_helper(const BCOOMatrix* A, const aligned_vector<T>& vals)
     }
 }
 template <typename T>
-void bsr_print_helper(const BSRMatrix* A, const aligned_vector<T>& vals)
+void bsr_print_helper(const BSRMatrix* A, const T& vals)
 {
     int col, start, end;
 
@@ -87,7 +87,7 @@ void bsr_print_helper(const BSRMatrix* A, const aligned_vector<T>& vals)
     }
 }
 template <typename T>
-void bsc_print_helper(const BSCMatrix* A, const aligned_vector<T>& vals)
+void bsc_print_helper(const BSCMatrix* A, const T& vals)
 {
     int row, start, end;
 
@@ -126,6 +126,14 @@ void BSCMatrix::print()
 {
     bsc_print_helper(this, vals);
 }
+void SELLMatrix::print()
+{
+    print_helper(this, vals);
+}
+void CSRFloatMatrix::print()
+{
+    print_helper(this, float_vals);
+}
 
 /**************************************************************
 *****  Matrix Transpose
@@ -133,6 +141,26 @@ void BSCMatrix::print()
 ***** Transpose the matrix, reversing rows and columns
 ***** Retain matrix type, and block structure if applicable
 **************************************************************/
+// Copies each (b_rows x b_cols) block of A into T_vals as a
+// (b_cols x b_rows) block
+void transpose_blocks(const Matrix* A, const BlockArray& A_vals, 
+        BlockArray& T_vals)
+{
+    T_vals.resize(A->nnz);
+    for (int j = 0; j < A->nnz; j++)
+    {
+        const double* val = A_vals[j];
+        double* val_T = T_vals[j];
+        for (int row = 0; row < A->b_rows; row++)
+        {
+            for (int col = 0; col < A->b_cols; col++)
+            {
+                val_T[col * A->b_rows + row] = val[row * A->b_cols + col];
+            }
+        }
+    }
+}
+
 COOMatrix* COOMatrix::transpose()
 {
     COOMatrix* T = new COOMatrix(n_rows, n_cols, idx2, idx1, vals);
@@ -141,7 +169,11 @@ COOMatrix* COOMatrix::transpose()
 
 BCOOMatrix* BCOOMatrix::transpose()
 {
-    BCOOMatrix* T = new BCOOMatrix(b_rows, b_cols, n_rows, n_cols, idx2, idx1, block_vals);
+    BCOOMatrix* T = new BCOOMatrix(n_cols, n_rows, b_cols, b_rows);
+    T->idx1.assign(idx2.begin(), idx2.end());
+    T->idx2.assign(idx1.begin(), idx1.end());
+    T->nnz = nnz;
+    transpose_blocks(this, block_vals, T->block_vals);
     return T;
 }
 
@@ -155,7 +187,12 @@ CSRMatrix* CSRMatrix::transpose()
 
 BSRMatrix* BSRMatrix::transpose()
 {
-    BSCMatrix* T_bsc = new BSCMatrix(b_rows, b_cols, n_rows, n_cols, idx1, idx2, block_vals);
+    // Block rows of A are block columns of A^T
+    BSCMatrix* T_bsc = new BSCMatrix(n_cols, n_rows, b_cols, b_rows);
+    T_bsc->idx1.assign(idx1.begin(), idx1.end());
+    T_bsc->idx2.assign(idx2.begin(), idx2.end());
+    T_bsc->nnz = nnz;
+    transpose_blocks(this, block_vals, T_bsc->block_vals);
     BSRMatrix* T = (BSRMatrix*) T_bsc->to_CSR();
     delete T_bsc;
     return T;
@@ -170,7 +207,12 @@ CSCMatrix* CSCMatrix::transpose()
 }
 BSCMatrix* BSCMatrix::transpose()
 {
-    BSRMatrix* T_bsr = new BSRMatrix(b_rows, b_cols, n_rows, n_cols, idx1, idx2, block_vals); 
+    // Block columns of A are block rows of A^T
+    BSRMatrix* T_bsr = new BSRMatrix(n_cols, n_rows, b_cols, b_rows);
+    T_bsr->idx1.assign(idx1.begin(), idx1.end());
+    T_bsr->idx2.assign(idx2.begin(), idx2.end());
+    T_bsr->nnz = nnz;
+    transpose_blocks(this, block_vals, T_bsr->block_vals);
     BSCMatrix* T = (BSCMatrix*) T_bsr->to_CSC();
     delete T_bsr;
     return T;
@@ -205,8 +247,8 @@ void Matrix::resize(int _n_rows, int _n_cols)
 ***** Matrix* A : original matrix to copy (of some type)
 **************************************************************/
 template <typename T>
-void COO_to_COO(const COOMatrix* A, COOMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void COO_to_COO(const COOMatrix* A, COOMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -223,12 +265,12 @@ void COO_to_COO(const COOMatrix* A, COOMatrix* B, aligned_vector<T>& A_vals,
     {
         B->idx1.emplace_back(A->idx1[i]);
         B->idx2.emplace_back(A->idx2[i]);
-        B_vals.emplace_back(B->copy_val(A_vals[i]));
+        B_vals.emplace_back(A_vals[i]);
     }
 }
 template <typename T>
-void CSR_to_COO(const CSRMatrix* A, COOMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void CSR_to_COO(const CSRMatrix* A, COOMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -249,13 +291,13 @@ void CSR_to_COO(const CSRMatrix* A, COOMatrix* B, aligned_vector<T>& A_vals,
         {
             B->idx1.emplace_back(i);
             B->idx2.emplace_back(A->idx2[j]);
-            B_vals.emplace_back(B->copy_val(A_vals[j]));
+            B_vals.emplace_back(A_vals[j]);
         }
     }
 }
 template <typename T>
-void CSC_to_COO(const CSCMatrix* A, COOMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void CSC_to_COO(const CSCMatrix* A, COOMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -276,14 +318,14 @@ void CSC_to_COO(const CSCMatrix* A, COOMatrix* B, aligned_vector<T>& A_vals,
         {
             B->idx1.emplace_back(A->idx2[j]);
             B->idx2.emplace_back(i);
-            B_vals.emplace_back(B->copy_val(A_vals[j]));
+            B_vals.emplace_back(A_vals[j]);
         }
     }
 
 }
 template <typename T>
-void COO_to_CSR(const COOMatrix* A, CSRMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void COO_to_CSR(const COOMatrix* A, CSRMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -323,14 +365,14 @@ void COO_to_CSR(const COOMatrix* A, CSRMatrix* B, aligned_vector<T>& A_vals,
         B->idx2[index] = col;
         if (A->data_size()) // Checking that matrix has values (not S)
         {
-            B_vals[index] = B->copy_val(A_vals[i]);
+            B->copy_val(B_vals[index], A_vals[i]);
         }
     }
 
 }
 template <typename T>
-void CSR_to_CSR(const CSRMatrix* A, CSRMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void CSR_to_CSR(const CSRMatrix* A, CSRMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -349,14 +391,13 @@ void CSR_to_CSR(const CSRMatrix* A, CSRMatrix* B, aligned_vector<T>& A_vals,
         for (int j = row_start; j < row_end; j++)
         {
             B->idx2[j] = A->idx2[j];
-            B_vals[j] = B->copy_val(A_vals[j]);
+            B->copy_val(B_vals[j], A_vals[j]);
         }
     }
 
 }
-template <typename T>
-void BSR_to_CSR(const BSRMatrix* A, CSRMatrix* B, aligned_vector<T*>& A_vals,
-        aligned_vector<T>& B_vals)
+void BSR_to_CSR(const BSRMatrix* A, CSRMatrix* B, const BlockArray& A_vals,
+        aligned_vector<double>& B_vals)
 {
     B->n_rows = A->n_rows * A->b_rows;
     B->n_cols = A->n_cols * A->b_cols;
@@ -365,7 +406,7 @@ void BSR_to_CSR(const BSRMatrix* A, CSRMatrix* B, aligned_vector<T*>& A_vals,
     B->idx2.reserve(A->nnz);
     B->vals.reserve(A->nnz);
 
-    T val;
+    double val;
     int col;
     B->idx1[0] = 0;
     for (int i = 0; i < A->n_rows; i++)
@@ -394,8 +435,8 @@ void BSR_to_CSR(const BSRMatrix* A, CSRMatrix* B, aligned_vector<T*>& A_vals,
 
 }
 template <typename T>
-void CSC_to_CSR(const CSCMatrix* A, CSRMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void CSC_to_CSR(const CSCMatrix* A, CSRMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -435,15 +476,15 @@ void CSC_to_CSR(const CSCMatrix* A, CSRMatrix* B, aligned_vector<T>& A_vals,
             B->idx2[idx] = i;
             if (A->data_size())
             {
-                B_vals[idx] = B->copy_val(A_vals[j]);
+                B->copy_val(B_vals[idx], A_vals[j]);
             }
         }
     }
 
 }
 template <typename T>
-void COO_to_CSC(const COOMatrix* A, CSCMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void COO_to_CSC(const COOMatrix* A, CSCMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -483,14 +524,14 @@ void COO_to_CSC(const COOMatrix* A, CSCMatrix* B, aligned_vector<T>& A_vals,
         B->idx2[index] = row;
         if (A->data_size()) // Checking that matrix has values (not S)
         {
-            B_vals[index] = B->copy_val(A_vals[i]);
+            B->copy_val(B_vals[index], A_vals[i]);
         }
     }
 
 }
 template <typename T>
-void CSR_to_CSC(const CSRMatrix* A, CSCMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void CSR_to_CSC(const CSRMatrix* A, CSCMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -530,15 +571,15 @@ void CSR_to_CSC(const CSRMatrix* A, CSCMatrix* B, aligned_vector<T>& A_vals,
             B->idx2[idx] = i;
             if (A->data_size())
             {
-                B_vals[idx] = B->copy_val(A_vals[j]);
+                B->copy_val(B_vals[idx], A_vals[j]);
             }
         }
     }
 
 }
 template <typename T>
-void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, aligned_vector<T>& A_vals,
-        aligned_vector<T>& B_vals)
+void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, T& A_vals,
+        T& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -546,7 +587,7 @@ void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, aligned_vector<T>& A_vals,
 
     B->idx1.resize(A->n_cols + 1);
     B->idx2.resize(A->nnz);
-    B->vals.resize(A->nnz);
+    B_vals.resize(A->nnz);
 
     B->idx1[0] = 0;
     for (int i = 0; i < A->n_cols; i++)
@@ -557,7 +598,7 @@ void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, aligned_vector<T>& A_vals,
         for (int j = col_start; j < col_end; j++)
         {
             B->idx2[j] = A->idx2[j];
-            B_vals[j] = B->copy_val(A_vals[j]);
+            B->copy_val(B_vals[j], A_vals[j]);
         }
     }
 }
@@ -569,7 +610,7 @@ void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, aligned_vector<T>& A_vals,
 ***** Sorts the sparse matrix by row and column
 **************************************************************/
 template <typename T>
-void sort_helper(COOMatrix* A, aligned_vector<T>& vals)
+void sort_helper(COOMatrix* A, T& vals)
 {
     if (A->sorted || A->nnz == 0)
     {
@@ -585,7 +626,7 @@ void sort_helper(COOMatrix* A, aligned_vector<T>& vals)
 }
 
 template <typename T>
-void sort_helper(CSRMatrix* A, aligned_vector<T>& vals)
+void sort_helper(CSRMatrix* A, T& vals)
 {
     int start, end, row_size;
 
@@ -618,7 +659,7 @@ void sort_helper(CSRMatrix* A, aligned_vector<T>& vals)
 }
 
 template <typename T>
-void sort_helper(CSCMatrix* A, aligned_vector<T>& vals)
+void sort_helper(CSCMatrix* A, T& vals)
 {
     int start, end, col_size;
 
@@ -674,6 +715,19 @@ void BSCMatrix::sort()
 {
     sort_helper(this, block_vals);
 }
+void SELLMatrix::sort()
+{
+    if (sorted) return;
+    sort_helper(this, vals);
+    form_slices();
+}
+void CSRFloatMatrix::sort()
+{
+    if (sorted) return;
+    vals.assign(float_vals.begin(), float_vals.end());
+    sort_helper(this, vals);
+    form_float_vals();
+}
 
 
 /**************************************************************
@@ -682,8 +736,20 @@ void BSCMatrix::sort()
 ***** Moves the diagonal element to the front of each row
 ***** If matrix is not sorted, sorts before moving
 **************************************************************/
+// Moves value last to position first, shifting values
+// in [first, last) back by one
+void rotate_vals(aligned_vector<double>& vals, int first, int last)
+{
+    std::rotate(vals.begin() + first, vals.begin() + last, 
+            vals.begin() + last + 1);
+}
+void rotate_vals(BlockArray& vals, int first, int last)
+{
+    vals.rotate(first, last);
+}
+
 template <typename T>
-void move_diag_helper(COOMatrix* A, aligned_vector<T>& vals)
+void move_diag_helper(COOMatrix* A, T& vals)
 {
     if (A->diag_first || A->nnz == 0)
     {
@@ -712,14 +778,12 @@ void move_diag_helper(COOMatrix* A, aligned_vector<T>& vals)
         }
         else if (row == col)
         {
-            auto tmp = vals[i];
             for (int j = i; j > row_start; j--)
             {
                 A->idx2[j] = A->idx2[j-1];
-                vals[j] = vals[j-1];
             }
             A->idx2[row_start] = row;
-            vals[row_start] = tmp;
+            rotate_vals(vals, row_start, i);
         }
     }
 
@@ -727,7 +791,7 @@ void move_diag_helper(COOMatrix* A, aligned_vector<T>& vals)
 }
 
 template <typename T>
-void move_diag_helper(CSRMatrix* A, aligned_vector<T>& vals)
+void move_diag_helper(CSRMatrix* A, T& vals)
 {
     int start, end;
     int col;
@@ -749,14 +813,12 @@ void move_diag_helper(CSRMatrix* A, aligned_vector<T>& vals)
                 col = A->idx2[j];
                 if (col == i)
                 {
-                    auto tmp = vals[j];
                     for (int k = j; k > start; k--)
                     {
                         A->idx2[k] = A->idx2[k-1];
-                        vals[k] = vals[k-1];
                     }
                     A->idx2[start] = i;
-                    vals[start] = tmp;
+                    rotate_vals(vals, start, j);
                     break;
                 }
             }
@@ -787,7 +849,7 @@ void move_diag_helper(CSRMatrix* A, aligned_vector<T>& vals)
 }
 
 template <typename T>
-void move_diag_helper(CSCMatrix* A, aligned_vector<T>& vals)
+void move_diag_helper(CSCMatrix* A, T& vals)
 {
     int start, end;
     int row;
@@ -809,14 +871,12 @@ void move_diag_helper(CSCMatrix* A, aligned_vector<T>& vals)
                 row = A->idx2[j];
                 if (row == i)
                 {
-                    auto tmp = vals[j];
                     for (int k = j; k > start; k--)
                     {
                         A->idx2[k] = A->idx2[k-1];
-                        vals[k] = vals[k-1];
                     }
                     A->idx2[start] = i;
-                    vals[start] = tmp;
+                    rotate_vals(vals, start, j);
                     break;
                 }
             }
@@ -870,6 +930,19 @@ void BSCMatrix::move_diag()
 {
     move_diag_helper(this, block_vals);
 }
+void SELLMatrix::move_diag()
+{
+    if (diag_first) return;
+    move_diag_helper(this, vals);
+    form_slices();
+}
+void CSRFloatMatrix::move_diag()
+{
+    if (diag_first) return;
+    vals.assign(float_vals.begin(), float_vals.end());
+    move_diag_helper(this, vals);
+    form_float_vals();
+}
 
 /**************************************************************
 *****   Matrix Removes Duplicates
@@ -878,7 +951,7 @@ void BSCMatrix::move_diag()
 ***** entries, summing associated values
 **************************************************************/
 template <typename T>
-void remove_duplicates_helper(COOMatrix* A, aligned_vector<T>& vals)
+void remove_duplicates_helper(COOMatrix* A, T& vals)
 {
     if (!A->sorted)
     {
@@ -899,7 +972,7 @@ void remove_duplicates_helper(COOMatrix* A, aligned_vector<T>& vals)
         col = A->idx2[i];
         if (row == prev_row && col == prev_col)
         {
-            A->append_vals(&vals[ctr - 1], &vals[i]);
+            A->append_vals(vals[ctr - 1], vals[i]);
         }
         else
         { 
@@ -907,7 +980,7 @@ void remove_duplicates_helper(COOMatrix* A, aligned_vector<T>& vals)
             {
                 A->idx1[ctr] = row;
                 A->idx2[ctr] = col;
-                vals[ctr] = vals[i];
+                A->copy_val(vals[ctr], vals[i]);
             }
             ctr++;
 
@@ -920,7 +993,7 @@ void remove_duplicates_helper(COOMatrix* A, aligned_vector<T>& vals)
 }
 
 template <typename T>
-void remove_duplicates_helper(CSRMatrix* A, aligned_vector<T>& vals)
+void remove_duplicates_helper(CSRMatrix* A, T& vals)
 {
     int orig_start, orig_end;
     int new_start;
@@ -949,7 +1022,7 @@ void remove_duplicates_helper(CSRMatrix* A, aligned_vector<T>& vals)
         // Remove Duplicates
         col = A->idx2[orig_start];
         A->idx2[new_start] = col;
-        vals[new_start] = vals[orig_start];
+        A->copy_val(vals[new_start], vals[orig_start]);
         prev_col = col;
         ctr = 1;
         for (int j = orig_start + 1; j < orig_end; j++)
@@ -957,7 +1030,7 @@ void remove_duplicates_helper(CSRMatrix* A, aligned_vector<T>& vals)
             col = A->idx2[j];
             if (col == prev_col)
             {
-                A->append_vals(&vals[ctr - 1 + new_start], &vals[j]);
+                A->append_vals(vals[ctr - 1 + new_start], vals[j]);
             }
             else
             {
@@ -967,7 +1040,7 @@ void remove_duplicates_helper(CSRMatrix* A, aligned_vector<T>& vals)
                 }
 
                 A->idx2[ctr + new_start] = col;
-                vals[ctr + new_start] = vals[j];
+                A->copy_val(vals[ctr + new_start], vals[j]);
                 ctr++;
                 prev_col = col;
             }
@@ -986,7 +1059,7 @@ void remove_duplicates_helper(CSRMatrix* A, aligned_vector<T>& vals)
 }
 
 template <typename T>
-void remove_duplicates_helper(CSCMatrix* A, aligned_vector<T>& vals)
+void remove_duplicates_helper(CSCMatrix* A, T& vals)
 {
     int orig_start, orig_end;
     int new_start;
@@ -1015,7 +1088,7 @@ void remove_duplicates_helper(CSCMatrix* A, aligned_vector<T>& vals)
         // Remove Duplicates
         row = A->idx2[orig_start];
         A->idx2[new_start] = row;
-        vals[new_start] = vals[orig_start];
+        A->copy_val(vals[new_start], vals[orig_start]);
         prev_row = row;
         ctr = 1;
         for (int j = orig_start + 1; j < orig_end; j++)
@@ -1023,7 +1096,7 @@ void remove_duplicates_helper(CSCMatrix* A, aligned_vector<T>& vals)
             row = A->idx2[j];
             if (row == prev_row)
             {
-                A->append_vals(&vals[ctr - 1 + new_start], &vals[j]);
+                A->append_vals(vals[ctr - 1 + new_start], vals[j]);
             }
             else
             {
@@ -1033,7 +1106,7 @@ void remove_duplicates_helper(CSCMatrix* A, aligned_vector<T>& vals)
                 }
 
                 A->idx2[ctr + new_start] = row;
-                vals[ctr + new_start] = vals[j];
+                A->copy_val(vals[ctr + new_start], vals[j]);
                 ctr++;
                 prev_row = row;
             }
@@ -1075,6 +1148,119 @@ void BSCMatrix::remove_duplicates()
 {
     remove_duplicates_helper(this, block_vals);
 }
+void SELLMatrix::remove_duplicates()
+{
+    remove_duplicates_helper(this, vals);
+    form_slices();
+}
+void CSRFloatMatrix::remove_duplicates()
+{
+    vals.assign(float_vals.begin(), float_vals.end());
+    remove_duplicates_helper(this, vals);
+    form_float_vals();
+}
+
+/**************************************************************
+*****   CSRFloatMatrix Form Float Values
+**************************************************************
+***** Rounds vals to single precision, storing them in 
+***** float_vals, and releases the double precision values.  
+***** Called after the CSR arrays are reordered in double.
+**************************************************************/
+void CSRFloatMatrix::form_float_vals()
+{
+    float_vals.resize(nnz);
+    for (int j = 0; j < nnz; j++)
+    {
+        float_vals[j] = vals[j];
+    }
+    aligned_vector<double>().swap(vals);
+}
+
+/**************************************************************
+*****   SELLMatrix Form Slices
+**************************************************************
+***** Forms SELL-C-sigma slices from the CSR arrays.  Within each
+***** window of sigma rows, rows are ordered by decreasing length
+***** so that rows in a slice have similar lengths, limiting the
+***** padding needed.  Entries of each slice are stored column-wise:
+***** entry k of row r in slice s is at slice_ptr[s] + k*C + r
+**************************************************************/
+void SELLMatrix::form_slices()
+{
+    int C = slice_size;
+    if (C < 1) C = slice_size = 1;
+    if (sigma < C) sigma = C;
+
+    n_slices = (n_rows + C - 1) / C;
+    row_perm.resize(n_rows);
+    for (int i = 0; i < n_rows; i++)
+    {
+        row_perm[i] = i;
+    }
+
+    // Sort rows by decreasing length within each sigma window
+    for (int start = 0; start < n_rows; start += sigma)
+    {
+        int end = start + sigma;
+        if (end > n_rows) end = n_rows;
+        std::stable_sort(row_perm.begin() + start, row_perm.begin() + end,
+                [&](const int i, const int j)
+                {
+                    return idx1[i+1] - idx1[i] > idx1[j+1] - idx1[j];
+                });
+    }
+
+    // Find padded width of each slice
+    slice_ptr.resize(n_slices + 1);
+    slice_ptr[0] = 0;
+    for (int s = 0; s < n_slices; s++)
+    {
+        int width = 0;
+        for (int r = 0; r < C; r++)
+        {
+            int row = s*C + r;
+            if (row >= n_rows) break;
+            int size = idx1[row_perm[row]+1] - idx1[row_perm[row]];
+            if (size > width) width = size;
+        }
+        slice_ptr[s+1] = slice_ptr[s] + width * C;
+    }
+
+    // Padding entries point to a column already used by the row (or
+    // column 0) with a zero value
+    slice_idx.resize(slice_ptr[n_slices]);
+    slice_vals.resize(slice_ptr[n_slices]);
+    for (int s = 0; s < n_slices; s++)
+    {
+        int width = (slice_ptr[s+1] - slice_ptr[s]) / C;
+        for (int r = 0; r < C; r++)
+        {
+            int row = s*C + r;
+            int start = 0, size = 0;
+            if (row < n_rows)
+            {
+                start = idx1[row_perm[row]];
+                size = idx1[row_perm[row]+1] - start;
+            }
+            int pad_col = size ? idx2[start + size - 1] : 0;
+            for (int k = 0; k < width; k++)
+            {
+                int pos = slice_ptr[s] + k*C + r;
+                if (k < size)
+                {
+                    slice_idx[pos] = idx2[start + k];
+                    slice_vals[pos] = vals[start + k];
+                }
+                else
+                {
+                    slice_idx[pos] = pad_col;
+                    slice_vals[pos] = 0.0;
+                }
+            }
+        }
+    }
+}
 
 /**************************************************************
 *****   Matrix Convert
@@ -1177,6 +1363,21 @@ CSRMatrix* CSRMatrix::to_BSR()
 {
     return this->to_CSR();
 }
+CSRMatrix* SELLMatrix::to_CSR()
+{
+    return CSRMatrix::copy();
+}
+CSRMatrix* CSRFloatMatrix::to_CSR()
+{
+    CSRMatrix* A = new CSRMatrix(n_rows, n_cols);
+    A->nnz = nnz;
+    A->idx1 = idx1;
+    A->idx2 = idx2;
+    A->vals.assign(float_vals.begin(), float_vals.end());
+    A->sorted = sorted;
+    A->diag_first = diag_first;
+    return A;
+}
 CSRMatrix* BSRMatrix::to_CSR()
 {
     CSRMatrix* A = new CSRMatrix();
@@ -1322,6 +1523,23 @@ BSCMatrix* BSCMatrix::copy()
     CSC_to_CSC(this, A, block_vals, A->block_vals);
     return A;
 }
+SELLMatrix* SELLMatrix::copy()
+{
+    return new SELLMatrix(this, slice_size, sigma);
+}
+CSRFloatMatrix* CSRFloatMatrix::copy()
+{
+    CSRFloatMatrix* A = new CSRFloatMatrix();
+    A->n_rows = n_rows;
+    A->n_cols = n_cols;
+    A->nnz = nnz;
+    A->idx1 = idx1;
+    A->idx2 = idx2;
+    A->float_vals = float_vals;
+    A->sorted = sorted;
+    A->diag_first = diag_first;
+    return A;
+}
 
 /**************************************************************
 *****  Matrix Block Removal 
@@ -49,6 +49,115 @@
  **************************************************************/
 namespace raptor
 {
+  /**************************************************************
+  *****   BlockArray Class
+  **************************************************************
+  ***** Accessor for the values of a block matrix (BCOO, BSR, BSC).
+  ***** All blocks are stored contiguously (row-wise within each
+  ***** block) in the owning matrix's vals array, which therefore
+  ***** holds nnz*b_size values.  Indexing returns a pointer to the
+  ***** first value of a block, so block_vals[j][k] is value k of
+  ***** block j.
+  *****
+  ***** Attributes
+  ***** -------------
+  ***** vals : aligned_vector<double>&
+  *****    Contiguous values of the owning matrix
+  ***** b_size : int&
+  *****    Number of values per block of the owning matrix
+  **************************************************************/
+  class BlockArray
+  {
+  public:
+    BlockArray(aligned_vector<double>& _vals, int& _b_size)
+        : vals(_vals), b_size(_b_size)
+    {
+    }
+
+    double* operator[](const int j)
+    {
+        return vals.data() + j*b_size;
+    }
+    const double* operator[](const int j) const
+    {
+        return vals.data() + j*b_size;
+    }
+
+    int size() const
+    {
+        return vals.size() / b_size;
+    }
+    void resize(const int n)
+    {
+        vals.resize(n * b_size, 0.0);
+    }
+    void reserve(const int n)
+    {
+        vals.reserve(n * b_size);
+    }
+    void clear()
+    {
+        vals.clear();
+    }
+    void shrink_to_fit()
+    {
+        vals.shrink_to_fit();
+    }
+    double* data()
+    {
+        return vals.data();
+    }
+
+    // Appends a copy of the b_size values in block
+    void emplace_back(const double* block)
+    {
+        int pos = vals.size();
+        const double* first = vals.data();
+        if (block >= first && block < first + pos)
+        {
+            // Block is already stored here, so copy by offset
+            // (resize may reallocate vals)
+            int offset = block - first;
+            vals.resize(pos + b_size);
+            std::copy(vals.begin() + offset, vals.begin() + offset + b_size,
+                    vals.begin() + pos);
+        }
+        else
+        {
+            vals.insert(vals.end(), block, block + b_size);
+        }
+    }
+
+    // Swaps blocks i and j
+    void swap(const int i, const int j)
+    {
+        std::swap_ranges(vals.begin() + i*b_size, vals.begin() + (i+1)*b_size,
+                vals.begin() + j*b_size);
+    }
+
+    // Moves block last to position first, shifting blocks
+    // [first, last) back by one
+    void rotate(const int first, const int last)
+    {
+        std::rotate(vals.begin() + first*b_size, vals.begin() + last*b_size,
+                vals.begin() + (last+1)*b_size);
+    }
+
+    aligned_vector<double>& vals;
+    int& b_size;
+
+  private:
+    BlockArray(const BlockArray&);
+    BlockArray& operator=(const BlockArray&);
+  };
+
+  // Swap blocks i and j (overloads vec_swap in utilities.hpp,
+  // so vec_sort can sort block values alongside indices)
+  inline void vec_swap(BlockArray& vec, const int i, const int j)
+  {
+      vec.swap(i, j);
+  }
+
   // Forward Declaration of classes so objects can be used
   class COOMatrix;
   class CSRMatrix;
@@ -106,21 +215,23 @@ namespace raptor
 
     virtual ~Matrix(){}
 
+    // data can be a list of values, a list of block pointers,
+    // or the BlockArray of another block matrix
     template <typename T>
     void init_from_lists(aligned_vector<int>& _idx1, aligned_vector<int>& _idx2, 
-            aligned_vector<T>& data)
+            T& data)
     {
         nnz = data.size();
         resize_data(nnz);
 
-        T* val_list = (T*) get_data();
+        double* val_list = (double*) get_data();
 
         std::copy(_idx1.begin(), _idx1.end(), std::back_inserter(idx1));
         std::copy(_idx2.begin(), _idx2.end(), std::back_inserter(idx2));
 
         for (int i = 0; i < nnz; i++)
         {
-            val_list[i] = copy_val(data[i]);
+            copy_val(&val_list[i*b_size], data[i]);
         }
     }
 
@@ -147,7 +258,7 @@ namespace raptor
     virtual void spmv_residual(const double* x, const double* b, double* r) const = 0;
 
     virtual CSRMatrix* spgemm(CSRMatrix* B, int* B_to_C = NULL) = 0;
-    virtual CSRMatrix* spgemm_T(CSCMatrix* A, int* C_map = NULL) = 0;
+    virtual CSRMatrix* spgemm_T(CSCMatrix* A, index_t* C_map = NULL) = 0;
     virtual Matrix* transpose() = 0;
 
     double* get_values(Vector& x) const
@@ -169,7 +280,7 @@ namespace raptor
     {
         printf("A[%d][%d] = %e\n", row, col, val);
     }
-    void val_print(int row, int col, double* val) const
+    void val_print(int row, int col, const double* val) const
     {
         for (int i = 0; i < b_rows; i++)
         {
@@ -180,18 +291,20 @@ namespace raptor
         }
     }
 
-    double copy_val(double val) const
+    // Methods for copying a single or block value into
+    // position dest
+    void copy_val(double& dest, const double val) const
     {
-        return val;
+        dest = val;
     }
-    double* copy_val(double* val) const
+    void copy_val(double* dest, const double val) const
     {
-        double* new_val = new double[b_size];
-        for (int i = 0; i < b_size; i++)
-        {
-            new_val[i] = val[i];
-        }
-        return new_val;
+        *dest = val;
+    }
+    void copy_val(double* dest, const double* val) const
+    {
+        if (dest != val)
+            std::copy(val, val + b_size, dest);
     }
 
     // Method for finding the absolute value of 
@@ -200,7 +313,7 @@ namespace raptor
     {
         return fabs(val);
     }
-    double abs_val(double* val) const
+    double abs_val(const double* val) const
     {
         double sum = 0;
         for (int i = 0; i < b_size; i++)
@@ -212,24 +325,23 @@ namespace raptor
 
     // Methods for appending two values
     // (either single or block values)
-    void append_vals(double* val, double* addl_val) const
+    void append_vals(double& val, const double addl_val) const
     {
-        *val += *addl_val;
+        val += addl_val;
     }
-    void append_vals(double** val, double** addl_val) const
+    void append_vals(double* val, const double* addl_val) const
     {
         for (int i = 0; i < b_size; i++)
         {
-            *val[i] += *addl_val[i];
+            val[i] += addl_val[i];
         }
-        delete[] *addl_val;
     }
     void mult_vals(double val, double addl_val, double* sum, 
             int n_rows, int n_cols, int n_inner) const
     {
         *sum += (val * addl_val);
     }
-    void mult_vals(double* val, double* addl_val, double** sum,
+    void mult_vals(const double* val, const double* addl_val, double* sum,
             int n_rows, int n_cols, int n_inner) const
     {
         for (int i = 0; i < n_rows; i++) // Go through b_rows of A
@@ -239,9 +351,9 @@ namespace raptor
                 double s = 0;
                 for (int k = 0; k < n_inner; k++) // Go through b_cols of A (== b_rows of B)
                 {
-                    s += val[i*n_inner + k] * addl_val[k*n_inner + j];
+                    s += val[i*n_inner + k] * addl_val[k*n_cols + j];
                 }
-                (*sum)[i*n_cols + j] += s;
+                sum[i*n_cols + j] += s;
             }
         }
     }
@@ -250,7 +362,7 @@ namespace raptor
     {
         *sum += (val * addl_val);
     }
-    void mult_T_vals(double* val, double* addl_val, double** sum,
+    void mult_T_vals(const double* val, const double* addl_val, double* sum,
             int n_rows, int n_cols, int n_inner) const
     {
         for (int i = 0; i < n_rows; i++) // Go through b_rows of A
@@ -260,9 +372,9 @@ namespace raptor
                 double s = 0;
                 for (int k = 0; k < n_inner; k++) // Go through b_cols of A (== b_rows of B)
                 {
-                    s += val[k*n_inner + i] * addl_val[k*n_inner + j];
+                    s += val[k*n_rows + i] * addl_val[k*n_cols + j];
                 }
-                (*sum)[i*n_cols + j] += s;
+                sum[i*n_cols + j] += s;
             }
         }
     }
@@ -370,9 +482,9 @@ namespace raptor
     CSRMatrix* mult(CSRMatrix* B, int* B_to_C = NULL);
     CSRMatrix* mult(CSCMatrix* B, int* B_to_C = NULL);
     CSRMatrix* mult(COOMatrix* B, int* B_to_C = NULL);
-    CSRMatrix* mult_T(CSCMatrix* A, int* C_map = NULL);
-    CSRMatrix* mult_T(CSRMatrix* A, int* C_map = NULL);
-    CSRMatrix* mult_T(COOMatrix* A, int* C_map = NULL);
+    CSRMatrix* mult_T(CSCMatrix* A, index_t* C_map = NULL);
+    CSRMatrix* mult_T(CSRMatrix* A, index_t* C_map = NULL);
+    CSRMatrix* mult_T(COOMatrix* A, index_t* C_map = NULL);
 
     virtual void add_value(int row, int col, double value) = 0;
     virtual void add_value(int row, int col, double* value) = 0;
@@ -493,7 +605,7 @@ namespace raptor
             resize_data(nnz_dense);
         }
 
-        T* val_list = (T*) get_data();
+        double* val_list = (double*) get_data();
 
         for (int i = 0; i < n_rows; i++)
         {
@@ -504,7 +616,7 @@ namespace raptor
                 {
                     idx1[nnz] = i;
                     idx2[nnz] = j;
-                    val_list[nnz] = copy_val(_data[pos]);
+                    copy_val(&val_list[nnz*b_size], _data[pos]);
                     nnz++;
                 }
             }
@@ -527,7 +639,7 @@ namespace raptor
     void spmv_residual(const double* x, const double* b, double* r) const; 
 
     CSRMatrix* spgemm(CSRMatrix* B, int* B_to_C = NULL);
-    CSRMatrix* spgemm_T(CSCMatrix* A, int* C_map = NULL);
+    CSRMatrix* spgemm_T(CSCMatrix* A, index_t* C_map = NULL);
 
     COOMatrix* to_COO();
     CSRMatrix* to_CSR();
@@ -677,7 +789,7 @@ namespace raptor
             resize_data(nnz_dense);
         }
 
-        T* val_list = (T*) get_data();
+        double* val_list = (double*) get_data();
 
         idx1[0] = 0;
         for (int i = 0; i < n_rows; i++)
@@ -688,7 +800,7 @@ namespace raptor
                 if (abs_val(_data[pos]))
                 {
                     idx2[nnz] = j;
-                    val_list[nnz] = copy_val(_data[pos]);
+                    copy_val(&val_list[nnz*b_size], _data[pos]);
                     nnz++;
                 }
             }
@@ -712,7 +824,51 @@ namespace raptor
     void spmv_residual(const double* x, const double* b, double* r) const; 
 
     CSRMatrix* spgemm(CSRMatrix* B, int* B_to_C = NULL);
-    CSRMatrix* spgemm_T(CSCMatrix* A, int* C_map = NULL);
+    CSRMatrix* spgemm_T(CSCMatrix* A, index_t* C_map = NULL);
+
+    /**************************************************************
+    *****   CSRMatrix Split SpGEMM
+    **************************************************************
+    ***** Two-pass products C = this*B and C = A^T*this.  The
+    ***** symbolic pass returns the structure of C (no entries are
+    ***** dropped, so the structure holds for any values), with 
+    ***** values set to zero.  The numeric pass refills the values 
+    ***** of a C returned by the symbolic pass, for matrices with 
+    ***** the same sparsity patterns.  Columns within each row of C
+    ***** may be reordered between numeric passes.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** B : CSRMatrix*
+    *****    Matrix to right multiply by
+    ***** A : CSCMatrix*
+    *****    Matrix whose transpose left multiplies this
+    ***** C : CSRMatrix*
+    *****    Structure returned by symbolic pass, values to be set
+    **************************************************************/
+    CSRMatrix* spgemm_symbolic(CSRMatrix* B);
+    void spgemm_numeric(CSRMatrix* B, CSRMatrix* C);
+    CSRMatrix* spgemm_T_symbolic(CSCMatrix* A);
+    void spgemm_T_numeric(CSCMatrix* A, CSRMatrix* C);
+
+    /**************************************************************
+    *****   CSRMatrix Split Triple Product
+    **************************************************************
+    ***** Two-pass product C = R^T*this*B, with rows of C formed
+    ***** from columns of R.  Each row of this*B is formed again for
+    ***** every nonzero of R in that row, so this*B is never stored.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** R : CSCMatrix*
+    *****    Matrix whose transpose left multiplies this
+    ***** B : CSRMatrix*
+    *****    Matrix to right multiply by
+    ***** C : CSRMatrix*
+    *****    Structure returned by symbolic pass, values to be set
+    **************************************************************/
+    CSRMatrix* rap_symbolic(CSCMatrix* R, CSRMatrix* B);
+    void rap_numeric(CSCMatrix* R, CSRMatrix* B, CSRMatrix* C);
 
     CSRMatrix* add(CSRMatrix* A, bool remove_dup = true);
     void add_append(CSRMatrix* A, CSRMatrix* C, bool remove_dup = true);
@@ -853,7 +1009,7 @@ namespace raptor
             resize_data(nnz_dense);
         }
 
-        T* val_list = (T*) get_data();
+        double* val_list = (double*) get_data();
 
         idx1[0] = 0;
         for (int i = 0; i < n_cols; i++)
@@ -864,7 +1020,7 @@ namespace raptor
                 if (abs_val(_data[pos]) > zero_tol)
                 {
                     idx2[nnz] = j;
-                    val_list[nnz] = copy_val(_data[pos]);
+                    copy_val(&val_list[nnz*b_size], _data[pos]);
                     nnz++;
                 }
             }
@@ -889,7 +1045,7 @@ namespace raptor
 
 
     CSRMatrix* spgemm(CSRMatrix* B, int* B_to_C = NULL);
-    CSRMatrix* spgemm_T(CSCMatrix* A, int* C_map = NULL);
+    CSRMatrix* spgemm_T(CSCMatrix* A, index_t* C_map = NULL);
 
     void jacobi(Vector& x, Vector& b, Vector& tmp, double omega = .667);    
 
@@ -953,6 +1109,185 @@ namespace raptor
 
 
 
+/**************************************************************
+ *****   SELLMatrix Class (Inherits from CSRMatrix)
+ **************************************************************
+ ***** This class stores a sparse matrix in SELL-C-sigma (sliced
+ ***** ELLPACK) format for vectorized SpMVs.  Rows are sorted by
+ ***** length within windows of sigma rows, grouped into slices of
+ ***** slice_size (C) rows, and each slice is padded to its longest
+ ***** row and stored column-wise, so that consecutive values in a
+ ***** slice belong to consecutive rows.
+ *****
+ ***** The CSR arrays (idx1, idx2, vals) are kept alongside the
+ ***** slices, so all CSRMatrix methods (relaxation, spgemm,
+ ***** conversions) still apply.  Only the SpMV kernels use the
+ ***** slices.  If the CSR arrays are modified directly, form_slices()
+ ***** must be called before the next SpMV.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** slice_size : int
+ *****    Number of rows per slice (C)
+ ***** sigma : int
+ *****    Number of rows in each sorting window
+ ***** n_slices : int
+ *****    Number of slices
+ ***** slice_ptr : aligned_vector<int>
+ *****    Position of first (padded) entry of each slice
+ ***** slice_idx : aligned_vector<int>
+ *****    Column of each (padded) entry
+ ***** slice_vals : aligned_vector<double>
+ *****    Value of each (padded) entry, zero for padding
+ ***** row_perm : aligned_vector<int>
+ *****    Original row of each sliced row
+ **************************************************************/
+class SELLMatrix : public CSRMatrix
+{
+  public:
+    SELLMatrix(const CSRMatrix* A, int _slice_size = SELL_SLICE_SIZE,
+            int _sigma = SELL_SIGMA) : CSRMatrix()
+    {
+        n_rows = A->n_rows;
+        n_cols = A->n_cols;
+        nnz = A->nnz;
+        idx1 = A->idx1;
+        idx2 = A->idx2;
+        vals = A->vals;
+        if (idx1.size() == 0) idx1.resize(n_rows + 1, 0);
+        sorted = A->sorted;
+        diag_first = A->diag_first;
+
+        slice_size = _slice_size;
+        sigma = _sigma;
+        form_slices();
+    }
+
+    SELLMatrix(int _nrows, int _ncols, int _slice_size = SELL_SLICE_SIZE,
+            int _sigma = SELL_SIGMA) : CSRMatrix(_nrows, _ncols)
+    {
+        slice_size = _slice_size;
+        sigma = _sigma;
+        form_slices();
+    }
+
+    SELLMatrix() : CSRMatrix()
+    {
+        slice_size = SELL_SLICE_SIZE;
+        sigma = SELL_SIGMA;
+        n_slices = 0;
+    }
+
+    ~SELLMatrix()
+    {
+    }
+
+    void form_slices();
+
+    void sort();
+    void move_diag();
+    void remove_duplicates();
+
+    CSRMatrix* to_CSR();
+    SELLMatrix* copy();
+
+    void print();
+
+    void spmv(const double* x, double* b) const;
+    void spmv_append(const double* x, double* b) const;
+    void spmv_append_T(const double* x, double* b) const;
+    void spmv_append_neg(const double* x, double* b) const;
+    void spmv_append_neg_T(const double* x, double* b) const;
+    void spmv_residual(const double* x, const double* b, double* r) const;
+
+    format_t format()
+    {
+        return SELL;
+    }
+
+    int slice_size;
+    int sigma;
+    int n_slices;
+    aligned_vector<int> slice_ptr;
+    aligned_vector<int> slice_idx;
+    aligned_vector<double> slice_vals;
+    aligned_vector<int> row_perm;
+};
+
+
+/**************************************************************
+ *****   CSRFloatMatrix Class (Inherits from CSRMatrix)
+ **************************************************************
+ ***** This class stores a sparse matrix in CSR format with
+ ***** values in single precision, halving the bytes read per
+ ***** nonzero in the bandwidth-bound SpMVs and relaxation sweeps.
+ ***** Products are accumulated in double precision, and input and
+ ***** output vectors remain in double precision.
+ *****
+ ***** The double precision vals array is left empty.  These 
+ ***** matrices are meant for the solve phase only; to_CSR()
+ ***** returns a double precision copy.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** float_vals : aligned_vector<float>
+ *****    Single precision value of each nonzero
+ **************************************************************/
+class CSRFloatMatrix : public CSRMatrix
+{
+  public:
+    CSRFloatMatrix(const CSRMatrix* A) : CSRMatrix()
+    {
+        n_rows = A->n_rows;
+        n_cols = A->n_cols;
+        nnz = A->nnz;
+        idx1 = A->idx1;
+        idx2 = A->idx2;
+        if (idx1.size() == 0) idx1.resize(n_rows + 1, 0);
+        sorted = A->sorted;
+        diag_first = A->diag_first;
+
+        float_vals.resize(A->vals.size());
+        for (int j = 0; j < A->vals.size(); j++)
+        {
+            float_vals[j] = A->vals[j];
+        }
+    }
+
+    CSRFloatMatrix() : CSRMatrix()
+    {
+    }
+
+    ~CSRFloatMatrix()
+    {
+    }
+
+    void form_float_vals();
+
+    void sort();
+    void move_diag();
+    void remove_duplicates();
+
+    CSRMatrix* to_CSR();
+    CSRFloatMatrix* copy();
+
+    void print();
+
+    void spmv(const double* x, double* b) const;
+    void spmv_append(const double* x, double* b) const;
+    void spmv_append_T(const double* x, double* b) const;
+    void spmv_append_neg(const double* x, double* b) const;
+    void spmv_append_neg_T(const double* x, double* b) const;
+    void spmv_residual(const double* x, const double* b, double* r) const;
+
+    format_t format()
+    {
+        return FCSR;
+    }
+
+    aligned_vector<float> float_vals;
+};
+
 
 // Forward Declaration of Blocked Classes 
 class BCOOMatrix;
@@ -964,7 +1299,7 @@ class BSRMatrix : public CSRMatrix
   public:
     BSRMatrix(int num_block_rows, int num_block_cols, int block_row_size, 
             int block_col_size, int _nnz = 1) 
-        : CSRMatrix(num_block_rows, num_block_cols, 0)
+        : CSRMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -973,7 +1308,7 @@ class BSRMatrix : public CSRMatrix
 
     BSRMatrix(int num_block_rows, int num_block_cols, 
             int block_row_size, int block_col_size, double** data)
-        :  CSRMatrix(num_block_rows, num_block_cols, 0)
+        :  CSRMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -986,7 +1321,7 @@ class BSRMatrix : public CSRMatrix
     BSRMatrix(int num_block_rows, int num_block_cols, 
             int block_row_size, int block_col_size, aligned_vector<int>& rowptr, 
             aligned_vector<int>& cols, aligned_vector<double*>& data)
-        :  CSRMatrix(num_block_rows, num_block_cols, 0)
+        :  CSRMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -996,7 +1331,7 @@ class BSRMatrix : public CSRMatrix
     }
 
     
-    BSRMatrix() : CSRMatrix()
+    BSRMatrix() : CSRMatrix(), block_vals(vals, b_size)
     {
         b_rows = 1;
         b_cols = 1;
@@ -1005,9 +1340,6 @@ class BSRMatrix : public CSRMatrix
 
     ~BSRMatrix()
     {
-        for (aligned_vector<double*>::iterator it = block_vals.begin();
-                it != block_vals.end(); ++it)
-            delete[] *it;
     }
 
     BSRMatrix* transpose();
@@ -1028,7 +1360,7 @@ class BSRMatrix : public CSRMatrix
     BSRMatrix* copy();
 
     BSRMatrix* spgemm(CSRMatrix* B, int* B_to_C = NULL);
-    BSRMatrix* spgemm_T(CSCMatrix* A, int* C_map = NULL);
+    BSRMatrix* spgemm_T(CSCMatrix* A, index_t* C_map = NULL);
 
     void spmv(const double* x, double* b) const;
     void spmv_append(const double* x, double* b) const;
@@ -1045,13 +1377,13 @@ class BSRMatrix : public CSRMatrix
     void add_value(int row, int col, double* value) 
     {
         idx2.emplace_back(col);
-        block_vals.emplace_back(copy_val(value));
+        block_vals.emplace_back(value);
         nnz++;
     }
 
     void* get_data()
     {
-       return block_vals.data();
+       return vals.data();
     } 
     int data_size() const
     {
@@ -1072,7 +1404,7 @@ class BSRMatrix : public CSRMatrix
         return block_vals[j][k];
     }
 
-    aligned_vector<double*> block_vals;
+    BlockArray block_vals;
 };
 
 class BCOOMatrix : public COOMatrix
@@ -1080,7 +1412,7 @@ class BCOOMatrix : public COOMatrix
   public:
     BCOOMatrix(int num_block_rows, int num_block_cols, int block_row_size, 
             int block_col_size, int nnz_per_block_row = 1) 
-        : COOMatrix(num_block_rows, num_block_cols, 0)
+        : COOMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -1089,7 +1421,7 @@ class BCOOMatrix : public COOMatrix
 
     BCOOMatrix(int num_block_rows, int num_block_cols,
             int block_row_size, int block_col_size, double** values) 
-        : COOMatrix(num_block_rows, num_block_cols, 0)
+        : COOMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -1102,7 +1434,7 @@ class BCOOMatrix : public COOMatrix
             int block_row_size, int block_col_size,
             aligned_vector<int>& rows, aligned_vector<int>& cols, 
             aligned_vector<double*>& data)
-       : COOMatrix(num_block_rows, num_block_cols, 0) 
+       : COOMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size) 
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -1111,7 +1443,7 @@ class BCOOMatrix : public COOMatrix
         init_from_lists(rows, cols, data);
     }
 
-    BCOOMatrix() : COOMatrix()
+    BCOOMatrix() : COOMatrix(), block_vals(vals, b_size)
     {
         b_rows = 1;
         b_cols = 1;
@@ -1120,9 +1452,6 @@ class BCOOMatrix : public COOMatrix
 
     ~BCOOMatrix()
     {
-        for (aligned_vector<double*>::iterator it = block_vals.begin();
-                it != block_vals.end(); ++it)
-            delete[] *it;
     }
 
     BCOOMatrix* transpose();
@@ -1142,7 +1471,7 @@ class BCOOMatrix : public COOMatrix
     void block_removal_col_check(bool* col_check);
 
     BSRMatrix* spgemm(CSRMatrix* B, int* B_to_C = NULL);
-    BSRMatrix* spgemm_T(CSCMatrix* A, int* C_map = NULL);
+    BSRMatrix* spgemm_T(CSCMatrix* A, index_t* C_map = NULL);
 
     void spmv(const double* x, double* b) const;
     void spmv_append(const double* x, double* b) const;
@@ -1155,7 +1484,7 @@ class BCOOMatrix : public COOMatrix
     {
         idx1.emplace_back(row);
         idx2.emplace_back(col);
-        block_vals.emplace_back(copy_val(values));
+        block_vals.emplace_back(values);
         nnz++;
     }
 
@@ -1166,7 +1495,7 @@ class BCOOMatrix : public COOMatrix
 
     void* get_data()
     {
-       return block_vals.data();
+       return vals.data();
     } 
     int data_size() const
     {
@@ -1188,7 +1517,7 @@ class BCOOMatrix : public COOMatrix
         return block_vals[j][k];
     }
 
-    aligned_vector<double*> block_vals;
+    BlockArray block_vals;
 };
 
 // Blocks are still stored row-wise in BSC matrix...
@@ -1197,7 +1526,7 @@ class BSCMatrix : public CSCMatrix
   public:
     BSCMatrix(int num_block_rows, int num_block_cols, int block_row_size, 
             int block_col_size, int _nnz = 1) 
-        : CSCMatrix(num_block_rows, num_block_cols, 0)
+        : CSCMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -1206,7 +1535,7 @@ class BSCMatrix : public CSCMatrix
 
     BSCMatrix(int num_block_rows, int num_block_cols, 
             int block_row_size, int block_col_size, double** data)
-        :  CSCMatrix(num_block_rows, num_block_cols, 0)
+        :  CSCMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -1219,7 +1548,7 @@ class BSCMatrix : public CSCMatrix
     BSCMatrix(int num_block_rows, int num_block_cols, 
             int block_row_size, int block_col_size, aligned_vector<int>& colptr, 
             aligned_vector<int>& rows, aligned_vector<double*>& data)
-        :  CSCMatrix(num_block_rows, num_block_cols, 0)
+        :  CSCMatrix(num_block_rows, num_block_cols, 0), block_vals(vals, b_size)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
@@ -1229,7 +1558,7 @@ class BSCMatrix : public CSCMatrix
     }
 
     
-    BSCMatrix() : CSCMatrix()
+    BSCMatrix() : CSCMatrix(), block_vals(vals, b_size)
     {
         b_rows = 1;
         b_cols = 1;
@@ -1238,9 +1567,6 @@ class BSCMatrix : public CSCMatrix
 
     ~BSCMatrix()
     {
-        for (aligned_vector<double*>::iterator it = block_vals.begin();
-                it != block_vals.end(); ++it)
-            delete[] *it;
     }
 
     BSCMatrix* transpose();
@@ -1261,7 +1587,7 @@ class BSCMatrix : public CSCMatrix
     BSCMatrix* copy();
 
     BSRMatrix* spgemm(CSRMatrix* B, int* B_to_C = NULL);
-    BSRMatrix* spgemm_T(CSCMatrix* A, int* C_map = NULL);
+    BSRMatrix* spgemm_T(CSCMatrix* A, index_t* C_map = NULL);
 
     void spmv(const double* x, double* b) const;
     void spmv_append(const double* x, double* b) const;
@@ -1278,13 +1604,13 @@ class BSCMatrix : public CSCMatrix
     void add_value(int row, int col, double* value)
     {
         idx2.emplace_back(row);
-        block_vals.emplace_back(copy_val(value));
+        block_vals.emplace_back(value);
         nnz++;
     }
 
     void* get_data()
     {
-       return block_vals.data();
+       return vals.data();
     }
     void resize_data(int size)
     {
@@ -1305,7 +1631,7 @@ class BSCMatrix : public CSCMatrix
         return block_vals[j][k];
     }
 
-    aligned_vector<double*> block_vals;
+    BlockArray block_vals;
 };
 
 
@@ -1,62 +1,14 @@
-bool profile = false;
-double collective_t = 0.0;
-double p2p_t = 0.0;
-double* current_t;
-double mat_t = 0.0;
-double vec_t = 0.0;
-double total_t = 0.0;
-double new_comm_t = 0.0;
-
 #include <mpi.h>
 #include "mpi_types.hpp"
 
-void init_profile()
-{
-    profile = true;
-    reset_profile();
-}
-void reset_profile()
-{
-    collective_t = 0.0;
-    p2p_t = 0.0;
-    mat_t = 0.0;
-    vec_t = 0.0;
-    new_comm_t = 0.0;
-    if (profile) total_t = -MPI_Wtime();
-    else total_t = 0.0;
-}
-void finalize_profile()
-{
-    profile = false;
-    total_t += MPI_Wtime();
-}
-void average_profile(int n_iter)
-{
-    total_t /= n_iter;
-    collective_t /= n_iter;
-    p2p_t /= n_iter;
-    vec_t /= n_iter;
-    mat_t /= n_iter;
-    new_comm_t /= n_iter;
-}
-void print_profile(const char* string)
-{
-    int rank;
-    double t0;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+using namespace raptor;
 
-    MPI_Allreduce(&total_t, &t0, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
-    if (rank == 0) printf("%s Total Time: %e\n", string, t0);
-    if (fabs(t0 - total_t) > zero_tol)
-        reset_profile();
-    MPI_Reduce(&collective_t, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-    if (rank == 0 && t0 > 0) printf("%s Collective Comm Time: %e\n", string, t0);
-    MPI_Reduce(&p2p_t, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-    if (rank == 0 && t0 > 0) printf("%s P2P Comm Time: %e\n", string, t0);
-    MPI_Reduce(&vec_t, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-    if (rank == 0 && t0 > 0) printf("%s Vec Comm Time: %e\n", string, t0);
-    MPI_Reduce(&mat_t, &t0, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-    if (rank == 0 && t0 > 0) printf("%s Mat Comm Time: %e\n", string, t0);
+// Bytes in count values of datatype
+static double type_bytes(int count, RAPtor_MPI_Datatype datatype)
+{
+    int size;
+    MPI_Type_size(datatype, &size);
+    return ((double) count) * size;
 }
 
 
@@ -64,77 +16,138 @@ void print_profile(const char* string)
 int RAPtor_MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, 
         RAPtor_MPI_Datatype datatype, RAPtor_MPI_Op op, RAPtor_MPI_Comm comm)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileCollective);
     return val;
 }
 int RAPtor_MPI_Reduce(const void *sendbuf, void *recvbuf, int count, 
         RAPtor_MPI_Datatype datatype, RAPtor_MPI_Op op, int root, RAPtor_MPI_Comm comm)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileCollective);
     return val;
 }
 int RAPtor_MPI_Gather(const void *sendbuf, int sendcount, RAPtor_MPI_Datatype sendtype,
         void *recvbuf, int recvcount, RAPtor_MPI_Datatype recvtype, int root, RAPtor_MPI_Comm comm)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, 
             recvtype, root, comm);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileCollective);
+    return val;
+}
+int RAPtor_MPI_Gatherv(const void *sendbuf, int sendcount, RAPtor_MPI_Datatype sendtype,
+        void *recvbuf, const int *recvcounts, const int* displs, 
+        RAPtor_MPI_Datatype recvtype, int root, RAPtor_MPI_Comm comm)
+{
+    if (profile) profile_start(ProfileCollective);
+    int val = MPI_Gatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, 
+            displs, recvtype, root, comm);
+    if (profile) profile_stop(ProfileCollective);
+    return val;
+}
+int RAPtor_MPI_Scatterv(const void *sendbuf, const int *sendcounts, const int* displs,
+        RAPtor_MPI_Datatype sendtype, void *recvbuf, int recvcount, 
+        RAPtor_MPI_Datatype recvtype, int root, RAPtor_MPI_Comm comm)
+{
+    if (profile) profile_start(ProfileCollective);
+    int val = MPI_Scatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, 
+            recvcount, recvtype, root, comm);
+    if (profile) profile_stop(ProfileCollective);
     return val;
 }
 int RAPtor_MPI_Allgather(const void* sendbuf, int sendcount, RAPtor_MPI_Datatype sendtype,
         void *recvbuf, int recvcount, RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, 
             recvcount, recvtype, comm);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileCollective);
     return val;
 }
 int RAPtor_MPI_Allgatherv(const void* sendbuf, int sendcount, RAPtor_MPI_Datatype sendtype,
         void *recvbuf, const int *recvcounts, const int* displs, 
         RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Allgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts,
             displs, recvtype, comm);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileCollective);
+    return val;
+}
+int RAPtor_MPI_Alltoall(const void* sendbuf, int sendcount, RAPtor_MPI_Datatype sendtype,
+        void *recvbuf, int recvcount, RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm)
+{
+    if (profile) profile_start(ProfileCollective);
+    int val = MPI_Alltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount,
+            recvtype, comm);
+    if (profile) profile_stop(ProfileCollective);
+    return val;
+}
+int RAPtor_MPI_Alltoallv(const void* sendbuf, const int *sendcounts, const int* sdispls,
+        RAPtor_MPI_Datatype sendtype, void *recvbuf, const int *recvcounts, 
+        const int* rdispls, RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm)
+{
+    if (profile) profile_start(ProfileCollective);
+    int val = MPI_Alltoallv(sendbuf, sendcounts, sdispls, sendtype, recvbuf, 
+            recvcounts, rdispls, recvtype, comm);
+    if (profile) profile_stop(ProfileCollective);
     return val;
 }
 int RAPtor_MPI_Iallreduce(const void *sendbuf, void *recvbuf, int count,
         RAPtor_MPI_Datatype datatype, RAPtor_MPI_Op op, RAPtor_MPI_Comm comm, RAPtor_MPI_Request* request)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Iallreduce(sendbuf, recvbuf, count, datatype, op, comm, request);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
-    if (profile) current_t = &collective_t;
+    if (profile) profile_stop(ProfileCollective);
+    if (profile) profile_set_wait(ProfileCollective);
+    return val;
+}
+int RAPtor_MPI_Ineighbor_alltoallv(const void *sendbuf, const int sendcounts[],
+        const int sdispls[], RAPtor_MPI_Datatype sendtype, void *recvbuf, 
+        const int recvcounts[], const int rdispls[], RAPtor_MPI_Datatype recvtype,
+        RAPtor_MPI_Comm comm, RAPtor_MPI_Request* request)
+{
+    if (profile) profile_start(ProfileCollective);
+    int val = MPI_Ineighbor_alltoallv(sendbuf, sendcounts, sdispls, sendtype, 
+            recvbuf, recvcounts, rdispls, recvtype, comm, request);
+    if (profile) profile_stop(ProfileCollective);
+    if (profile) profile_set_wait(ProfileCollective);
+    if (profile)
+    {
+        int indegree, outdegree, weighted;
+        MPI_Dist_graph_neighbors_count(comm, &indegree, &outdegree, &weighted);
+        int send_size = 0, recv_size = 0;
+        for (int i = 0; i < outdegree; i++) send_size += sendcounts[i];
+        for (int i = 0; i < indegree; i++) recv_size += recvcounts[i];
+        profile_send(outdegree, type_bytes(send_size, sendtype));
+        profile_recv(type_bytes(recv_size, recvtype));
+    }
     return val;
 }
 int RAPtor_MPI_Bcast(void *buffer, int count, RAPtor_MPI_Datatype datatype,
         int root, RAPtor_MPI_Comm comm)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Bcast(buffer, count, datatype, root, comm);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileCollective);
     return val;
 }
 int RAPtor_MPI_Ibarrier(RAPtor_MPI_Comm comm, RAPtor_MPI_Request *request)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Ibarrier(comm, request);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
-    if (profile) current_t = &collective_t;
+    if (profile) profile_stop(ProfileCollective);
+    if (profile) profile_set_wait(ProfileCollective);
     return val;
 }
 int RAPtor_MPI_Barrier(RAPtor_MPI_Comm comm)
 {
-    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileCollective);
     int val = MPI_Barrier(comm);
-    if (profile) collective_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileCollective);
     return val;
 }
 
@@ -144,60 +157,130 @@ int RAPtor_MPI_Barrier(RAPtor_MPI_Comm comm)
 int RAPtor_MPI_Send(const void *buf, int count, RAPtor_MPI_Datatype datatype, int dest,
         int tag, RAPtor_MPI_Comm comm)
 {
-    if (profile) p2p_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileP2P);
     int val = MPI_Send(buf, count, datatype, dest, tag, comm);
-    if (profile) p2p_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileP2P);
+    if (profile) profile_send(1, type_bytes(count, datatype));
     return val;
 }
 int RAPtor_MPI_Isend(const void *buf, int count, RAPtor_MPI_Datatype datatype, int dest, int tag,
         RAPtor_MPI_Comm comm, RAPtor_MPI_Request * request)
 {
-    if (profile) p2p_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileP2P);
     int val = MPI_Isend(buf, count, datatype, dest, tag, comm, request);
-    if (profile) p2p_t += RAPtor_MPI_Wtime();
-    if (profile) current_t = &p2p_t;
+    if (profile) profile_stop(ProfileP2P);
+    if (profile) profile_set_wait(ProfileP2P);
+    if (profile) profile_send(1, type_bytes(count, datatype));
     return val;
 }
 int RAPtor_MPI_Issend(const void *buf, int count, RAPtor_MPI_Datatype datatype, int dest, int tag,
         RAPtor_MPI_Comm comm, RAPtor_MPI_Request * request)
 {
-    if (profile) p2p_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileP2P);
     int val = MPI_Issend(buf, count, datatype, dest, tag, comm, request);
-    if (profile) p2p_t += RAPtor_MPI_Wtime();
-    if (profile) current_t = &p2p_t;
+    if (profile) profile_stop(ProfileP2P);
+    if (profile) profile_set_wait(ProfileP2P);
+    if (profile) profile_send(1, type_bytes(count, datatype));
     return val;
 }
 int RAPtor_MPI_Recv(void *buf, int count, RAPtor_MPI_Datatype datatype, int source, int tag,
         RAPtor_MPI_Comm comm, RAPtor_MPI_Status * status)
 {
-    if (profile) p2p_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileP2P);
     int val = MPI_Recv(buf, count, datatype, source, tag, comm, status);
-    if (profile) p2p_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileP2P);
+    if (profile) profile_recv(type_bytes(count, datatype));
     return val;
 }
 int RAPtor_MPI_Irecv(void *buf, int count, RAPtor_MPI_Datatype datatype, int source,
         int tag, RAPtor_MPI_Comm comm, RAPtor_MPI_Request * request)
 {
-    if (profile) p2p_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileP2P);
     int val = MPI_Irecv(buf, count, datatype, source, tag, comm, request);
-    if (profile) p2p_t += RAPtor_MPI_Wtime();
-    if (profile) current_t = &p2p_t;
+    if (profile) profile_stop(ProfileP2P);
+    if (profile) profile_set_wait(ProfileP2P);
+    if (profile) profile_recv(type_bytes(count, datatype));
     return val;
 }
+int RAPtor_MPI_Send_init(const void *buf, int count, RAPtor_MPI_Datatype datatype, 
+        int dest, int tag, RAPtor_MPI_Comm comm, RAPtor_MPI_Request * request)
+{
+    if (profile) profile_start(ProfileP2P);
+    int val = MPI_Send_init(buf, count, datatype, dest, tag, comm, request);
+    if (profile) profile_stop(ProfileP2P);
+    return val;
+}
+int RAPtor_MPI_Recv_init(void *buf, int count, RAPtor_MPI_Datatype datatype, int source,
+        int tag, RAPtor_MPI_Comm comm, RAPtor_MPI_Request * request)
+{
+    if (profile) profile_start(ProfileP2P);
+    int val = MPI_Recv_init(buf, count, datatype, source, tag, comm, request);
+    if (profile) profile_stop(ProfileP2P);
+    return val;
+}
+int RAPtor_MPI_Startall(int count, RAPtor_MPI_Request array_of_requests[])
+{
+    if (profile) profile_start(ProfileP2P);
+    int val = MPI_Startall(count, array_of_requests);
+    if (profile) profile_stop(ProfileP2P);
+    if (profile) profile_set_wait(ProfileP2P);
+    return val;
+}
+int RAPtor_MPI_Request_free(RAPtor_MPI_Request *request)
+{
+    return MPI_Request_free(request);
+}
+int RAPtor_MPI_File_open(RAPtor_MPI_Comm comm, const char *filename, 
+        int amode, MPI_Info info, RAPtor_MPI_File *fh)
+{
+    return MPI_File_open(comm, filename, amode, info, fh);
+}
+int RAPtor_MPI_File_close(RAPtor_MPI_File *fh)
+{
+    return MPI_File_close(fh);
+}
+int RAPtor_MPI_File_get_size(RAPtor_MPI_File fh, RAPtor_MPI_Offset *size)
+{
+    return MPI_File_get_size(fh, size);
+}
+int RAPtor_MPI_File_read_at(RAPtor_MPI_File fh, RAPtor_MPI_Offset offset,
+        void *buf, int count, RAPtor_MPI_Datatype datatype, RAPtor_MPI_Status *status)
+{
+    return MPI_File_read_at(fh, offset, buf, count, datatype, status);
+}
+int RAPtor_MPI_File_read_at_all(RAPtor_MPI_File fh, RAPtor_MPI_Offset offset,
+        void *buf, int count, RAPtor_MPI_Datatype datatype, RAPtor_MPI_Status *status)
+{
+    return MPI_File_read_at_all(fh, offset, buf, count, datatype, status);
+}
+int RAPtor_MPI_File_set_size(RAPtor_MPI_File fh, RAPtor_MPI_Offset size)
+{
+    return MPI_File_set_size(fh, size);
+}
+int RAPtor_MPI_File_write_at(RAPtor_MPI_File fh, RAPtor_MPI_Offset offset,
+        const void *buf, int count, RAPtor_MPI_Datatype datatype, RAPtor_MPI_Status *status)
+{
+    return MPI_File_write_at(fh, offset, buf, count, datatype, status);
+}
+int RAPtor_MPI_File_write_at_all(RAPtor_MPI_File fh, RAPtor_MPI_Offset offset,
+        const void *buf, int count, RAPtor_MPI_Datatype datatype, RAPtor_MPI_Status *status)
+{
+    return MPI_File_write_at_all(fh, offset, buf, count, datatype, status);
+}
 int RAPtor_MPI_Probe(int source, int tag, RAPtor_MPI_Comm comm, RAPtor_MPI_Status* status)
 {
-    if (profile) p2p_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileP2P);
     int val = MPI_Probe(source, tag, comm, status);
-    if (profile) p2p_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileP2P);
     return val;
 }
 int RAPtor_MPI_Iprobe(int source, int tag, RAPtor_MPI_Comm comm,
         int *flag, RAPtor_MPI_Status *status)
 {
-    if (profile) p2p_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileP2P);
     int val = MPI_Iprobe(source, tag, comm, flag, status);
-    if (profile) p2p_t += RAPtor_MPI_Wtime();
-    if (profile) current_t = &p2p_t;
+    if (profile) profile_stop(ProfileP2P);
+    if (profile) profile_set_wait(ProfileP2P);
     return val;
 }
 
@@ -206,31 +289,31 @@ int RAPtor_MPI_Iprobe(int source, int tag, RAPtor_MPI_Comm comm,
 // Waiting for completion
 int RAPtor_MPI_Wait(RAPtor_MPI_Request *request, RAPtor_MPI_Status *status)
 {
-    if (profile) *current_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start_wait();
     int val = MPI_Wait(request, status);
-    if (profile) *current_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop_wait();
     return val;
 }
 int RAPtor_MPI_Waitall(int count, RAPtor_MPI_Request array_of_requests[], RAPtor_MPI_Status array_of_statuses[])
 {
-    if (profile) *current_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start_wait();
     int val = MPI_Waitall(count, array_of_requests, array_of_statuses);
-    if (profile) *current_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop_wait();
     return val;
 }
 int RAPtor_MPI_Test(MPI_Request *request, int *flag, MPI_Status *status)
 {
-    if (profile) *current_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start_wait();
     int val = MPI_Test(request, flag, status);
-    if (profile) *current_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop_wait();
     return val;
 }
 int RAPtor_MPI_Testall(int count, MPI_Request array_of_requests[],
         int* flag, MPI_Status array_of_statuses[])
 {
-    if (profile) *current_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start_wait();
     int val = MPI_Testall(count, array_of_requests, flag, array_of_statuses);
-    if (profile) *current_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop_wait();
     return val;
 }
 
@@ -252,6 +335,19 @@ int RAPtor_MPI_Pack_size(int incount, RAPtor_MPI_Datatype datatype,
 {
     return MPI_Pack_size(incount, datatype, comm, size);
 }
+int RAPtor_MPI_Type_contiguous(int count, RAPtor_MPI_Datatype oldtype,
+        RAPtor_MPI_Datatype *newtype)
+{
+    return MPI_Type_contiguous(count, oldtype, newtype);
+}
+int RAPtor_MPI_Type_commit(RAPtor_MPI_Datatype *datatype)
+{
+    return MPI_Type_commit(datatype);
+}
+int RAPtor_MPI_Type_free(RAPtor_MPI_Datatype *datatype)
+{
+    return MPI_Type_free(datatype);
+}
 
 
 // Other utilities (no communication)
@@ -279,53 +375,97 @@ int RAPtor_MPI_Comm_size(RAPtor_MPI_Comm comm, int* size)
 int RAPtor_MPI_Comm_split(RAPtor_MPI_Comm comm, int color, int key,
         RAPtor_MPI_Comm* new_comm)
 {
-    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileNewComm);
     int val = MPI_Comm_split(comm, color, key, new_comm);
-    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileNewComm);
     return val;
 }
 int RAPtor_MPI_Comm_group(RAPtor_MPI_Comm comm, RAPtor_MPI_Group *group)
 {
-    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileNewComm);
     int val = MPI_Comm_group(comm, group);
-    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileNewComm);
     return val;
 }
 int RAPtor_MPI_Comm_create_group(RAPtor_MPI_Comm comm, RAPtor_MPI_Group group,
         int tag, RAPtor_MPI_Comm* newcomm)
 {
-    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileNewComm);
     int val = MPI_Comm_create_group(comm, group, tag, newcomm);
-    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileNewComm);
     return val;
 }
 int RAPtor_MPI_Group_incl(RAPtor_MPI_Group group, int n, const int ranks[],
         RAPtor_MPI_Group *newgroup)
 {
-    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileNewComm);
     int val = MPI_Group_incl(group, n, ranks, newgroup);
-    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileNewComm);
     return val;
 }
 int RAPtor_MPI_Comm_free(RAPtor_MPI_Comm *comm)
 {
-    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileNewComm);
     int val = MPI_Comm_free(comm);
-    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileNewComm);
     return val;
 }
 int RAPtor_MPI_Group_free(RAPtor_MPI_Group* group)
 {
-    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileNewComm);
     int val = MPI_Group_free(group);
-    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileNewComm);
+    return val;
+}
+int RAPtor_MPI_Group_translate_ranks(RAPtor_MPI_Group group1, int n,
+        const int ranks1[], RAPtor_MPI_Group group2, int ranks2[])
+{
+    if (profile) profile_start(ProfileNewComm);
+    int val = MPI_Group_translate_ranks(group1, n, ranks1, group2, ranks2);
+    if (profile) profile_stop(ProfileNewComm);
     return val;
 }
 int RAPtor_MPI_Comm_dup(MPI_Comm comm, MPI_Comm* new_comm)
 {
-    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    if (profile) profile_start(ProfileNewComm);
     int val = MPI_Comm_dup(comm, new_comm);
-    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    if (profile) profile_stop(ProfileNewComm);
+    return val;
+}
+int RAPtor_MPI_Comm_create_keyval(MPI_Comm_copy_attr_function* copy_fn,
+        MPI_Comm_delete_attr_function* delete_fn, int* keyval, void* extra_state)
+{
+    if (profile) profile_start(ProfileNewComm);
+    int val = MPI_Comm_create_keyval(copy_fn, delete_fn, keyval, extra_state);
+    if (profile) profile_stop(ProfileNewComm);
+    return val;
+}
+int RAPtor_MPI_Comm_get_attr(RAPtor_MPI_Comm comm, int keyval,
+        void* attribute_val, int* flag)
+{
+    if (profile) profile_start(ProfileNewComm);
+    int val = MPI_Comm_get_attr(comm, keyval, attribute_val, flag);
+    if (profile) profile_stop(ProfileNewComm);
+    return val;
+}
+int RAPtor_MPI_Comm_set_attr(RAPtor_MPI_Comm comm, int keyval,
+        void* attribute_val)
+{
+    if (profile) profile_start(ProfileNewComm);
+    int val = MPI_Comm_set_attr(comm, keyval, attribute_val);
+    if (profile) profile_stop(ProfileNewComm);
+    return val;
+}
+int RAPtor_MPI_Dist_graph_create_adjacent(RAPtor_MPI_Comm comm_old,
+        int indegree, const int sources[], const int sourceweights[],
+        int outdegree, const int destinations[], const int destweights[],
+        MPI_Info info, int reorder, RAPtor_MPI_Comm* comm_dist_graph)
+{
+    if (profile) profile_start(ProfileNewComm);
+    int val = MPI_Dist_graph_create_adjacent(comm_old, indegree, sources, 
+            sourceweights, outdegree, destinations, destweights, info, reorder,
+            comm_dist_graph);
+    if (profile) profile_stop(ProfileNewComm);
     return val;
 }
 
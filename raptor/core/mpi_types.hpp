@@ -6,23 +6,12 @@
 #include "types.hpp"
 #include <mpi.h>
 
-// Global Timing Variables
-extern bool profile;
-extern double collective_t;
-extern double p2p_t;
-extern double* current_t;
-extern double mat_t;
-extern double vec_t;
-extern double total_t;
-
-extern void init_profile();
-extern void reset_profile();
-extern void finalize_profile();
-extern void print_profile(const char* string);
-extern void average_profile(int n_iter);
+// Profiling registry (init_profile, print_profile, ...)
+#include "profiler.hpp"
 
 #define RAPtor_MPI_COMM_WORLD        MPI_COMM_WORLD
 #define RAPtor_MPI_COMM_NULL         MPI_COMM_NULL
+#define RAPtor_MPI_UNDEFINED         MPI_UNDEFINED
 
 #define RAPtor_MPI_Comm              MPI_Comm
 #define RAPtor_MPI_Group             MPI_Group
@@ -30,22 +19,38 @@ extern void average_profile(int n_iter);
 #define RAPtor_MPI_Request           MPI_Request
 #define RAPtor_MPI_Status            MPI_Status
 #define RAPtor_MPI_Op                MPI_Op
+#define RAPtor_MPI_File              MPI_File
+#define RAPtor_MPI_Offset            MPI_Offset
 
 #define RAPtor_MPI_INT               MPI_INT
+#define RAPtor_MPI_FLOAT             MPI_FLOAT
 #define RAPtor_MPI_DOUBLE            MPI_DOUBLE
 #define RAPtor_MPI_DOUBLE_INT        MPI_DOUBLE_INT
 #define RAPtor_MPI_LONG              MPI_LONG
+#define RAPtor_MPI_INT64_T           MPI_INT64_T
 #define RAPtor_MPI_PACKED            MPI_PACKED
+#define RAPtor_MPI_CHAR              MPI_CHAR
+#define RAPtor_MPI_BYTE              MPI_BYTE
 
 #define RAPtor_MPI_STATUS_IGNORE     MPI_STATUS_IGNORE
 #define RAPtor_MPI_STATUSES_IGNORE   MPI_STATUSES_IGNORE
 
 #define RAPtor_MPI_SOURCE            MPI_SOURCE
 #define RAPtor_MPI_ANY_SOURCE        MPI_ANY_SOURCE
+#define RAPtor_MPI_SUCCESS           MPI_SUCCESS
+#define RAPtor_MPI_KEYVAL_INVALID    MPI_KEYVAL_INVALID
+#define RAPtor_MPI_COMM_NULL_COPY_FN MPI_COMM_NULL_COPY_FN
+
+#define RAPtor_MPI_UNWEIGHTED        MPI_UNWEIGHTED
+#define RAPtor_MPI_INFO_NULL         MPI_INFO_NULL
+#define RAPtor_MPI_MODE_RDONLY       MPI_MODE_RDONLY
+#define RAPtor_MPI_MODE_WRONLY       MPI_MODE_WRONLY
+#define RAPtor_MPI_MODE_CREATE       MPI_MODE_CREATE
 
 #define RAPtor_MPI_IN_PLACE          MPI_IN_PLACE
 #define RAPtor_MPI_SUM               MPI_SUM
 #define RAPtor_MPI_MAX               MPI_MAX
+#define RAPtor_MPI_MIN               MPI_MIN
 #define RAPtor_MPI_BOR               MPI_BOR
 
 
@@ -62,15 +67,34 @@ extern int RAPtor_MPI_Reduce(const void *sendbuf, void *recvbuf, int count,
 extern int RAPtor_MPI_Gather(const void *sendbuf, int sendcount, 
         RAPtor_MPI_Datatype sendtype, void *recvbuf, int recvcount,
         RAPtor_MPI_Datatype recvtype, int root, RAPtor_MPI_Comm comm);
+extern int RAPtor_MPI_Gatherv(const void *sendbuf, int sendcount, 
+        RAPtor_MPI_Datatype sendtype, void *recvbuf, const int *recvcounts,
+        const int* displs, RAPtor_MPI_Datatype recvtype, int root, 
+        RAPtor_MPI_Comm comm);
+extern int RAPtor_MPI_Scatterv(const void *sendbuf, const int *sendcounts,
+        const int* displs, RAPtor_MPI_Datatype sendtype, void *recvbuf, 
+        int recvcount, RAPtor_MPI_Datatype recvtype, int root, 
+        RAPtor_MPI_Comm comm);
 extern int RAPtor_MPI_Allgather(const void* sendbuf, int sendcount,
         RAPtor_MPI_Datatype sendtype, void *recvbuf, int recvcount,
          RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm);
 extern int RAPtor_MPI_Allgatherv(const void* sendbuf, int sendcount,
         RAPtor_MPI_Datatype sendtype, void *recvbuf, const int *recvcounts, 
         const int* displs, RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm);
+extern int RAPtor_MPI_Alltoall(const void* sendbuf, int sendcount,
+        RAPtor_MPI_Datatype sendtype, void *recvbuf, int recvcount,
+        RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm);
+extern int RAPtor_MPI_Alltoallv(const void* sendbuf, const int *sendcounts,
+        const int* sdispls, RAPtor_MPI_Datatype sendtype, void *recvbuf, 
+        const int *recvcounts, const int* rdispls, RAPtor_MPI_Datatype recvtype, 
+        RAPtor_MPI_Comm comm);
 extern int RAPtor_MPI_Iallreduce(const void *sendbuf, void *recvbuf, int count,
         RAPtor_MPI_Datatype datatype, RAPtor_MPI_Op op, RAPtor_MPI_Comm comm, 
         RAPtor_MPI_Request* request);
+extern int RAPtor_MPI_Ineighbor_alltoallv(const void *sendbuf, const int sendcounts[],
+        const int sdispls[], RAPtor_MPI_Datatype sendtype, void *recvbuf, 
+        const int recvcounts[], const int rdispls[], RAPtor_MPI_Datatype recvtype,
+        RAPtor_MPI_Comm comm, RAPtor_MPI_Request* request);
 extern int RAPtor_MPI_Ibarrier(RAPtor_MPI_Comm comm, 
         RAPtor_MPI_Request *request);
 extern int RAPtor_MPI_Barrier(RAPtor_MPI_Comm comm);
@@ -91,6 +115,30 @@ extern int RAPtor_MPI_Recv(void *buf, int count, RAPtor_MPI_Datatype datatype,
 extern int RAPtor_MPI_Irecv(void *buf, int count, RAPtor_MPI_Datatype datatype,
         int source, int tag, RAPtor_MPI_Comm comm, RAPtor_MPI_Request * request);
 
+// Persistent Point-to-Point Operations
+extern int RAPtor_MPI_Send_init(const void *buf, int count, 
+        RAPtor_MPI_Datatype datatype, int dest, int tag, RAPtor_MPI_Comm comm,
+        RAPtor_MPI_Request * request);
+extern int RAPtor_MPI_Recv_init(void *buf, int count, RAPtor_MPI_Datatype datatype,
+        int source, int tag, RAPtor_MPI_Comm comm, RAPtor_MPI_Request * request);
+extern int RAPtor_MPI_Startall(int count, RAPtor_MPI_Request array_of_requests[]);
+extern int RAPtor_MPI_Request_free(RAPtor_MPI_Request *request);
+
+// Parallel File I/O
+extern int RAPtor_MPI_File_open(RAPtor_MPI_Comm comm, const char *filename, 
+        int amode, MPI_Info info, RAPtor_MPI_File *fh);
+extern int RAPtor_MPI_File_close(RAPtor_MPI_File *fh);
+extern int RAPtor_MPI_File_get_size(RAPtor_MPI_File fh, RAPtor_MPI_Offset *size);
+extern int RAPtor_MPI_File_read_at(RAPtor_MPI_File fh, RAPtor_MPI_Offset offset,
+        void *buf, int count, RAPtor_MPI_Datatype datatype, RAPtor_MPI_Status *status);
+extern int RAPtor_MPI_File_read_at_all(RAPtor_MPI_File fh, RAPtor_MPI_Offset offset,
+        void *buf, int count, RAPtor_MPI_Datatype datatype, RAPtor_MPI_Status *status);
+extern int RAPtor_MPI_File_set_size(RAPtor_MPI_File fh, RAPtor_MPI_Offset size);
+extern int RAPtor_MPI_File_write_at(RAPtor_MPI_File fh, RAPtor_MPI_Offset offset,
+        const void *buf, int count, RAPtor_MPI_Datatype datatype, RAPtor_MPI_Status *status);
+extern int RAPtor_MPI_File_write_at_all(RAPtor_MPI_File fh, RAPtor_MPI_Offset offset,
+        const void *buf, int count, RAPtor_MPI_Datatype datatype, RAPtor_MPI_Status *status);
+
 // Waiting for data
 extern int RAPtor_MPI_Wait(RAPtor_MPI_Request *request, 
         RAPtor_MPI_Status *status);
@@ -114,6 +162,10 @@ extern int RAPtor_MPI_Get_count(const RAPtor_MPI_Status *status,
         RAPtor_MPI_Datatype datatype, int *count);
 extern int RAPtor_MPI_Pack_size(int incount, RAPtor_MPI_Datatype datatype, 
         RAPtor_MPI_Comm comm, int *size);
+extern int RAPtor_MPI_Type_contiguous(int count, RAPtor_MPI_Datatype oldtype,
+        RAPtor_MPI_Datatype *newtype);
+extern int RAPtor_MPI_Type_commit(RAPtor_MPI_Datatype *datatype);
+extern int RAPtor_MPI_Type_free(RAPtor_MPI_Datatype *datatype);
 
 // Timing Data
 extern double RAPtor_MPI_Wtime();
@@ -128,6 +180,18 @@ extern int RAPtor_MPI_Comm_create_group(RAPtor_MPI_Comm comm, RAPtor_MPI_Group g
 extern int RAPtor_MPI_Group_incl(RAPtor_MPI_Group group, int n, const int ranks[],
         RAPtor_MPI_Group *newgroup);
 extern int RAPtor_MPI_Group_free(RAPtor_MPI_Group* group);
+extern int RAPtor_MPI_Group_translate_ranks(RAPtor_MPI_Group group1, int n,
+        const int ranks1[], RAPtor_MPI_Group group2, int ranks2[]);
 extern int RAPtor_MPI_Comm_dup(MPI_Comm comm, MPI_Comm* new_comm);
+extern int RAPtor_MPI_Comm_create_keyval(MPI_Comm_copy_attr_function* copy_fn,
+        MPI_Comm_delete_attr_function* delete_fn, int* keyval, void* extra_state);
+extern int RAPtor_MPI_Comm_get_attr(RAPtor_MPI_Comm comm, int keyval,
+        void* attribute_val, int* flag);
+extern int RAPtor_MPI_Comm_set_attr(RAPtor_MPI_Comm comm, int keyval,
+        void* attribute_val);
+extern int RAPtor_MPI_Dist_graph_create_adjacent(RAPtor_MPI_Comm comm_old,
+        int indegree, const int sources[], const int sourceweights[],
+        int outdegree, const int destinations[], const int destweights[],
+        MPI_Info info, int reorder, RAPtor_MPI_Comm* comm_dist_graph);
 
 #endif
@@ -80,31 +80,49 @@ void ParMatrix::condense_off_proc()
         return;
     }
 
-    int prev_col = -1;
+    aligned_vector<index_t> off_proc_cols(off_proc->idx2.begin(),
+            off_proc->idx2.end());
+    condense_off_proc(off_proc_cols);
+}
 
-    std::map<int, int> orig_to_new;
+/**************************************************************
+*****   ParMatrix Condense Off Proc (Global Columns)
+**************************************************************
+***** Forms off_proc_column_map from the global column of each
+***** off_proc nonzero, and replaces off_proc->idx2 with the 
+***** corresponding local columns.  Matrices with global columns
+***** that may not fit in an int (USING_BIG_INDEX) are assembled
+***** with this, leaving only local columns in idx2.
+*****
+***** Parameters
+***** -------------
+***** off_proc_cols : aligned_vector<index_t>&
+*****    Global column of each nonzero in off_proc->idx2
+**************************************************************/
+void ParMatrix::condense_off_proc(const aligned_vector<index_t>& off_proc_cols)
+{
+    off_proc_column_map.clear();
+    off_proc_num_cols = 0;
+    if (off_proc_cols.empty())
+    {
+        return;
+    }
 
-    std::copy(off_proc->idx2.begin(), off_proc->idx2.end(),
-            std::back_inserter(off_proc_column_map));
-    std::sort(off_proc_column_map.begin(), off_proc_column_map.end());
+    IntMap orig_to_new(off_proc_cols.size());
 
-    off_proc_num_cols = 0;
-    for (aligned_vector<int>::iterator it = off_proc_column_map.begin(); 
-            it != off_proc_column_map.end(); ++it)
+    off_proc_column_map.assign(off_proc_cols.begin(), off_proc_cols.end());
+    sort_unique(off_proc_column_map);
+    off_proc_num_cols = off_proc_column_map.size();
+    for (int i = 0; i < off_proc_num_cols; i++)
     {
-        if (*it != prev_col)
-        {
-            orig_to_new[*it] = off_proc_num_cols;
-            off_proc_column_map[off_proc_num_cols++] = *it;
-            prev_col = *it;
-        }
+        orig_to_new[off_proc_column_map[i]] = i;
     }
-    off_proc_column_map.resize(off_proc_num_cols);
 
-    for (aligned_vector<int>::iterator it = off_proc->idx2.begin();
-            it != off_proc->idx2.end(); ++it)
+    int n = off_proc_cols.size();
+    off_proc->idx2.resize(n);
+    for (int i = 0; i < n; i++)
     {
-        *it = orig_to_new[*it];
+        off_proc->idx2[i] = orig_to_new.find(off_proc_cols[i]);
     }
 }
 
@@ -137,12 +155,13 @@ void ParMatrix::finalize(bool create_comm)
     }
 
     // Condense columns in off_proc, storing global
-    // columns as 0-num_cols, and store mapping
-    if (off_proc->nnz)
+    // columns as 0-num_cols, and store mapping (unless
+    // already condensed from global columns)
+    if (off_proc->nnz && off_proc_column_map.empty())
     {
         condense_off_proc();
     }
-    else
+    else if (off_proc->nnz == 0)
     {
         off_proc_num_cols = 0;
     }
@@ -359,6 +378,33 @@ ParCSRMatrix* ParBSRMatrix::to_ParBSR()
 {
     return this;
 }
+void ParCSRMatrix::on_proc_to_SELL(int slice_size, int sigma)
+{
+    if (on_proc->format() != CSR) return;
+
+    SELLMatrix* on_proc_sell = new SELLMatrix((CSRMatrix*) on_proc,
+            slice_size, sigma);
+    delete on_proc;
+    on_proc = on_proc_sell;
+}
+void ParCSRMatrix::to_single_precision()
+{
+    if (on_proc->format() != CSR || off_proc->format() != CSR) return;
+
+    // Sort in double precision, as required by relaxation
+    on_proc->sort();
+    on_proc->move_diag();
+    off_proc->sort();
+
+    CSRFloatMatrix* on_proc_float = new CSRFloatMatrix((CSRMatrix*) on_proc);
+    CSRFloatMatrix* off_proc_float = new CSRFloatMatrix((CSRMatrix*) off_proc);
+    delete on_proc;
+    delete off_proc;
+    on_proc = on_proc_float;
+    off_proc = off_proc_float;
+
+    float_comm = true;
+}
 ParCSCMatrix* ParCSRMatrix::to_ParCSC()
 {
     ParCSCMatrix* A = new ParCSCMatrix();
@@ -600,6 +646,76 @@ void ParCSRMatrix::copy_helper(ParCSRMatrix* A)
     ParMatrix::copy_helper(A);
 }
 
+void ParCSRMatrix::copy_values(ParCSRMatrix* A)
+{
+    int col;
+    CSRMatrix* on = (CSRMatrix*) on_proc;
+    CSRMatrix* off = (CSRMatrix*) off_proc;
+    CSRMatrix* A_on = (CSRMatrix*) A->on_proc;
+    CSRMatrix* A_off = (CSRMatrix*) A->off_proc;
+
+    // Map columns of A to local columns of this matrix (-1 if absent)
+    IntMap global_to_on(on_proc_num_cols);
+    IntMap global_to_off(off_proc_num_cols);
+    for (int i = 0; i < on_proc_num_cols; i++)
+    {
+        global_to_on[on_proc_column_map[i]] = i;
+    }
+    for (int i = 0; i < off_proc_num_cols; i++)
+    {
+        global_to_off[off_proc_column_map[i]] = i;
+    }
+    aligned_vector<int> A_on_to_local(A->on_proc_num_cols);
+    aligned_vector<int> A_off_to_local(A->off_proc_num_cols);
+    for (int i = 0; i < A->on_proc_num_cols; i++)
+    {
+        A_on_to_local[i] = global_to_on.find(A->on_proc_column_map[i]);
+    }
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        A_off_to_local[i] = global_to_off.find(A->off_proc_column_map[i]);
+    }
+
+    // Position of each column in the current row
+    aligned_vector<int> on_pos(on_proc_num_cols, -1);
+    aligned_vector<int> off_pos(off_proc_num_cols, -1);
+    for (int i = 0; i < local_num_rows; i++)
+    {
+        for (int j = on->idx1[i]; j < on->idx1[i+1]; j++)
+        {
+            on_pos[on->idx2[j]] = j;
+            on->vals[j] = 0.0;
+        }
+        for (int j = off->idx1[i]; j < off->idx1[i+1]; j++)
+        {
+            off_pos[off->idx2[j]] = j;
+            off->vals[j] = 0.0;
+        }
+
+        for (int j = A_on->idx1[i]; j < A_on->idx1[i+1]; j++)
+        {
+            col = A_on_to_local[A_on->idx2[j]];
+            if (col >= 0 && on_pos[col] >= 0)
+                on->vals[on_pos[col]] = A_on->vals[j];
+        }
+        for (int j = A_off->idx1[i]; j < A_off->idx1[i+1]; j++)
+        {
+            col = A_off_to_local[A_off->idx2[j]];
+            if (col >= 0 && off_pos[col] >= 0)
+                off->vals[off_pos[col]] = A_off->vals[j];
+        }
+
+        for (int j = on->idx1[i]; j < on->idx1[i+1]; j++)
+        {
+            on_pos[on->idx2[j]] = -1;
+        }
+        for (int j = off->idx1[i]; j < off->idx1[i+1]; j++)
+        {
+            off_pos[off->idx2[j]] = -1;
+        }
+    }
+}
+
 void ParCSRMatrix::copy_helper(ParCSCMatrix* A)
 {
     if (on_proc)
@@ -847,20 +963,21 @@ ParCSCMatrix* ParCSCMatrix::transpose()
 ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_col_size)
 {
     int start, end, col;
-    int prev_row, prev_col;
-    int block_row, block_col;
+    index_t prev_row, prev_col;
+    index_t block_row, block_col;
     int block_pos, row_pos, col_pos;
-    int global_col, pos;
+    index_t global_col;
+    int pos;
     double val;
 
-    int global_block_rows = global_num_rows / block_row_size;
-    int global_block_cols = global_num_cols / block_col_size;
+    index_t global_block_rows = global_num_rows / block_row_size;
+    index_t global_block_cols = global_num_cols / block_col_size;
     ParBSRMatrix* A = new ParBSRMatrix(global_block_rows, global_block_cols,
             block_row_size, block_col_size);
 
     // Get local to global mappings for block matrix
     prev_row = -1;
-    for (aligned_vector<int>::iterator it = local_row_map.begin();
+    for (aligned_vector<index_t>::iterator it = local_row_map.begin();
             it != local_row_map.end(); ++it)
     {
         block_row = *it / block_row_size;
@@ -877,7 +994,7 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
     else
     {
         prev_col = -1;        
-        for (aligned_vector<int>::iterator it = on_proc_column_map.begin();
+        for (aligned_vector<index_t>::iterator it = on_proc_column_map.begin();
                 it != on_proc_column_map.end(); ++it)
         {
             block_col = *it / block_col_size;
@@ -890,8 +1007,8 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
     }
 
     prev_col = -1;
-    std::map<int, int> global_to_block_local;
-    for (aligned_vector<int>::iterator it = off_proc_column_map.begin();
+    IntMap global_to_block_local(off_proc_column_map.size());
+    for (aligned_vector<index_t>::iterator it = off_proc_column_map.begin();
             it != off_proc_column_map.end(); ++it)
     {
         block_col = *it / block_col_size;
@@ -928,8 +1045,7 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
                 {
                     on_proc_pos[block_col] = A_on_proc->idx2.size();
                     A_on_proc->idx2.emplace_back(block_col);
-                    A_on_proc->block_vals.emplace_back(
-                            new double[A_on_proc->b_size]());
+                    A_on_proc->block_vals.resize(A_on_proc->idx2.size());
                 }
                 val = on_proc->vals[k];
                 pos = on_proc_pos[block_col];
@@ -944,13 +1060,12 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
             {
                 col = off_proc->idx2[k];
                 global_col = off_proc_column_map[col];
-                block_col = global_to_block_local[global_col / block_col_size];
+                block_col = global_to_block_local.find(global_col / block_col_size);
                 if (off_proc_pos[block_col] == -1)
                 {
                     off_proc_pos[block_col] = A_off_proc->idx2.size();
                     A_off_proc->idx2.emplace_back(block_col);
-                    A_off_proc->block_vals.emplace_back(
-                            new double[A_off_proc->b_size]());
+                    A_off_proc->block_vals.resize(A_off_proc->idx2.size());
                 }
                 val = off_proc->vals[k];
                 pos = off_proc_pos[block_col];
@@ -1091,3 +1206,45 @@ void ParMatrix::init_tap_communicators(RAPtor_MPI_Comm comm)
     }
 }
 
+/**************************************************************
+*****   ParMatrix Init Neighbor Communicator
+**************************************************************
+***** Replaces the standard communication package with a
+***** NeighborComm, so that vector communication is performed
+***** with neighborhood collectives on a distributed graph 
+***** communicator.  Matrices already holding a NeighborComm
+***** are left unchanged.
+**************************************************************/
+void ParMatrix::init_neighbor_comm()
+{
+    if (comm == NULL)
+    {
+        comm = new ParComm(partition, off_proc_column_map, on_proc_column_map);
+    }
+    else if (dynamic_cast<NeighborComm*>(comm))
+    {
+        return;
+    }
+
+    ParComm* old_comm = comm;
+    comm = new NeighborComm(old_comm);
+    old_comm->delete_comm();
+}
+
+/**************************************************************
+*****   ParMatrix Init Persistent Communicator
+**************************************************************
+***** Creates persistent requests for the double vector 
+***** communication of the standard communication package, so
+***** that repeated SpMVs and sweeps reuse the same requests.
+***** NeighborComm packages already exchange values with a single
+***** collective, and are left unchanged.
+**************************************************************/
+void ParMatrix::init_persistent_comm()
+{
+    if (comm == NULL || dynamic_cast<NeighborComm*>(comm))
+        return;
+
+    comm->init_persistent_comm();
+}
+
@@ -41,7 +41,7 @@
  *****    Matrix storing local off-diagonal block
  ***** offd_num_cols : index_t
  *****    Number of columns in the off-diagonal matrix
- ***** offd_column_map : aligned_vector<int>
+ ***** offd_column_map : aligned_vector<index_t>
  *****    Maps local columns of offd Matrix to global
  ***** comm : ParComm*
  *****    Parallel communicator for matrix
@@ -91,6 +91,7 @@ namespace raptor
         comm = NULL;
         tap_comm = NULL;
         tap_mat_comm = NULL;
+        float_comm = false;
         on_proc = NULL;
         off_proc = NULL;
     }
@@ -109,6 +110,7 @@ namespace raptor
         comm = NULL;
         tap_comm = NULL;
         tap_mat_comm = NULL;
+        float_comm = false;
         on_proc = NULL;
         off_proc = NULL;
     }
@@ -125,6 +127,7 @@ namespace raptor
         comm = NULL;
         tap_comm = NULL;
         tap_mat_comm = NULL;
+        float_comm = false;
         on_proc = NULL;
         off_proc = NULL;
     }
@@ -148,6 +151,7 @@ namespace raptor
         comm = NULL;
         tap_comm = NULL;
         tap_mat_comm = NULL;
+        float_comm = false;
         on_proc = NULL;
         off_proc = NULL;
     }
@@ -163,6 +167,7 @@ namespace raptor
         comm = NULL;
         tap_comm = NULL;
         tap_mat_comm = NULL;
+        float_comm = false;
 
         on_proc = NULL;
         off_proc = NULL;
@@ -208,7 +213,7 @@ namespace raptor
     ***** value : data_t
     *****    Value to be added to parallel matrix
     **************************************************************/
-    void add_value(index_t row, index_t global_col, data_t value);
+    void add_value(int row, index_t global_col, data_t value);
 
     /**************************************************************
     *****   ParMatrix Add Global Value
@@ -226,7 +231,7 @@ namespace raptor
     ***** value : data_t
     *****    Value to be added to parallel matrix
     **************************************************************/
-    void add_global_value(int row, int global_col, double value);
+    void add_global_value(index_t row, index_t global_col, data_t value);
 
     /**************************************************************
     *****   ParMatrix Finalize
@@ -239,6 +244,7 @@ namespace raptor
 
     int* map_partition_to_local();
     void condense_off_proc();
+    void condense_off_proc(const aligned_vector<index_t>& off_proc_cols);
 
     void residual(ParVector& x, ParVector& b, ParVector& r, bool tap = false);
     void tap_residual(ParVector& x, ParVector& b, ParVector& r);
@@ -258,6 +264,8 @@ namespace raptor
     ParMatrix* subtract(ParCSRMatrix* A);
 
     void init_tap_communicators(RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD);
+    void init_neighbor_comm();
+    void init_persistent_comm();
     void update_tap_comm(ParMatrix* old, const aligned_vector<int>& old_to_new)
     {
         tap_comm = new TAPComm((TAPComm*) old->tap_comm, old_to_new, NULL);
@@ -283,17 +291,17 @@ namespace raptor
 
     virtual ParMatrix* transpose() = 0;
 
-    aligned_vector<int>& get_off_proc_column_map()
+    aligned_vector<index_t>& get_off_proc_column_map()
     {
         return off_proc_column_map;
     }
 
-    aligned_vector<int>& get_on_proc_column_map()
+    aligned_vector<index_t>& get_on_proc_column_map()
     {
         return on_proc_column_map;
     }
 
-    aligned_vector<int>& get_local_row_map()
+    aligned_vector<index_t>& get_local_row_map()
     {
         return local_row_map;
     }
@@ -313,8 +321,8 @@ namespace raptor
     // Store dimensions of parallel matrix
     int local_nnz;
     int local_num_rows;
-    int global_num_rows;
-    int global_num_cols;
+    index_t global_num_rows;
+    index_t global_num_cols;
     int off_proc_num_cols;
     int on_proc_num_cols;
 
@@ -329,9 +337,9 @@ namespace raptor
     // It will be condensed to only store columns with 
     // nonzeros, and these must be mapped to 
     // global column indices
-    aligned_vector<int> off_proc_column_map; // Maps off_proc local to global
-    aligned_vector<int> on_proc_column_map; // Maps on_proc local to global
-    aligned_vector<int> local_row_map; // Maps local rows to global
+    aligned_vector<index_t> off_proc_column_map; // Maps off_proc local to global
+    aligned_vector<index_t> on_proc_column_map; // Maps on_proc local to global
+    aligned_vector<index_t> local_row_map; // Maps local rows to global
 
     // Parallel communication package indicating which 
     // processes hold vector values associated with off_proc,
@@ -340,6 +348,10 @@ namespace raptor
     ParComm* comm;
     TAPComm* tap_comm;
     TAPComm* tap_mat_comm;
+
+    // If true, vector values are exchanged in single precision
+    // during SpMVs and relaxation
+    bool float_comm;
   };
 
   class ParCOOMatrix : public ParMatrix
@@ -430,7 +442,7 @@ namespace raptor
         off_proc = new BCOOMatrix(0, 0, 1, 1, 0);
     }
 
-    ParBCOOMatrix(int global_block_rows, int global_block_cols,
+    ParBCOOMatrix(index_t global_block_rows, index_t global_block_cols,
             int block_row_size, int block_col_size, int nnz_per_row)
         : ParCOOMatrix(global_block_rows, global_block_cols, nnz_per_row, false)
     {
@@ -440,7 +452,7 @@ namespace raptor
                 block_row_size, block_col_size, nnz_per_row);
     }
 
-    ParBCOOMatrix(int global_block_rows, int global_block_cols,
+    ParBCOOMatrix(index_t global_block_rows, index_t global_block_cols,
             int local_block_rows, int local_block_cols, 
             int first_block_row, int first_block_col,
             int block_row_size, int block_col_size, int nnz_per_row = 5) 
@@ -478,6 +490,49 @@ namespace raptor
     }
   };
 
+/**************************************************************
+ *****   ParMultPlan Class
+ **************************************************************
+ ***** Holds the structure formed by the symbolic phase of a
+ ***** parallel product (ParCSRMatrix::mult_symbolic or 
+ ***** mult_T_symbolic), so that numeric phases only refill 
+ ***** values for matrices with unchanged sparsity patterns.
+ ***** Intermediate rows use a combined local column space, in
+ ***** which off_proc column c follows the on_proc columns.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** pattern : CSRMatrix*
+ *****    Structure of the local product
+ ***** send_pattern : CSRMatrix*
+ *****    Structure of partial products sent to other processes
+ *****    (transpose products only)
+ ***** off_to_C : aligned_vector<int>
+ *****    Maps off_proc columns of the input to those of C
+ ***** global_to_C : IntMap
+ *****    Maps global off_proc columns to those of C
+ **************************************************************/
+  class ParMultPlan
+  {
+  public:
+    ParMultPlan()
+    {
+        pattern = NULL;
+        send_pattern = NULL;
+    }
+
+    ~ParMultPlan()
+    {
+        delete pattern;
+        delete send_pattern;
+    }
+
+    CSRMatrix* pattern;
+    CSRMatrix* send_pattern;
+    aligned_vector<int> off_to_C;
+    IntMap global_to_C;
+  };
+
   class ParCSRMatrix : public ParMatrix
   {
   public:
@@ -570,10 +625,53 @@ namespace raptor
 
     ParBSRMatrix* to_ParBSR(const int block_row_size, const int block_col_size);
 
+    /**************************************************************
+    *****   ParCSRMatrix On Proc To SELL
+    **************************************************************
+    ***** Converts on_proc (if in CSR format) to SELL-C-sigma
+    ***** format for faster SpMVs.  on_proc keeps its CSR arrays, so
+    ***** the matrix can still be used in setup and relaxation.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** slice_size : int
+    *****    Number of rows per slice
+    ***** sigma : int
+    *****    Number of rows in each sorting window
+    **************************************************************/
+    void on_proc_to_SELL(int slice_size = SELL_SLICE_SIZE, int sigma = SELL_SIGMA);
+
+    /**************************************************************
+    *****   ParCSRMatrix To Single Precision
+    **************************************************************
+    ***** Converts on_proc and off_proc (if in CSR format) to
+    ***** CSRFloatMatrix, storing values in single precision, and
+    ***** exchanges vector values in single precision during SpMVs
+    ***** and relaxation.  All products are still accumulated in
+    ***** double.  Intended for the solve phase only.
+    **************************************************************/
+    void to_single_precision();
+
     void copy_helper(ParCSRMatrix* A);
     void copy_helper(ParCSCMatrix* A);
     void copy_helper(ParCOOMatrix* A);
 
+    /**************************************************************
+    *****   ParCSRMatrix Copy Values
+    **************************************************************
+    ***** Overwrites values of this matrix with those of A, matched
+    ***** by global column, keeping the sparsity pattern of this
+    ***** matrix.  Entries missing from A are set to zero, and 
+    ***** entries of A outside of the pattern are dropped.  Both
+    ***** matrices must hold the same rows, in CSR format.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** A : ParCSRMatrix*
+    *****    Matrix containing the new values
+    **************************************************************/
+    void copy_values(ParCSRMatrix* A);
+
     ParCSRMatrix* strength(strength_t strength_type, double theta = 0.0, 
             bool tap_amg = false, int num_variables = 1, int* variables = NULL);
     ParCSRMatrix* aggregate();
@@ -592,6 +690,58 @@ namespace raptor
     ParCSRMatrix* mult_T(ParCSRMatrix* A, bool tap = false);
     ParCSRMatrix* tap_mult_T(ParCSCMatrix* A);
     ParCSRMatrix* tap_mult_T(ParCSRMatrix* A);
+
+    /**************************************************************
+    *****   ParCSRMatrix RAP
+    **************************************************************
+    ***** Forms the Galerkin product P^T*A*P in a single call.
+    ***** Rows of P needed for A*P are communicated while the local
+    ***** blocks of P are transposed, and partial products 
+    ***** P_off^T*A*P are communicated while P_on^T*A*P is formed.
+    ***** Both are two-pass triple products (rap_symbolic and
+    ***** rap_numeric), which form each row of AP as it is needed,
+    ***** so AP is never stored.  P's communication package is 
+    ***** reused for the transpose exchange.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** P : ParCSRMatrix*
+    *****    Interpolation operator
+    ***** tap : bool
+    *****    Use node-aware (2-step) communication
+    **************************************************************/
+    ParCSRMatrix* RAP(ParCSRMatrix* P, bool tap = false);
+
+    /**************************************************************
+    *****   ParCSRMatrix Split Products
+    **************************************************************
+    ***** Symbolic and numeric phases of C = this*B and 
+    ***** C = A^T*this.  The symbolic phase returns the product,
+    ***** with the full structural pattern (no entries dropped), 
+    ***** and fills plan.  The numeric phase communicates the 
+    ***** inputs as usual, but only refills values of C, so B (or 
+    ***** A) and this must keep the sparsity patterns they had in 
+    ***** the symbolic phase.  CSR blocks only.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** B : ParCSRMatrix*
+    *****    Matrix to right multiply by
+    ***** A : ParCSRMatrix*
+    *****    Matrix whose transpose left multiplies this
+    ***** C : ParCSRMatrix*
+    *****    Product returned by symbolic phase
+    ***** plan : ParMultPlan*
+    *****    Structure filled by symbolic phase
+    ***** tap : bool
+    *****    Use node-aware (2-step) communication
+    **************************************************************/
+    ParCSRMatrix* mult_symbolic(ParCSRMatrix* B, ParMultPlan* plan, bool tap = false);
+    void mult_numeric(ParCSRMatrix* B, ParCSRMatrix* C, ParMultPlan* plan, 
+            bool tap = false);
+    ParCSRMatrix* mult_T_symbolic(ParCSRMatrix* A, ParMultPlan* plan, bool tap = false);
+    void mult_T_numeric(ParCSRMatrix* A, ParCSRMatrix* C, ParMultPlan* plan, 
+            bool tap = false);
     ParCSRMatrix* add(ParCSRMatrix* A);
     ParCSRMatrix* subtract(ParCSRMatrix* B);
 
@@ -604,7 +754,7 @@ namespace raptor
             CSRMatrix* C_on_on, CSRMatrix* C_on_off);
     CSRMatrix* mult_T_partial(ParCSCMatrix* A);
     CSRMatrix* mult_T_partial(CSCMatrix* A_off);
-    void mult_T_combine(ParCSCMatrix* A, ParCSRMatrix* C, CSRMatrix* recv_mat,
+    void mult_T_combine(ParMatrix* A, ParCSRMatrix* C, CSRMatrix* recv_mat,
             CSRMatrix* C_on_on, CSRMatrix* C_off_on);
     
     ParCSRMatrix* transpose();
@@ -619,7 +769,7 @@ namespace raptor
         off_proc = new BSRMatrix(0, 0, 1, 1, 0);
     }
 
-    ParBSRMatrix(int global_block_rows, int global_block_cols,
+    ParBSRMatrix(index_t global_block_rows, index_t global_block_cols,
             int block_row_size, int block_col_size,
             int nnz = 0) 
         :  ParCSRMatrix(global_block_rows, global_block_cols, nnz, false)
@@ -630,7 +780,7 @@ namespace raptor
                 block_row_size, block_col_size, nnz);
     }
 
-    ParBSRMatrix(int global_block_rows, int global_block_cols, 
+    ParBSRMatrix(index_t global_block_rows, index_t global_block_cols, 
             int local_block_rows, int local_block_cols, 
             int first_block_row, int first_block_col,
             int block_row_size, int block_col_size,
@@ -666,7 +816,7 @@ namespace raptor
         finalize();
     }
 
-    ParBSRMatrix(Partition* part, int global_block_rows, int global_block_cols,
+    ParBSRMatrix(Partition* part, index_t global_block_rows, index_t global_block_cols,
             int local_block_rows, int on_proc_block_cols, int off_proc_block_cols, 
             int block_row_size, int block_col_size, int nnz = 0)
           : ParCSRMatrix(part, global_block_rows, global_block_cols,
@@ -798,7 +948,7 @@ class ParBSCMatrix : public ParCSCMatrix
         off_proc = new BSCMatrix(0, 0, 1, 1, 0);
     }
 
-    ParBSCMatrix(int global_block_rows, int global_block_cols,
+    ParBSCMatrix(index_t global_block_rows, index_t global_block_cols,
             int block_row_size, int block_col_size,
             int nnz = 0) 
         : ParCSCMatrix(global_block_rows, global_block_cols, nnz, false)
@@ -818,7 +968,7 @@ class ParBSCMatrix : public ParCSCMatrix
                 block_row_size, block_col_size, nnz);
     }
 
-    ParBSCMatrix(Partition* part, int global_block_rows, int global_block_cols,
+    ParBSCMatrix(Partition* part, index_t global_block_rows, index_t global_block_cols,
             int local_block_rows, int on_proc_block_cols, int off_proc_block_cols, 
             int block_row_size, int block_col_size, int nnz = 0)
           : ParCSCMatrix(part, global_block_rows, global_block_cols, local_block_rows, 
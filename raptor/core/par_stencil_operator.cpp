@@ -0,0 +1,633 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include <algorithm>
+
+#include "par_stencil_operator.hpp"
+#include "threads.hpp"
+
+using namespace raptor;
+
+// Lines of the padded brick are split evenly across threads (when
+// built WITH_OPENMP), calling func(first, last) on each thread
+template <typename F>
+void line_ranges(int num_lines, int nnz, F func)
+{
+#ifdef USING_OPENMP
+    int n_threads = kernel_num_threads(nnz);
+    if (n_threads > 1)
+    {
+#pragma omp parallel num_threads(n_threads)
+        {
+            int tid = omp_get_thread_num();
+            int n_t = omp_get_num_threads();
+            func((int) (((long) num_lines * tid) / n_t),
+                    (int) (((long) num_lines * (tid+1)) / n_t));
+        }
+        return;
+    }
+#endif
+    func(0, num_lines);
+}
+
+void raptor::par_stencil_proc_grid(int* grid, int dim, int num_procs, int* proc_grid)
+{
+    aligned_vector<int> factors;
+    int n = num_procs;
+    for (int f = 2; f * f <= n; f++)
+    {
+        while (n % f == 0)
+        {
+            factors.emplace_back(f);
+            n /= f;
+        }
+    }
+    if (n > 1) factors.emplace_back(n);
+
+    for (int d = 0; d < dim; d++)
+    {
+        proc_grid[d] = 1;
+    }
+    for (int i = factors.size() - 1; i >= 0; i--)
+    {
+        int max_d = 0;
+        for (int d = 1; d < dim; d++)
+        {
+            if ((double) grid[d] / proc_grid[d] > (double) grid[max_d] / proc_grid[max_d])
+            {
+                max_d = d;
+            }
+        }
+        proc_grid[max_d] *= factors[i];
+    }
+}
+
+ParStencilOperator::ParStencilOperator(data_t* stencil, int* _grid, int _dim,
+        int* _proc_grid)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    int rem, size;
+
+    dim = _dim;
+    grid.resize(dim);
+    proc_grid.resize(dim);
+    for (int d = 0; d < dim; d++)
+    {
+        grid[d] = _grid[d];
+    }
+    if (_proc_grid)
+    {
+        for (int d = 0; d < dim; d++)
+        {
+            proc_grid[d] = _proc_grid[d];
+        }
+    }
+    else
+    {
+        par_stencil_proc_grid(grid.data(), dim, num_procs, proc_grid.data());
+    }
+
+    int grid_procs = 1;
+    global_num_rows = 1;
+    for (int d = 0; d < dim; d++)
+    {
+        grid_procs *= proc_grid[d];
+        global_num_rows *= grid[d];
+    }
+    assert(grid_procs == num_procs);
+
+    // First row of each process, numbering bricks in order of rank
+    // (processor grid in lexicographic order, last dimension fastest)
+    proc_first_row.resize(num_procs + 1);
+    proc_first_row[0] = 0;
+    for (int p = 0; p < num_procs; p++)
+    {
+        size = 1;
+        rem = p;
+        for (int d = dim - 1; d >= 0; d--)
+        {
+            size *= brick_size(grid[d], proc_grid[d], rem % proc_grid[d]);
+            rem /= proc_grid[d];
+        }
+        proc_first_row[p+1] = proc_first_row[p] + size;
+    }
+
+    // Local brick : [lo, lo + n_local) in each dimension
+    lo.resize(dim);
+    n_local.resize(dim);
+    rem = rank;
+    for (int d = dim - 1; d >= 0; d--)
+    {
+        int coord = rem % proc_grid[d];
+        rem /= proc_grid[d];
+        lo[d] = brick_start(grid[d], proc_grid[d], coord);
+        n_local[d] = brick_size(grid[d], proc_grid[d], coord);
+    }
+    first_local_row = proc_first_row[rank];
+    local_num_rows = proc_first_row[rank+1] - first_local_row;
+
+    // Padded brick, with a layer of ghost points on each side
+    aligned_vector<int> pad_stride(dim);
+    int pad_size = 1;
+    for (int d = dim - 1; d >= 0; d--)
+    {
+        pad_stride[d] = pad_size;
+        pad_size *= n_local[d] + 2;
+    }
+    x_pad.resize(pad_size);
+    std::fill(x_pad.begin(), x_pad.end(), 0.0);
+
+    // Nonzero stencil entries.  As in par_stencil_grid, the entry
+    // with offset o holds the stencil value at -o.
+    int stencil_len = (int) pow(3, dim);
+    int centre = (stencil_len - 1) / 2;
+    diag = stencil[centre];
+    if (fabs(diag) <= zero_tol) diag = 0.0;
+    for (int i = 0; i < stencil_len; i++)
+    {
+        double val = stencil[stencil_len - i - 1];
+        if (i == centre || fabs(val) <= zero_tol) continue;
+
+        int s = values.size();
+        int pad_offset = 0;
+        offsets.resize((s+1)*dim);
+        rem = i;
+        for (int d = dim - 1; d >= 0; d--)
+        {
+            offsets[s*dim + d] = rem % 3 - 1;
+            pad_offset += offsets[s*dim + d] * pad_stride[d];
+            rem /= 3;
+        }
+        pad_offsets.emplace_back(pad_offset);
+        values.emplace_back(val);
+    }
+    int num_entries = values.size();
+
+    // Entries grouped by their offset in all but the last dimension,
+    // each group holding values at offsets -1, 0, and 1 of the last
+    // dimension, so that one pass over a line applies three entries
+    for (int s = -1; s < num_entries; s++)
+    {
+        int last = s < 0 ? 0 : offsets[s*dim + dim - 1];
+        int line_offset = (s < 0 ? 0 : pad_offsets[s]) - last;
+        double val = s < 0 ? diag : values[s];
+        if (val == 0.0) continue;
+
+        int g = 0;
+        int num_groups = line_offsets.size();
+        while (g < num_groups && line_offsets[g] != line_offset) g++;
+        if (g == num_groups)
+        {
+            line_offsets.emplace_back(line_offset);
+            line_vals.resize(3*(g+1), 0.0);
+        }
+        line_vals[3*g + last + 1] = val;
+    }
+
+    // Lines of the last dimension, which are contiguous in both the
+    // local vector and the padded brick
+    line_len = n_local[dim-1];
+    int num_lines = line_len ? local_num_rows / line_len : 0;
+    line_pos.resize(num_lines);
+    for (int l = 0; l < num_lines; l++)
+    {
+        int pos = 1;
+        rem = l;
+        for (int d = dim - 2; d >= 0; d--)
+        {
+            pos += (rem % n_local[d] + 1) * pad_stride[d];
+            rem /= n_local[d];
+        }
+        line_pos[l] = pos;
+    }
+
+    // Find ghost points the stencil reaches, and rows that need them
+    aligned_vector<index_t> pad_global(pad_size, -1);
+    aligned_vector<int> x(dim);
+    aligned_vector<int> y(dim);
+    bool in_grid, on_proc, boundary;
+    for (int i = 0; i < local_num_rows; i++)
+    {
+        rem = i;
+        for (int d = dim - 1; d >= 0; d--)
+        {
+            x[d] = lo[d] + rem % n_local[d];
+            rem /= n_local[d];
+        }
+        int pos = line_pos[i / line_len] + i % line_len;
+
+        boundary = false;
+        for (int s = 0; s < num_entries; s++)
+        {
+            in_grid = true;
+            on_proc = true;
+            for (int d = 0; d < dim; d++)
+            {
+                y[d] = x[d] + offsets[s*dim + d];
+                if (y[d] < 0 || y[d] >= grid[d])
+                {
+                    in_grid = false;
+                    break;
+                }
+                if (y[d] < lo[d] || y[d] >= lo[d] + n_local[d])
+                {
+                    on_proc = false;
+                }
+            }
+            if (!in_grid || on_proc) continue;
+
+            boundary = true;
+            if (pad_global[pos + pad_offsets[s]] < 0)
+            {
+                pad_global[pos + pad_offsets[s]] = global_index(y.data());
+            }
+        }
+        if (boundary) boundary_rows.emplace_back(i);
+        else interior_rows.emplace_back(i);
+    }
+
+    // Ghost points are received in order of global index
+    aligned_vector<std::pair<index_t, int>> ghosts;
+    for (int pos = 0; pos < pad_size; pos++)
+    {
+        if (pad_global[pos] >= 0)
+        {
+            ghosts.emplace_back(std::make_pair(pad_global[pos], pos));
+        }
+    }
+    std::sort(ghosts.begin(), ghosts.end());
+    off_proc_column_map.resize(ghosts.size());
+    ghost_pos.resize(ghosts.size());
+    for (int i = 0; i < (int) ghosts.size(); i++)
+    {
+        off_proc_column_map[i] = ghosts[i].first;
+        ghost_pos[i] = ghosts[i].second;
+    }
+
+    partition = new Partition(global_num_rows, global_num_rows,
+            local_num_rows, local_num_rows, first_local_row, first_local_row);
+    comm = new ParComm(partition, off_proc_column_map);
+}
+
+// Global (brick ordered) index of grid point y
+index_t ParStencilOperator::global_index(const int* y)
+{
+    int proc = 0;
+    index_t col = 0;
+    for (int d = 0; d < dim; d++)
+    {
+        int part = brick_part(grid[d], proc_grid[d], y[d]);
+        proc = proc * proc_grid[d] + part;
+        col = col * brick_size(grid[d], proc_grid[d], part)
+            + y[d] - brick_start(grid[d], proc_grid[d], part);
+    }
+    return proc_first_row[proc] + col;
+}
+
+// Copies x into the padded brick, and ghost points from the halo
+void ParStencilOperator::gather_x(ParVector& x)
+{
+    int num_lines = line_pos.size();
+    const double* x_vals = x.local.data();
+    double* pad = x_pad.data();
+
+    comm->init_comm(x);
+    for (int l = 0; l < num_lines; l++)
+    {
+        std::copy(x_vals + l*line_len, x_vals + (l+1)*line_len,
+                pad + line_pos[l]);
+    }
+
+    aligned_vector<double>& dist_x = comm->complete_comm<double>();
+    for (int i = 0; i < (int) ghost_pos.size(); i++)
+    {
+        pad[ghost_pos[i]] = dist_x[i];
+    }
+}
+
+// out = init + alpha * A * x_pad (init is zero if NULL, and may be out)
+void ParStencilOperator::apply(double* out, const double* init, double alpha)
+{
+    int num_lines = line_pos.size();
+    int num_groups = line_offsets.size();
+    const double* pad = x_pad.data();
+    profile_add_flops(2.0 * local_num_rows * (values.size() + 1));
+    profile_add_nnz(((double) local_num_rows) * (values.size() + 1));
+
+    line_ranges(num_lines, local_num_rows * (values.size() + 1),
+            [&](int first, int last)
+    {
+        for (int l = first; l < last; l++)
+        {
+            double* out_l = out + l*line_len;
+            const double* x_l = pad + line_pos[l];
+            if (init)
+            {
+                const double* init_l = init + l*line_len;
+                RAPTOR_SIMD
+                for (int k = 0; k < line_len; k++)
+                {
+                    out_l[k] = init_l[k];
+                }
+            }
+            else
+            {
+                RAPTOR_SIMD
+                for (int k = 0; k < line_len; k++)
+                {
+                    out_l[k] = 0.0;
+                }
+            }
+
+            for (int g = 0; g < num_groups; g++)
+            {
+                const double* x_g = x_l + line_offsets[g];
+                const double w0 = alpha * line_vals[3*g];
+                const double w1 = alpha * line_vals[3*g + 1];
+                const double w2 = alpha * line_vals[3*g + 2];
+                if (w0 == 0.0 && w2 == 0.0)
+                {
+                    RAPTOR_SIMD
+                    for (int k = 0; k < line_len; k++)
+                    {
+                        out_l[k] += w1 * x_g[k];
+                    }
+                }
+                else
+                {
+                    RAPTOR_SIMD
+                    for (int k = 0; k < line_len; k++)
+                    {
+                        out_l[k] += w0 * x_g[k-1] + w1 * x_g[k] + w2 * x_g[k+1];
+                    }
+                }
+            }
+        }
+    });
+}
+
+void ParStencilOperator::mult(ParVector& x, ParVector& b)
+{
+    gather_x(x);
+    apply(b.local.data(), NULL, 1.0);
+}
+
+void ParStencilOperator::mult_append(ParVector& x, ParVector& b)
+{
+    gather_x(x);
+    apply(b.local.data(), b.local.data(), 1.0);
+}
+
+void ParStencilOperator::residual(ParVector& x, ParVector& b, ParVector& r)
+{
+    gather_x(x);
+    apply(r.local.data(), b.local.data(), -1.0);
+}
+
+// x += omega * (b - A*x) * scale, where scale holds the inverse of
+// each row's diagonal (or l1 norm), or is NULL to use 1 / diag
+void ParStencilOperator::jacobi_helper(ParVector& x, ParVector& b, ParVector& tmp,
+        int num_sweeps, double omega, const double* scale)
+{
+    double* x_vals = x.local.data();
+    const double* r_vals = tmp.local.data();
+    double inv_diag = fabs(diag) < zero_tol ? 0.0 : 1.0 / diag;
+
+    for (int iter = 0; iter < num_sweeps; iter++)
+    {
+        gather_x(x);
+        apply(tmp.local.data(), b.local.data(), -1.0);
+        if (scale)
+        {
+            RAPTOR_SIMD
+            for (int i = 0; i < local_num_rows; i++)
+            {
+                x_vals[i] += omega * r_vals[i] * scale[i];
+            }
+        }
+        else
+        {
+            RAPTOR_SIMD
+            for (int i = 0; i < local_num_rows; i++)
+            {
+                x_vals[i] += omega * r_vals[i] * inv_diag;
+            }
+        }
+    }
+}
+
+void ParStencilOperator::jacobi(ParVector& x, ParVector& b, ParVector& tmp,
+        int num_sweeps, double omega)
+{
+    jacobi_helper(x, b, tmp, num_sweeps, omega, NULL);
+}
+
+void ParStencilOperator::l1_jacobi(ParVector& x, ParVector& b, ParVector& tmp,
+        int num_sweeps, double omega)
+{
+    int num_entries = values.size();
+    if ((int) l1_diag.size() < local_num_rows)
+    {
+        // Inverse of a_ii + sum_{j != i} |a_ij|, over the neighbors
+        // of each point that lie in the grid
+        aligned_vector<int> y(dim);
+        l1_diag.resize(local_num_rows);
+        for (int i = 0; i < local_num_rows; i++)
+        {
+            int rem = i;
+            for (int d = dim - 1; d >= 0; d--)
+            {
+                y[d] = lo[d] + rem % n_local[d];
+                rem /= n_local[d];
+            }
+
+            double row_l1 = diag;
+            for (int s = 0; s < num_entries; s++)
+            {
+                bool in_grid = true;
+                for (int d = 0; d < dim; d++)
+                {
+                    int y_d = y[d] + offsets[s*dim + d];
+                    if (y_d < 0 || y_d >= grid[d])
+                    {
+                        in_grid = false;
+                        break;
+                    }
+                }
+                if (in_grid) row_l1 += fabs(values[s]);
+            }
+            l1_diag[i] = (diag == 0.0 || fabs(row_l1) < zero_tol) ? 0.0 : 1.0 / row_l1;
+        }
+    }
+
+    jacobi_helper(x, b, tmp, num_sweeps, omega, l1_diag.data());
+}
+
+// Gauss-Seidel update of row i, in place in the padded brick
+inline void ParStencilOperator::gs_point(int i, const double* b, double omega)
+{
+    int num_entries = values.size();
+    int pos = line_pos[i / line_len] + i % line_len;
+    double* x_i = x_pad.data() + pos;
+
+    double row_sum = 0;
+    for (int s = 0; s < num_entries; s++)
+    {
+        row_sum += values[s] * x_i[pad_offsets[s]];
+    }
+    *x_i = ((1.0 - omega) * (*x_i)) + (omega * ((b[i] - row_sum) / diag));
+}
+
+// Hybrid Gauss-Seidel, relaxing interior rows while the halo is in
+// flight, then boundary rows (the order of hybrid_gs on to_ParCSR)
+void ParStencilOperator::gs_helper(ParVector& x, ParVector& b, int num_sweeps,
+        double omega, bool symmetric)
+{
+    // Rows without a diagonal are not relaxed
+    if (diag == 0.0) return;
+
+    int num_lines = line_pos.size();
+    int n_interior = interior_rows.size();
+    int n_boundary = boundary_rows.size();
+    double* x_vals = x.local.data();
+    const double* b_vals = b.local.data();
+    double* pad = x_pad.data();
+    int num_passes = symmetric ? 2 * num_sweeps : num_sweeps;
+    profile_add_flops(2.0 * num_passes * local_num_rows * (values.size() + 1));
+    profile_add_nnz(((double) num_passes) * local_num_rows * (values.size() + 1));
+
+    for (int iter = 0; iter < num_sweeps; iter++)
+    {
+        comm->init_comm(x);
+        for (int l = 0; l < num_lines; l++)
+        {
+            std::copy(x_vals + l*line_len, x_vals + (l+1)*line_len,
+                    pad + line_pos[l]);
+        }
+
+        for (int i = 0; i < n_interior; i++)
+        {
+            gs_point(interior_rows[i], b_vals, omega);
+        }
+
+        aligned_vector<double>& dist_x = comm->complete_comm<double>();
+        for (int i = 0; i < (int) ghost_pos.size(); i++)
+        {
+            pad[ghost_pos[i]] = dist_x[i];
+        }
+
+        for (int i = 0; i < n_boundary; i++)
+        {
+            gs_point(boundary_rows[i], b_vals, omega);
+        }
+        if (symmetric)
+        {
+            for (int i = n_boundary - 1; i >= 0; i--)
+            {
+                gs_point(boundary_rows[i], b_vals, omega);
+            }
+            for (int i = n_interior - 1; i >= 0; i--)
+            {
+                gs_point(interior_rows[i], b_vals, omega);
+            }
+        }
+
+        for (int l = 0; l < num_lines; l++)
+        {
+            std::copy(pad + line_pos[l], pad + line_pos[l] + line_len,
+                    x_vals + l*line_len);
+        }
+    }
+}
+
+void ParStencilOperator::hybrid_gs(ParVector& x, ParVector& b, ParVector& tmp,
+        int num_sweeps, double omega)
+{
+    gs_helper(x, b, num_sweeps, omega, false);
+}
+
+void ParStencilOperator::hybrid_sgs(ParVector& x, ParVector& b, ParVector& tmp,
+        int num_sweeps, double omega)
+{
+    gs_helper(x, b, num_sweeps, omega, true);
+}
+
+ParCSRMatrix* ParStencilOperator::to_ParCSR()
+{
+    int num_entries = values.size();
+    ParCSRMatrix* A = new ParCSRMatrix(partition);
+    A->on_proc->idx2.reserve(local_num_rows * (num_entries + 1));
+    A->on_proc->vals.reserve(local_num_rows * (num_entries + 1));
+
+    // Add each stencil entry, holding global columns of off_proc
+    // nonzeros until they are condensed
+    aligned_vector<index_t> off_proc_cols;
+    aligned_vector<int> x(dim);
+    aligned_vector<int> y(dim);
+    bool in_grid, on_proc;
+    int rem, col;
+    A->on_proc->idx1[0] = 0;
+    A->off_proc->idx1[0] = 0;
+    for (int i = 0; i < local_num_rows; i++)
+    {
+        rem = i;
+        for (int d = dim - 1; d >= 0; d--)
+        {
+            x[d] = lo[d] + rem % n_local[d];
+            rem /= n_local[d];
+        }
+
+        if (diag != 0.0)
+        {
+            A->on_proc->add_value(i, i, diag);
+        }
+        for (int s = 0; s < num_entries; s++)
+        {
+            in_grid = true;
+            on_proc = true;
+            col = 0;
+            for (int d = 0; d < dim; d++)
+            {
+                y[d] = x[d] + offsets[s*dim + d];
+                if (y[d] < 0 || y[d] >= grid[d])
+                {
+                    in_grid = false;
+                    break;
+                }
+                if (y[d] < lo[d] || y[d] >= lo[d] + n_local[d])
+                {
+                    on_proc = false;
+                }
+                col = col * n_local[d] + y[d] - lo[d];
+            }
+            if (!in_grid) continue;
+
+            if (on_proc)
+            {
+                A->on_proc->add_value(i, col, values[s]);
+            }
+            else
+            {
+                A->off_proc->add_value(i, 0, values[s]);
+                off_proc_cols.emplace_back(global_index(y.data()));
+            }
+        }
+        A->on_proc->idx1[i+1] = A->on_proc->idx2.size();
+        A->off_proc->idx1[i+1] = A->off_proc->idx2.size();
+    }
+
+    A->on_proc->nnz = A->on_proc->idx2.size();
+    A->off_proc->nnz = A->off_proc->idx2.size();
+    A->condense_off_proc(off_proc_cols);
+    A->finalize(false);
+
+    // Columns of A are the points of the halo, so its communication
+    // package is the halo exchange
+    assert(A->off_proc_column_map.size() == off_proc_column_map.size());
+    A->comm = comm;
+    comm->num_shared++;
+
+    return A;
+}
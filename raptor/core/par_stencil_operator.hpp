@@ -0,0 +1,221 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_CORE_PARSTENCILOPERATOR_HPP
+#define RAPTOR_CORE_PARSTENCILOPERATOR_HPP
+
+#include "types.hpp"
+#include "par_vector.hpp"
+#include "par_matrix.hpp"
+
+/**************************************************************
+ *****   ParStencilOperator Class
+ **************************************************************
+ ***** Matrix-free parallel operator for a constant coefficient
+ ***** stencil on a structured grid.  Each process holds a brick
+ ***** of the processor grid proc_grid, with rows numbered as in
+ ***** par_stencil_grid(stencil, grid, dim, proc_grid), so that
+ ***** vectors and the materialized matrix (to_ParCSR) share one
+ ***** partition.  Values of x are copied into a padded local
+ ***** brick holding a single layer of ghost points, filled by
+ ***** halo exchange (ghost points outside of the grid stay zero),
+ ***** and every kernel applies the stencil along contiguous lines
+ ***** of the last dimension, so inner loops vectorize.  No matrix
+ ***** is stored, so each row costs only its vector entries.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** dim : int
+ *****    Number of dimensions
+ ***** grid : aligned_vector<int>
+ *****    Number of points in each dimension
+ ***** proc_grid : aligned_vector<int>
+ *****    Number of processes in each dimension
+ ***** global_num_rows : index_t
+ *****    Number of points in the grid
+ ***** local_num_rows : int
+ *****    Number of points in the local brick
+ ***** first_local_row : index_t
+ *****    Global index of the first point of the local brick
+ ***** partition : Partition*
+ *****    Row partition, shared with matrices from to_ParCSR
+ ***** comm : ParComm*
+ *****    Halo exchange of the off-process points each local
+ *****    stencil reaches
+ ***** off_proc_column_map : aligned_vector<index_t>
+ *****    Global indices of the ghost points received by comm
+ *****
+ ***** Methods
+ ***** -------
+ ***** mult(x, b)
+ *****    b = A*x
+ ***** mult_append(x, b)
+ *****    b += A*x
+ ***** residual(x, b, r)
+ *****    r = b - A*x
+ ***** jacobi(x, b, tmp, num_sweeps, omega)
+ ***** l1_jacobi(x, b, tmp, num_sweeps, omega)
+ ***** hybrid_gs(x, b, tmp, num_sweeps, omega)
+ ***** hybrid_sgs(x, b, tmp, num_sweeps, omega)
+ *****    Relaxation sweeps, matching those of util/linalg/par_relax
+ *****    on the materialized matrix (single threaded)
+ ***** to_ParCSR()
+ *****    Returns the operator as a ParCSRMatrix, for setup phases
+ *****    (strength, splitting, interpolation) that need a matrix
+ **************************************************************/
+namespace raptor
+{
+    // Number of points in part p, when n points are split into P parts
+    inline int brick_size(int n, int P, int p)
+    {
+        return n / P + (p < n % P);
+    }
+
+    // First point in part p, when n points are split into P parts
+    inline int brick_start(int n, int P, int p)
+    {
+        int extra = n % P;
+        return p * (n / P) + (p < extra ? p : extra);
+    }
+
+    // Part holding point x, when n points are split into P parts
+    inline int brick_part(int n, int P, int x)
+    {
+        int q = n / P;
+        int extra = n % P;
+        if (x < extra * (q + 1))
+        {
+            return x / (q + 1);
+        }
+        return extra + (x - extra * (q + 1)) / q;
+    }
+
+    /**************************************************************
+    *****   Par Stencil Proc Grid
+    **************************************************************
+    ***** Chooses a processor grid for a structured grid, assigning
+    ***** the prime factors of num_procs (largest first) to the
+    ***** dimension with the most points per process, so that
+    ***** subdomains are as close to cubes as possible
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** grid : int*
+    *****    Number of points in each dimension
+    ***** dim : int
+    *****    Number of dimensions
+    ***** num_procs : int
+    *****    Number of processes
+    ***** proc_grid : int*
+    *****    Returned holding number of processes in each dimension
+    **************************************************************/
+    void par_stencil_proc_grid(int* grid, int dim, int num_procs, int* proc_grid);
+
+    class ParStencilOperator
+    {
+    public:
+        /**************************************************************
+        *****   ParStencilOperator Class Constructor
+        **************************************************************
+        ***** Sets up the padded brick and halo exchange of a stencil
+        ***** on a structured grid
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** stencil : data_t*
+        *****    Stencil of length 3^dim (copied)
+        ***** grid : int*
+        *****    Number of points in each dimension
+        ***** dim : int
+        *****    Number of dimensions
+        ***** proc_grid : int* (optional)
+        *****    Number of processes in each dimension, with product
+        *****    equal to num_procs (default par_stencil_proc_grid)
+        **************************************************************/
+        ParStencilOperator(data_t* stencil, int* grid, int dim,
+                int* proc_grid = NULL);
+
+        ~ParStencilOperator()
+        {
+            if (comm) comm->delete_comm();
+
+            if (partition->num_shared)
+            {
+                partition->num_shared--;
+            }
+            else
+            {
+                delete partition;
+            }
+        }
+
+        void mult(ParVector& x, ParVector& b);
+        void mult_append(ParVector& x, ParVector& b);
+        void residual(ParVector& x, ParVector& b, ParVector& r);
+
+        void jacobi(ParVector& x, ParVector& b, ParVector& tmp,
+                int num_sweeps = 1, double omega = 1.0);
+        void l1_jacobi(ParVector& x, ParVector& b, ParVector& tmp,
+                int num_sweeps = 1, double omega = 1.0);
+        void hybrid_gs(ParVector& x, ParVector& b, ParVector& tmp,
+                int num_sweeps = 1, double omega = 1.0);
+        void hybrid_sgs(ParVector& x, ParVector& b, ParVector& tmp,
+                int num_sweeps = 1, double omega = 1.0);
+
+        ParCSRMatrix* to_ParCSR();
+
+        int dim;
+        aligned_vector<int> grid;
+        aligned_vector<int> proc_grid;
+        index_t global_num_rows;
+        int local_num_rows;
+        index_t first_local_row;
+
+        Partition* partition;
+        ParComm* comm;
+        aligned_vector<index_t> off_proc_column_map;
+
+    protected:
+        void gather_x(ParVector& x);
+        void apply(double* out, const double* init, double alpha);
+        void jacobi_helper(ParVector& x, ParVector& b, ParVector& tmp,
+                int num_sweeps, double omega, const double* scale);
+        void gs_helper(ParVector& x, ParVector& b, int num_sweeps,
+                double omega, bool symmetric);
+        void gs_point(int i, const double* b, double omega);
+        index_t global_index(const int* y);
+
+        // First row of each process, and bounds of local brick
+        aligned_vector<index_t> proc_first_row;
+        aligned_vector<int> lo;
+        aligned_vector<int> n_local;
+
+        // Centre of stencil, and offsets (in each dimension and in
+        // the padded brick) and values of its nonzero off-diagonals
+        double diag;
+        aligned_vector<int> offsets;
+        aligned_vector<int> pad_offsets;
+        aligned_vector<double> values;
+
+        // Stencil (diagonal included) grouped along the last dimension:
+        // offset in the padded brick of each group's middle entry, and
+        // values at offsets -1, 0, and 1 of the last dimension
+        aligned_vector<int> line_offsets;
+        aligned_vector<double> line_vals;
+
+        // Padded brick, position of first point of each line of the
+        // last dimension, and positions of received ghost points
+        aligned_vector<double> x_pad;
+        aligned_vector<int> line_pos;
+        int line_len;
+        aligned_vector<int> ghost_pos;
+
+        // Rows with no off-process neighbors, and the rest (relaxed
+        // after the halo arrives), and l1 row norms (formed on first
+        // use by l1_jacobi)
+        aligned_vector<int> interior_rows;
+        aligned_vector<int> boundary_rows;
+        aligned_vector<double> l1_diag;
+    };
+}
+
+#endif
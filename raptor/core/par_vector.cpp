@@ -121,3 +121,56 @@ data_t ParVector::inner_product(ParVector& x)
 }
 
 
+
+/**************************************************************
+*****   Vector Local Inner Products
+**************************************************************
+***** Calculates the local portions of the n inner products 
+***** (this, y[i]) in a single pass over the local vectors
+**************************************************************/
+void ParVector::local_inner_products(int n, ParVector** y, data_t* results)
+{
+    aligned_vector<data_t*> y_vals(n);
+    for (int k = 0; k < n; k++)
+    {
+        if (local_n != y[k]->local_n)
+        {
+            printf("Error.  Cannot perform inner product.  Dimensions do not match.\n");
+            exit(-1);
+        }
+        y_vals[k] = y[k]->local.data();
+        results[k] = 0.0;
+    }
+
+    data_t* vals = local.data();
+    data_t val;
+    for (int i = 0; i < local_n; i++)
+    {
+        val = vals[i];
+        for (int k = 0; k < n; k++)
+        {
+            results[k] += val * y_vals[k][i];
+        }
+    }
+}
+
+void ParVector::inner_products(int n, ParVector** y, data_t* results)
+{
+    local_inner_products(n, y, results);
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, results, n, RAPtor_MPI_DATA_T, 
+            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+}
+
+void ParVector::init_inner_products(int n, ParVector** y, data_t* results,
+        RAPtor_MPI_Request* request)
+{
+    local_inner_products(n, y, results);
+    RAPtor_MPI_Iallreduce(RAPtor_MPI_IN_PLACE, results, n, RAPtor_MPI_DATA_T, 
+            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD, request);
+}
+
+void ParVector::complete_inner_products(RAPtor_MPI_Request* request)
+{
+    RAPtor_MPI_Wait(request, RAPtor_MPI_STATUS_IGNORE);
+}
+
@@ -38,6 +38,8 @@
  *****    Multiplies entries of the local vector by a constant
  ***** norm(index_t p)
  *****    Calculates the p-norm of the global vector
+ ***** inner_products(int n, ParVector** y, data_t* results)
+ *****    Calculates n inner products with a single reduction
  **************************************************************/
 namespace raptor
 {
@@ -160,6 +162,50 @@ namespace raptor
 
         data_t inner_product(ParVector& x);        
 
+        /**************************************************************
+        *****   Vector Multiple Inner Products
+        **************************************************************
+        ***** Calculates the n inner products (this, y[i]), computing 
+        ***** all local contributions in a single pass over the vectors
+        ***** and reducing them with one Allreduce.  Passing this 
+        ***** vector in y gives its squared 2-norm.
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** n : int
+        *****    Number of inner products
+        ***** y : ParVector**
+        *****    Vectors to be multiplied with this vector
+        ***** results : data_t*
+        *****    Array of size n in which inner products are returned
+        **************************************************************/
+        void inner_products(int n, ParVector** y, data_t* results);
+
+        /**************************************************************
+        *****   Vector Initialize Multiple Inner Products
+        **************************************************************
+        ***** Computes the n local inner products (this, y[i]) and
+        ***** starts a non-blocking reduction of them.  The global
+        ***** inner products are in results once 
+        ***** complete_inner_products(request) returns.
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** n : int
+        *****    Number of inner products
+        ***** y : ParVector**
+        *****    Vectors to be multiplied with this vector
+        ***** results : data_t*
+        *****    Array of size n, must not be modified until completed
+        ***** request : RAPtor_MPI_Request*
+        *****    Request handle for the reduction
+        **************************************************************/
+        void init_inner_products(int n, ParVector** y, data_t* results,
+                RAPtor_MPI_Request* request);
+        void complete_inner_products(RAPtor_MPI_Request* request);
+
+        void local_inner_products(int n, ParVector** y, data_t* results);
+
         const data_t& operator[](const int index) const
         {
             return local.values[index];
@@ -171,7 +217,7 @@ namespace raptor
         }
 
         Vector local;
-        int global_n;
+        index_t global_n;
         int local_n;
     };
 
@@ -0,0 +1,471 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "profiler.hpp"
+#include "mpi_types.hpp"
+
+#include <map>
+#include <vector>
+
+bool profile = false;
+
+using namespace raptor;
+
+namespace
+{
+    const char* counter_names[num_profile_counters] = {"time", "collective",
+        "p2p", "vec_comm", "mat_comm", "new_comm", "calls", "msgs",
+        "bytes_sent", "bytes_recv", "flops", "nnz"};
+
+    struct ProfileNode
+    {
+        ProfileNode(const std::string& _name, int _level)
+            : name(_name), level(_level), counters(num_profile_counters, 0.0)
+        {
+        }
+        ~ProfileNode()
+        {
+            for (int i = 0; i < (int) children.size(); i++)
+                delete children[i];
+        }
+
+        ProfileNode* child(const std::string& child_name, int child_level)
+        {
+            for (int i = 0; i < (int) children.size(); i++)
+            {
+                if (children[i]->level == child_level
+                        && children[i]->name == child_name)
+                    return children[i];
+            }
+            children.push_back(new ProfileNode(child_name, child_level));
+            return children.back();
+        }
+
+        std::string name;
+        int level;
+        std::vector<double> counters;
+        std::vector<ProfileNode*> children;
+    };
+
+    // Root of the registry, open regions (root first) with the times
+    // they were entered, and nesting depth and start time of each
+    // time counter
+    ProfileNode root("total", -1);
+    std::vector<ProfileNode*> open_nodes;
+    std::vector<double> open_times;
+    int timer_depth[num_profile_counters];
+    double timer_start[num_profile_counters];
+    profile_counter_t wait_counter = ProfileP2P;
+
+    void clear_node(ProfileNode* node)
+    {
+        for (int i = 0; i < (int) node->children.size(); i++)
+            delete node->children[i];
+        node->children.clear();
+        std::fill(node->counters.begin(), node->counters.end(), 0.0);
+    }
+
+    void scale_node(ProfileNode* node, double scale)
+    {
+        for (int i = 0; i < num_profile_counters; i++)
+            node->counters[i] *= scale;
+        for (int i = 0; i < (int) node->children.size(); i++)
+            scale_node(node->children[i], scale);
+    }
+
+    // Path of each region, as names (with ":level" appended for
+    // regions of a level) joined by '/', in preorder
+    void flatten(ProfileNode* node, const std::string& parent,
+            std::vector<std::string>& paths, std::vector<double>& values)
+    {
+        std::string path = parent.empty() ? node->name : parent + "/" + node->name;
+        if (node->level >= 0) path += ":" + std::to_string(node->level);
+        paths.push_back(path);
+        values.insert(values.end(), node->counters.begin(), node->counters.end());
+        for (int i = 0; i < (int) node->children.size(); i++)
+            flatten(node->children[i], path, paths, values);
+    }
+
+    // Region of the reduced registry, holding min, max, and sum over
+    // all processes of every counter
+    struct ReducedNode
+    {
+        ReducedNode(const std::string& _name, int _level)
+            : name(_name), level(_level), num_procs(0),
+              min(num_profile_counters, 0.0), max(num_profile_counters, 0.0),
+              sum(num_profile_counters, 0.0)
+        {
+        }
+        ~ReducedNode()
+        {
+            for (int i = 0; i < (int) children.size(); i++)
+                delete children[i];
+        }
+
+        std::string name;
+        int level;
+        int num_procs;
+        std::vector<double> min;
+        std::vector<double> max;
+        std::vector<double> sum;
+        std::vector<ReducedNode*> children;
+        std::map<std::string, ReducedNode*> child_map;
+    };
+
+    ReducedNode* find_reduced(ReducedNode* reduced_root, const std::string& path)
+    {
+        ReducedNode* node = reduced_root;
+        size_t start = path.find('/');
+        while (start != std::string::npos)
+        {
+            size_t end = path.find('/', start + 1);
+            std::string part = path.substr(start + 1,
+                    end == std::string::npos ? std::string::npos : end - start - 1);
+            std::map<std::string, ReducedNode*>::iterator it = node->child_map.find(part);
+            if (it == node->child_map.end())
+            {
+                size_t pos = part.rfind(':');
+                ReducedNode* child = pos == std::string::npos
+                    ? new ReducedNode(part, -1)
+                    : new ReducedNode(part.substr(0, pos), std::stoi(part.substr(pos + 1)));
+                node->children.push_back(child);
+                node->child_map[part] = child;
+                node = child;
+            }
+            else node = it->second;
+            start = end;
+        }
+        return node;
+    }
+
+    // Broadcasts the paths held by root, appending those missing from
+    // region_paths (and their positions in region_index)
+    void bcast_paths(int root, const std::vector<std::string>& paths,
+            std::vector<std::string>& region_paths,
+            std::map<std::string, int>& region_index)
+    {
+        int rank;
+        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+
+        std::string names;
+        if (rank == root)
+        {
+            for (int i = 0; i < (int) paths.size(); i++)
+            {
+                names += paths[i];
+                names += '\n';
+            }
+        }
+        int size = names.size();
+        RAPtor_MPI_Bcast(&size, 1, RAPtor_MPI_INT, root, RAPtor_MPI_COMM_WORLD);
+        names.resize(size);
+        RAPtor_MPI_Bcast(&names[0], size, RAPtor_MPI_CHAR, root, RAPtor_MPI_COMM_WORLD);
+
+        int start = 0;
+        for (int i = 0; i < size; i++)
+        {
+            if (names[i] != '\n') continue;
+            std::string path = names.substr(start, i - start);
+            start = i + 1;
+            if (region_index.find(path) == region_index.end())
+            {
+                region_index[path] = region_paths.size();
+                region_paths.push_back(path);
+            }
+        }
+    }
+
+    // Reduces the registry of every process onto rank 0, returning
+    // the reduced registry on rank 0 (and NULL elsewhere).  The set of
+    // regions is agreed on first (those of rank 0, followed by any
+    // held only by other processes), so that the counters of every 
+    // region are reduced with a single MIN, MAX, and SUM reduction
+    ReducedNode* reduce_profile(int* num_procs_ptr)
+    {
+        int rank, num_procs;
+        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+        *num_procs_ptr = num_procs;
+
+        // Communication of the reduction itself is not recorded
+        bool profiling = profile;
+        profile = false;
+
+        std::vector<std::string> paths;
+        std::vector<double> values;
+        flatten(&root, "", paths, values);
+
+        // Regions of rank 0, then those of the lowest remaining process 
+        // holding regions not yet in the set (usually none)
+        std::vector<std::string> region_paths;
+        std::map<std::string, int> region_index;
+        bcast_paths(0, paths, region_paths, region_index);
+        while (1)
+        {
+            int missing_rank = num_procs;
+            for (int i = 0; i < (int) paths.size(); i++)
+            {
+                if (region_index.find(paths[i]) == region_index.end())
+                {
+                    missing_rank = rank;
+                    break;
+                }
+            }
+            RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &missing_rank, 1, RAPtor_MPI_INT,
+                    RAPtor_MPI_MIN, RAPtor_MPI_COMM_WORLD);
+            if (missing_rank == num_procs) break;
+            bcast_paths(missing_rank, paths, region_paths, region_index);
+        }
+
+        // Regions missing on a process count as zero there
+        int n_regions = region_paths.size();
+        int n_values = n_regions * num_profile_counters;
+        std::vector<double> local_values(n_values, 0.0);
+        std::vector<int> region_procs(n_regions, 0);
+        for (int i = 0; i < (int) paths.size(); i++)
+        {
+            int idx = region_index[paths[i]];
+            region_procs[idx] = 1;
+            std::copy(&values[i * num_profile_counters],
+                    &values[(i + 1) * num_profile_counters],
+                    &local_values[idx * num_profile_counters]);
+        }
+
+        std::vector<double> min_values(n_values);
+        std::vector<double> max_values(n_values);
+        std::vector<double> sum_values(n_values);
+        RAPtor_MPI_Reduce(local_values.data(), min_values.data(), n_values,
+                RAPtor_MPI_DOUBLE, RAPtor_MPI_MIN, 0, RAPtor_MPI_COMM_WORLD);
+        RAPtor_MPI_Reduce(local_values.data(), max_values.data(), n_values,
+                RAPtor_MPI_DOUBLE, RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
+        RAPtor_MPI_Reduce(local_values.data(), sum_values.data(), n_values,
+                RAPtor_MPI_DOUBLE, RAPtor_MPI_SUM, 0, RAPtor_MPI_COMM_WORLD);
+        RAPtor_MPI_Reduce(rank ? region_procs.data() : RAPtor_MPI_IN_PLACE,
+                region_procs.data(), n_regions, RAPtor_MPI_INT, RAPtor_MPI_SUM, 0,
+                RAPtor_MPI_COMM_WORLD);
+        profile = profiling;
+
+        if (rank) return NULL;
+
+        ReducedNode* reduced_root = new ReducedNode(root.name, root.level);
+        for (int i = 0; i < n_regions; i++)
+        {
+            ReducedNode* node = find_reduced(reduced_root, region_paths[i]);
+            node->num_procs = region_procs[i];
+            for (int c = 0; c < num_profile_counters; c++)
+            {
+                int idx = i * num_profile_counters + c;
+                node->min[c] = min_values[idx];
+                node->max[c] = max_values[idx];
+                node->sum[c] = sum_values[idx];
+            }
+        }
+
+        return reduced_root;
+    }
+
+    std::string reduced_label(ReducedNode* node)
+    {
+        if (node->level < 0) return node->name;
+        return node->name + " " + std::to_string(node->level);
+    }
+
+    void print_reduced(ReducedNode* node, const char* label,
+            const std::string& indent, int num_procs)
+    {
+        printf("%s %s%s: Time %e (avg %e)", label, indent.c_str(),
+                reduced_label(node).c_str(), node->max[ProfileTime],
+                node->sum[ProfileTime] / num_procs);
+        if (node->max[ProfileP2P] > 0 || node->max[ProfileCollective] > 0)
+            printf(", P2P %e, Collective %e", node->max[ProfileP2P],
+                    node->max[ProfileCollective]);
+        if (node->max[ProfileMsgs] > 0)
+            printf(", Msgs %.0f, Bytes %.0f", node->max[ProfileMsgs],
+                    node->max[ProfileBytesSent]);
+        if (node->max[ProfileFlops] > 0)
+            printf(", Flops %e", node->max[ProfileFlops]);
+        printf("\n");
+        for (int i = 0; i < (int) node->children.size(); i++)
+            print_reduced(node->children[i], label, indent + "  ", num_procs);
+    }
+
+    void write_json_node(FILE* f, ReducedNode* node, const std::string& indent,
+            int num_procs)
+    {
+        fprintf(f, "%s{\"name\": \"%s\", \"level\": %d, \"procs\": %d,\n",
+                indent.c_str(), node->name.c_str(), node->level, node->num_procs);
+        for (int c = 0; c < num_profile_counters; c++)
+        {
+            fprintf(f, "%s \"%s\": {\"min\": %.17g, \"max\": %.17g, \"avg\": %.17g},\n",
+                    indent.c_str(), counter_names[c], node->min[c], node->max[c],
+                    node->sum[c] / num_procs);
+        }
+        fprintf(f, "%s \"children\": [", indent.c_str());
+        for (int i = 0; i < (int) node->children.size(); i++)
+        {
+            fprintf(f, i ? ",\n" : "\n");
+            write_json_node(f, node->children[i], indent + "  ", num_procs);
+        }
+        if (node->children.size()) fprintf(f, "\n%s ", indent.c_str());
+        fprintf(f, "]}");
+    }
+
+    void write_csv_node(FILE* f, ReducedNode* node, const std::string& parent,
+            int num_procs)
+    {
+        std::string path = parent.empty() ? reduced_label(node)
+            : parent + "/" + reduced_label(node);
+        fprintf(f, "%s,%d", path.c_str(), node->level);
+        for (int c = 0; c < num_profile_counters; c++)
+        {
+            fprintf(f, ",%.17g,%.17g,%.17g", node->min[c], node->max[c],
+                    node->sum[c] / num_procs);
+        }
+        fprintf(f, "\n");
+        for (int i = 0; i < (int) node->children.size(); i++)
+            write_csv_node(f, node->children[i], path, num_procs);
+    }
+}
+
+namespace raptor
+{
+void init_profile()
+{
+    profile = true;
+    reset_profile();
+}
+void reset_profile()
+{
+    clear_node(&root);
+    open_nodes.clear();
+    open_times.clear();
+    open_nodes.push_back(&root);
+    open_times.push_back(profile ? RAPtor_MPI_Wtime() : 0.0);
+    for (int i = 0; i < num_profile_counters; i++)
+        timer_depth[i] = 0;
+    root.counters[ProfileCalls] = 1;
+}
+void finalize_profile()
+{
+    if (!profile) return;
+    while (open_nodes.size() > 1)
+        profile_pop();
+    root.counters[ProfileTime] += RAPtor_MPI_Wtime() - open_times[0];
+    profile = false;
+}
+void average_profile(int n_iter)
+{
+    scale_node(&root, 1.0 / n_iter);
+}
+void print_profile(const char* label)
+{
+    int num_procs;
+    ReducedNode* reduced_root = reduce_profile(&num_procs);
+    if (reduced_root)
+    {
+        print_reduced(reduced_root, label, "", num_procs);
+        delete reduced_root;
+    }
+}
+void write_profile_json(const char* fname)
+{
+    int num_procs;
+    ReducedNode* reduced_root = reduce_profile(&num_procs);
+    if (reduced_root)
+    {
+        FILE* f = fopen(fname, "w");
+        if (f)
+        {
+            fprintf(f, "{\"num_procs\": %d,\n \"profile\":\n", num_procs);
+            write_json_node(f, reduced_root, "  ", num_procs);
+            fprintf(f, "\n}\n");
+            fclose(f);
+        }
+        delete reduced_root;
+    }
+}
+void write_profile_csv(const char* fname)
+{
+    int num_procs;
+    ReducedNode* reduced_root = reduce_profile(&num_procs);
+    if (reduced_root)
+    {
+        FILE* f = fopen(fname, "w");
+        if (f)
+        {
+            fprintf(f, "region,level");
+            for (int c = 0; c < num_profile_counters; c++)
+            {
+                fprintf(f, ",%s_min,%s_max,%s_avg", counter_names[c],
+                        counter_names[c], counter_names[c]);
+            }
+            fprintf(f, "\n");
+            write_csv_node(f, reduced_root, "", num_procs);
+            fclose(f);
+        }
+        delete reduced_root;
+    }
+}
+double get_profile_value(profile_counter_t counter)
+{
+    return root.counters[counter];
+}
+
+void profile_push(const char* name, int level)
+{
+    if (!profile) return;
+    if (open_nodes.empty()) reset_profile();
+    ProfileNode* node = open_nodes.back()->child(name, level);
+    node->counters[ProfileCalls] += 1;
+    open_nodes.push_back(node);
+    open_times.push_back(RAPtor_MPI_Wtime());
+}
+void profile_pop()
+{
+    if (open_nodes.size() <= 1) return;
+    open_nodes.back()->counters[ProfileTime] += RAPtor_MPI_Wtime() - open_times.back();
+    open_nodes.pop_back();
+    open_times.pop_back();
+}
+
+void profile_add(profile_counter_t counter, double value)
+{
+    if (!profile) return;
+    if (open_nodes.empty()) reset_profile();
+    for (int i = 0; i < (int) open_nodes.size(); i++)
+        open_nodes[i]->counters[counter] += value;
+}
+void profile_start(profile_counter_t counter)
+{
+    if (!profile) return;
+    if (timer_depth[counter]++ == 0)
+        timer_start[counter] = RAPtor_MPI_Wtime();
+}
+void profile_stop(profile_counter_t counter)
+{
+    if (!profile || timer_depth[counter] == 0) return;
+    if (--timer_depth[counter] == 0)
+        profile_add(counter, RAPtor_MPI_Wtime() - timer_start[counter]);
+}
+
+void profile_send(int n_msgs, double bytes)
+{
+    profile_add(ProfileMsgs, n_msgs);
+    profile_add(ProfileBytesSent, bytes);
+}
+void profile_recv(double bytes)
+{
+    profile_add(ProfileBytesRecv, bytes);
+}
+void profile_set_wait(profile_counter_t counter)
+{
+    wait_counter = counter;
+}
+void profile_start_wait()
+{
+    profile_start(wait_counter);
+}
+void profile_stop_wait()
+{
+    profile_stop(wait_counter);
+}
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_CORE_PROFILER_HPP_
+#define RAPTOR_CORE_PROFILER_HPP_
+
+#include "types.hpp"
+#include <string>
+
+// Profiling is recorded only while this is set (by init_profile)
+extern bool profile;
+
+/**************************************************************
+ *****   Profiler
+ **************************************************************
+ ***** Registry of timers and counters, held in a tree of named
+ ***** regions.  A region is opened with profile_begin(name, level)
+ ***** (or a ProfileScope), as a child of the innermost open region,
+ ***** and regions with the same name and level under the same
+ ***** parent share counters, so that repeated calls accumulate.
+ ***** The root region is opened by init_profile.  The RAPtor_MPI
+ ***** wrappers charge time, messages, and bytes to every open
+ ***** region, and kernels add their flops and nnz touched, so
+ ***** every region holds inclusive totals.
+ *****
+ ***** Nothing is recorded while profile is false, and every entry
+ ***** point checks profile before doing any work, so that the
+ ***** registry may be left in place in production runs.
+ *****
+ ***** Counters
+ ***** -------------
+ ***** ProfileTime : time in region
+ ***** ProfileCollective : time in collective communication
+ ***** ProfileP2P : time in point-to-point communication
+ ***** ProfileVecComm : time communicating vector values
+ ***** ProfileMatComm : time communicating matrix rows
+ ***** ProfileNewComm : time creating and freeing communicators
+ ***** ProfileCalls : number of times region was entered
+ ***** ProfileMsgs : number of point-to-point messages sent
+ ***** ProfileBytesSent, ProfileBytesRecv : bytes sent / received
+ ***** ProfileFlops : floating point operations
+ ***** ProfileNNZ : matrix nonzeros touched
+ *****
+ ***** Methods
+ ***** -------
+ ***** init_profile()
+ *****    Clears the registry and starts recording
+ ***** finalize_profile()
+ *****    Stops recording, closing all open regions
+ ***** reset_profile()
+ *****    Clears the registry (restarting the root timer if recording)
+ ***** average_profile(n_iter)
+ *****    Divides every counter by n_iter
+ ***** print_profile(label)
+ *****    Prints max and average of every region over all processes
+ ***** write_profile_json(fname), write_profile_csv(fname)
+ *****    Writes min, max, and average of every counter of every
+ *****    region over all processes (written by rank 0)
+ ***** get_profile_value(counter)
+ *****    Local value of a counter in the root region
+ *****
+ ***** print_profile and the write methods are collective over
+ ***** RAPtor_MPI_COMM_WORLD, and regions missing on some processes
+ ***** count as zero for these.
+ **************************************************************/
+namespace raptor
+{
+    enum profile_counter_t {ProfileTime, ProfileCollective, ProfileP2P,
+        ProfileVecComm, ProfileMatComm, ProfileNewComm, ProfileCalls,
+        ProfileMsgs, ProfileBytesSent, ProfileBytesRecv, ProfileFlops,
+        ProfileNNZ, num_profile_counters};
+
+    void init_profile();
+    void reset_profile();
+    void finalize_profile();
+    void average_profile(int n_iter);
+    void print_profile(const char* label);
+    void write_profile_json(const char* fname);
+    void write_profile_csv(const char* fname);
+    double get_profile_value(profile_counter_t counter);
+
+    // Open (and close) a region under the innermost open region.
+    // Level is -1 for regions not tied to a level of a hierarchy.
+    void profile_push(const char* name, int level);
+    void profile_pop();
+    inline void profile_begin(const char* name, int level = -1)
+    {
+        if (profile) profile_push(name, level);
+    }
+    inline void profile_end()
+    {
+        if (profile) profile_pop();
+    }
+
+    // Add to a counter of every open region, and time spent between
+    // start and stop to a time counter of every open region
+    void profile_add(profile_counter_t counter, double value);
+    void profile_start(profile_counter_t counter);
+    void profile_stop(profile_counter_t counter);
+
+    // Record point-to-point messages, and time waiting on outstanding
+    // requests (charged to the counter of the last non-blocking call,
+    // set by profile_set_wait)
+    void profile_send(int n_msgs, double bytes);
+    void profile_recv(double bytes);
+    void profile_set_wait(profile_counter_t counter);
+    void profile_start_wait();
+    void profile_stop_wait();
+
+    inline void profile_add_flops(double flops)
+    {
+        if (profile) profile_add(ProfileFlops, flops);
+    }
+    inline void profile_add_nnz(double nnz)
+    {
+        if (profile) profile_add(ProfileNNZ, nnz);
+    }
+
+    // Region open for the lifetime of the object (if profiling when
+    // it is created)
+    class ProfileScope
+    {
+      public:
+        ProfileScope(const char* name, int level = -1)
+        {
+            active = profile;
+            if (active) profile_push(name, level);
+        }
+        ~ProfileScope()
+        {
+            if (active) profile_pop();
+        }
+
+      private:
+        bool active;
+    };
+}
+
+#endif
@@ -1,5 +1,7 @@
 // Copyright (c) 2015-2017, RAPtor Developer Team
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include <climits>
+#include <stdexcept>
 #include "comm_pkg.hpp"
 
 //#include <pmi.h>
@@ -17,7 +19,7 @@ using namespace raptor;
 *****
 ***** Parameters
 ***** -------------
-***** off_proc_column_map : aligned_vector<int>&
+***** off_proc_column_map : aligned_vector<index_t>&
 *****    Vector holding rank's off_proc_columns
 ***** off_proc_col_to_proc : aligned_vector<int>&
 *****    Vector mapping rank's off_proc_columns to distant procs
@@ -33,8 +35,12 @@ using namespace raptor;
 *****    Will be returned holding procs corresponding to off_node cols
 ***** off_node_to_off_proc : aligned_vector<int>&
 *****    Will be returned holding map from off_node to off_proc
+*****
+***** Node-aware setup stages global columns in int buffers, so
+***** each off_proc column must fit in an int, even with 
+***** USING_BIG_INDEX (larger columns throw std::overflow_error)
 **************************************************************/
-void TAPComm::split_off_proc_cols(const aligned_vector<int>& off_proc_column_map,
+void TAPComm::split_off_proc_cols(const aligned_vector<index_t>& off_proc_column_map,
         const aligned_vector<int>& off_proc_col_to_proc,
         aligned_vector<int>& on_node_column_map,
         aligned_vector<int>& on_node_col_to_proc,
@@ -46,7 +52,7 @@ void TAPComm::split_off_proc_cols(const aligned_vector<int>& off_proc_column_map
     int rank, rank_node, num_procs;
     int proc;
     int node;
-    int global_col;
+    index_t global_col;
     int off_proc_num_cols = off_proc_column_map.size();
 
     RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
@@ -65,6 +71,13 @@ void TAPComm::split_off_proc_cols(const aligned_vector<int>& off_proc_column_map
         proc = off_proc_col_to_proc[i];
         node = topology->get_node(proc);
         global_col = off_proc_column_map[i];
+#ifdef USING_BIG_INDEX
+        if (global_col > INT_MAX)
+        {
+            throw std::overflow_error("TAPComm::split_off_proc_cols(): "
+                    "off_proc column does not fit in an int");
+        }
+#endif
         if (node == rank_node)
         {
             on_node_column_map.emplace_back(global_col);
@@ -491,38 +504,23 @@ void TAPComm::form_global_par_comm(aligned_vector<int>& orig_procs)
     global_recv->size_msgs = ctr;
     global_recv->finalize();
 
-    aligned_vector<int> send_p(num_procs, 0);
+    // Send recv sizes to corresponding local procs on appropriate nodes,
+    // discovering the procs that send to this rank with NBX
+    aligned_vector<int> node_procs(global_recv->num_msgs);
+    aligned_vector<int> node_ptr(global_recv->num_msgs + 1);
+    aligned_vector<int> node_recv_sizes(global_recv->num_msgs);
+    aligned_vector<int> sendbuf_ptr(1, 0);
+    node_ptr[0] = 0;
     for (int i = 0; i < global_recv->num_msgs; i++)
     {
         node = global_recv->procs[i];
-        proc = topology->get_global_proc(node, local_rank);
-        send_p[proc] = 1;
+        node_procs[i] = topology->get_global_proc(node, local_rank);
+        node_recv_sizes[i] = node_sizes[node];
+        node_ptr[i+1] = i+1;
     }
-    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, send_p.data(), num_procs, RAPtor_MPI_INT,
-            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
-    int recv_n = send_p[rank];
-    sendbuf.resize(recv_n);
-    sendbuf_sizes.resize(recv_n);
-    // Send recv sizes to corresponding local procs on appropriate nodes
-    ctr = 0;
-    for (int i = 0; i < global_recv->num_msgs; i++)
-    {
-        node = global_recv->procs[i];
-        proc = topology->get_global_proc(node, local_rank);
-        RAPtor_MPI_Isend(&(node_sizes[node]), 1, RAPtor_MPI_INT, proc, 9876, RAPtor_MPI_COMM_WORLD,
-                &(global_recv->requests[i]));
-    }
-    for (int i = 0; i < recv_n; i++)
-    {
-        RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 9876, RAPtor_MPI_COMM_WORLD, &recv_status);
-        proc = recv_status.RAPtor_MPI_SOURCE;
-        RAPtor_MPI_Recv(&recvbuf, 1, RAPtor_MPI_INT, proc, 9876, RAPtor_MPI_COMM_WORLD, 
-                &recv_status);
-        sendbuf[i] = proc;
-        sendbuf_sizes[i] = recvbuf;
-    }
-    RAPtor_MPI_Waitall(global_recv->num_msgs, global_recv->requests.data(),
-            RAPtor_MPI_STATUSES_IGNORE);
+    nbx_exchange(global_recv->num_msgs, node_procs.data(), node_ptr.data(),
+            node_recv_sizes.data(), sendbuf, sendbuf_ptr, sendbuf_sizes,
+            9876, RAPtor_MPI_COMM_WORLD);
 
     // Gather all procs to which node must send 
     n_sends = sendbuf.size();
@@ -810,7 +808,7 @@ void TAPComm::adjust_send_indices(const int first_local_col)
         }
 
         // Update global_par_comm->send_data->indices (global rows) to 
-        std::map<int, int> S_global_to_local;
+        IntMap S_global_to_local(local_S_recv->size_msgs);
         for (int i = 0; i < local_S_recv->size_msgs; i++)
         {
             S_global_to_local[local_S_recv->indices[i]] = i;
@@ -821,7 +819,7 @@ void TAPComm::adjust_send_indices(const int first_local_col)
         for (int i = 0; i < global_par_comm->send_data->size_msgs; i++)
         {
             idx = global_par_comm->send_data->indices[i];
-            local_S_idx = S_global_to_local[idx];
+            local_S_idx = S_global_to_local.find(idx);
             global_par_comm->send_data->indices[i] = local_S_idx;
             local_S_num_pos[local_S_idx]++;
         }
@@ -852,7 +850,7 @@ void TAPComm::adjust_send_indices(const int first_local_col)
 
     // Update local_R_par_comm->send_data->indices (global_rows)
     DuplicateData* global_recv = (DuplicateData*) global_par_comm->recv_data;
-    std::map<int, int> global_to_local;
+    IntMap global_to_local(global_recv->size_msgs);
     for (int i = 0; i < global_recv->size_msgs; i++)
     {
         global_to_local[global_recv->indices[i]] = i;
@@ -863,7 +861,7 @@ void TAPComm::adjust_send_indices(const int first_local_col)
     for (int i = 0; i < local_R_par_comm->send_data->size_msgs; i++)
     {
         idx = local_R_par_comm->send_data->indices[i];
-        global_comm_idx = global_to_local[idx];
+        global_comm_idx = global_to_local.find(idx);
         local_R_par_comm->send_data->indices[i] = global_comm_idx;
         global_num_pos[global_comm_idx]++;
     }
@@ -1106,21 +1104,8 @@ void TAPComm::form_simple_global_comm(aligned_vector<int>& off_proc_col_to_proc)
     global_recv->finalize();
 
     // Communicate global recv_data so send_data can be formed (dynamic comm)
-    aligned_vector<int> recv_sizes(num_procs, 0);
-    for (int i = 0; i < global_recv->num_msgs; i++)
-        recv_sizes[global_recv->procs[i]] = global_recv->indptr[i+1] - global_recv->indptr[i];
-    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, recv_sizes.data(), num_procs, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
-
-    for (int i = 0; i < global_recv->num_msgs; i++)
-    {
-        proc = global_recv->procs[i];
-        start = global_recv->indptr[i];
-        end = global_recv->indptr[i+1];
-        RAPtor_MPI_Isend(&(global_recv->indices[start]), end - start, RAPtor_MPI_INT,
-                proc, 6789, RAPtor_MPI_COMM_WORLD, &(global_recv->requests[i]));
-    }
-    global_par_comm->send_data->probe(recv_sizes[rank], 6789, RAPtor_MPI_COMM_WORLD);
-    global_par_comm->recv_data->waitall();
+    global_par_comm->send_data->probe_nbx(global_recv, global_recv->indices.data(),
+            6789, RAPtor_MPI_COMM_WORLD);
 }
 
 void TAPComm::update_recv(const aligned_vector<int>& on_node_to_off_proc,
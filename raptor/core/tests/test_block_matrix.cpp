@@ -108,25 +108,25 @@ TEST(BlockMatrixTest, TestsInCore)
     ASSERT_EQ(A_bsr->nnz, A_bsc->nnz);
     ASSERT_EQ(A_csr_from_bsr->nnz, A_csr->nnz);
 
-    double** bcoo_vals = (double**) A_bcoo->get_data();
-    double** bsr_vals = (double**) A_bsr->get_data();
+    double* bcoo_vals = (double*) A_bcoo->get_data();
+    double* bsr_vals = (double*) A_bsr->get_data();
     for (int i = 0; i < A_bcoo->nnz; i++)
     {
         for (int j = 0; j < A_bcoo->b_size; j++)
         {
-            ASSERT_NEAR(bcoo_vals[i][j], bsr_vals[i][j], 1e-10);
+            ASSERT_NEAR(bcoo_vals[i*A_bcoo->b_size + j], bsr_vals[i*A_bcoo->b_size + j], 1e-10);
         }
     }
 
     Matrix* Atmp = A_bsc->to_CSR();
     Atmp->sort();
     Atmp->move_diag();
-    double** tmp_vals = (double**) Atmp->get_data();
+    double* tmp_vals = (double*) Atmp->get_data();
     for (int i = 0; i < A_bsr->nnz; i++)
     {
         for (int j = 0; j < A_bsr->b_size; j++)
         {
-            ASSERT_NEAR(bsr_vals[i][j], tmp_vals[i][j], 1e-10);
+            ASSERT_NEAR(bsr_vals[i*A_bsr->b_size + j], tmp_vals[i*A_bsr->b_size + j], 1e-10);
         }
     }
 
@@ -0,0 +1,131 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Expected volume of one exchange sending bytes per index through
+// data (with two processes per node)
+CommVolume expected_volume(CommData* data, int rank, int bytes)
+{
+    CommVolume volume;
+    for (int i = 0; i < data->num_msgs; i++)
+    {
+        volume.add(data->procs[i] / 2 == rank / 2, 1,
+                (data->indptr[i+1] - data->indptr[i]) * bytes);
+    }
+    return volume;
+}
+
+void compare_volume(const CommVolume& volume, const CommVolume& expected)
+{
+    ASSERT_EQ(volume.intra_node_msgs, expected.intra_node_msgs);
+    ASSERT_EQ(volume.inter_node_msgs, expected.inter_node_msgs);
+    ASSERT_EQ(volume.intra_node_bytes, expected.intra_node_bytes);
+    ASSERT_EQ(volume.inter_node_bytes, expected.inter_node_bytes);
+}
+
+TEST(CommVolumeTest, TestsInCore)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    // Two processes per node, so that both classes are exercised
+    setenv("PPN", "2", 1);
+
+    int grid[2] = {25, 25};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI / 8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+    ParComm* comm = A->comm;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+
+    // Forming the communication package is not counted
+    CommVolume sends, recvs;
+    comm->get_comm_volume(sends, recvs);
+    compare_volume(sends, CommVolume());
+    compare_volume(recvs, CommVolume());
+
+    // Forward communication sends from send_data, recvs into recv_data
+    comm->communicate(x);
+    CommVolume expected_sends = expected_volume(comm->send_data, rank, sizeof(double));
+    CommVolume expected_recvs = expected_volume(comm->recv_data, rank, sizeof(double));
+    comm->get_comm_volume(sends, recvs);
+    compare_volume(sends, expected_sends);
+    compare_volume(recvs, expected_recvs);
+
+    // Transpose communication reverses directions, and counts
+    // accumulate until reset
+    aligned_vector<double> off_proc_vals(A->off_proc_num_cols, 1.0);
+    comm->communicate_T(off_proc_vals);
+    expected_sends += expected_volume(comm->recv_data, rank, sizeof(double));
+    expected_recvs += expected_volume(comm->send_data, rank, sizeof(double));
+    sends.reset();
+    recvs.reset();
+    comm->get_comm_volume(sends, recvs);
+    compare_volume(sends, expected_sends);
+    compare_volume(recvs, expected_recvs);
+
+    // Persistent and integer communication are counted as well
+    comm->reset_comm_volume();
+    comm->init_persistent_comm();
+    comm->communicate(x);
+    comm->free_persistent_comm();
+    aligned_vector<int> int_vals(A->local_num_rows, rank);
+    comm->communicate(int_vals);
+    expected_sends = expected_volume(comm->send_data, rank, sizeof(double));
+    expected_sends += expected_volume(comm->send_data, rank, sizeof(int));
+    expected_recvs = expected_volume(comm->recv_data, rank, sizeof(double));
+    expected_recvs += expected_volume(comm->recv_data, rank, sizeof(int));
+    sends.reset();
+    recvs.reset();
+    comm->get_comm_volume(sends, recvs);
+    compare_volume(sends, expected_sends);
+    compare_volume(recvs, expected_recvs);
+
+    // Matrix communication sends one packed message per process
+    comm->reset_comm_volume();
+    CSRMatrix* recv_mat = comm->communicate(A);
+    delete recv_mat;
+    sends.reset();
+    recvs.reset();
+    comm->get_comm_volume(sends, recvs);
+    ASSERT_EQ(sends.intra_node_msgs + sends.inter_node_msgs, comm->send_data->num_msgs);
+    ASSERT_EQ(recvs.intra_node_msgs + recvs.inter_node_msgs, comm->recv_data->num_msgs);
+    if (comm->send_data->num_msgs)
+    {
+        ASSERT_GT(sends.intra_node_bytes + sends.inter_node_bytes, 0);
+    }
+
+    // Sent and received volumes match over all processes
+    long vals[4] = {sends.intra_node_msgs, sends.inter_node_msgs,
+        sends.intra_node_bytes, sends.inter_node_bytes};
+    long recv_vals[4] = {recvs.intra_node_msgs, recvs.inter_node_msgs,
+        recvs.intra_node_bytes, recvs.inter_node_bytes};
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, vals, 4, RAPtor_MPI_LONG, RAPtor_MPI_SUM,
+            RAPtor_MPI_COMM_WORLD);
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, recv_vals, 4, RAPtor_MPI_LONG, RAPtor_MPI_SUM,
+            RAPtor_MPI_COMM_WORLD);
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_EQ(vals[i], recv_vals[i]);
+    }
+
+    delete A;
+    unsetenv("PPN");
+
+} // end of TEST(CommVolumeTest, TestsInCore) //
@@ -0,0 +1,128 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+TEST(NeighborCommTest, TestsInCore)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    double eps = 0.001;
+    double theta = M_PI / 8.0;
+    int grid[2] = {25, 25};
+    double* stencil = diffusion_stencil_2d(eps, theta);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParComm* par_comm = A->comm;
+    NeighborComm* nbr_comm = new NeighborComm(A->partition, 
+            A->off_proc_column_map, A->on_proc_column_map);
+    ASSERT_EQ(nbr_comm->send_data->num_msgs, par_comm->send_data->num_msgs);
+    ASSERT_EQ(nbr_comm->recv_data->num_msgs, par_comm->recv_data->num_msgs);
+
+    int block_size = 2;
+    int n = A->local_num_rows;
+    int n_off = A->off_proc_num_cols;
+    aligned_vector<int> int_vals(n);
+    aligned_vector<double> vals(n * block_size);
+    aligned_vector<int> off_int_vals(n_off);
+    aligned_vector<double> off_vals(n_off * block_size);
+    for (int i = 0; i < n; i++)
+    {
+        int_vals[i] = A->local_row_map[i];
+        for (int j = 0; j < block_size; j++)
+            vals[i*block_size + j] = A->local_row_map[i] * 0.5 + j;
+    }
+    for (int i = 0; i < n_off; i++)
+    {
+        off_int_vals[i] = A->off_proc_column_map[i];
+        for (int j = 0; j < block_size; j++)
+            off_vals[i*block_size + j] = A->off_proc_column_map[i] * 0.25 - j;
+    }
+
+    // Forward communication
+    aligned_vector<int>& int_recv = nbr_comm->communicate(int_vals);
+    for (int i = 0; i < n_off; i++)
+        ASSERT_EQ(int_recv[i], A->off_proc_column_map[i]);
+
+    aligned_vector<double>& par_recv = par_comm->communicate(vals, block_size);
+    aligned_vector<double> par_recv_copy(par_recv.begin(), 
+            par_recv.begin() + n_off * block_size);
+    aligned_vector<double>& recv = nbr_comm->communicate(vals, block_size);
+    for (int i = 0; i < n_off * block_size; i++)
+        ASSERT_NEAR(recv[i], par_recv_copy[i], 1e-15);
+
+    aligned_vector<double> single_vals(n);
+    for (int i = 0; i < n; i++)
+        single_vals[i] = A->local_row_map[i] * 0.5;
+    aligned_vector<double>& single_recv = nbr_comm->communicate(single_vals);
+    for (int i = 0; i < n_off; i++)
+        ASSERT_NEAR(single_recv[i], A->off_proc_column_map[i] * 0.5, 1e-15);
+
+    // Single precision communication
+    ParVector x(A->global_num_rows, n);
+    for (int i = 0; i < n; i++)
+        x[i] = 1.0 / (A->local_row_map[i] + 3.0);
+    aligned_vector<double>& float_recv = nbr_comm->communicate_float(x);
+    for (int i = 0; i < n_off; i++)
+        ASSERT_NEAR(float_recv[i], 1.0 / (A->off_proc_column_map[i] + 3.0), 1e-07);
+
+    // Transpose communication
+    aligned_vector<double> par_result(n * block_size, 1.0);
+    aligned_vector<double> result(n * block_size, 1.0);
+    par_comm->communicate_T(off_vals, par_result, block_size);
+    nbr_comm->communicate_T(off_vals, result, block_size);
+    for (int i = 0; i < n * block_size; i++)
+        ASSERT_NEAR(result[i], par_result[i], 1e-12);
+
+    aligned_vector<int> par_int_result(n, 0);
+    aligned_vector<int> int_result(n, 0);
+    par_comm->communicate_T(off_int_vals, par_int_result);
+    nbr_comm->communicate_T(off_int_vals, int_result);
+    for (int i = 0; i < n; i++)
+        ASSERT_EQ(int_result[i], par_int_result[i]);
+
+    aligned_vector<double> float_result(n, 0.0);
+    std::fill(par_result.begin(), par_result.end(), 0.0);
+    par_comm->communicate_T(off_vals, par_result);
+    nbr_comm->init_float_comm_T(off_vals.data(), 1);
+    nbr_comm->complete_float_comm_T(float_result, 1);
+    for (int i = 0; i < n; i++)
+        ASSERT_NEAR(float_result[i], par_result[i], 1e-05 * fabs(par_result[i]));
+
+    // SpMVs with neighborhood collectives match point-to-point
+    ParVector b(A->global_num_rows, n);
+    ParVector b_nbr(A->global_num_rows, n);
+    ParVector b_T(A->global_num_rows, n);
+    ParVector b_T_nbr(A->global_num_rows, n);
+    A->mult(x, b);
+    A->mult_T(x, b_T);
+    A->init_neighbor_comm();
+    ASSERT_TRUE(dynamic_cast<NeighborComm*>(A->comm) != NULL);
+    A->mult(x, b_nbr);
+    A->mult_T(x, b_T_nbr);
+    for (int i = 0; i < n; i++)
+    {
+        ASSERT_NEAR(b[i], b_nbr[i], 1e-12);
+        ASSERT_NEAR(b_T[i], b_T_nbr[i], 1e-12);
+    }
+
+    delete nbr_comm;
+    delete A;
+
+} // end of TEST(NeighborCommTest, TestsInCore) //
@@ -81,3 +81,120 @@ TEST(ParCommTest, TestsInCore)
     delete A_seq;
 
 } // end of TEST(ParCommTest, TestsInCore) //
+
+TEST(NBXExchangeTest, TestsInCore)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    // Rank r sends r+1 values to each rank r+2^k, so rank r receives
+    // from each distinct rank r-2^k
+    aligned_vector<int> send_procs;
+    aligned_vector<int> send_ptr(1, 0);
+    aligned_vector<int> send_vals;
+    for (int k = 1; k < num_procs; k *= 2)
+    {
+        int proc = (rank + k) % num_procs;
+        if (proc == rank) continue;
+        send_procs.emplace_back(proc);
+        for (int i = 0; i <= rank; i++)
+            send_vals.emplace_back(rank * 1000 + proc);
+        send_ptr.emplace_back(send_vals.size());
+    }
+
+    // Repeated exchanges with the same key must not mix messages
+    for (int iter = 0; iter < 3; iter++)
+    {
+        aligned_vector<int> recv_procs;
+        aligned_vector<int> recv_ptr(1, 0);
+        aligned_vector<int> recv_vals;
+        nbx_exchange(send_procs.size(), send_procs.data(), send_ptr.data(),
+                send_vals.data(), recv_procs, recv_ptr, recv_vals, 4321, 
+                MPI_COMM_WORLD);
+
+        ASSERT_EQ(recv_procs.size(), send_procs.size());
+        for (int i = 0; i < recv_procs.size(); i++)
+        {
+            int proc = recv_procs[i];
+            ASSERT_EQ(recv_ptr[i+1] - recv_ptr[i], proc + 1);
+            for (int j = recv_ptr[i]; j < recv_ptr[i+1]; j++)
+                ASSERT_EQ(recv_vals[j], proc * 1000 + rank);
+        }
+    }
+
+} // end of TEST(NBXExchangeTest, TestsInCore) //
+
+
+TEST(PersistentCommTest, TestsInCore)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int grid[2] = {25, 25};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI / 8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    int n = A->local_num_rows;
+    int n_off = A->off_proc_num_cols;
+    ParComm* persistent_comm = new ParComm(A->comm);
+    persistent_comm->init_persistent_comm();
+    ASSERT_TRUE(persistent_comm->persistent);
+
+    // Requests are reused across repeated communication, and
+    // recreated when block size changes
+    for (int test = 0; test < 3; test++)
+    {
+        for (int block_size = 1; block_size <= 2; block_size++)
+        {
+            aligned_vector<double> vals(n * block_size);
+            aligned_vector<double> off_vals(n_off * block_size);
+            for (int i = 0; i < n * block_size; i++)
+                vals[i] = A->local_row_map[i / block_size] + 0.1*(i % block_size) + test;
+            for (int i = 0; i < n_off * block_size; i++)
+                off_vals[i] = A->off_proc_column_map[i / block_size] - 0.5*(i % block_size);
+
+            aligned_vector<double>& recv = persistent_comm->communicate(vals, block_size);
+            ASSERT_EQ(persistent_comm->send_data->persistent_block_size, block_size);
+            for (int i = 0; i < n_off * block_size; i++)
+            {
+                ASSERT_NEAR(recv[i], A->off_proc_column_map[i / block_size] 
+                        + 0.1*(i % block_size) + test, 1e-12);
+            }
+
+            aligned_vector<double> result(n * block_size, 0.0);
+            aligned_vector<double> persistent_result(n * block_size, 0.0);
+            A->comm->communicate_T(off_vals, result, block_size);
+            persistent_comm->communicate_T(off_vals, persistent_result, block_size);
+            for (int i = 0; i < n * block_size; i++)
+                ASSERT_NEAR(result[i], persistent_result[i], 1e-12);
+        }
+    }
+
+    // SpMVs with persistent requests match standard communication
+    ParVector x(A->global_num_rows, n);
+    ParVector b(A->global_num_rows, n);
+    ParVector b_persistent(A->global_num_rows, n);
+    x.set_rand_values();
+    A->mult(x, b);
+    A->init_persistent_comm();
+    for (int test = 0; test < 3; test++)
+    {
+        A->mult(x, b_persistent);
+        for (int i = 0; i < n; i++)
+            ASSERT_NEAR(b[i], b_persistent[i], 1e-12);
+    }
+
+    persistent_comm->free_persistent_comm();
+    ASSERT_FALSE(persistent_comm->persistent);
+    aligned_vector<double>& std_recv = A->comm->communicate(x);
+    aligned_vector<double>& recv = persistent_comm->communicate(x);
+    for (int i = 0; i < n_off; i++)
+        ASSERT_NEAR(recv[i], std_recv[i], 1e-15);
+
+    delete persistent_comm;
+    delete A;
+
+} // end of TEST(PersistentCommTest, TestsInCore) //
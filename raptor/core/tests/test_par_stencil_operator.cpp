@@ -0,0 +1,123 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+void compare_vectors(ParVector& x, ParVector& y)
+{
+    ASSERT_EQ(x.local_n, y.local_n);
+    for (int i = 0; i < x.local_n; i++)
+    {
+        ASSERT_NEAR(x[i], y[i], 1e-10);
+    }
+}
+
+void set_values(ParVector& x, index_t first_row, int offset)
+{
+    for (int i = 0; i < x.local_n; i++)
+    {
+        x[i] = 1.0 / (((first_row + i + offset) % 13) + 1);
+    }
+}
+
+void test_stencil_operator(double* stencil, int* grid, int dim)
+{
+    ParStencilOperator* op = new ParStencilOperator(stencil, grid, dim);
+    ParCSRMatrix* A = op->to_ParCSR();
+    ParCSRMatrix* A_gallery = par_stencil_grid(stencil, grid, dim,
+            op->proc_grid.data());
+
+    // Materialized matrix is that of par_stencil_grid
+    ASSERT_EQ(A->global_num_rows, A_gallery->global_num_rows);
+    ASSERT_EQ(A->local_num_rows, A_gallery->local_num_rows);
+    ASSERT_EQ(A->partition->first_local_row, A_gallery->partition->first_local_row);
+    ASSERT_EQ(A->local_nnz, A_gallery->local_nnz);
+    ASSERT_EQ(A->off_proc_column_map.size(), op->off_proc_column_map.size());
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        ASSERT_EQ(A->off_proc_column_map[i], A_gallery->off_proc_column_map[i]);
+    }
+
+    index_t first_row = op->first_local_row;
+    int n = op->local_num_rows;
+    ParVector x(op->global_num_rows, n);
+    ParVector b(op->global_num_rows, n);
+    ParVector b_csr(op->global_num_rows, n);
+    ParVector tmp(op->global_num_rows, n);
+    ParVector x_csr(op->global_num_rows, n);
+    set_values(x, first_row, 0);
+    set_values(b, first_row, 5);
+
+    // SpMV kernels
+    op->mult(x, b);
+    A_gallery->mult(x, b_csr);
+    compare_vectors(b, b_csr);
+
+    op->mult_append(x, b);
+    A_gallery->mult_append(x, b_csr);
+    compare_vectors(b, b_csr);
+
+    set_values(b, first_row, 5);
+    op->residual(x, b, tmp);
+    A_gallery->residual(x, b, b_csr);
+    compare_vectors(tmp, b_csr);
+
+    // Relaxation matches par_relax on the materialized matrix
+    for (int r = 0; r < 4; r++)
+    {
+        set_values(x, first_row, 0);
+        set_values(x_csr, first_row, 0);
+        switch (r)
+        {
+            case 0:
+                op->jacobi(x, b, tmp, 2, 2.0/3);
+                jacobi(A, x_csr, b, tmp, 2, 2.0/3);
+                break;
+            case 1:
+                op->l1_jacobi(x, b, tmp, 2, 1.0);
+                l1_jacobi(A, x_csr, b, tmp, 2, 1.0);
+                break;
+            case 2:
+                op->hybrid_gs(x, b, tmp, 2, 1.0);
+                hybrid_gs(A, x_csr, b, tmp, 2, 1.0);
+                break;
+            case 3:
+                op->hybrid_sgs(x, b, tmp, 2, 1.0);
+                hybrid_sgs(A, x_csr, b, tmp, 2, 1.0);
+                break;
+        }
+        compare_vectors(x, x_csr);
+    }
+
+    delete A_gallery;
+    delete A;
+    delete op;
+}
+
+TEST(ParStencilOperatorTest, TestsInCore)
+{
+    set_num_threads(1);
+
+    int grid_3d[3] = {10, 9, 8};
+    double* stencil = laplace_stencil_27pt();
+    test_stencil_operator(stencil, grid_3d, 3);
+    delete[] stencil;
+
+    int grid_2d[2] = {25, 17};
+    stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    test_stencil_operator(stencil, grid_2d, 2);
+    delete[] stencil;
+
+} // end of TEST(ParStencilOperatorTest, TestsInCore) //
@@ -65,6 +65,30 @@ TEST(ParVectorTest, TestsInCore)
     {
         ASSERT_EQ(v[first_n+i], v_par_l[i]);
     }
+
+    // Multiple inner products with a single reduction
+    Vector w(global_n);
+    ParVector w_par(global_n, local_n);
+    for (int i = 0; i < global_n; i++)
+        w[i] = ((i * 7) % 5) - 2.0;
+    for (int i = 0; i < local_n; i++)
+        w_par[i] = w[first_n+i];
+
+    data_t inners[3];
+    ParVector* vecs[3] = {&w_par, &v_par, &w_par};
+    v_par.inner_products(3, vecs, inners);
+    ASSERT_NEAR(inners[0], v.inner_product(w), 1e-12);
+    ASSERT_NEAR(inners[1], v.inner_product(v), 1e-12);
+    ASSERT_NEAR(inners[2], inners[0], 1e-14);
+    ASSERT_NEAR(sqrt(inners[1]), v_par.norm(2), 1e-12);
+
+    RAPtor_MPI_Request request;
+    vecs[1] = &v_par;
+    vecs[2] = &w_par;
+    w_par.init_inner_products(2, &vecs[1], inners, &request);
+    w_par.complete_inner_products(&request);
+    ASSERT_NEAR(inners[0], w_par.inner_product(v_par), 1e-12);
+    ASSERT_NEAR(inners[1], w.inner_product(w), 1e-12);
     
 } // end of TEST(ParVectorTest, TestsInCore) //
 
@@ -0,0 +1,152 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+#include <fstream>
+#include <sstream>
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Sends n doubles to the next process, and receives from the previous
+void ring_exchange(int n)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    aligned_vector<double> send_vals(n, rank);
+    aligned_vector<double> recv_vals(n);
+    RAPtor_MPI_Request requests[2];
+    RAPtor_MPI_Isend(send_vals.data(), n, RAPtor_MPI_DOUBLE, (rank + 1) % num_procs,
+            1234, RAPtor_MPI_COMM_WORLD, &requests[0]);
+    RAPtor_MPI_Irecv(recv_vals.data(), n, RAPtor_MPI_DOUBLE,
+            (rank + num_procs - 1) % num_procs, 1234, RAPtor_MPI_COMM_WORLD,
+            &requests[1]);
+    RAPtor_MPI_Waitall(2, requests, RAPtor_MPI_STATUSES_IGNORE);
+}
+
+// Fields of the CSV row of a region
+std::vector<std::string> csv_row(const char* fname, const std::string& region)
+{
+    std::ifstream f(fname);
+    std::string line, field;
+    std::vector<std::string> fields;
+    while (std::getline(f, line))
+    {
+        if (line.compare(0, region.size() + 1, region + ",") != 0) continue;
+        std::stringstream ss(line);
+        while (std::getline(ss, field, ',')) fields.push_back(field);
+        break;
+    }
+    return fields;
+}
+
+TEST(ProfilerTest, TestsInCore)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    // Nothing is recorded while profiling is off
+    init_profile();
+    finalize_profile();
+    {
+        ProfileScope scope("off");
+        profile_add_flops(10);
+        ring_exchange(5);
+    }
+    ASSERT_EQ(get_profile_value(ProfileFlops), 0);
+    ASSERT_EQ(get_profile_value(ProfileMsgs), 0);
+
+    // Counters are inclusive, and regions with the same name and
+    // level accumulate
+    init_profile();
+    {
+        ProfileScope outer("outer");
+        for (int i = 0; i < 3; i++)
+        {
+            ProfileScope inner("inner", 1);
+            profile_add_flops(10);
+            profile_add_nnz(rank + 1);
+        }
+        profile_begin("exchange", 0);
+        ring_exchange(5);
+        profile_end();
+    }
+    if (rank == 0)
+    {
+        profile_begin("rank zero");
+        profile_add_flops(1);
+        profile_end();
+    }
+    if (rank == num_procs - 1)
+    {
+        ProfileScope last("last rank");
+        ProfileScope nested("nested", 2);
+        profile_add_flops(2);
+    }
+    finalize_profile();
+
+    ASSERT_EQ(get_profile_value(ProfileMsgs), 1);
+    ASSERT_EQ(get_profile_value(ProfileBytesSent), 5 * sizeof(double));
+    ASSERT_EQ(get_profile_value(ProfileBytesRecv), 5 * sizeof(double));
+    ASSERT_EQ(get_profile_value(ProfileFlops), 30 + (rank == 0)
+            + 2 * (rank == num_procs - 1));
+    ASSERT_GT(get_profile_value(ProfileTime), 0);
+
+    const char* fname = "profile_test.csv";
+    write_profile_csv(fname);
+    if (rank == 0)
+    {
+        // Columns are region, level, then min, max, avg of each counter
+        std::vector<std::string> row = csv_row(fname, "total/outer/inner 1");
+        ASSERT_EQ(row.size(), 2 + 3 * num_profile_counters);
+        ASSERT_EQ(std::stoi(row[1]), 1);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileCalls]), 3, 1e-12);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileFlops + 1]), 30, 1e-12);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileNNZ]), 3, 1e-12);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileNNZ + 1]), 3 * num_procs, 1e-12);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileNNZ + 2]), 1.5 * (num_procs + 1), 1e-12);
+
+        row = csv_row(fname, "total/outer/exchange 0");
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileMsgs + 2]), 1, 1e-12);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileBytesSent + 1]), 5 * sizeof(double), 1e-12);
+
+        // Regions missing on some processes count as zero there
+        row = csv_row(fname, "total/rank zero");
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileFlops]), num_procs > 1 ? 0 : 1, 1e-12);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileFlops + 2]), 1.0 / num_procs, 1e-12);
+
+        // as do regions missing on rank 0
+        row = csv_row(fname, "total/last rank/nested 2");
+        ASSERT_EQ(std::stoi(row[1]), 2);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileFlops]), num_procs > 1 ? 0 : 2, 1e-12);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileFlops + 1]), 2, 1e-12);
+        ASSERT_NEAR(std::stod(row[2 + 3*ProfileFlops + 2]), 2.0 / num_procs, 1e-12);
+        remove(fname);
+    }
+
+    fname = "profile_test.json";
+    write_profile_json(fname);
+    if (rank == 0)
+    {
+        std::ifstream f(fname);
+        std::stringstream ss;
+        ss << f.rdbuf();
+        std::string json = ss.str();
+        ASSERT_NE(json.find("\"name\": \"inner\", \"level\": 1"), std::string::npos);
+        ASSERT_NE(json.find("\"name\": \"rank zero\", \"level\": -1"), std::string::npos);
+        remove(fname);
+    }
+
+} // end of TEST(ProfilerTest, TestsInCore) //
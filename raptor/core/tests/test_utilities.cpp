@@ -0,0 +1,59 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+using namespace raptor;
+
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+
+} // end of main() //
+
+TEST(UtilitiesTest, TestsInCore)
+{
+    // Strided global indices, enough to force several rehashes
+    int n = 10000;
+    IntMap global_to_local;
+    for (int i = 0; i < n; i++)
+    {
+        global_to_local[i * 37 + 5] = i;
+    }
+    ASSERT_EQ(global_to_local.size(), n);
+    for (int i = 0; i < n; i++)
+    {
+        ASSERT_EQ(global_to_local.find(i * 37 + 5), i);
+        ASSERT_EQ(global_to_local.count(i * 37 + 5), 1);
+        ASSERT_EQ(global_to_local.find(i * 37 + 6), -1);
+        ASSERT_EQ(global_to_local.count(i * 37 + 6), 0);
+    }
+    ASSERT_EQ(global_to_local.find(3, n), n);
+
+    // operator[] on existing key updates in place
+    global_to_local[5] += 10;
+    ASSERT_EQ(global_to_local.find(5), 10);
+    ASSERT_EQ(global_to_local.size(), n);
+
+    global_to_local.clear();
+    ASSERT_EQ(global_to_local.size(), 0);
+    ASSERT_EQ(global_to_local.find(5), -1);
+
+    // Sort and binary search
+    aligned_vector<int> cols = {21, 5, 18, 5, 0, 21, 7, 0};
+    sort_unique(cols);
+    ASSERT_EQ(cols.size(), 5);
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_LT(cols[i], cols[i+1]);
+    }
+    ASSERT_EQ(sorted_index(cols, 0), 0);
+    ASSERT_EQ(sorted_index(cols, 18), 3);
+    ASSERT_EQ(sorted_index(cols, 21), 4);
+    ASSERT_EQ(sorted_index(cols, 6), -1);
+    ASSERT_EQ(sorted_index(cols, 22), -1);
+
+} // end of TEST(UtilitiesTest, TestsInCore) //
+
@@ -0,0 +1,33 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "threads.hpp"
+
+namespace raptor
+{
+    // Number of threads set by set_num_threads, or -1 if
+    // omp_get_max_threads() should be used
+    static int raptor_num_threads = -1;
+
+    void set_num_threads(int n_threads)
+    {
+        if (n_threads < 1) n_threads = 1;
+        raptor_num_threads = n_threads;
+    }
+
+    int get_num_threads()
+    {
+#ifdef USING_OPENMP
+        if (raptor_num_threads < 0)
+            return omp_get_max_threads();
+        return raptor_num_threads;
+#else
+        return 1;
+#endif
+    }
+
+    int kernel_num_threads(int nnz)
+    {
+        if (nnz < THREAD_NNZ_MIN) return 1;
+        return get_num_threads();
+    }
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_CORE_THREADS_HPP
+#define RAPTOR_CORE_THREADS_HPP
+
+#include "types.hpp"
+
+#ifdef USING_OPENMP
+#include <omp.h>
+#endif
+
+// Local matrices with fewer nonzeros than this are always
+// multiplied serially, as thread startup outweighs the work
+#define THREAD_NNZ_MIN 4096
+
+// Marks an inner loop as free of loop-carried dependences, so that
+// it is vectorized (needs OpenMP 4.0 simd, so is only a hint to the
+// auto-vectorizer unless built WITH_OPENMP)
+#ifdef USING_OPENMP
+#define RAPTOR_SIMD _Pragma("omp simd")
+#else
+#define RAPTOR_SIMD
+#endif
+
+namespace raptor
+{
+    /**************************************************************
+    *****   Set Number of Threads
+    **************************************************************
+    ***** Sets the number of threads used by the local (on_proc and
+    ***** off_proc) matrix kernels.  Has no effect unless RAPtor is
+    ***** built WITH_OPENMP.  Defaults to omp_get_max_threads(), so
+    ***** OMP_NUM_THREADS can also be used to select this at run time.
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** n_threads : int
+    *****    Number of threads (values < 1 are treated as 1)
+    **************************************************************/
+    void set_num_threads(int n_threads);
+    int get_num_threads();
+
+    /**************************************************************
+    *****   Kernel Thread Count
+    **************************************************************
+    ***** Returns number of threads a kernel over nnz nonzeros
+    ***** should use (1 if the matrix is too small to split)
+    **************************************************************/
+    int kernel_num_threads(int nnz);
+
+    /**************************************************************
+    *****   Thread Row Bound
+    **************************************************************
+    ***** Returns first row owned by thread tid when rows are split
+    ***** across n_threads, balancing nnz + rows per thread (rows
+    ***** are counted so that runs of empty off_proc rows are also
+    ***** spread out).  Thread tid owns rows in
+    ***** [thread_row_bound(tid), thread_row_bound(tid+1)).
+    *****
+    ***** Parameters
+    ***** -------------
+    ***** rowptr : const int*
+    *****    Row pointer (idx1) of length n_rows+1
+    ***** n_rows : int
+    *****    Number of rows to split
+    ***** n_threads : int
+    *****    Number of threads rows are split across
+    ***** tid : int
+    *****    Thread to find first row of
+    **************************************************************/
+    inline int thread_row_bound(const int* rowptr, int n_rows,
+            int n_threads, int tid)
+    {
+        if (tid <= 0) return 0;
+        if (tid >= n_threads) return n_rows;
+
+        long total = (long) (rowptr[n_rows] - rowptr[0]) + n_rows;
+        long target = (total * tid) / n_threads;
+
+        // Binary search for first row i with (rowptr[i] - rowptr[0]) + i >= target
+        int lo = 0;
+        int hi = n_rows;
+        while (lo < hi)
+        {
+            int mid = lo + (hi - lo) / 2;
+            if ((long) (rowptr[mid] - rowptr[0]) + mid < target)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+}
+
+#endif
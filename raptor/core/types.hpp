@@ -24,9 +24,17 @@
 using namespace std;
 
 #define zero_tol 1e-16
-#define RAPtor_MPI_INDEX_T MPI_INT
+#ifdef USING_BIG_INDEX
+#define RAPtor_MPI_INDEX_T RAPtor_MPI_INT64_T
+#else
+#define RAPtor_MPI_INDEX_T RAPtor_MPI_INT
+#endif
 #define RAPtor_MPI_DATA_T MPI_DOUBLE
 
+// Default SELL-C-sigma parameters (rows per slice, rows per sorting window)
+#define SELL_SLICE_SIZE 8
+#define SELL_SIGMA 128
+
 // Defines for CF splitting and aggregation
 #define TmpSelection 4
 #define NewSelection 3
@@ -152,16 +160,25 @@ private:
 namespace raptor
 {
     using data_t = double;
+
+    // Global row and column indices (partitions, column and row maps,
+    // and any index exchanged between processes).  Local indices,
+    // such as idx2 of on_proc and off_proc after finalize, are int.
+#ifdef USING_BIG_INDEX
+    using index_t = int64_t;
+#else
     using index_t = int;
+#endif
     template <typename T>
     using aligned_vector = std::vector<T, AlignAllocator<T, 16>>;
     enum strength_t {Classical, Symmetric};
-    enum format_t {COO, CSR, CSC, BCOO, BSR, BSC};
+    enum format_t {COO, CSR, CSC, BCOO, BSR, BSC, SELL, FCSR};
     enum coarsen_t {RS, CLJP, Falgout, PMIS, HMIS};
     enum interp_t {Direct, ModClassical, Extended};
     enum agg_t {MIS};
     enum prolong_t {JacobiProlongation};
-    enum relax_t {Jacobi, SOR, SSOR};
+    enum relax_t {Jacobi, SOR, SSOR, HybridGS, HybridSGS, L1Jacobi};
+    enum coarse_solve_t {DenseLU, SparseLU, NodeLU, CoarseCG};
 
     template<typename T, typename U> 
     U sum_func(const U& a, const T&b)
@@ -5,8 +5,15 @@
 
 using namespace raptor;
 
-template <typename T, typename U>
-void vec_sort(aligned_vector<T>& vec1, aligned_vector<U>& vec2, int start = 0, int end = -1)
+// Swap positions i and j of vec (overloaded for block values)
+template <typename T>
+void vec_swap(aligned_vector<T>& vec, const int i, const int j)
+{
+    std::swap(vec[i], vec[j]);
+}
+
+template <typename T, typename V>
+void vec_sort(aligned_vector<T>& vec1, V& vec2, int start = 0, int end = -1)
 {
     vec1.shrink_to_fit();
     vec2.shrink_to_fit();
@@ -34,7 +41,7 @@ void vec_sort(aligned_vector<T>& vec1, aligned_vector<U>& vec2, int start = 0, i
         while (i != k)
         {
             std::swap(vec1[prev_k + start], vec1[k + start]);
-            std::swap(vec2[prev_k + start], vec2[k + start]);
+            vec_swap(vec2, prev_k + start, k + start);
             done[k] = true;
             prev_k = k;
             k = p[k];
@@ -42,9 +49,9 @@ void vec_sort(aligned_vector<T>& vec1, aligned_vector<U>& vec2, int start = 0, i
     }
 }
 
-template <typename T, typename U>
+template <typename T, typename V>
 void vec_sort(aligned_vector<T>& vec1, aligned_vector<T>& vec2, 
-        aligned_vector<U>& vec3,
+        V& vec3,
         int start = 0, int end = -1)
 {
     vec1.shrink_to_fit();
@@ -82,7 +89,7 @@ void vec_sort(aligned_vector<T>& vec1, aligned_vector<T>& vec2,
         {
             std::swap(vec1[idx1], vec1[idx2]);
             std::swap(vec2[idx1], vec2[idx2]);
-            std::swap(vec3[idx1], vec3[idx2]);
+            vec_swap(vec3, idx1, idx2);
             done[k] = true;
             prev_k = k;
             k = p[k];
@@ -90,6 +97,153 @@ void vec_sort(aligned_vector<T>& vec1, aligned_vector<T>& vec2,
     }
 }
 
+// Sort vec and remove duplicate entries, leaving a sorted list of
+// unique values (e.g. the off_proc_column_map of a matrix)
+template <typename T>
+void sort_unique(aligned_vector<T>& vec)
+{
+    std::sort(vec.begin(), vec.end());
+    vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+}
+
+// Position of key in the sorted vector vec, or -1 if key is not found
+template <typename T>
+int sorted_index(const aligned_vector<T>& vec, const T key)
+{
+    typename aligned_vector<T>::const_iterator it =
+        std::lower_bound(vec.begin(), vec.end(), key);
+    if (it == vec.end() || *it != key) return -1;
+    return it - vec.begin();
+}
+
+/**************************************************************
+ *****   IntMap
+ **************************************************************
+ ***** Open-addressing hash map from non-negative index_t keys
+ ***** (global row or column indices) to integer values, used
+ ***** in place of std::map for global-to-local index lookups.
+ ***** Keys and values are stored in a single flat table with 
+ ***** linear probing, so lookups touch contiguous memory and
+ ***** no per-entry allocations are made.
+ *****
+ ***** Methods
+ ***** -------
+ ***** reserve(int n)
+ *****    Size table to hold n entries without rehashing
+ ***** operator[](int key)
+ *****    Returns reference to value for key, inserting 0 if absent
+ ***** find(int key, int absent = -1)
+ *****    Returns value for key, or absent if key is not in the map
+ ***** count(int key)
+ *****    Returns 1 if key is in the map, 0 otherwise
+ ***** size()
+ *****    Returns number of entries in the map
+ ***** clear()
+ *****    Removes all entries, keeping the table allocated
+ **************************************************************/
+class IntMap
+{
+public:
+    IntMap(int n = 0)
+    {
+        num_entries = 0;
+        mask = 0;
+        reserve(n);
+    }
+
+    void reserve(int n)
+    {
+        // Keep load factor at most 1/2
+        int capacity = 16;
+        while (capacity < 2*n) capacity *= 2;
+        if (capacity <= (int) keys.size()) return;
+        rehash(capacity);
+    }
+
+    int& operator[](const index_t key)
+    {
+        if (2*(num_entries + 1) > (int) keys.size())
+        {
+            rehash(keys.size() ? 2*keys.size() : 16);
+        }
+        int pos = probe(key);
+        if (keys[pos] == empty_key)
+        {
+            keys[pos] = key;
+            values[pos] = 0;
+            num_entries++;
+        }
+        return values[pos];
+    }
+
+    int find(const index_t key, const int absent = -1) const
+    {
+        if (num_entries == 0) return absent;
+        int pos = probe(key);
+        if (keys[pos] == empty_key) return absent;
+        return values[pos];
+    }
+
+    int count(const index_t key) const
+    {
+        if (num_entries == 0) return 0;
+        return keys[probe(key)] != empty_key;
+    }
+
+    int size() const
+    {
+        return num_entries;
+    }
+
+    void clear()
+    {
+        std::fill(keys.begin(), keys.end(), empty_key);
+        num_entries = 0;
+    }
+
+private:
+    enum { empty_key = -1 };
+
+    // Multiplicative (Fibonacci) hash, so that consecutive global
+    // indices are spread across the table
+    int hash(const index_t key) const
+    {
+        return (int)((((unsigned long long) key) * 11400714819323198485ull) >> 32) & mask;
+    }
+
+    // Position of key in table, or of the empty slot where it belongs
+    int probe(const index_t key) const
+    {
+        int pos = hash(key);
+        while (keys[pos] != empty_key && keys[pos] != key)
+        {
+            pos = (pos + 1) & mask;
+        }
+        return pos;
+    }
+
+    void rehash(const int capacity)
+    {
+        aligned_vector<index_t> old_keys(capacity, empty_key);
+        aligned_vector<int> old_values(capacity);
+        keys.swap(old_keys);
+        values.swap(old_values);
+        mask = capacity - 1;
+
+        int n = old_keys.size();
+        for (int i = 0; i < n; i++)
+        {
+            if (old_keys[i] == empty_key) continue;
+            int pos = probe(old_keys[i]);
+            keys[pos] = old_keys[i];
+            values[pos] = old_values[i];
+        }
+    }
 
+    aligned_vector<index_t> keys;
+    aligned_vector<int> values;
+    int num_entries;
+    int mask;
+};
 
 #endif
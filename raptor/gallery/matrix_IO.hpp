@@ -17,6 +17,7 @@
 
 using namespace raptor;
 
+bool little_endian();
 CSRMatrix* readMatrix(const char* filename);
 
 #endif
@@ -4,14 +4,9 @@
 #include "par_matrix_IO.hpp"
 #include "matrix_IO.hpp"
 #include <stdio.h>
+#include <stdint.h>
 #include "limits.h"
 
-bool little_endian()
-{
-    int num = 1;
-    return (*(char *)&num == 1);
-}
-
 template <class T>
 void endian_swap(T *objp)
 {
@@ -19,9 +14,29 @@ void endian_swap(T *objp)
   std::reverse(memp, memp + sizeof(T));
 }
 
-ParCSRMatrix* readParMatrix(const char* filename, 
+// Swap byte order of n contiguous values.  Written as a single pass
+// of builtin byte swaps so that the loop is vectorized.
+static void endian_swap_bulk(int32_t* data, int n)
+{
+    uint32_t* udata = reinterpret_cast<uint32_t*>(data);
+    for (int i = 0; i < n; i++)
+    {
+        udata[i] = __builtin_bswap32(udata[i]);
+    }
+}
+
+static void endian_swap_bulk(double* data, int n)
+{
+    uint64_t* udata = reinterpret_cast<uint64_t*>(data);
+    for (int i = 0; i < n; i++)
+    {
+        udata[i] = __builtin_bswap64(udata[i]);
+    }
+}
+
+ParCSRMatrix* readParMatrix(const char* filename,
         int local_num_rows, int local_num_cols,
-        int first_local_row, int first_local_col, 
+        index_t first_local_row, index_t first_local_col,
         RAPtor_MPI_Comm comm)
 {
     int rank, num_procs;
@@ -30,47 +45,39 @@ ParCSRMatrix* readParMatrix(const char* filename,
 
     ParCSRMatrix* A = NULL;
 
-
-    int64_t pos;
-    int32_t code;
+    int32_t header[4];
     int32_t global_num_rows;
     int32_t global_num_cols;
-    int32_t global_nnz;
     int32_t idx;
-    double val;
-
-    bool is_little_endian = false;
-
-    int ctr, size;
 
-    int sizeof_dbl = sizeof(val);
-    int sizeof_int32 = sizeof(code);
+    int sizeof_dbl = sizeof(double);
+    int sizeof_int32 = sizeof(int32_t);
 
-    FILE* ifile = fopen(filename, "rb");
-    if (fseek(ifile, 0, SEEK_SET)) printf("Error seeking beginning of file\n"); 
-    
-    // Read code, and determine if little endian, or if long int
-    fread(&code, sizeof_int32, 1, ifile);
-    if (ferror(ifile)) printf("Error reading code\n");
-    if (code != PETSC_MAT_CODE)
+    RAPtor_MPI_File fh;
+    if (RAPtor_MPI_File_open(comm, filename, RAPtor_MPI_MODE_RDONLY,
+                RAPtor_MPI_INFO_NULL, &fh) != RAPtor_MPI_SUCCESS)
     {
-        endian_swap(&code);
-        is_little_endian = true;
+        if (rank == 0) printf("Error opening file %s\n", filename);
+        return NULL;
     }
 
-    fread(&global_num_rows, sizeof_int32, 1, ifile);
-    if (ferror(ifile)) printf("Error reading N\n");
-    fread(&global_num_cols, sizeof_int32, 1, ifile);
-    if (ferror(ifile)) printf("Error reading M\n");
-    fread(&global_nnz, sizeof_int32, 1, ifile);
-    if (ferror(ifile)) printf("Error reading nnz\n");
-
-    if (is_little_endian)
+    // Rank 0 reads code and dimensions, and determines if little endian
+    int is_little_endian = 0;
+    if (rank == 0)
     {
-        endian_swap(&global_num_rows);
-        endian_swap(&global_num_cols);
-        endian_swap(&global_nnz);
+        RAPtor_MPI_File_read_at(fh, 0, header, 4, RAPtor_MPI_INT,
+                RAPtor_MPI_STATUS_IGNORE);
+        if (header[0] != PETSC_MAT_CODE)
+        {
+            endian_swap_bulk(header, 4);
+            is_little_endian = 1;
+        }
+        if (header[0] != PETSC_MAT_CODE) printf("Error reading code\n");
     }
+    RAPtor_MPI_Bcast(header, 4, RAPtor_MPI_INT, 0, comm);
+    RAPtor_MPI_Bcast(&is_little_endian, 1, RAPtor_MPI_INT, 0, comm);
+    global_num_rows = header[1];
+    global_num_cols = header[2];
 
     if (first_local_col >= 0)
     {
@@ -83,24 +90,20 @@ ParCSRMatrix* readParMatrix(const char* filename,
         A = new ParCSRMatrix(global_num_rows, global_num_cols);
     }
 
-    aligned_vector<int32_t> row_sizes;
+    aligned_vector<int32_t> row_sizes(A->local_num_rows + 1);
     aligned_vector<int32_t> col_indices;
     aligned_vector<double> vals;
     aligned_vector<int> proc_nnz(num_procs);
-    if (A->local_num_rows)
-        row_sizes.resize(A->local_num_rows);
     int nnz = 0;
 
-    // Find row sizes
-    pos = (4 + A->partition->first_local_row) * sizeof_int32;
-    if (fseek(ifile, pos, SEEK_SET)) printf("Error seeking pos\n"); 
+    // Read row sizes of local rows
+    int64_t pos = ((int64_t) 4 + A->partition->first_local_row) * sizeof_int32;
+    RAPtor_MPI_File_read_at_all(fh, pos, row_sizes.data(), A->local_num_rows,
+            RAPtor_MPI_INT, RAPtor_MPI_STATUS_IGNORE);
+    if (is_little_endian) endian_swap_bulk(row_sizes.data(), A->local_num_rows);
     for (int i = 0; i < A->local_num_rows; i++)
     {
-        fread(&idx, sizeof_int32, 1, ifile);
-        if (ferror(ifile)) printf("Error reading row_size\n");
-        if (is_little_endian) endian_swap(&idx);
-        row_sizes[i] = idx;
-        nnz += idx;
+        nnz += row_sizes[i];
     }
 
     // Find nnz per proc (to find first_nnz)
@@ -112,64 +115,177 @@ ParCSRMatrix* readParMatrix(const char* filename,
     for (int i = rank; i < num_procs; i++)
         total_nnz += proc_nnz[i];
 
-    // Resize variables
-    if (nnz)
-    {
-        col_indices.resize(nnz);
-        vals.resize(nnz);
-    }
+    // Read col_indices and values, each with a single collective read
+    col_indices.resize(nnz + 1);
+    vals.resize(nnz + 1);
+    pos = ((int64_t) 4 + A->global_num_rows + first_nnz) * sizeof_int32;
+    RAPtor_MPI_File_read_at_all(fh, pos, col_indices.data(), nnz,
+            RAPtor_MPI_INT, RAPtor_MPI_STATUS_IGNORE);
+    pos = ((int64_t) 4 + A->global_num_rows + total_nnz) * sizeof_int32 + (first_nnz * sizeof_dbl);
+    RAPtor_MPI_File_read_at_all(fh, pos, vals.data(), nnz,
+            RAPtor_MPI_DOUBLE, RAPtor_MPI_STATUS_IGNORE);
+    RAPtor_MPI_File_close(&fh);
 
-    // Read in col_indices
-    pos = (4 + A->global_num_rows + first_nnz) * sizeof_int32;
-    if (fseek(ifile, pos, SEEK_SET)) printf("Error seeking pos\n"); 
-    for (int i = 0; i < nnz; i++)
+    if (is_little_endian)
     {
-        fread(&idx, sizeof_int32, 1, ifile);
-        if (ferror(ifile)) printf("Error reading col idx\n");
-        if (is_little_endian) endian_swap(&idx);
-        col_indices[i] = idx;
+        endian_swap_bulk(col_indices.data(), nnz);
+        endian_swap_bulk(vals.data(), nnz);
     }
 
-    pos = (4 + A->global_num_rows + total_nnz) * sizeof_int32 + (first_nnz * sizeof_dbl);
-    if (fseek(ifile, pos, SEEK_SET)) printf("Error seeking pos\n"); 
+    // Split rows into on_proc and off_proc
+    index_t first_col = A->partition->first_local_col;
+    index_t last_col = A->partition->last_local_col;
+    int on_nnz = 0;
     for (int i = 0; i < nnz; i++)
     {
-        fread(&val, sizeof_dbl, 1, ifile);
-        if (ferror(ifile)) printf("Error reading value\n");
-        if (is_little_endian) endian_swap(&val);
-        vals[i] = val;
+        idx = col_indices[i];
+        if (idx >= first_col && idx <= last_col) on_nnz++;
     }
-    fclose(ifile);
+    A->on_proc->idx2.resize(on_nnz);
+    A->on_proc->vals.resize(on_nnz);
+    A->off_proc->idx2.resize(nnz - on_nnz);
+    A->off_proc->vals.resize(nnz - on_nnz);
 
+    int ctr = 0;
+    int on_ctr = 0;
+    int off_ctr = 0;
     A->on_proc->idx1[0] = 0;
     A->off_proc->idx1[0] = 0;
-    ctr = 0;
     for (int i = 0; i < A->local_num_rows; i++)
     {
-        size = row_sizes[i];
+        int size = row_sizes[i];
         for (int j = 0; j < size; j++)
         {
             idx = col_indices[ctr];
-            val = vals[ctr++];
-            if ((int) idx >= A->partition->first_local_col &&
-                    (int) idx <= A->partition->last_local_col)
+            if (idx >= first_col && idx <= last_col)
             {
-                A->on_proc->idx2.emplace_back(idx - A->partition->first_local_col);
-                A->on_proc->vals.emplace_back(val);
+                A->on_proc->idx2[on_ctr] = idx - first_col;
+                A->on_proc->vals[on_ctr++] = vals[ctr];
             }
             else
             {
-                A->off_proc->idx2.emplace_back(idx);
-                A->off_proc->vals.emplace_back(val);
+                A->off_proc->idx2[off_ctr] = idx;
+                A->off_proc->vals[off_ctr++] = vals[ctr];
             }
-        } 
-        A->on_proc->idx1[i+1] = A->on_proc->idx2.size();
-        A->off_proc->idx1[i+1] = A->off_proc->idx2.size();
+            ctr++;
+        }
+        A->on_proc->idx1[i+1] = on_ctr;
+        A->off_proc->idx1[i+1] = off_ctr;
     }
-    A->on_proc->nnz = A->on_proc->idx2.size();
-    A->off_proc->nnz = A->off_proc->idx2.size();
+    A->on_proc->nnz = on_ctr;
+    A->off_proc->nnz = off_ctr;
 
     A->finalize();
 
     return A;
 }
+
+void writeParMatrix(ParCSRMatrix* A, const char* filename, RAPtor_MPI_Comm comm)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(comm, &rank);
+    RAPtor_MPI_Comm_size(comm, &num_procs);
+
+    // PETSc binary files hold 32-bit indices and sizes
+    if (A->global_num_rows > INT32_MAX || A->global_num_cols > INT32_MAX)
+    {
+        if (rank == 0)
+            fprintf(stderr, "writeParMatrix(): %ld x %ld matrix is too large "
+                    "for a PETSc binary file\n", (long) A->global_num_rows,
+                    (long) A->global_num_cols);
+        return;
+    }
+
+    int sizeof_dbl = sizeof(double);
+    int sizeof_int32 = sizeof(int32_t);
+    int nnz = A->local_nnz;
+    bool is_little_endian = little_endian();
+
+    // Form row sizes, and global columns of each row in ascending order
+    aligned_vector<int32_t> row_sizes(A->local_num_rows + 1);
+    aligned_vector<int32_t> col_indices(nnz + 1);
+    aligned_vector<double> vals(nnz + 1);
+    std::vector<std::pair<int32_t, double>> row;
+    int ctr = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        row.clear();
+        for (int j = A->on_proc->idx1[i]; j < A->on_proc->idx1[i+1]; j++)
+        {
+            row.emplace_back(A->on_proc_column_map[A->on_proc->idx2[j]],
+                    A->on_proc->vals[j]);
+        }
+        for (int j = A->off_proc->idx1[i]; j < A->off_proc->idx1[i+1]; j++)
+        {
+            row.emplace_back(A->off_proc_column_map[A->off_proc->idx2[j]],
+                    A->off_proc->vals[j]);
+        }
+        std::sort(row.begin(), row.end());
+        row_sizes[i] = row.size();
+        for (std::vector<std::pair<int32_t, double>>::iterator it = row.begin();
+                it != row.end(); ++it)
+        {
+            col_indices[ctr] = it->first;
+            vals[ctr++] = it->second;
+        }
+    }
+
+    // PETSc binary files are big endian
+    if (is_little_endian)
+    {
+        endian_swap_bulk(row_sizes.data(), A->local_num_rows);
+        endian_swap_bulk(col_indices.data(), nnz);
+        endian_swap_bulk(vals.data(), nnz);
+    }
+
+    // Find nnz per proc (to find first_nnz)
+    aligned_vector<int> proc_nnz(num_procs);
+    RAPtor_MPI_Allgather(&nnz, 1, RAPtor_MPI_INT, proc_nnz.data(), 1, RAPtor_MPI_INT, comm);
+    long first_nnz = 0;
+    for (int i = 0; i < rank; i++)
+        first_nnz += proc_nnz[i];
+    long total_nnz = first_nnz;
+    for (int i = rank; i < num_procs; i++)
+        total_nnz += proc_nnz[i];
+    if (total_nnz > INT32_MAX)
+    {
+        if (rank == 0)
+            fprintf(stderr, "writeParMatrix(): %ld nonzeros are too many "
+                    "for a PETSc binary file\n", total_nnz);
+        return;
+    }
+
+    RAPtor_MPI_File fh;
+    if (RAPtor_MPI_File_open(comm, filename, RAPtor_MPI_MODE_CREATE | RAPtor_MPI_MODE_WRONLY,
+            RAPtor_MPI_INFO_NULL, &fh) != RAPtor_MPI_SUCCESS)
+    {
+        if (rank == 0) printf("Error opening file %s\n", filename);
+        return;
+    }
+    RAPtor_MPI_File_set_size(fh, ((int64_t) 4 + A->global_num_rows + total_nnz) * sizeof_int32
+            + total_nnz * sizeof_dbl);
+
+    // Rank 0 writes code and dimensions
+    if (rank == 0)
+    {
+        int32_t header[4] = {PETSC_MAT_CODE, (int32_t) A->global_num_rows,
+            (int32_t) A->global_num_cols, (int32_t) total_nnz};
+        if (is_little_endian) endian_swap_bulk(header, 4);
+        RAPtor_MPI_File_write_at(fh, 0, header, 4, RAPtor_MPI_INT,
+                RAPtor_MPI_STATUS_IGNORE);
+    }
+
+    // Write row sizes, col_indices, and values, each with a single
+    // collective write
+    int64_t pos = ((int64_t) 4 + A->partition->first_local_row) * sizeof_int32;
+    RAPtor_MPI_File_write_at_all(fh, pos, row_sizes.data(), A->local_num_rows,
+            RAPtor_MPI_INT, RAPtor_MPI_STATUS_IGNORE);
+    pos = ((int64_t) 4 + A->global_num_rows + first_nnz) * sizeof_int32;
+    RAPtor_MPI_File_write_at_all(fh, pos, col_indices.data(), nnz,
+            RAPtor_MPI_INT, RAPtor_MPI_STATUS_IGNORE);
+    pos = ((int64_t) 4 + A->global_num_rows + total_nnz) * sizeof_int32 + (first_nnz * sizeof_dbl);
+    RAPtor_MPI_File_write_at_all(fh, pos, vals.data(), nnz,
+            RAPtor_MPI_DOUBLE, RAPtor_MPI_STATUS_IGNORE);
+
+    RAPtor_MPI_File_close(&fh);
+}
@@ -19,7 +19,9 @@ using namespace raptor;
 
 ParCSRMatrix* readParMatrix(const char* filename, 
         int local_num_rows = -1, int local_num_cols = -1,
-        int first_local_row = -1, int first_local_col = -1, 
+        index_t first_local_row = -1, index_t first_local_col = -1, 
+        RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD);
+void writeParMatrix(ParCSRMatrix* A, const char* filename,
         RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD);
 
 #endif
@@ -10,131 +10,449 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <limits.h>
+#include <algorithm>
 
 #include "par_matrix_market.hpp"
 
 
 using namespace raptor;
 
-ParCSRMatrix* read_par_mm(const char *fname)
+/**************************************************************
+*****   MatrixMarket Entry Parsing
+**************************************************************
+***** Hand-written integer and floating point parsers for the
+***** coordinate entries of a MatrixMarket file.  Values with
+***** at most 19 significant digits and a small exponent are 
+***** converted exactly (as in strtod), and all others fall 
+***** back to strtod.  Buffers must be null-terminated.
+**************************************************************/
+static const double mm_pow10[23] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 
+    1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+    1e19, 1e20, 1e21, 1e22};
+
+static inline const char* mm_skip_blank(const char* p)
 {
-    FILE *f;
-    MM_typecode matcode;
-    int M, N, nz;
-    int i;
-    int row, col;
-    double val;
- 
-    if ((f = fopen(fname, "r")) == NULL)
-            return NULL;
- 
- 
-    if (mm_read_banner(f, &matcode) != 0)
+    while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+    return p;
+}
+
+template <typename T>
+static inline const char* mm_parse_int(const char* p, T* val)
+{
+    p = mm_skip_blank(p);
+    bool neg = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+
+    T v = 0;
+    while (*p >= '0' && *p <= '9')
     {
-        printf("mm_read_unsymetric: Could not process Matrix Market banner ");
-        printf(" in file [%s]\n", fname);
-        return NULL;
+        v = v * 10 + (*p - '0');
+        p++;
     }
- 
- 
-    if ( !(mm_is_real(matcode) && mm_is_matrix(matcode) &&
-            mm_is_sparse(matcode)))
+    *val = neg ? -v : v;
+    return p;
+}
+
+static inline const char* mm_parse_double(const char* p, double* val)
+{
+    p = mm_skip_blank(p);
+    const char* start = p;
+    bool neg = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+
+    uint64_t mantissa = 0;
+    int n_digits = 0;
+    int exponent = 0;
+    bool exact = true;
+    bool has_digits = false;
+
+    while (*p >= '0' && *p <= '9')
     {
-        fprintf(stderr, "Sorry, this application does not support ");
-        fprintf(stderr, "Market Market type: [%s]\n",
-                mm_typecode_to_str(matcode));
-        return NULL;
+        has_digits = true;
+        if (n_digits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa) n_digits++;
+        }
+        else
+        {
+            if (*p != '0') exact = false;
+            exponent++;
+        }
+        p++;
     }
- 
-    /* find out size of sparse matrix: M, N, nz .... */
- 
-    if (mm_read_mtx_crd_size(f, &M, &N, &nz) !=0)
+    if (*p == '.')
     {
-        fprintf(stderr, "read_unsymmetric_sparse(): could not parse matrix size.\n");
-        return NULL;
+        p++;
+        while (*p >= '0' && *p <= '9')
+        {
+            has_digits = true;
+            if (n_digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa) n_digits++;
+                exponent--;
+            }
+            else if (*p != '0')
+            {
+                exact = false;
+            }
+            p++;
+        }
+    }
+    if (has_digits && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D'))
+    {
+        int exp_val;
+        p = mm_parse_int(p + 1, &exp_val);
+        exponent += exp_val;
+    }
+
+    if (has_digits && exact && mantissa <= (1ull << 53)
+            && exponent >= -22 && exponent <= 22)
+    {
+        double v = (double) mantissa;
+        if (exponent < 0) v /= mm_pow10[-exponent];
+        else v *= mm_pow10[exponent];
+        *val = neg ? -v : v;
+        return p;
     }
- 
-    int row_nnz = nz / M;
-    ParCOOMatrix* A = new ParCOOMatrix(M, N);
-    A->on_proc->vals.reserve(row_nnz);
-    A->off_proc->vals.reserve(row_nnz);
-
-    /* NOTE: when reading in doubles, ANSI C requires the use of the "l"  */
-    /*   specifier as in "%lg", "%lf", "%le", otherwise errors will occur */
-    /*  (ANSI C X3.159-1989, Sec. 4.9.6.2, p. 136 lines 13-15)            */
- 
-    bool symmetric = mm_is_symmetric(matcode);
-    bool row_local;
-    bool col_local;
-    for (i=0; i<nz; i++)
+
+    char* end;
+    *val = strtod(start, &end);
+    return end;
+}
+
+// Reads the size line of a coordinate file (as mm_read_mtx_crd_size),
+// with dimensions and number of entries that may exceed 32 bits
+static int mm_read_crd_size_long(FILE* f, long* M, long* N, long* nz)
+{
+    char line[MM_MAX_LINE_LENGTH];
+    int num_items_read;
+
+    *M = *N = *nz = 0;
+    do
     {
-        fscanf(f, "%d %d %lg\n", &row, &col, &val);
-        row--;
-        col--;
-        if (row >= A->partition->first_local_row && row <= A->partition->last_local_row)
+        if (fgets(line, MM_MAX_LINE_LENGTH, f) == NULL)
+            return MM_PREMATURE_EOF;
+    } while (line[0] == '%');
+
+    if (sscanf(line, "%ld %ld %ld", M, N, nz) == 3)
+        return 0;
+
+    do
+    {
+        num_items_read = fscanf(f, "%ld %ld %ld", M, N, nz);
+        if (num_items_read == EOF) return MM_PREMATURE_EOF;
+    } while (num_items_read != 3);
+
+    return 0;
+}
+
+struct MMEntry
+{
+    index_t row;
+    index_t col;
+    double val;
+};
+
+/**************************************************************
+*****   Read Parallel MatrixMarket File
+**************************************************************
+***** Reads a real, integer, or pattern coordinate matrix (general,
+***** symmetric, or skew-symmetric) into a ParCSRMatrix.  Rank 0
+***** reads the header, after which each process reads a disjoint 
+***** byte range of the entries with MPI-IO.  Each process parses
+***** the lines that begin in its range, and entries are sent to
+***** the processes holding their rows with a single all-to-all.
+*****
+***** Parameters
+***** -------------
+***** fname : const char*
+*****    Name of MatrixMarket file
+***** 
+***** Returns
+***** -------------
+***** ParCSRMatrix* : matrix read from file, or NULL if the file
+*****    cannot be opened or its type is not supported
+**************************************************************/
+ParCSRMatrix* read_par_mm(const char *fname)
+{
+    RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD;
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(comm, &rank);
+    RAPtor_MPI_Comm_size(comm, &num_procs);
+
+    // Rank 0 reads banner and matrix dimensions
+    // header : [valid, M, N, nz, symmetric, skew, pattern]
+    long header[7] = {0, 0, 0, 0, 0, 0, 0};
+    long header_bytes = 0;
+    if (rank == 0)
+    {
+        FILE* f = fopen(fname, "r");
+        MM_typecode matcode;
+        if (f == NULL)
         {
-            row_local = true;
-            row -= A->partition->first_local_row;
+            fprintf(stderr, "read_par_mm(): could not open file [%s]\n", fname);
         }
-        else
+        else if (mm_read_banner(f, &matcode) != 0)
+        {
+            printf("mm_read_unsymetric: Could not process Matrix Market banner ");
+            printf(" in file [%s]\n", fname);
+        }
+        else if (!((mm_is_real(matcode) || mm_is_integer(matcode) 
+                        || mm_is_pattern(matcode)) && mm_is_matrix(matcode) 
+                    && mm_is_sparse(matcode)) || mm_is_hermitian(matcode))
         {
-            row_local = false;
-            if (!symmetric) 
-                continue;
+            fprintf(stderr, "Sorry, this application does not support ");
+            fprintf(stderr, "Market Market type: [%s]\n",
+                    mm_typecode_to_str(matcode));
         }
-        if (col >= A->partition->first_local_col && col <= A->partition->last_local_col)
+        else if (mm_read_crd_size_long(f, &header[1], &header[2], &header[3]) != 0)
         {
-            col_local = true;
-            col -= A->partition->first_local_col;
+            fprintf(stderr, "read_unsymmetric_sparse(): could not parse matrix size.\n");
         }
         else
         {
-            col_local = false;
-            if (!row_local) 
-                continue;
+            header[0] = 1;
+            header[4] = mm_is_symmetric(matcode) || mm_is_skew(matcode);
+            header[5] = mm_is_skew(matcode);
+            header[6] = mm_is_pattern(matcode);
+            header_bytes = ftell(f);
         }
+        if (f) fclose(f);
+    }
+    RAPtor_MPI_Bcast(header, 7, RAPtor_MPI_LONG, 0, comm);
+    RAPtor_MPI_Bcast(&header_bytes, 1, RAPtor_MPI_LONG, 0, comm);
+    if (!header[0]) return NULL;
+
+    index_t global_num_rows = header[1];
+    index_t global_num_cols = header[2];
+    bool symmetric = header[4];
+    bool skew = header[5];
+    bool pattern = header[6];
+
+    // Each process reads a disjoint range of bytes [start, end), 
+    // along with the byte preceding it (to find whether the range
+    // begins on a new line)
+    RAPtor_MPI_File fh;
+    RAPtor_MPI_Offset file_size;
+    RAPtor_MPI_File_open(comm, fname, RAPtor_MPI_MODE_RDONLY, 
+            RAPtor_MPI_INFO_NULL, &fh);
+    RAPtor_MPI_File_get_size(fh, &file_size);
+
+    long data_bytes = file_size - header_bytes;
+    long chunk = data_bytes / num_procs;
+    long extra = data_bytes % num_procs;
+    long start = header_bytes + rank * chunk + (rank < extra ? rank : extra);
+    long end = start + chunk + (rank < extra ? 1 : 0);
+    long read_size = end - start + 1;
+
+    // A single read is limited to INT_MAX bytes, so large ranges are
+    // read in chunks (every process joins each collective read)
+    aligned_vector<char> buffer(read_size + 1);
+    long max_read_size;
+    RAPtor_MPI_Allreduce(&read_size, &max_read_size, 1, RAPtor_MPI_LONG,
+            RAPtor_MPI_MAX, comm);
+    for (long offset = 0; offset < max_read_size; offset += INT_MAX)
+    {
+        long size = read_size - offset;
+        if (size < 0) size = 0;
+        if (size > INT_MAX) size = INT_MAX;
+        RAPtor_MPI_File_read_at_all(fh, start - 1 + offset, 
+                size ? &buffer[offset] : buffer.data(), (int) size,
+                RAPtor_MPI_CHAR, RAPtor_MPI_STATUS_IGNORE);
+    }
 
-        if (row_local)
+    // Read past end of range until the last line beginning in the
+    // range is complete
+    const int line_read = 256;
+    long pos = end;
+    bool complete = (end == start || buffer[read_size - 1] == '\n');
+    while (!complete && pos < file_size)
+    {
+        int size = line_read;
+        if (pos + size > file_size) size = file_size - pos;
+        long prev_size = read_size;
+        read_size += size;
+        buffer.resize(read_size + 1);
+        RAPtor_MPI_File_read_at(fh, pos, &buffer[prev_size], size, 
+                RAPtor_MPI_CHAR, RAPtor_MPI_STATUS_IGNORE);
+        for (long i = prev_size; i < read_size; i++)
         {
-            if (col_local)
+            if (buffer[i] == '\n')
             {
-                A->on_proc->add_value(row, col, val);
-            }
-            else
-            {
-                A->off_proc->add_value(row, col, val);
+                read_size = i + 1;
+                complete = true;
+                break;
             }
         }
+        pos += size;
+    }
+    buffer[read_size] = '\0';
+    RAPtor_MPI_File_close(&fh);
+
+    // Create matrix, and find first row of every process
+    ParCSRMatrix* A = new ParCSRMatrix(global_num_rows, global_num_cols);
+    aligned_vector<index_t> proc_first_row(num_procs + 1);
+    RAPtor_MPI_Allgather(&(A->partition->first_local_row), 1, RAPtor_MPI_INDEX_T,
+            proc_first_row.data(), 1, RAPtor_MPI_INDEX_T, comm);
+    proc_first_row[num_procs] = global_num_rows;
+
+    // Parse lines beginning within [start, end)
+    aligned_vector<MMEntry> entries;
+    aligned_vector<int> entry_procs;
+    aligned_vector<int> send_counts(num_procs, 0);
+    const char* p = buffer.data();
+    const char* p_end = p + (end - start + 1);
+    if (end > start && *p != '\n')
+    {
+        while (p < p_end && *p != '\n') p++;
+    }
+    p++;
 
-        if (symmetric)
+    MMEntry entry;
+    int proc;
+    while (p < p_end)
+    {
+        p = mm_skip_blank(p);
+        if (*p == '\n' || *p == '%' || *p == '\0')
         {
-            if (col_local)
-            {
-                if (row_local)
-                {
-                    A->on_proc->add_value(col, row, val);
-                }
-                else
-                {
-                    A->off_proc->add_value(col, row, val);
-                }
-            }
+            while (*p != '\n' && *p != '\0') p++;
+            if (*p == '\0') break;
+            p++;
+            continue;
+        }
+
+        p = mm_parse_int(p, &entry.row);
+        p = mm_parse_int(p, &entry.col);
+        if (pattern) entry.val = 1.0;
+        else p = mm_parse_double(p, &entry.val);
+        while (*p != '\n' && *p != '\0') p++;
+        if (*p == '\n') p++;
+
+        entry.row--;
+        entry.col--;
+        proc = std::upper_bound(proc_first_row.begin(), proc_first_row.end(),
+                entry.row) - proc_first_row.begin() - 1;
+        entries.emplace_back(entry);
+        entry_procs.emplace_back(proc);
+        send_counts[proc]++;
+
+        if (symmetric && entry.row != entry.col)
+        {
+            std::swap(entry.row, entry.col);
+            if (skew) entry.val = -entry.val;
+            proc = std::upper_bound(proc_first_row.begin(), proc_first_row.end(),
+                    entry.row) - proc_first_row.begin() - 1;
+            entries.emplace_back(entry);
+            entry_procs.emplace_back(proc);
+            send_counts[proc]++;
+        }
+    }
+    buffer.clear();
+    buffer.shrink_to_fit();
+
+    // Send each entry to the process holding its row, with counts in
+    // entries (a contiguous datatype) so they do not overflow as bytes
+    RAPtor_MPI_Datatype entry_type;
+    RAPtor_MPI_Type_contiguous(sizeof(MMEntry), RAPtor_MPI_BYTE, &entry_type);
+    RAPtor_MPI_Type_commit(&entry_type);
+    long n_entries = entries.size();
+    aligned_vector<int> recv_counts(num_procs);
+    aligned_vector<int> send_displs(num_procs + 1);
+    aligned_vector<int> recv_displs(num_procs + 1);
+    RAPtor_MPI_Alltoall(send_counts.data(), 1, RAPtor_MPI_INT, recv_counts.data(),
+            1, RAPtor_MPI_INT, comm);
+    send_displs[0] = 0;
+    recv_displs[0] = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        send_displs[i+1] = send_displs[i] + send_counts[i];
+        recv_displs[i+1] = recv_displs[i] + recv_counts[i];
+    }
+    long n_recv = recv_displs[num_procs];
+    aligned_vector<MMEntry> send_entries(n_entries + 1);
+    aligned_vector<MMEntry> recv_entries(n_recv + 1);
+    aligned_vector<int> ctr(send_displs.begin(), send_displs.end() - 1);
+    for (long i = 0; i < n_entries; i++)
+    {
+        send_entries[ctr[entry_procs[i]]++] = entries[i];
+    }
+    entries.clear();
+    entries.shrink_to_fit();
+    RAPtor_MPI_Alltoallv(send_entries.data(), send_counts.data(), send_displs.data(),
+            entry_type, recv_entries.data(), recv_counts.data(), 
+            recv_displs.data(), entry_type, comm);
+    RAPtor_MPI_Type_free(&entry_type);
+
+    // Form on_proc and off_proc CSR matrices directly from entries
+    index_t first_row = A->partition->first_local_row;
+    index_t first_col = A->partition->first_local_col;
+    index_t last_col = A->partition->last_local_col;
+    index_t col;
+    int row;
+    CSRMatrix* on_proc = (CSRMatrix*) A->on_proc;
+    CSRMatrix* off_proc = (CSRMatrix*) A->off_proc;
+    std::fill(on_proc->idx1.begin(), on_proc->idx1.end(), 0);
+    std::fill(off_proc->idx1.begin(), off_proc->idx1.end(), 0);
+    for (long i = 0; i < n_recv; i++)
+    {
+        row = recv_entries[i].row - first_row;
+        col = recv_entries[i].col;
+        if (col >= first_col && col <= last_col)
+            on_proc->idx1[row+1]++;
+        else
+            off_proc->idx1[row+1]++;
+    }
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        on_proc->idx1[i+1] += on_proc->idx1[i];
+        off_proc->idx1[i+1] += off_proc->idx1[i];
+    }
+    on_proc->nnz = on_proc->idx1[A->local_num_rows];
+    off_proc->nnz = off_proc->idx1[A->local_num_rows];
+    on_proc->idx2.resize(on_proc->nnz);
+    on_proc->vals.resize(on_proc->nnz);
+    off_proc->idx2.resize(off_proc->nnz);
+    off_proc->vals.resize(off_proc->nnz);
+
+    // Hold global columns of off_proc nonzeros until they are condensed
+    aligned_vector<index_t> off_proc_cols(off_proc->nnz);
+    aligned_vector<int> on_ctr(on_proc->idx1.begin(), on_proc->idx1.end() - 1);
+    aligned_vector<int> off_ctr(off_proc->idx1.begin(), off_proc->idx1.end() - 1);
+    int idx;
+    for (long i = 0; i < n_recv; i++)
+    {
+        row = recv_entries[i].row - first_row;
+        col = recv_entries[i].col;
+        if (col >= first_col && col <= last_col)
+        {
+            idx = on_ctr[row]++;
+            on_proc->idx2[idx] = col - first_col;
+            on_proc->vals[idx] = recv_entries[i].val;
+        }
+        else
+        {
+            idx = off_ctr[row]++;
+            off_proc_cols[idx] = col;
+            off_proc->vals[idx] = recv_entries[i].val;
         }
     }
+    A->condense_off_proc(off_proc_cols);
 
     A->finalize();
-    ParCSRMatrix* A_csr = A->to_ParCSR();
-    delete A;
 
-    fclose(f);
- 
-    return A_csr;
+    return A;
 }
 
+
 void write_par_data(FILE* f, int n, int* rowptr, int* col_idx,
-        double* vals, int first_row, int* col_map)
+        double* vals, index_t first_row, index_t* col_map)
 {
-    int start, end, global_row;
+    int start, end;
+    index_t global_row;
 
     for (int i = 0; i < n; i++)
     {
@@ -143,8 +461,8 @@ void write_par_data(FILE* f, int n, int* rowptr, int* col_idx,
         end = rowptr[i+1];
         for (int j = start; j < end; j++)
         {
-            fprintf(f, "%d %d %2.15e\n", global_row + 1, 
-                    col_map[col_idx[j]] + 1, vals[j]);
+            fprintf(f, "%ld %ld %2.15e\n", (long)(global_row + 1), 
+                    (long)(col_map[col_idx[j]] + 1), vals[j]);
         }
     }
 }
@@ -159,8 +477,8 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
     FILE *f;
     MM_typecode matcode;
     int pos, bytes;
-    int int_bytes, double_bytes;
-    int num_ints, num_doubles;
+    int int_bytes, index_bytes, double_bytes;
+    int num_ints, num_indices, num_doubles;
     int comm_size;
 
     aligned_vector<char> buffer;
@@ -193,7 +511,7 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
                 global_nnz);
 
         // Write local data
-        int first_row = 0;
+        index_t first_row = 0;
         write_par_data(f, A->local_num_rows, A->on_proc->idx1.data(),
                 A->on_proc->idx2.data(), A->on_proc->vals.data(),
                 first_row, A->on_proc_column_map.data());
@@ -206,17 +524,18 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
         aligned_vector<int> idx1;
         aligned_vector<int> idx2;
         aligned_vector<double> vals;
-        aligned_vector<int> row_map;
-        aligned_vector<int> col_map; 
+        aligned_vector<index_t> col_map; 
         for (int i = 1; i < num_procs; i++)
         {
             // Calculate comm_size and allocate recv_buf
             int* i_dims = &proc_dims[i*5];
-            num_ints = i_dims[0] * 2 + i_dims[1] + i_dims[3] + i_dims[3] + i_dims[4];
+            num_ints = i_dims[0] * 2 + i_dims[3] + i_dims[4];
+            num_indices = i_dims[1] + i_dims[2];
             num_doubles = i_dims[3] + i_dims[4];
             RAPtor_MPI_Pack_size(num_ints, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD, &int_bytes);
+            RAPtor_MPI_Pack_size(num_indices, RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD, &index_bytes);
             RAPtor_MPI_Pack_size(num_doubles, RAPtor_MPI_DOUBLE, RAPtor_MPI_COMM_WORLD, &double_bytes);
-            comm_size = int_bytes + double_bytes;
+            comm_size = int_bytes + index_bytes + double_bytes;
             if (buffer.size() < comm_size) buffer.resize(comm_size);
 
             // Resize Matrix Arrays
@@ -240,7 +559,7 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
             // Unpack On Proc Data
             pos = 0;
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, col_map.data(), i_dims[1],
-                    RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                    RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD);
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, idx1.data(), i_dims[0],
                     RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, idx2.data(), i_dims[3],
@@ -251,7 +570,7 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
                     vals.data(), first_row, col_map.data());
 
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, col_map.data(), i_dims[2],
-                    RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                    RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD);
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, idx1.data(), i_dims[0],
                     RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, idx2.data(), i_dims[4],
@@ -269,16 +588,18 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
     else // All processes that are not 0, send to 0
     {
         // Determine send size (in bytes)
-        num_ints = dims[0] * 2 + dims[1] + dims[3] + dims[3] + dims[4];
+        num_ints = dims[0] * 2 + dims[3] + dims[4];
+        num_indices = dims[1] + dims[2];
         num_doubles = dims[3] + dims[4];
         RAPtor_MPI_Pack_size(num_ints, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD, &int_bytes);
+        RAPtor_MPI_Pack_size(num_indices, RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD, &index_bytes);
         RAPtor_MPI_Pack_size(num_doubles, RAPtor_MPI_DOUBLE, RAPtor_MPI_COMM_WORLD, &double_bytes);
-        comm_size = int_bytes + double_bytes;
+        comm_size = int_bytes + index_bytes + double_bytes;
         buffer.resize(comm_size);
 
         // Pack Data
         pos = 0;
-        RAPtor_MPI_Pack(A->on_proc_column_map.data(), dims[1], RAPtor_MPI_INT, buffer.data(), comm_size, 
+        RAPtor_MPI_Pack(A->on_proc_column_map.data(), dims[1], RAPtor_MPI_INDEX_T, buffer.data(), comm_size, 
                &pos, RAPtor_MPI_COMM_WORLD); 
         RAPtor_MPI_Pack(A->on_proc->idx1.data(), dims[0], RAPtor_MPI_INT, buffer.data(), comm_size,
                 &pos, RAPtor_MPI_COMM_WORLD);
@@ -287,7 +608,7 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
         RAPtor_MPI_Pack(A->on_proc->vals.data(), dims[3], RAPtor_MPI_DOUBLE, buffer.data(), comm_size,
                 &pos, RAPtor_MPI_COMM_WORLD);
         
-        RAPtor_MPI_Pack(A->off_proc_column_map.data(), dims[2], RAPtor_MPI_INT, buffer.data(), comm_size, 
+        RAPtor_MPI_Pack(A->off_proc_column_map.data(), dims[2], RAPtor_MPI_INDEX_T, buffer.data(), comm_size, 
                &pos, RAPtor_MPI_COMM_WORLD); 
         RAPtor_MPI_Pack(A->off_proc->idx1.data(), dims[0], RAPtor_MPI_INT, buffer.data(), comm_size,
                 &pos, RAPtor_MPI_COMM_WORLD);
@@ -10,6 +10,7 @@
 
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
+#include "core/par_stencil_operator.hpp"
 
 using namespace raptor;
 
@@ -20,20 +21,20 @@ ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim)
     RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
     RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
 
-    aligned_vector<int> diags;
+    aligned_vector<index_t> diags;
     aligned_vector<double> nonzero_stencil;
-    aligned_vector<int> strides(dim);
+    aligned_vector<index_t> strides(dim);
     aligned_vector<double> data;
     aligned_vector<int> stack_indices;
 
     int stencil_len, ctr;
-    int N_v;  // Number of rows (and cols) in matrix
+    index_t N_v;  // Number of rows (and cols) in matrix
     int N_s;  // Number of nonzero stencil entries
     int n_v;  // Local number of rows (and cols)
     
     int init_step, idx;
-    int len, step, current_step;
-    int col;
+    index_t len, step, current_step;
+    index_t col;
     double value;
 
     // Initialize variables
@@ -59,8 +60,8 @@ ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim)
     ParCSRMatrix* A = new ParCSRMatrix(N_v, N_v);
 
     n_v = A->partition->local_num_rows;
-    int first_local_row = A->partition->first_local_row;
-    int last_local_row = first_local_row + n_v - 1;
+    index_t first_local_row = A->partition->first_local_row;
+    index_t last_local_row = first_local_row + n_v - 1;
 
     A->on_proc->n_rows = n_v;
     A->on_proc->n_cols = n_v;
@@ -208,7 +209,10 @@ ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim)
         }
     }
 
-    //Add diagonals to ParMatrix A
+    //Add diagonals to ParMatrix A, holding global columns of 
+    //off_proc nonzeros until they are condensed
+    aligned_vector<index_t> off_proc_cols;
+    off_proc_cols.reserve(0.3*n_v*stencil_len);
     A->on_proc->idx1[0] = 0;
     A->off_proc->idx1[0] = 0;
     for (index_t i = 0; i < n_v; i++)
@@ -220,7 +224,15 @@ ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim)
             value = data[(N_s-d-1)*n_v+i];
             if (col >= 0 && col < N_v && fabs(value) > zero_tol)
             {
-                A->add_value(i, col, value);
+                if (col >= first_local_row && col <= last_local_row)
+                {
+                    A->on_proc->add_value(i, col - first_local_row, value);
+                }
+                else
+                {
+                    A->off_proc->add_value(i, 0, value);
+                    off_proc_cols.emplace_back(col);
+                }
             }
         }
         A->on_proc->idx1[i+1] = A->on_proc->idx2.size();
@@ -229,12 +241,188 @@ ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim)
 
     A->on_proc->nnz = A->on_proc->idx2.size();
     A->off_proc->nnz = A->off_proc->idx2.size();
+    A->condense_off_proc(off_proc_cols);
     
     A->finalize();
 
     return A;
 } 
 
+/**************************************************************
+*****   Par Stencil Grid (Processor Grid)
+**************************************************************
+***** Forms a parallel matrix from a stencil on a structured 
+***** grid, with each process holding a brick subdomain of the
+***** processor grid proc_grid, rather than a slab of rows in 
+***** lexicographic order.  Rows are numbered subdomain-major
+***** (points of rank 0's brick first, lexicographic within each
+***** brick), so the row partition stays contiguous while the
+***** off_proc halo of each process shrinks to the faces of its
+***** brick.
+*****
+***** Parameters
+***** -------------
+***** stencil : data_t*
+*****    Stencil of length 3^dim
+***** grid : int*
+*****    Number of points in each dimension
+***** dim : int
+*****    Number of dimensions
+***** proc_grid : int*
+*****    Number of processes in each dimension, with product 
+*****    equal to num_procs (see par_stencil_proc_grid)
+**************************************************************/
+ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim, int* proc_grid)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    int stencil_len = (int) pow(3, dim);
+    int proc, rem, size;
+    index_t N_v = 1;
+    for (int d = 0; d < dim; d++)
+    {
+        N_v *= grid[d];
+    }
+
+    int grid_procs = 1;
+    for (int d = 0; d < dim; d++)
+    {
+        grid_procs *= proc_grid[d];
+    }
+    assert(grid_procs == num_procs);
+
+    // First row of each process, numbering bricks in order of rank
+    // (processor grid in lexicographic order, last dimension fastest)
+    aligned_vector<int> coords(dim);
+    aligned_vector<index_t> proc_first_row(num_procs + 1);
+    proc_first_row[0] = 0;
+    for (int p = 0; p < num_procs; p++)
+    {
+        size = 1;
+        rem = p;
+        for (int d = dim - 1; d >= 0; d--)
+        {
+            size *= brick_size(grid[d], proc_grid[d], rem % proc_grid[d]);
+            rem /= proc_grid[d];
+        }
+        proc_first_row[p+1] = proc_first_row[p] + size;
+    }
+
+    // Local brick : [lo, lo + n_local) in each dimension
+    aligned_vector<int> lo(dim);
+    aligned_vector<int> n_local(dim);
+    rem = rank;
+    for (int d = dim - 1; d >= 0; d--)
+    {
+        coords[d] = rem % proc_grid[d];
+        rem /= proc_grid[d];
+        lo[d] = brick_start(grid[d], proc_grid[d], coords[d]);
+        n_local[d] = brick_size(grid[d], proc_grid[d], coords[d]);
+    }
+    int n_v = proc_first_row[rank+1] - proc_first_row[rank];
+    index_t first_local_row = proc_first_row[rank];
+
+    // Offsets and values of nonzero stencil entries.  As in the 
+    // lexicographic par_stencil_grid, the entry with offset o 
+    // holds the stencil value at -o.
+    aligned_vector<int> offsets;
+    aligned_vector<double> values;
+    for (int i = 0; i < stencil_len; i++)
+    {
+        if (fabs(stencil[i]) > zero_tol)
+        {
+            rem = i;
+            for (int d = dim - 1; d >= 0; d--)
+            {
+                offsets.emplace_back(rem % 3 - 1);
+                rem /= 3;
+            }
+            std::reverse(offsets.end() - dim, offsets.end());
+            values.emplace_back(stencil[stencil_len - i - 1]);
+        }
+    }
+    int N_s = values.size();
+
+    ParCSRMatrix* A = new ParCSRMatrix(N_v, N_v, n_v, n_v, 
+            first_local_row, first_local_row);
+    A->on_proc->idx2.reserve(n_v*N_s);
+    A->on_proc->vals.reserve(n_v*N_s);
+
+    // Add each stencil entry, holding global columns of off_proc
+    // nonzeros until they are condensed
+    aligned_vector<index_t> off_proc_cols;
+    aligned_vector<int> x(dim);
+    aligned_vector<int> y(dim);
+    aligned_vector<int> y_part(dim);
+    index_t col;
+    bool in_grid;
+    A->on_proc->idx1[0] = 0;
+    A->off_proc->idx1[0] = 0;
+    for (int i = 0; i < n_v; i++)
+    {
+        rem = i;
+        for (int d = dim - 1; d >= 0; d--)
+        {
+            x[d] = lo[d] + rem % n_local[d];
+            rem /= n_local[d];
+        }
+
+        for (int s = 0; s < N_s; s++)
+        {
+            if (fabs(values[s]) <= zero_tol) continue;
+
+            in_grid = true;
+            for (int d = 0; d < dim; d++)
+            {
+                y[d] = x[d] + offsets[s*dim + d];
+                if (y[d] < 0 || y[d] >= grid[d])
+                {
+                    in_grid = false;
+                    break;
+                }
+            }
+            if (!in_grid) continue;
+
+            // Find process holding y, and position of y in its brick
+            proc = 0;
+            for (int d = 0; d < dim; d++)
+            {
+                y_part[d] = brick_part(grid[d], proc_grid[d], y[d]);
+                proc = proc * proc_grid[d] + y_part[d];
+            }
+            col = 0;
+            for (int d = 0; d < dim; d++)
+            {
+                col = col * brick_size(grid[d], proc_grid[d], y_part[d])
+                    + y[d] - brick_start(grid[d], proc_grid[d], y_part[d]);
+            }
+            col += proc_first_row[proc];
+
+            if (proc == rank)
+            {
+                A->on_proc->add_value(i, col - first_local_row, values[s]);
+            }
+            else
+            {
+                A->off_proc->add_value(i, 0, values[s]);
+                off_proc_cols.emplace_back(col);
+            }
+        }
+        A->on_proc->idx1[i+1] = A->on_proc->idx2.size();
+        A->off_proc->idx1[i+1] = A->off_proc->idx2.size();
+    }
+
+    A->on_proc->nnz = A->on_proc->idx2.size();
+    A->off_proc->nnz = A->off_proc->idx2.size();
+    A->condense_off_proc(off_proc_cols);
+
+    A->finalize();
+
+    return A;
+}
+
 #endif
 
 
@@ -0,0 +1,79 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+#include "tests/par_compare.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+TEST(ParMatrixIOTest, TestsInGallery)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    const char* f_in = "../../../../test_data/aniso.pm";
+    const char* f_out = "par_matrix_IO_out.pm";
+
+    // Write and read back matrix in parallel
+    ParCSRMatrix* A = readParMatrix(f_in);
+    writeParMatrix(A, f_out);
+    MPI_Barrier(MPI_COMM_WORLD);
+    ParCSRMatrix* A_out = readParMatrix(f_out);
+    compare(A, A_out);
+    delete A_out;
+
+    // Written file matches original when read sequentially
+    CSRMatrix* A_seq = readMatrix(f_in);
+    CSRMatrix* A_seq_out = readMatrix(f_out);
+    A_seq->sort();
+    A_seq_out->sort();
+    ASSERT_EQ(A_seq->n_rows, A_seq_out->n_rows);
+    ASSERT_EQ(A_seq->n_cols, A_seq_out->n_cols);
+    ASSERT_EQ(A_seq->nnz, A_seq_out->nnz);
+    for (int i = 0; i < A_seq->n_rows + 1; i++)
+        ASSERT_EQ(A_seq->idx1[i], A_seq_out->idx1[i]);
+    for (int i = 0; i < A_seq->nnz; i++)
+    {
+        ASSERT_EQ(A_seq->idx2[i], A_seq_out->idx2[i]);
+        ASSERT_EQ(A_seq->vals[i], A_seq_out->vals[i]);
+    }
+    delete A_seq_out;
+
+    // Read with uneven partition, in which rank 0 holds extra rows
+    int n = A->global_num_rows;
+    int extra = num_procs > 1 ? 37 : 0;
+    int local_n = (n - extra) / num_procs;
+    int first_n = rank * local_n + (rank ? extra : 0);
+    if (rank == 0) local_n += extra;
+    if (rank == num_procs - 1) local_n = n - first_n;
+    ParCSRMatrix* A_part = readParMatrix(f_in, local_n, local_n, first_n, first_n);
+    ASSERT_EQ(A_part->local_num_rows, local_n);
+    ASSERT_EQ(A_part->partition->first_local_row, first_n);
+    for (int i = 0; i < local_n; i++)
+    {
+        int row = first_n + i;
+        int row_nnz = (A_part->on_proc->idx1[i+1] - A_part->on_proc->idx1[i])
+            + (A_part->off_proc->idx1[i+1] - A_part->off_proc->idx1[i]);
+        ASSERT_EQ(row_nnz, A_seq->idx1[row+1] - A_seq->idx1[row]);
+    }
+    delete A_part;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) remove(f_out);
+
+    delete A_seq;
+    delete A;
+
+} // end of TEST(ParMatrixIOTest, TestsInGallery) //
+
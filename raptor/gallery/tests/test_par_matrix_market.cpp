@@ -16,6 +16,38 @@ int main(int argc, char** argv)
     return temp;
 } // end of main() //
 
+// Compare local rows of A with the same rows of sequential matrix A_seq
+void compare_rows(ParCSRMatrix* A, CSRMatrix* A_seq)
+{
+    ASSERT_EQ(A->global_num_rows, A_seq->n_rows);
+    ASSERT_EQ(A->global_num_cols, A_seq->n_cols);
+
+    std::vector<std::pair<int, double>> row, row_seq;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        row.clear();
+        row_seq.clear();
+        for (int j = A->on_proc->idx1[i]; j < A->on_proc->idx1[i+1]; j++)
+            row.emplace_back(A->on_proc_column_map[A->on_proc->idx2[j]],
+                    A->on_proc->vals[j]);
+        for (int j = A->off_proc->idx1[i]; j < A->off_proc->idx1[i+1]; j++)
+            row.emplace_back(A->off_proc_column_map[A->off_proc->idx2[j]],
+                    A->off_proc->vals[j]);
+        int global_row = A->local_row_map[i];
+        for (int j = A_seq->idx1[global_row]; j < A_seq->idx1[global_row+1]; j++)
+            row_seq.emplace_back(A_seq->idx2[j], A_seq->vals[j]);
+        std::sort(row.begin(), row.end());
+        std::sort(row_seq.begin(), row_seq.end());
+
+        ASSERT_EQ(row.size(), row_seq.size());
+        for (int j = 0; j < row.size(); j++)
+        {
+            ASSERT_EQ(row[j].first, row_seq[j].first);
+            ASSERT_NEAR(row[j].second, row_seq[j].second, 1e-15);
+        }
+    }
+}
+
 TEST(ParAnisoTest, TestsInGallery)
 {
     int rank, num_procs;
@@ -42,9 +74,39 @@ TEST(ParAnisoTest, TestsInGallery)
         remove(f_out);
     }
 
+    // Each process holds its rows of the sequentially read matrix
+    CSRMatrix* A_seq = read_mm(f_in);
+    compare_rows(Amm, A_seq);
+
+    delete A_seq;
     delete Amm_out;
     delete Amm;
 
  } // end of TEST(ParAnisoTest, TestsInGallery) //
 
+TEST(ParSymmetricMatrixMarketTest, TestsInGallery)
+{
+    // aniso.mtx holds only the lower triangle of a symmetric matrix
+    const char* f_in = "../../../../test_data/aniso.mtx";
+    ParCSRMatrix* A_mm = read_par_mm(f_in);
+
+    CSRMatrix* A_lower = read_mm(f_in);
+    COOMatrix* A_coo = new COOMatrix(A_lower->n_rows, A_lower->n_cols);
+    for (int i = 0; i < A_lower->n_rows; i++)
+    {
+        for (int j = A_lower->idx1[i]; j < A_lower->idx1[i+1]; j++)
+        {
+            A_coo->add_value(i, A_lower->idx2[j], A_lower->vals[j]);
+            if (A_lower->idx2[j] != i)
+                A_coo->add_value(A_lower->idx2[j], i, A_lower->vals[j]);
+        }
+    }
+    CSRMatrix* A_seq = A_coo->to_CSR();
+    compare_rows(A_mm, A_seq);
+
+    delete A_seq;
+    delete A_coo;
+    delete A_lower;
+    delete A_mm;
 
+} // end of TEST(ParSymmetricMatrixMarketTest, TestsInGallery) //
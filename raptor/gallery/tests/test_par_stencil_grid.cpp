@@ -0,0 +1,128 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Lexicographic index of each local row of a brick-partitioned grid
+aligned_vector<int> brick_lex_rows(int* grid, int dim, int* proc_grid)
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    aligned_vector<int> lo(dim), n_local(dim);
+    int rem = rank;
+    int n = 1;
+    for (int d = dim - 1; d >= 0; d--)
+    {
+        int c = rem % proc_grid[d];
+        rem /= proc_grid[d];
+        int q = grid[d] / proc_grid[d];
+        int extra = grid[d] % proc_grid[d];
+        lo[d] = c * q + (c < extra ? c : extra);
+        n_local[d] = q + (c < extra);
+        n *= n_local[d];
+    }
+
+    aligned_vector<int> lex_rows(n);
+    for (int i = 0; i < n; i++)
+    {
+        int lex = 0;
+        int stride = 1;
+        rem = i;
+        for (int d = dim - 1; d >= 0; d--)
+        {
+            lex += (lo[d] + rem % n_local[d]) * stride;
+            rem /= n_local[d];
+            stride *= grid[d];
+        }
+        lex_rows[i] = lex;
+    }
+    return lex_rows;
+}
+
+void test_stencil_grid(double* stencil, int* grid, int dim)
+{
+    int num_procs;
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    aligned_vector<int> proc_grid(dim);
+    par_stencil_proc_grid(grid, dim, num_procs, proc_grid.data());
+    int grid_procs = 1;
+    for (int d = 0; d < dim; d++)
+    {
+        grid_procs *= proc_grid[d];
+    }
+    ASSERT_EQ(grid_procs, num_procs);
+
+    CSRMatrix* A_serial = stencil_grid(stencil, grid, dim);
+    ParCSRMatrix* A_lex = par_stencil_grid(stencil, grid, dim);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, dim, proc_grid.data());
+    aligned_vector<int> lex_rows = brick_lex_rows(grid, dim, proc_grid.data());
+
+    // Row partition is contiguous, in order of rank
+    ASSERT_EQ(A->global_num_rows, A_serial->n_rows);
+    ASSERT_EQ(A->local_num_rows, (int) lex_rows.size());
+    int n = A->local_num_rows;
+    MPI_Allreduce(MPI_IN_PLACE, &n, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_EQ(n, A->global_num_rows);
+    int nnz = A->local_nnz;
+    MPI_Allreduce(MPI_IN_PLACE, &nnz, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_EQ(nnz, A_serial->nnz);
+
+    // Same operator as the lexicographic grid, with rows and columns
+    // permuted to brick order
+    Vector x_serial(A_serial->n_rows);
+    Vector b_serial(A_serial->n_rows);
+    for (int i = 0; i < A_serial->n_rows; i++)
+    {
+        x_serial[i] = 1.0 / (i + 1);
+    }
+    A_serial->mult(x_serial, b_serial);
+
+    ParVector x(A->global_num_cols, A->on_proc_num_cols);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        x[i] = x_serial[lex_rows[i]];
+    }
+    A->mult(x, b);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        ASSERT_NEAR(b[i], b_serial[lex_rows[i]], 1e-10);
+    }
+
+    // Bricks communicate no more values than slabs
+    int off_proc_cols[2] = {A->off_proc_num_cols, A_lex->off_proc_num_cols};
+    MPI_Allreduce(MPI_IN_PLACE, off_proc_cols, 2, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_LE(off_proc_cols[0], off_proc_cols[1]);
+
+    delete A;
+    delete A_lex;
+    delete A_serial;
+}
+
+TEST(ParStencilGridTest, TestsInGallery)
+{
+    int grid_3d[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    test_stencil_grid(stencil, grid_3d, 3);
+    delete[] stencil;
+
+    int grid_2d[2] = {25, 25};
+    stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    test_stencil_grid(stencil, grid_2d, 2);
+    delete[] stencil;
+
+} // end of TEST(ParStencilGridTest, TestsInGallery) //
@@ -32,6 +32,9 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
     int iter;
     data_t alpha, beta, omega;
     data_t rr_inner, next_inner, Apr_inner, As_inner, AsAs_inner;
+    data_t r_inners[2], As_inners[2];
+    ParVector* r_vecs[2] = {&r_star, &r};
+    ParVector* As_vecs[2] = {&s, &As};
     double norm_r;
 
     // Same max iterations definition as pyAMG
@@ -56,8 +59,9 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
     // p0 = r0
     p.copy(r);
 
-    rr_inner = r.inner_product(r_star);
-    norm_r = r.norm(2);
+    r.inner_products(2, r_vecs, r_inners);
+    rr_inner = r_inners[0];
+    norm_r = sqrt(r_inners[1]);
     res.emplace_back(norm_r);
 
     if (norm_r != 0.0)
@@ -81,8 +85,9 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
 
         // omega_i = (As_i, s_i) / (As_i, As_i)
         A->mult(s, As);
-        As_inner = As.inner_product(s);
-        AsAs_inner = As.inner_product(As);
+        As.inner_products(2, As_vecs, As_inners);
+        As_inner = As_inners[0];
+        AsAs_inner = As_inners[1];
         omega = As_inner / AsAs_inner;
 
         // x_{i+1} = x_i + alpha_i * p_i + omega_i * s_i
@@ -94,7 +99,9 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
         r.axpy(As, -1.0*omega);
 
         // beta_i = (r_{i+1}, r_star) / (r_i, r_star) * alpha_i / omega_i
-        next_inner = r.inner_product(r_star);
+        // (r_{i+1}, r_star) and (r_{i+1}, r_{i+1}) with a single reduction
+        r.inner_products(2, r_vecs, r_inners);
+        next_inner = r_inners[0];
         beta = (next_inner / rr_inner) * (alpha / omega);
 
         // p_{i+1} = r_{i+1} + beta_i * (p_i - omega_i * Ap_i)
@@ -104,7 +111,7 @@ void BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double
 
         // Update next inner product
         rr_inner = next_inner;
-        norm_r = r.norm(2);
+        norm_r = sqrt(r_inners[1]);
         res.push_back(norm_r);
 
         iter++;
@@ -265,6 +272,9 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
     int iter;
     data_t alpha, beta, omega;
     data_t rr_inner, next_inner, Apr_inner, As_inner, AsAs_inner;
+    data_t r_inners[2], As_inners[2];
+    ParVector* r_vecs[2] = {&r_star, &r};
+    ParVector* As_vecs[2] = {&s, &As};
     double norm_r;
 
     // Same max iterations definition as pyAMG
@@ -291,8 +301,9 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
     p.copy(r);
 
     // Use true residual inner product to start
-    rr_inner = r.inner_product(r_star);
-    norm_r = r.norm(2);
+    r.inner_products(2, r_vecs, r_inners);
+    rr_inner = r_inners[0];
+    norm_r = sqrt(r_inners[1]);
     res.push_back(norm_r);
 
     if (norm_r != 0.0)
@@ -324,8 +335,9 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
 
         // omega_i = (As_i, s_i) / (As_i, As_i)
         A->mult(s_hat, As);
-        As_inner = As.inner_product(s);
-        AsAs_inner = As.inner_product(As);
+        As.inner_products(2, As_vecs, As_inners);
+        As_inner = As_inners[0];
+        AsAs_inner = As_inners[1];
         omega = As_inner / AsAs_inner;
 
         // x_{i+1} = x_i + alpha_i * p_i + omega_i * s_i
@@ -337,7 +349,9 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
         r.axpy(As, -1.0*omega);
 
         // beta_i = (r_{i+1}, r_star) / (r_i, r_star) * alpha_i / omega_i
-        next_inner = r.inner_product(r_star);
+        // (r_{i+1}, r_star) and (r_{i+1}, r_{i+1}) with a single reduction
+        r.inner_products(2, r_vecs, r_inners);
+        next_inner = r_inners[0];
         beta = (next_inner / rr_inner) * (alpha / omega);
 
         // p_{i+1} = r_{i+1} + beta_i * (p_i - omega_i * Ap_i)
@@ -347,7 +361,7 @@ void Pre_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, ParMultilevel *ml
 
         // Update next inner product
         rr_inner = next_inner;
-        norm_r = r.norm(2);
+        norm_r = sqrt(r_inners[1]);
         res.push_back(norm_r);
 
         iter++;
@@ -629,6 +643,8 @@ void PI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<dou
     int iter;
     data_t alpha, beta, omega;
     data_t rr_inner, next_inner, Apr_inner, As_inner, AsAs_inner;
+    data_t r_inners[2];
+    ParVector* r_vecs[2] = {&r_star, &r};
     double norm_r;
 
     // Same max iterations definition as pyAMG
@@ -655,8 +671,9 @@ void PI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<dou
     p.copy(r);
 
     // Use true residual inner product to start
-    rr_inner = r.inner_product(r_star);
-    norm_r = r.norm(2);
+    r.inner_products(2, r_vecs, r_inners);
+    rr_inner = r_inners[0];
+    norm_r = sqrt(r_inners[1]);
     res.emplace_back(norm_r);
 
     if (norm_r != 0.0)
@@ -700,7 +717,9 @@ void PI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<dou
         r.axpy(As, -1.0*omega);
 
         // beta_i = (r_{i+1}, r_star) / (r_i, r_star) * alpha_i / omega_i
-        next_inner = r.inner_product(r_star);
+        // (r_{i+1}, r_star) and (r_{i+1}, r_{i+1}) with a single reduction
+        r.inner_products(2, r_vecs, r_inners);
+        next_inner = r_inners[0];
         beta = (next_inner / rr_inner) * (alpha / omega);
 
         // p_{i+1} = r_{i+1} + beta_i * (p_i - omega_i * Ap_i)
@@ -710,7 +729,7 @@ void PI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<dou
 
         // Update next inner product
         rr_inner = next_inner;
-        norm_r = r.norm(2);
+        norm_r = sqrt(r_inners[1]);
         res.push_back(norm_r);
 
         iter++;
@@ -781,6 +800,9 @@ void PrePI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<
     int iter;
     data_t alpha, beta, omega;
     data_t rr_inner, next_inner, Apr_inner, As_inner, AsAs_inner;
+    data_t r_inners[2], As_inners[2];
+    ParVector* r_vecs[2] = {&r_star, &r};
+    ParVector* As_vecs[2] = {&s, &As};
     double norm_r;
 
     // Same max iterations definition as pyAMG
@@ -807,8 +829,9 @@ void PrePI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<
     p.copy(r);
 
     // Use true residual inner product to start
-    rr_inner = r.inner_product(r_star);
-    norm_r = r.norm(2);
+    r.inner_products(2, r_vecs, r_inners);
+    rr_inner = r_inners[0];
+    norm_r = sqrt(r_inners[1]);
     res.push_back(norm_r);
 
     if (norm_r != 0.0)
@@ -837,8 +860,9 @@ void PrePI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<
 
         // omega_i = (As_i, s_i) / (As_i, As_i)
         A->mult(s, As);
-        As_inner = As.inner_product(s);
-        AsAs_inner = As.inner_product(As);
+        As.inner_products(2, As_vecs, As_inners);
+        As_inner = As_inners[0];
+        AsAs_inner = As_inners[1];
         // Replace single inner product with half inner for testing
         // UPDATE THESE PARTIAL INNER PRODUCT CALCULATIONS
         /*if (iter % 2 == 0) {
@@ -862,7 +886,9 @@ void PrePI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<
         r.axpy(As, -1.0*omega);
 
         // beta_i = (r_{i+1}, r_star) / (r_i, r_star) * alpha_i / omega_i
-        next_inner = r.inner_product(r_star);
+        // (r_{i+1}, r_star) and (r_{i+1}, r_{i+1}) with a single reduction
+        r.inner_products(2, r_vecs, r_inners);
+        next_inner = r_inners[0];
         beta = (next_inner / rr_inner) * (alpha / omega);
 
         // p_{i+1} = r_{i+1} + beta_i * (p_i - omega_i * Ap_i)
@@ -872,7 +898,7 @@ void PrePI_BiCGStab(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<
 
         // Update next inner product
         rr_inner = next_inner;
-        norm_r = r.norm(2);
+        norm_r = sqrt(r_inners[1]);
         res.push_back(norm_r);
 
         iter++;
@@ -262,3 +262,211 @@ if (comm_t) *comm_t += RAPtor_MPI_Wtime();
     return;
 }
 
+
+
+/**************************************************************
+ *****   Pipelined Preconditioned Conjugate Gradient
+ **************************************************************
+ ***** Pipelined PCG (Ghysels and Vanroose).  The two inner 
+ ***** products of each iteration, (r, u) and (w, u), are reduced
+ ***** together with a single non-blocking Allreduce, which is 
+ ***** overlapped with the preconditioner (m = M^{-1}w) and the
+ ***** SpMV (n = A*m).  Auxiliary vectors s = A*p, q = M^{-1}s,
+ ***** and z = A*q are updated by recurrences.
+ *****
+ ***** The recurrences accumulate rounding errors, so every 
+ ***** replace_iter iterations r, u, w, s, q, and z are recomputed
+ ***** from x and p (residual replacement).
+ *****
+ ***** Residual history is stored as in PCG: the first entry is
+ ***** sqrt((r_0, M^{-1}r_0)), followed by 
+ ***** (r_i, M^{-1}r_i) / (b, M^{-1}b) for each iteration.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** replace_iter : int
+ *****    Number of iterations between residual replacements
+ *****    (no replacement if <= 0)
+ **************************************************************/
+void Pipelined_PCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, aligned_vector<double>& res, double tol, int max_iter, double* precond_t, double* comm_t, int replace_iter)
+{
+    int rank;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+
+    ParVector r;
+    ParVector u;
+    ParVector w;
+    ParVector m;
+    ParVector n;
+    ParVector p;
+    ParVector s;
+    ParVector q;
+    ParVector z;
+
+    int iter;
+    data_t alpha, beta, denom;
+    data_t b_inner, gamma, gamma_prev, delta;
+    double norm_b;
+    data_t inner[2];
+    ParVector* inner_vecs[2] = {&r, &w};
+    RAPtor_MPI_Request inner_request;
+
+    if (max_iter <= 0)
+    {
+        max_iter = ((int)(1.3*b.global_n)) + 2;
+    }
+
+    // Fixed Constructors
+    r.resize(b.global_n, b.local_n);
+    u.resize(b.global_n, b.local_n);
+    w.resize(b.global_n, b.local_n);
+    m.resize(b.global_n, b.local_n);
+    n.resize(b.global_n, b.local_n);
+    p.resize(b.global_n, b.local_n);
+    s.resize(b.global_n, b.local_n);
+    q.resize(b.global_n, b.local_n);
+    z.resize(b.global_n, b.local_n);
+
+    // Initial b_norm (preconditioned)
+    z.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+    ml->cycle(z, b);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+    b_inner = b.inner_product(z);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+    norm_b = sqrt(b_inner);
+    if (norm_b > zero_tol)
+    {
+        tol = tol * norm_b;
+    }
+
+    // r0 = b - A * x0, u0 = M^{-1}r0, w0 = A * u0
+    A->residual(x, b, r);
+    u.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+    ml->cycle(u, r);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+    A->mult(u, w);
+
+    p.set_const_value(0.0);
+    s.set_const_value(0.0);
+    q.set_const_value(0.0);
+    z.set_const_value(0.0);
+
+    double* r_vals = r.local.data();
+    double* u_vals = u.local.data();
+    double* w_vals = w.local.data();
+    double* m_vals = m.local.data();
+    double* n_vals = n.local.data();
+    double* p_vals = p.local.data();
+    double* s_vals = s.local.data();
+    double* q_vals = q.local.data();
+    double* z_vals = z.local.data();
+    double* x_vals = x.local.data();
+
+    alpha = 0.0;
+    gamma_prev = 0.0;
+    iter = 0;
+
+    // Main CG Loop
+    while (true)
+    {
+        // Start reduction of gamma = (u, r) and delta = (u, w)
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+        u.init_inner_products(2, inner_vecs, inner, &inner_request);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+
+        // m = M^{-1}w and n = A*m, overlapping the reduction
+        m.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+        ml->cycle(m, w);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+        A->mult(m, n);
+
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+        u.complete_inner_products(&inner_request);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+        gamma = inner[0];
+        delta = inner[1];
+
+        if (iter == 0)
+        {
+            res.emplace_back(sqrt(gamma));
+        }
+        else
+        {
+            res.emplace_back(gamma / b_inner);
+            if (gamma < tol) break;
+        }
+        if (iter == max_iter) break;
+
+        iter++;
+
+        // alpha_i = (r_i, u_i) / (A*p_i, p_i)
+        if (iter == 1)
+        {
+            beta = 0.0;
+            denom = delta;
+        }
+        else
+        {
+            beta = gamma / gamma_prev;
+            denom = delta - beta * gamma / alpha;
+        }
+        if (denom < 0.0)
+        {
+            if (rank == 0)
+            {
+                printf("Indefinite matrix detected in CG! Aborting...\n");
+            }
+            exit(-1);
+        }
+        alpha = gamma / denom;
+
+        // z = n + beta*z, q = m + beta*q, s = w + beta*s, p = u + beta*p
+        // x = x + alpha*p, r = r - alpha*s, u = u - alpha*q, w = w - alpha*z
+        for (int i = 0; i < b.local_n; i++)
+        {
+            z_vals[i] = n_vals[i] + beta * z_vals[i];
+            q_vals[i] = m_vals[i] + beta * q_vals[i];
+            s_vals[i] = w_vals[i] + beta * s_vals[i];
+            p_vals[i] = u_vals[i] + beta * p_vals[i];
+            x_vals[i] += alpha * p_vals[i];
+            r_vals[i] -= alpha * s_vals[i];
+            u_vals[i] -= alpha * q_vals[i];
+            w_vals[i] -= alpha * z_vals[i];
+        }
+        gamma_prev = gamma;
+
+        // Residual replacement
+        if (replace_iter > 0 && iter % replace_iter == 0)
+        {
+            A->residual(x, b, r);
+            A->mult(p, s);
+            u.set_const_value(0.0);
+            q.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+            ml->cycle(u, r);
+            ml->cycle(q, s);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+            A->mult(u, w);
+            A->mult(q, z);
+        }
+    }
+
+    if (rank == 0)
+    {
+        if (iter == max_iter)
+        {
+            printf("Max Iterations Reached.\n");
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+        }
+        printf("Relative Residual: %lg\n\n", res[iter]);
+    }
+
+    return;
+}
@@ -14,5 +14,8 @@ void CG(ParCSRMatrix* A, ParVector& x, ParVector& b, aligned_vector<double>& res
 void PCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
         aligned_vector<double>& res, double tol = 1e-05, int max_iter = -1,
         double* precond_t = NULL, double* comm_t = NULL);
+void Pipelined_PCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
+        aligned_vector<double>& res, double tol = 1e-05, int max_iter = -1,
+        double* precond_t = NULL, double* comm_t = NULL, int replace_iter = 50);
 
 #endif
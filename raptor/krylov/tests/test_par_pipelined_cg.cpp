@@ -0,0 +1,67 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+TEST(ParPipelinedCGTest, TestsInKrylov)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    aligned_vector<double> pcg_res;
+    aligned_vector<double> ppcg_res;
+    aligned_vector<double> replace_res;
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SSOR);
+    ml->setup(A);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+
+    x.set_const_value(0.0);
+    PCG(A, ml, x, b, pcg_res, 1e-10);
+    int pcg_iter = pcg_res.size() - 1;
+
+    x.set_const_value(0.0);
+    Pipelined_PCG(A, ml, x, b, ppcg_res, 1e-10);
+    int ppcg_iter = ppcg_res.size() - 1;
+    for (int i = 0; i < A->local_num_rows; i++)
+        ASSERT_NEAR(x[i], 1.0, 1e-04);
+
+    // Matches PCG until PCG restarts its search direction (iteration 8)
+    ASSERT_NEAR(ppcg_res[0], pcg_res[0], 1e-10 * pcg_res[0]);
+    for (int i = 1; i < 8 && i < ppcg_res.size() && i < pcg_res.size(); i++)
+        ASSERT_NEAR(ppcg_res[i], pcg_res[i], 1e-06 * pcg_res[i] + 1e-14);
+    ASSERT_LE(abs(ppcg_iter - pcg_iter), 2);
+
+    // Frequent residual replacement
+    x.set_const_value(0.0);
+    Pipelined_PCG(A, ml, x, b, replace_res, 1e-10, -1, NULL, NULL, 3);
+    for (int i = 0; i < A->local_num_rows; i++)
+        ASSERT_NEAR(x[i], 1.0, 1e-04);
+    ASSERT_LE(abs((int)replace_res.size() - (int)ppcg_res.size()), 2);
+
+    delete ml;
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(ParPipelinedCGTest, TestsInKrylov) //
+
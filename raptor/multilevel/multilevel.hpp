@@ -153,12 +153,15 @@ namespace raptor
                     switch (relax_type)
                     {
                         case Jacobi:
+                        case L1Jacobi:
                             jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight);
                             break;
                         case SOR:
+                        case HybridGS:
                             sor(A, x, b, tmp, num_smooth_sweeps, relax_weight);
                             break;
                         case SSOR:
+                        case HybridSGS:
                             ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight);
                             break;
                     }
@@ -179,12 +182,15 @@ namespace raptor
                     switch (relax_type)
                     {
                         case Jacobi:
+                        case L1Jacobi:
                             jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight);
                             break;
                         case SOR:
+                        case HybridGS:
                             sor(A, x, b, tmp, num_smooth_sweeps, relax_weight);
                             break;
                         case SSOR:
+                        case HybridSGS:
                             ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight);
                             break;
                     }
@@ -21,6 +21,10 @@ namespace raptor
                 P = NULL;
                 AP = NULL;
                 I = NULL;
+
+                S = NULL;
+                AP_plan = NULL;
+                Ac_plan = NULL;
             }
 
             ~ParLevel()
@@ -30,6 +34,10 @@ namespace raptor
 
                 delete AP;
                 delete I;
+
+                delete S;
+                delete AP_plan;
+                delete Ac_plan;
             }
 
             ParCSRMatrix* A;
@@ -40,6 +48,13 @@ namespace raptor
 
             ParCSRMatrix* AP;
             ParCSRMatrix* I;
+
+            // Kept after setup for resetup (see ParMultilevel)
+            ParCSRMatrix* S;
+            aligned_vector<int> states;
+            aligned_vector<int> off_proc_states;
+            ParMultPlan* AP_plan;
+            ParMultPlan* Ac_plan;
     };
 }
 #endif
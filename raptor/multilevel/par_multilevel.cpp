@@ -0,0 +1,1139 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include <string.h>
+#include <queue>
+#include <functional>
+#include <set>
+#include "multilevel/par_multilevel.hpp"
+#include "util/linalg/repartition.hpp"
+
+using namespace raptor;
+
+// Hierarchy file layout (all sections 8-byte aligned)
+//   header  : long[RAPTOR_HIERARCHY_HEADER_SIZE] (magic, version,
+//             byte order, num_procs, num_levels, sizeof(index_t))
+//   offsets : long[num_procs+1], byte offset of each process's section
+//   section : raw arrays of each level's A and P, followed by the
+//             coarse LU factorization, in native byte order
+#define RAPTOR_HIERARCHY_MAGIC 0x4c4d5054504152L // "RAPTPML"
+#define RAPTOR_HIERARCHY_VERSION 2
+#define RAPTOR_HIERARCHY_BYTE_ORDER 0x0102030405060708L
+#define RAPTOR_HIERARCHY_HEADER_SIZE 6
+#define RAPTOR_HIERARCHY_MATRIX_DIMS 18
+
+// Largest count passed to a single MPI-IO call
+static const long hierarchy_io_chunk = 1L << 30;
+
+// Append n values to the buffer, padded to a multiple of 8 bytes
+template <typename T>
+static void hierarchy_pack(aligned_vector<char>& buffer, const T* data, long n)
+{
+    long bytes = n * sizeof(T);
+    long pos = buffer.size();
+    buffer.resize(pos + ((bytes + 7) & ~7L), 0);
+    if (bytes) memcpy(&buffer[pos], data, bytes);
+}
+
+// Copy n values out of the buffer, returning position of next array
+template <typename T>
+static const char* hierarchy_unpack(const char* p, T* data, long n)
+{
+    long bytes = n * sizeof(T);
+    if (bytes) memcpy(data, p, bytes);
+    return p + ((bytes + 7) & ~7L);
+}
+
+// Pack the local portion of A.  If shared, the partition of A is 
+// the same as that of the previously packed matrix (P shares the
+// row partition of A on each level)
+static void hierarchy_pack_matrix(aligned_vector<char>& buffer, ParCSRMatrix* A,
+        bool shared)
+{
+    CSRMatrix* on_proc = (CSRMatrix*) A->on_proc;
+    CSRMatrix* off_proc = (CSRMatrix*) A->off_proc;
+    Partition* part = A->partition;
+    int n = A->local_num_rows;
+
+    // Dimensions are stored as long, so that global sizes and first
+    // rows are not truncated with 64-bit indices
+    long dims[RAPTOR_HIERARCHY_MATRIX_DIMS] = {part->global_num_rows,
+        part->global_num_cols, part->local_num_rows, part->local_num_cols,
+        part->first_local_row, part->first_local_col, shared,
+        A->global_num_rows, A->global_num_cols, n, 
+        A->on_proc_num_cols, A->off_proc_num_cols,
+        on_proc->idx1[n], off_proc->idx1[n],
+        on_proc->sorted, on_proc->diag_first,
+        off_proc->sorted, off_proc->diag_first};
+    hierarchy_pack(buffer, dims, RAPTOR_HIERARCHY_MATRIX_DIMS);
+    hierarchy_pack(buffer, A->local_row_map.data(), n);
+    hierarchy_pack(buffer, A->on_proc_column_map.data(), A->on_proc_num_cols);
+    hierarchy_pack(buffer, A->off_proc_column_map.data(), A->off_proc_num_cols);
+
+    CSRMatrix* mats[2] = {on_proc, off_proc};
+    aligned_vector<double> vals;
+    for (int i = 0; i < 2; i++)
+    {
+        CSRMatrix* mat = mats[i];
+        int nnz = mat->idx1[n];
+        hierarchy_pack(buffer, mat->idx1.data(), n + 1);
+        hierarchy_pack(buffer, mat->idx2.data(), nnz);
+
+        // Single precision values are stored in double
+        if (mat->format() == FCSR)
+        {
+            CSRFloatMatrix* mat_f = (CSRFloatMatrix*) mat;
+            vals.resize(nnz);
+            for (int j = 0; j < nnz; j++)
+                vals[j] = mat_f->float_vals[j];
+            hierarchy_pack(buffer, vals.data(), nnz);
+        }
+        else
+        {
+            hierarchy_pack(buffer, mat->vals.data(), nnz);
+        }
+    }
+}
+
+static const char* hierarchy_unpack_matrix(const char* p, Partition* prev_part,
+        ParCSRMatrix** A_ptr)
+{
+    long dims[RAPTOR_HIERARCHY_MATRIX_DIMS];
+    p = hierarchy_unpack(p, dims, RAPTOR_HIERARCHY_MATRIX_DIMS);
+
+    Partition* part;
+    if (dims[6])
+    {
+        part = prev_part;
+    }
+    else
+    {
+        part = new Partition(dims[0], dims[1], dims[2], dims[3], dims[4], dims[5]);
+    }
+
+    int n = dims[9];
+    ParCSRMatrix* A = new ParCSRMatrix(part, dims[7], dims[8], n,
+            dims[10], dims[11]);
+    if (!dims[6]) part->num_shared = 0;
+
+    A->local_row_map.resize(n);
+    A->on_proc_column_map.resize(A->on_proc_num_cols);
+    A->off_proc_column_map.resize(A->off_proc_num_cols);
+    p = hierarchy_unpack(p, A->local_row_map.data(), n);
+    p = hierarchy_unpack(p, A->on_proc_column_map.data(), A->on_proc_num_cols);
+    p = hierarchy_unpack(p, A->off_proc_column_map.data(), A->off_proc_num_cols);
+
+    CSRMatrix* mats[2] = {(CSRMatrix*) A->on_proc, (CSRMatrix*) A->off_proc};
+    for (int i = 0; i < 2; i++)
+    {
+        CSRMatrix* mat = mats[i];
+        int nnz = dims[12 + i];
+        mat->nnz = nnz;
+        mat->idx1.resize(n + 1);
+        mat->idx2.resize(nnz);
+        mat->vals.resize(nnz);
+        p = hierarchy_unpack(p, mat->idx1.data(), n + 1);
+        p = hierarchy_unpack(p, mat->idx2.data(), nnz);
+        p = hierarchy_unpack(p, mat->vals.data(), nnz);
+        mat->sorted = dims[14 + 2*i];
+        mat->diag_first = dims[15 + 2*i];
+    }
+    A->local_nnz = dims[12] + dims[13];
+
+    // Communication pattern is rebuilt from the column maps
+    A->comm = new ParComm(A->partition, A->off_proc_column_map,
+            A->on_proc_column_map);
+
+    *A_ptr = A;
+    return p;
+}
+
+void ParMultilevel::save_hierarchy(const char* fname)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    // Pack local portion of every level, and coarse LU factorization
+    aligned_vector<char> buffer;
+    for (int i = 0; i < num_levels; i++)
+    {
+        ParCSRMatrix* A = levels[i]->A;
+        ParCSRMatrix* P = levels[i]->P;
+        if (i == 0 && fine_op)
+        {
+            // Fine level nonzeros of a matrix-free hierarchy are 
+            // formed again from fine_op
+            ParCSRMatrix* Af = fine_op->to_ParCSR();
+            Af->sort();
+            Af->on_proc->move_diag();
+            hierarchy_pack_matrix(buffer, Af, false);
+            delete Af;
+        }
+        else hierarchy_pack_matrix(buffer, A, false);
+        if (i < num_levels - 1)
+            hierarchy_pack_matrix(buffer, P, P->partition == A->partition);
+    }
+    int coarse_dims[2] = {0, 0};
+    if (coarse_solver == DenseLU && levels[num_levels-1]->A->local_num_rows)
+    {
+        coarse_dims[0] = coarse_n;
+        coarse_dims[1] = coarse_sizes.size();
+    }
+    hierarchy_pack(buffer, coarse_dims, 2);
+    if (coarse_dims[0])
+    {
+        hierarchy_pack(buffer, coarse_sizes.data(), coarse_dims[1]);
+        hierarchy_pack(buffer, coarse_displs.data(), coarse_dims[1] + 1);
+        hierarchy_pack(buffer, LU_permute.data(), coarse_n);
+        hierarchy_pack(buffer, A_coarse.data(), (long) coarse_n * coarse_n);
+    }
+
+    // Find offset of each process's section
+    long bytes = buffer.size();
+    aligned_vector<long> offsets(num_procs + 1);
+    RAPtor_MPI_Allgather(&bytes, 1, RAPtor_MPI_LONG, &offsets[1], 1, RAPtor_MPI_LONG,
+            RAPtor_MPI_COMM_WORLD);
+    offsets[0] = (RAPTOR_HIERARCHY_HEADER_SIZE + num_procs + 1) * sizeof(long);
+    long max_bytes = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (offsets[i+1] > max_bytes) max_bytes = offsets[i+1];
+        offsets[i+1] += offsets[i];
+    }
+
+    RAPtor_MPI_File fh;
+    RAPtor_MPI_File_open(RAPtor_MPI_COMM_WORLD, fname,
+            RAPtor_MPI_MODE_CREATE | RAPtor_MPI_MODE_WRONLY,
+            RAPtor_MPI_INFO_NULL, &fh);
+    RAPtor_MPI_File_set_size(fh, offsets[num_procs]);
+
+    if (rank == 0)
+    {
+        long header[RAPTOR_HIERARCHY_HEADER_SIZE] = {RAPTOR_HIERARCHY_MAGIC,
+            RAPTOR_HIERARCHY_VERSION, RAPTOR_HIERARCHY_BYTE_ORDER,
+            num_procs, num_levels, (long) sizeof(index_t)};
+        RAPtor_MPI_File_write_at(fh, 0, header, RAPTOR_HIERARCHY_HEADER_SIZE,
+                RAPtor_MPI_LONG, RAPtor_MPI_STATUS_IGNORE);
+        RAPtor_MPI_File_write_at(fh, RAPTOR_HIERARCHY_HEADER_SIZE * sizeof(long),
+                offsets.data(), num_procs + 1, RAPtor_MPI_LONG,
+                RAPtor_MPI_STATUS_IGNORE);
+    }
+
+    // Collective writes, split so that each count fits in an int
+    int num_chunks = (max_bytes + hierarchy_io_chunk - 1) / hierarchy_io_chunk;
+    for (int i = 0; i < num_chunks; i++)
+    {
+        long pos = i * hierarchy_io_chunk;
+        long size = bytes - pos;
+        if (size > hierarchy_io_chunk) size = hierarchy_io_chunk;
+        if (size < 0) size = 0;
+        RAPtor_MPI_File_write_at_all(fh, offsets[rank] + pos,
+                buffer.data() + (size ? pos : 0), size, RAPtor_MPI_BYTE,
+                RAPtor_MPI_STATUS_IGNORE);
+    }
+
+    RAPtor_MPI_File_close(&fh);
+}
+
+int ParMultilevel::load_hierarchy(const char* fname)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    RAPtor_MPI_File fh;
+    if (RAPtor_MPI_File_open(RAPtor_MPI_COMM_WORLD, fname, RAPtor_MPI_MODE_RDONLY,
+            RAPtor_MPI_INFO_NULL, &fh) != RAPtor_MPI_SUCCESS)
+    {
+        if (rank == 0)
+            fprintf(stderr, "load_hierarchy(): could not open file [%s]\n", fname);
+        return -1;
+    }
+
+    long header[RAPTOR_HIERARCHY_HEADER_SIZE];
+    RAPtor_MPI_File_read_at_all(fh, 0, header, RAPTOR_HIERARCHY_HEADER_SIZE,
+            RAPtor_MPI_LONG, RAPtor_MPI_STATUS_IGNORE);
+    if (header[0] != RAPTOR_HIERARCHY_MAGIC
+            || header[1] != RAPTOR_HIERARCHY_VERSION
+            || header[2] != RAPTOR_HIERARCHY_BYTE_ORDER
+            || header[3] != num_procs
+            || header[5] != (long) sizeof(index_t))
+    {
+        if (rank == 0)
+            fprintf(stderr, "load_hierarchy(): file [%s] is not a version %d "
+                    "hierarchy written natively on %d processes with %d-byte "
+                    "indices\n", fname, RAPTOR_HIERARCHY_VERSION, num_procs,
+                    (int) sizeof(index_t));
+        RAPtor_MPI_File_close(&fh);
+        return -1;
+    }
+
+    // Read this process's section of the file
+    long offsets[2];
+    RAPtor_MPI_File_read_at_all(fh, (RAPTOR_HIERARCHY_HEADER_SIZE + rank) * sizeof(long),
+            offsets, 2, RAPtor_MPI_LONG, RAPtor_MPI_STATUS_IGNORE);
+    long bytes = offsets[1] - offsets[0];
+    long max_bytes;
+    RAPtor_MPI_Allreduce(&bytes, &max_bytes, 1, RAPtor_MPI_LONG, RAPtor_MPI_MAX,
+            RAPtor_MPI_COMM_WORLD);
+    aligned_vector<char> buffer(bytes + 1);
+    int num_chunks = (max_bytes + hierarchy_io_chunk - 1) / hierarchy_io_chunk;
+    for (int i = 0; i < num_chunks; i++)
+    {
+        long pos = i * hierarchy_io_chunk;
+        long size = bytes - pos;
+        if (size > hierarchy_io_chunk) size = hierarchy_io_chunk;
+        if (size < 0) size = 0;
+        RAPtor_MPI_File_read_at_all(fh, offsets[0] + pos,
+                buffer.data() + (size ? pos : 0), size, RAPtor_MPI_BYTE,
+                RAPtor_MPI_STATUS_IGNORE);
+    }
+    RAPtor_MPI_File_close(&fh);
+
+    // Remove any existing hierarchy
+    clear_hierarchy();
+
+    // Unpack levels
+    const char* p = buffer.data();
+    num_levels = header[4];
+    for (int i = 0; i < num_levels; i++)
+    {
+        ParLevel* level = new ParLevel();
+        p = hierarchy_unpack_matrix(p, NULL, &(level->A));
+        if (i < num_levels - 1)
+            p = hierarchy_unpack_matrix(p, level->A->partition, &(level->P));
+        level->x.resize(level->A->global_num_rows, level->A->local_num_rows);
+        level->b.resize(level->A->global_num_rows, level->A->local_num_rows);
+        level->tmp.resize(level->A->global_num_rows, level->A->local_num_rows);
+        levels.emplace_back(level);
+
+        if (tap_amg >= 0 && tap_amg <= i)
+        {
+            level->A->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+            if (level->P)
+                level->P->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+        }
+    }
+
+    // Unpack coarse LU factorization, or set up the coarse solver if
+    // the file holds none (or another coarse solver is used)
+    int coarse_dims[2];
+    p = hierarchy_unpack(p, coarse_dims, 2);
+    if (coarse_solver != DenseLU || !coarse_dims[0])
+    {
+        setup_coarse_solver();
+    }
+    else
+    {
+        aligned_vector<int> proc_sizes;
+        aligned_vector<int> active_procs;
+        create_coarse_comm(proc_sizes, active_procs);
+
+        coarse_n = coarse_dims[0];
+        coarse_sizes.resize(coarse_dims[1]);
+        coarse_displs.resize(coarse_dims[1] + 1);
+        LU_permute.resize(coarse_n);
+        A_coarse.resize((long) coarse_n * coarse_n);
+        p = hierarchy_unpack(p, coarse_sizes.data(), coarse_dims[1]);
+        p = hierarchy_unpack(p, coarse_displs.data(), coarse_dims[1] + 1);
+        p = hierarchy_unpack(p, LU_permute.data(), coarse_n);
+        p = hierarchy_unpack(p, A_coarse.data(), (long) coarse_n * coarse_n);
+    }
+
+    init_solve_phase();
+
+    return 0;
+}
+
+void ParMultilevel::resetup_helper(ParCSRMatrix* Af)
+{
+    // Af replaces any matrix-free fine level
+    fine_op = NULL;
+
+    // The hierarchy can only be reused if it was formed with 
+    // allow_resetup (and without agglomeration), on_proc and off_proc
+    // are still in CSR format, and Af has the pattern of the fine 
+    // level matrix on every process
+    ParCSRMatrix* A = NULL;
+    int reuse = allow_resetup && !agglomerated && num_levels > 0 
+        && !sell_solve && !mixed_precision;
+    if (reuse && num_levels > 1 && levels[0]->Ac_plan == NULL) reuse = 0;
+    if (reuse)
+    {
+        A = Af->copy();
+        A->sort();
+        A->on_proc->move_diag();
+        ParCSRMatrix* Al = levels[0]->A;
+        if (A->local_num_rows != Al->local_num_rows
+                || A->off_proc_column_map != Al->off_proc_column_map
+                || A->on_proc->idx1 != Al->on_proc->idx1
+                || A->on_proc->idx2 != Al->on_proc->idx2
+                || A->off_proc->idx1 != Al->off_proc->idx1
+                || A->off_proc->idx2 != Al->off_proc->idx2)
+        {
+            reuse = 0;
+        }
+    }
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &reuse, 1, RAPtor_MPI_INT, RAPtor_MPI_MIN,
+            RAPtor_MPI_COMM_WORLD);
+    if (!reuse)
+    {
+        delete A;
+        clear_hierarchy();
+        setup(Af);
+        return;
+    }
+    ProfileScope resetup_scope("resetup");
+
+    // Refresh values on each level, keeping all structure and 
+    // communication packages
+    levels[0]->A->copy_values(A);
+    delete A;
+    for (int i = 0; i < num_levels - 1; i++)
+    {
+        bool tap_level = tap_amg >= 0 && tap_amg <= i;
+        ParLevel* l = levels[i];
+
+        update_interpolation(i);
+        l->A->mult_numeric(l->P, l->AP, l->AP_plan, tap_level);
+        l->P->mult_T_numeric(l->AP, levels[i+1]->A, l->Ac_plan, tap_level);
+    }
+
+    // Refactor the coarsest matrix
+    free_coarse_solver();
+    setup_coarse_solver();
+}
+
+// Agglomerate levels[level] onto fewer processes if the average 
+// number of rows per active process is below agglomerate_rows.  Rows
+// are moved in contiguous blocks (in global order) to every stride-th
+// process and numbered by position, so the columns of P on the 
+// previous level are renumbered and re-split by the new partition.
+void ParMultilevel::agglomerate_level(int level)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    ParLevel* l = levels[level];
+    ParLevel* prev = levels[level - 1];
+    ParCSRMatrix* A = l->A;
+    ParCSRMatrix* P = prev->P;
+
+    int num_active = A->local_num_rows > 0;
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &num_active, 1, RAPtor_MPI_INT, 
+            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    if (num_active <= 1 || A->global_num_rows >= (long) agglomerate_rows * num_active)
+        return;
+
+    int num_new = A->global_num_rows / agglomerate_rows;
+    if (num_new < 1) num_new = 1;
+    int stride = num_procs / num_new;
+
+    // Position of first local row in global order (coarse global
+    // indices are increasing with rank, but not contiguous)
+    aligned_vector<int> proc_sizes(num_procs);
+    RAPtor_MPI_Allgather(&(A->local_num_rows), 1, RAPtor_MPI_INT, proc_sizes.data(),
+            1, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+    int first_pos = 0;
+    for (int i = 0; i < rank; i++)
+    {
+        first_pos += proc_sizes[i];
+    }
+
+    // New global index of each column of P, which is the position of
+    // the corresponding row of A in global order
+    IntMap row_to_local(A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        row_to_local[A->on_proc_column_map[i]] = i;
+    }
+    aligned_vector<int> on_proc_new(P->on_proc_num_cols);
+    for (int i = 0; i < P->on_proc_num_cols; i++)
+    {
+        on_proc_new[i] = first_pos + row_to_local.find(P->on_proc_column_map[i]);
+    }
+    ParComm* P_comm = new ParComm(P->partition, P->off_proc_column_map,
+            P->on_proc_column_map);
+    aligned_vector<int> off_proc_new = P_comm->communicate(on_proc_new);
+    delete P_comm;
+
+    // Renumber rows and columns of A by position, as repartition_matrix
+    // requires global indices below global_num_rows (A is replaced below)
+    aligned_vector<int> on_proc_pos(A->local_num_rows);
+    std::iota(on_proc_pos.begin(), on_proc_pos.end(), first_pos);
+    aligned_vector<int>& off_proc_pos = A->comm->communicate(on_proc_pos);
+    std::copy(off_proc_pos.begin(), off_proc_pos.end(), 
+            A->off_proc_column_map.begin());
+    A->on_proc_column_map.assign(on_proc_pos.begin(), on_proc_pos.end());
+    A->local_row_map.assign(on_proc_pos.begin(), on_proc_pos.end());
+
+    // Assign contiguous blocks of rows to active processes.  Received
+    // rows are ordered by sending process, so each keeps its index.
+    aligned_vector<int> proc_part(A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        long pos = first_pos + i;
+        proc_part[i] = stride * (int) ((pos * num_new) / A->global_num_rows);
+    }
+    aligned_vector<int> new_local_rows;
+    ParCSRMatrix* Ac = repartition_matrix(A, proc_part.data(), new_local_rows);
+
+    // Renumber and re-split columns of P by the partition of Ac
+    int first_col = Ac->partition->first_local_col;
+    int last_col = first_col + Ac->local_num_rows;
+    ParCSRMatrix* P_ag = new ParCSRMatrix(P->global_num_rows, Ac->global_num_rows,
+            P->local_num_rows, Ac->local_num_rows, P->partition->first_local_row,
+            first_col, P->partition->topology);
+    P_ag->on_proc->idx1[0] = 0;
+    P_ag->off_proc->idx1[0] = 0;
+    for (int i = 0; i < P->local_num_rows; i++)
+    {
+        for (int k = 0; k < 2; k++)
+        {
+            Matrix* mat = k ? P->off_proc : P->on_proc;
+            aligned_vector<int>& col_to_new = k ? off_proc_new : on_proc_new;
+            for (int j = mat->idx1[i]; j < mat->idx1[i+1]; j++)
+            {
+                int global_col = col_to_new[mat->idx2[j]];
+                if (global_col >= first_col && global_col < last_col)
+                {
+                    P_ag->on_proc->idx2.emplace_back(global_col - first_col);
+                    P_ag->on_proc->vals.emplace_back(mat->vals[j]);
+                }
+                else
+                {
+                    P_ag->off_proc->idx2.emplace_back(global_col);
+                    P_ag->off_proc->vals.emplace_back(mat->vals[j]);
+                }
+            }
+        }
+        P_ag->on_proc->idx1[i+1] = P_ag->on_proc->idx2.size();
+        P_ag->off_proc->idx1[i+1] = P_ag->off_proc->idx2.size();
+    }
+    P_ag->on_proc->nnz = P_ag->on_proc->idx2.size();
+    P_ag->off_proc->nnz = P_ag->off_proc->idx2.size();
+    P_ag->local_row_map = P->get_local_row_map();
+    P_ag->finalize();
+
+    if (tap_amg >= 0 && tap_amg <= level - 1)
+    {
+        P_ag->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+    }
+    if (tap_amg >= 0 && tap_amg <= level)
+    {
+        Ac->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+    }
+
+    // Move per-row solver data, and form new coarsening weights
+    agglomerate_data(A, Ac);
+    delete[] weights;
+    weights = NULL;
+    form_rand_weights(Ac->local_num_rows, Ac->partition->first_local_row);
+
+    // Galerkin product structure no longer matches P or Ac
+    delete prev->AP;
+    delete prev->AP_plan;
+    delete prev->Ac_plan;
+    prev->AP = NULL;
+    prev->AP_plan = NULL;
+    prev->Ac_plan = NULL;
+
+    delete P;
+    prev->P = P_ag;
+    delete A;
+    l->A = Ac;
+    l->x.resize(Ac->global_num_rows, Ac->local_num_rows);
+    l->b.resize(Ac->global_num_rows, Ac->local_num_rows);
+    l->tmp.resize(Ac->global_num_rows, Ac->local_num_rows);
+
+    agglomerated = true;
+}
+
+void ParMultilevel::setup_coarse_solver()
+{
+    coarse_setup_time = -RAPtor_MPI_Wtime();
+    coarse_solve_time = 0.0;
+
+    switch (coarse_solver)
+    {
+        case DenseLU:
+            duplicate_coarse();
+            break;
+        case SparseLU:
+            setup_sparse_coarse();
+            break;
+        case NodeLU:
+            setup_node_coarse();
+            break;
+        case CoarseCG:
+            setup_cg_coarse();
+            break;
+    }
+
+    coarse_setup_time += RAPtor_MPI_Wtime();
+}
+
+void ParMultilevel::free_coarse_solver()
+{
+    if (num_levels > 0 && levels[num_levels-1]->A->local_num_rows)
+    {
+        RAPtor_MPI_Comm_free(&coarse_comm);
+    }
+    if (node_comm != RAPtor_MPI_COMM_NULL)
+    {
+        RAPtor_MPI_Comm_free(&node_comm);
+    }
+    if (leader_comm != RAPtor_MPI_COMM_NULL)
+    {
+        RAPtor_MPI_Comm_free(&leader_comm);
+    }
+    delete coarse_LU;
+    coarse_LU = NULL;
+}
+
+void ParMultilevel::coarse_solve(ParVector& x, ParVector& b)
+{
+    coarse_solve_time -= RAPtor_MPI_Wtime();
+
+    switch (coarse_solver)
+    {
+        case DenseLU:
+            dense_coarse_solve(x, b);
+            break;
+        case SparseLU:
+            sparse_coarse_solve(x, b);
+            break;
+        case NodeLU:
+            node_coarse_solve(x, b);
+            break;
+        case CoarseCG:
+            cg_coarse_solve(x, b);
+            break;
+    }
+
+    coarse_solve_time += RAPtor_MPI_Wtime();
+}
+
+void ParMultilevel::dense_coarse_solve(ParVector& x, ParVector& b)
+{
+    if (levels[num_levels-1]->A->local_num_rows == 0) return;
+
+    int active_rank;
+    RAPtor_MPI_Comm_rank(coarse_comm, &active_rank);
+
+    char trans = 'N'; //No transpose
+    int nhrs = 1; // Number of right hand sides
+    int info; // result
+
+    aligned_vector<double> b_data(coarse_n);
+    RAPtor_MPI_Allgatherv(b.local.data(), b.local_n, RAPtor_MPI_DOUBLE, b_data.data(), 
+            coarse_sizes.data(), coarse_displs.data(), 
+            RAPtor_MPI_DOUBLE, coarse_comm);
+
+    dgetrs_(&trans, &coarse_n, &nhrs, A_coarse.data(), &coarse_n, 
+            LU_permute.data(), b_data.data(), &coarse_n, &info);
+    for (int i = 0; i < b.local_n; i++)
+    {
+        x.local[i] = b_data[i + coarse_displs[active_rank]];
+    }
+}
+
+// Gather rows of Ac, with global columns, onto root of comm.  Sizes
+// and displacements of the rows held by each process are returned
+// on every process, and the gathered rows (in order of rank) on root.
+static void gather_coarse_rows(ParCSRMatrix* Ac, RAPtor_MPI_Comm comm,
+        aligned_vector<int>& sizes, aligned_vector<int>& displs,
+        aligned_vector<index_t>& rows, aligned_vector<int>& row_sizes, 
+        aligned_vector<index_t>& cols, aligned_vector<double>& vals)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(comm, &rank);
+    RAPtor_MPI_Comm_size(comm, &num_procs);
+
+    sizes.resize(num_procs);
+    displs.resize(num_procs + 1);
+    RAPtor_MPI_Allgather(&(Ac->local_num_rows), 1, RAPtor_MPI_INT, sizes.data(), 1,
+            RAPtor_MPI_INT, comm);
+    displs[0] = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        displs[i+1] = displs[i] + sizes[i];
+    }
+
+    // Local rows with global column indices
+    aligned_vector<int> local_sizes(Ac->local_num_rows);
+    aligned_vector<index_t> local_cols;
+    aligned_vector<double> local_vals;
+    for (int i = 0; i < Ac->local_num_rows; i++)
+    {
+        for (int j = Ac->on_proc->idx1[i]; j < Ac->on_proc->idx1[i+1]; j++)
+        {
+            local_cols.emplace_back(Ac->on_proc_column_map[Ac->on_proc->idx2[j]]);
+            local_vals.emplace_back(Ac->on_proc->vals[j]);
+        }
+        for (int j = Ac->off_proc->idx1[i]; j < Ac->off_proc->idx1[i+1]; j++)
+        {
+            local_cols.emplace_back(Ac->off_proc_column_map[Ac->off_proc->idx2[j]]);
+            local_vals.emplace_back(Ac->off_proc->vals[j]);
+        }
+        local_sizes[i] = (Ac->on_proc->idx1[i+1] - Ac->on_proc->idx1[i])
+            + (Ac->off_proc->idx1[i+1] - Ac->off_proc->idx1[i]);
+    }
+
+    int n = rank == 0 ? displs[num_procs] : 0;
+    rows.resize(n);
+    row_sizes.resize(n);
+    RAPtor_MPI_Gatherv(Ac->local_row_map.data(), Ac->local_num_rows, RAPtor_MPI_INDEX_T,
+            rows.data(), sizes.data(), displs.data(), RAPtor_MPI_INDEX_T, 0, comm);
+    RAPtor_MPI_Gatherv(local_sizes.data(), Ac->local_num_rows, RAPtor_MPI_INT,
+            row_sizes.data(), sizes.data(), displs.data(), RAPtor_MPI_INT, 0, comm);
+
+    int nnz = local_cols.size();
+    aligned_vector<int> proc_nnz(num_procs);
+    aligned_vector<int> nnz_displs(num_procs + 1, 0);
+    RAPtor_MPI_Gather(&nnz, 1, RAPtor_MPI_INT, proc_nnz.data(), 1, RAPtor_MPI_INT, 0, comm);
+    for (int i = 0; i < num_procs; i++)
+    {
+        nnz_displs[i+1] = nnz_displs[i] + proc_nnz[i];
+    }
+    cols.resize(rank == 0 ? nnz_displs[num_procs] : 0);
+    vals.resize(rank == 0 ? nnz_displs[num_procs] : 0);
+    RAPtor_MPI_Gatherv(local_cols.data(), nnz, RAPtor_MPI_INDEX_T, cols.data(), 
+            proc_nnz.data(), nnz_displs.data(), RAPtor_MPI_INDEX_T, 0, comm);
+    RAPtor_MPI_Gatherv(local_vals.data(), nnz, RAPtor_MPI_DOUBLE, vals.data(), 
+            proc_nnz.data(), nnz_displs.data(), RAPtor_MPI_DOUBLE, 0, comm);
+}
+
+// Sparse LU factorization of A (without pivoting), formed row by row.
+// Columns of L in each row are eliminated in ascending order, taken
+// from a heap that grows as fill is introduced.
+static CSRMatrix* sparse_lu(CSRMatrix* A, aligned_vector<int>& diag)
+{
+    int n = A->n_rows;
+    int col;
+    double l_val;
+    CSRMatrix* LU = new CSRMatrix(n, n, A->nnz);
+    aligned_vector<double> work(n, 0.0);
+    aligned_vector<int> marker(n, -1);
+    aligned_vector<int> row_cols;
+    std::priority_queue<int, std::vector<int>, std::greater<int> > lower;
+
+    diag.resize(n);
+    LU->idx1[0] = 0;
+    for (int i = 0; i < n; i++)
+    {
+        row_cols.clear();
+        marker[i] = i;
+        row_cols.emplace_back(i);
+        for (int j = A->idx1[i]; j < A->idx1[i+1]; j++)
+        {
+            col = A->idx2[j];
+            work[col] += A->vals[j];
+            if (marker[col] != i)
+            {
+                marker[col] = i;
+                row_cols.emplace_back(col);
+                if (col < i) lower.push(col);
+            }
+        }
+
+        while (!lower.empty())
+        {
+            int k = lower.top();
+            lower.pop();
+            l_val = work[k] / LU->vals[diag[k]];
+            work[k] = l_val;
+            for (int j = diag[k] + 1; j < LU->idx1[k+1]; j++)
+            {
+                col = LU->idx2[j];
+                if (marker[col] != i)
+                {
+                    marker[col] = i;
+                    row_cols.emplace_back(col);
+                    if (col < i) lower.push(col);
+                }
+                work[col] -= l_val * LU->vals[j];
+            }
+        }
+
+        // Store L, diagonal, then U
+        std::sort(row_cols.begin(), row_cols.end());
+        for (aligned_vector<int>::iterator it = row_cols.begin(); 
+                it != row_cols.end(); ++it)
+        {
+            if (*it == i) diag[i] = LU->idx2.size();
+            LU->idx2.emplace_back(*it);
+            LU->vals.emplace_back(work[*it]);
+            work[*it] = 0.0;
+        }
+        LU->idx1[i+1] = LU->idx2.size();
+    }
+    LU->nnz = LU->idx2.size();
+
+    return LU;
+}
+
+void ParMultilevel::setup_sparse_coarse()
+{
+    ParCSRMatrix* Ac = levels[num_levels-1]->A;
+    aligned_vector<int> proc_sizes;
+    aligned_vector<int> active_procs;
+    create_coarse_comm(proc_sizes, active_procs);
+    if (Ac->local_num_rows == 0) return;
+
+    int active_rank;
+    RAPtor_MPI_Comm_rank(coarse_comm, &active_rank);
+
+    aligned_vector<index_t> rows, cols;
+    aligned_vector<int> row_sizes;
+    aligned_vector<double> vals;
+    gather_coarse_rows(Ac, coarse_comm, coarse_sizes, coarse_displs, 
+            rows, row_sizes, cols, vals);
+    coarse_n = Ac->global_num_rows;
+    if (active_rank) return;
+
+    // Coarse system, in order of gathered rows
+    IntMap global_to_local(coarse_n);
+    for (int i = 0; i < coarse_n; i++)
+    {
+        global_to_local[rows[i]] = i;
+    }
+    CSRMatrix* A_gather = new CSRMatrix(coarse_n, coarse_n, cols.size());
+    A_gather->idx1[0] = 0;
+    for (int i = 0; i < coarse_n; i++)
+    {
+        A_gather->idx1[i+1] = A_gather->idx1[i] + row_sizes[i];
+    }
+    A_gather->idx2.resize(cols.size());
+    A_gather->vals.resize(cols.size());
+    for (int i = 0; i < (int) cols.size(); i++)
+    {
+        A_gather->idx2[i] = global_to_local.find(cols[i]);
+        A_gather->vals[i] = vals[i];
+    }
+    A_gather->nnz = cols.size();
+
+    coarse_LU = sparse_lu(A_gather, coarse_LU_diag);
+    delete A_gather;
+}
+
+void ParMultilevel::sparse_coarse_solve(ParVector& x, ParVector& b)
+{
+    if (levels[num_levels-1]->A->local_num_rows == 0) return;
+
+    int active_rank;
+    RAPtor_MPI_Comm_rank(coarse_comm, &active_rank);
+
+    aligned_vector<double> b_data(active_rank == 0 ? coarse_n : 0);
+    RAPtor_MPI_Gatherv(b.local.data(), b.local_n, RAPtor_MPI_DOUBLE, b_data.data(),
+            coarse_sizes.data(), coarse_displs.data(), RAPtor_MPI_DOUBLE, 0,
+            coarse_comm);
+
+    if (active_rank == 0)
+    {
+        CSRMatrix* LU = coarse_LU;
+        for (int i = 0; i < coarse_n; i++)
+        {
+            for (int j = LU->idx1[i]; j < coarse_LU_diag[i]; j++)
+            {
+                b_data[i] -= LU->vals[j] * b_data[LU->idx2[j]];
+            }
+        }
+        for (int i = coarse_n - 1; i >= 0; i--)
+        {
+            for (int j = coarse_LU_diag[i] + 1; j < LU->idx1[i+1]; j++)
+            {
+                b_data[i] -= LU->vals[j] * b_data[LU->idx2[j]];
+            }
+            b_data[i] /= LU->vals[coarse_LU_diag[i]];
+        }
+    }
+
+    RAPtor_MPI_Scatterv(b_data.data(), coarse_sizes.data(), coarse_displs.data(),
+            RAPtor_MPI_DOUBLE, x.local.data(), x.local_n, RAPtor_MPI_DOUBLE, 0,
+            coarse_comm);
+}
+
+void ParMultilevel::setup_node_coarse()
+{
+    ParCSRMatrix* Ac = levels[num_levels-1]->A;
+    aligned_vector<int> proc_sizes;
+    aligned_vector<int> active_procs;
+    create_coarse_comm(proc_sizes, active_procs);
+    if (Ac->local_num_rows == 0) return;
+
+    int rank, active_rank, node_rank;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_rank(coarse_comm, &active_rank);
+
+    // Group active processes by node, with the first on each node 
+    // holding the factorization
+    int node = Ac->partition->topology->get_node(rank);
+    RAPtor_MPI_Comm_split(coarse_comm, node, active_rank, &node_comm);
+    RAPtor_MPI_Comm_rank(node_comm, &node_rank);
+    RAPtor_MPI_Comm_split(coarse_comm, node_rank == 0 ? 0 : RAPtor_MPI_UNDEFINED,
+            active_rank, &leader_comm);
+
+    aligned_vector<index_t> rows, cols;
+    aligned_vector<int> row_sizes;
+    aligned_vector<double> vals;
+    gather_coarse_rows(Ac, node_comm, node_sizes, node_displs,
+            rows, row_sizes, cols, vals);
+    coarse_n = Ac->global_num_rows;
+
+    int node_offset = 0;
+    if (node_rank == 0)
+    {
+        int num_leaders, leader_rank;
+        RAPtor_MPI_Comm_rank(leader_comm, &leader_rank);
+        RAPtor_MPI_Comm_size(leader_comm, &num_leaders);
+
+        // Coarse system is ordered by node
+        int node_n = rows.size();
+        coarse_sizes.resize(num_leaders);
+        coarse_displs.resize(num_leaders + 1);
+        RAPtor_MPI_Allgather(&node_n, 1, RAPtor_MPI_INT, coarse_sizes.data(), 1,
+                RAPtor_MPI_INT, leader_comm);
+        coarse_displs[0] = 0;
+        for (int i = 0; i < num_leaders; i++)
+        {
+            coarse_displs[i+1] = coarse_displs[i] + coarse_sizes[i];
+        }
+        node_offset = coarse_displs[leader_rank];
+
+        aligned_vector<index_t> global_rows(coarse_n);
+        RAPtor_MPI_Allgatherv(rows.data(), node_n, RAPtor_MPI_INDEX_T, global_rows.data(),
+                coarse_sizes.data(), coarse_displs.data(), RAPtor_MPI_INDEX_T, leader_comm);
+        IntMap global_to_local(coarse_n);
+        for (int i = 0; i < coarse_n; i++)
+        {
+            global_to_local[global_rows[i]] = i;
+        }
+
+        // Dense rows of this node, allgathered between nodes
+        aligned_vector<double> A_node((long) node_n * coarse_n, 0.0);
+        int ctr = 0;
+        for (int i = 0; i < node_n; i++)
+        {
+            for (int j = 0; j < row_sizes[i]; j++)
+            {
+                A_node[(long) i * coarse_n + global_to_local.find(cols[ctr])] = vals[ctr];
+                ctr++;
+            }
+        }
+        for (int i = 0; i < num_leaders; i++)
+        {
+            coarse_sizes[i] *= coarse_n;
+            coarse_displs[i+1] *= coarse_n;
+        }
+        A_coarse.resize((long) coarse_n * coarse_n);
+        RAPtor_MPI_Allgatherv(A_node.data(), A_node.size(), RAPtor_MPI_DOUBLE,
+                A_coarse.data(), coarse_sizes.data(), coarse_displs.data(),
+                RAPtor_MPI_DOUBLE, leader_comm);
+        for (int i = 0; i < num_leaders; i++)
+        {
+            coarse_sizes[i] /= coarse_n;
+            coarse_displs[i+1] /= coarse_n;
+        }
+
+        // Dense rows are stored contiguously, so A_coarse holds A^T in
+        // column-major order, and is factored as such
+        LU_permute.resize(coarse_n);
+        int info;
+        dgetrf_(&coarse_n, &coarse_n, A_coarse.data(), &coarse_n, 
+                LU_permute.data(), &info);
+    }
+
+    RAPtor_MPI_Bcast(&node_offset, 1, RAPtor_MPI_INT, 0, node_comm);
+    coarse_offset = node_offset + node_displs[node_rank];
+}
+
+void ParMultilevel::node_coarse_solve(ParVector& x, ParVector& b)
+{
+    if (levels[num_levels-1]->A->local_num_rows == 0) return;
+
+    int node_rank;
+    RAPtor_MPI_Comm_rank(node_comm, &node_rank);
+
+    aligned_vector<double> b_data(coarse_n);
+    int node_offset = coarse_offset - node_displs[node_rank];
+    RAPtor_MPI_Gatherv(b.local.data(), b.local_n, RAPtor_MPI_DOUBLE, 
+            b_data.data() + node_offset, node_sizes.data(), node_displs.data(),
+            RAPtor_MPI_DOUBLE, 0, node_comm);
+
+    if (node_rank == 0)
+    {
+        char trans = 'T'; // Rows of A stored contiguously
+        int nhrs = 1;
+        int info;
+
+        RAPtor_MPI_Allgatherv(RAPtor_MPI_IN_PLACE, 0, RAPtor_MPI_DOUBLE, b_data.data(),
+                coarse_sizes.data(), coarse_displs.data(), RAPtor_MPI_DOUBLE, 
+                leader_comm);
+        dgetrs_(&trans, &coarse_n, &nhrs, A_coarse.data(), &coarse_n, 
+                LU_permute.data(), b_data.data(), &coarse_n, &info);
+    }
+
+    RAPtor_MPI_Bcast(b_data.data(), coarse_n, RAPtor_MPI_DOUBLE, 0, node_comm);
+    for (int i = 0; i < x.local_n; i++)
+    {
+        x.local[i] = b_data[coarse_offset + i];
+    }
+}
+
+void ParMultilevel::setup_cg_coarse()
+{
+    ParCSRMatrix* Ac = levels[num_levels-1]->A;
+    aligned_vector<int> proc_sizes;
+    aligned_vector<int> active_procs;
+    create_coarse_comm(proc_sizes, active_procs);
+
+    coarse_n = Ac->global_num_rows;
+    coarse_inv_diag.resize(Ac->local_num_rows);
+    for (int i = 0; i < Ac->local_num_rows; i++)
+    {
+        coarse_inv_diag[i] = 0.0;
+        for (int j = Ac->on_proc->idx1[i]; j < Ac->on_proc->idx1[i+1]; j++)
+        {
+            if (Ac->on_proc->idx2[j] == i)
+            {
+                coarse_inv_diag[i] = 1.0 / Ac->on_proc->vals[j];
+                break;
+            }
+        }
+    }
+}
+
+void ParMultilevel::cg_coarse_solve(ParVector& x, ParVector& b)
+{
+    ParCSRMatrix* Ac = levels[num_levels-1]->A;
+    bool tap_level = tap_amg >= 0 && tap_amg <= num_levels - 1;
+    int local_n = Ac->local_num_rows;
+    double alpha, beta, rz, rz_next;
+
+    ParVector r(coarse_n, local_n);
+    ParVector z(coarse_n, local_n);
+    ParVector p(coarse_n, local_n);
+    ParVector Ap(coarse_n, local_n);
+
+    double b_norm = b.norm(2);
+    if (b_norm == 0.0)
+    {
+        x.set_const_value(0.0);
+        return;
+    }
+
+    Ac->residual(x, b, r, tap_level);
+    for (int i = 0; i < local_n; i++)
+    {
+        z.local[i] = coarse_inv_diag[i] * r.local[i];
+    }
+    p.copy(z);
+    rz = r.inner_product(z);
+
+    for (int iter = 0; iter < coarse_iterations; iter++)
+    {
+        Ac->mult(p, Ap, tap_level);
+        alpha = rz / p.inner_product(Ap);
+        x.axpy(p, alpha);
+        r.axpy(Ap, -alpha);
+        if (r.norm(2) < coarse_tol * b_norm) break;
+
+        for (int i = 0; i < local_n; i++)
+        {
+            z.local[i] = coarse_inv_diag[i] * r.local[i];
+        }
+        rz_next = r.inner_product(z);
+        beta = rz_next / rz;
+        rz = rz_next;
+        for (int i = 0; i < local_n; i++)
+        {
+            p.local[i] = z.local[i] + beta * p.local[i];
+        }
+    }
+}
+
+
+// Adds the point-to-point packages A communicates with to comms
+// (topology-aware packages are made up of several ParComms)
+static void add_par_comms(ParCSRMatrix* A, std::set<ParComm*>& comms)
+{
+    if (A == NULL) return;
+    if (A->comm) comms.insert(A->comm);
+
+    TAPComm* tap_comms[2] = {A->tap_comm, A->tap_mat_comm};
+    for (int i = 0; i < 2; i++)
+    {
+        TAPComm* tap_comm = tap_comms[i];
+        if (tap_comm == NULL) continue;
+        if (tap_comm->local_S_par_comm) comms.insert(tap_comm->local_S_par_comm);
+        if (tap_comm->local_R_par_comm) comms.insert(tap_comm->local_R_par_comm);
+        if (tap_comm->local_L_par_comm) comms.insert(tap_comm->local_L_par_comm);
+        if (tap_comm->global_par_comm) comms.insert(tap_comm->global_par_comm);
+    }
+}
+
+static void level_par_comms(ParLevel* level, ParStencilOperator* op,
+        std::set<ParComm*>& comms)
+{
+    add_par_comms(level->A, comms);
+    add_par_comms(level->P, comms);
+    if (op && op->comm) comms.insert(op->comm);
+}
+
+void ParMultilevel::get_comm_volume(int level, CommVolume& sends, CommVolume& recvs)
+{
+    std::set<ParComm*> comms;
+    level_par_comms(levels[level], level == 0 ? fine_op : NULL, comms);
+    for (std::set<ParComm*>::iterator it = comms.begin(); it != comms.end(); ++it)
+    {
+        (*it)->get_comm_volume(sends, recvs);
+    }
+}
+
+void ParMultilevel::reset_comm_volume()
+{
+    for (int i = 0; i < num_levels; i++)
+    {
+        std::set<ParComm*> comms;
+        level_par_comms(levels[i], i == 0 ? fine_op : NULL, comms);
+        for (std::set<ParComm*>::iterator it = comms.begin(); it != comms.end(); ++it)
+        {
+            (*it)->reset_comm_volume();
+        }
+    }
+}
+
+void ParMultilevel::print_comm_volume()
+{
+    int rank;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+
+    long vals[4], max_vals[4], sum_vals[4];
+
+    if (rank == 0)
+    {
+        printf("Messages and bytes sent (max over processes / total)\n");
+        printf("Level\tInter-Node Msgs\tInter-Node Bytes\tIntra-Node Msgs\tIntra-Node Bytes\n");
+    }
+    for (int i = 0; i < num_levels; i++)
+    {
+        CommVolume sends, recvs;
+        get_comm_volume(i, sends, recvs);
+        vals[0] = sends.inter_node_msgs;
+        vals[1] = sends.inter_node_bytes;
+        vals[2] = sends.intra_node_msgs;
+        vals[3] = sends.intra_node_bytes;
+        RAPtor_MPI_Reduce(vals, max_vals, 4, RAPtor_MPI_LONG, RAPtor_MPI_MAX, 0, 
+                RAPtor_MPI_COMM_WORLD);
+        RAPtor_MPI_Reduce(vals, sum_vals, 4, RAPtor_MPI_LONG, RAPtor_MPI_SUM, 0, 
+                RAPtor_MPI_COMM_WORLD);
+        if (rank == 0)
+        {
+            printf("%d\t%ld / %ld\t%ld / %ld\t%ld / %ld\t%ld / %ld\n", i,
+                    max_vals[0], sum_vals[0], max_vals[1], sum_vals[1],
+                    max_vals[2], sum_vals[2], max_vals[3], sum_vals[3]);
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
 #include "core/par_vector.hpp"
+#include "core/par_stencil_operator.hpp"
 #include "multilevel/par_level.hpp"
 #include "util/linalg/par_relax.hpp"
 #include "ruge_stuben/par_interpolation.hpp"
@@ -47,6 +48,10 @@
  *****      - Jacobi: weighted jacobi for both on and off proc
  *****      - SOR: weighted jacobi off_proc, SOR on_proc
  *****      - SSOR : weighted jacobi off_proc, SSOR on_proc
+ *****      - HybridGS : threaded hybrid Gauss-Seidel (block
+ *****          jacobi across processes and threads, GS within each)
+ *****      - HybridSGS : symmetric threaded hybrid Gauss-Seidel
+ *****      - L1Jacobi : threaded l1 Jacobi
  ***** num_smooth_sweeps : int (defualt 1)
  *****    Number of relaxation sweeps (both pre and post smoothing)
  *****    to be performed during each cycle of the AMG solve.
@@ -56,12 +61,95 @@
  *****    Maximum global num rows allowed in coarsest matrix
  ***** max_levels : int (default -1)
  *****    Maximum number of levels in hierarchy, or no maximum if -1
+ ***** sell_solve : bool (default false)
+ *****    Convert on_proc of A and P on every level to SELL-C-sigma
+ *****    format after setup, for faster SpMVs in the solve phase
+ ***** mixed_precision : bool (default false)
+ *****    Store A on coarse levels and P on every level in single
+ *****    precision after setup, and exchange their vector values
+ *****    in single precision.  Products are accumulated in double,
+ *****    and the fine level operator and residual stay in double.
+ *****    Levels stored in single precision are not converted to SELL.
+ ***** neighbor_collectives : bool (default false)
+ *****    Exchange vector values on every level with MPI-3 
+ *****    neighborhood collectives (NeighborComm) rather than 
+ *****    point-to-point messages, during both setup and solve
+ ***** persistent_comm : bool (default false)
+ *****    Create persistent requests for the halo exchanges of A
+ *****    and P on every level after setup, so that each solve 
+ *****    phase exchange is started with MPI_Startall
+ ***** coarse_solver : coarse_solve_t (default DenseLU)
+ *****    Solver used on the coarsest level.  Options are
+ *****      - DenseLU : dense LU factorization, allgathered onto
+ *****        every process holding coarse rows
+ *****      - SparseLU : sparse LU factorization (without pivoting),
+ *****        gathered onto the first active process, with the 
+ *****        right-hand side gathered and the solution scattered
+ *****      - NodeLU : dense LU factorization held redundantly by
+ *****        one process per node, with the solution broadcast to 
+ *****        the other processes on each node
+ *****      - CoarseCG : Jacobi preconditioned CG on the distributed
+ *****        coarse matrix
+ ***** coarse_iterations : int (default 20)
+ *****    Maximum number of CG iterations per coarse solve (CoarseCG)
+ ***** coarse_tol : double (default 1e-10)
+ *****    Relative residual tolerance of each coarse solve (CoarseCG)
+ ***** coarse_setup_time, coarse_solve_time : double
+ *****    Time spent by this process setting up the coarse solver,
+ *****    and in all coarse solves since setup
+ ***** allow_resetup : bool (default false)
+ *****    Keep the strength matrices, CF splittings, and symbolic
+ *****    structure of the Galerkin products after setup, so that
+ *****    resetup can refresh the hierarchy for a new matrix
+ ***** agglomerate_rows : int (default 0, no agglomeration)
+ *****    Once the average number of rows per active process of a
+ *****    coarse level falls below agglomerate_rows, the level is
+ *****    redistributed (repartition_matrix) onto about
+ *****    global_num_rows / agglomerate_rows processes, spread evenly
+ *****    over all ranks.  Global row order is kept, and coarser levels
+ *****    stay on (at most) this subset of processes.  A process
+ *****    holding no rows of a level and all coarser levels idles
+ *****    through them in the cycle (unless those levels take part in
+ *****    TAP communication, neighborhood collectives, or CoarseCG).
  ***** 
  ***** Methods
  ***** -------
  ***** solve(x, b, num_iters)
  *****    Solves system Ax = b, performing at most num_iters iterations
  *****    of AMG.
+ ***** save_hierarchy(fname)
+ *****    Writes every level (A and P) and the coarse LU factorization
+ *****    to a binary file with MPI-IO, one section per process
+ ***** load_hierarchy(fname)
+ *****    Replaces setup, reading a hierarchy written by save_hierarchy
+ *****    on the same number of processes.  Solve phase options 
+ *****    (sell_solve, mixed_precision, etc) are applied after loading.
+ *****    Returns 0 on success, or -1 if the file cannot be used.
+ ***** resetup(Af)
+ *****    Refreshes the hierarchy for a matrix with the same sparsity
+ *****    pattern as that passed to setup, but new values.  The 
+ *****    coarsening, interpolation sparsity, and all communication
+ *****    packages are kept, and only the interpolation weights, 
+ *****    Galerkin products, and coarse LU factorization are
+ *****    recomputed.  Requires allow_resetup to be set before setup,
+ *****    and falls back to a full setup otherwise (or if sell_solve 
+ *****    or mixed_precision are set, or the pattern has changed).
+ ***** setup_matrix_free(op)
+ *****    Sets up the hierarchy from the matrix op->to_ParCSR(), but
+ *****    performs all fine level work of the solve phase (relaxation
+ *****    and residuals) with the ParStencilOperator op, which must 
+ *****    outlive the hierarchy.  The CSR fine matrix is only held
+ *****    during setup: afterwards levels[0]->A keeps its sizes and 
+ *****    communication package, but no nonzeros.  SOR and SSOR 
+ *****    relax as HybridGS and HybridSGS on the fine level, and TAP
+ *****    communication is only used on coarse levels.
+ *****
+ ***** While profiling (init_profile), setup records regions 
+ ***** setup/level l/{strength, split, interp, RAP} (aggregate in 
+ ***** place of split for smoothed aggregation) and coarse setup,
+ ***** and solve records solve/level l/{relax, residual, restrict,
+ ***** interpolate, coarse solve}, into the registry of 
+ ***** core/profiler.hpp.
  **************************************************************/
 
 namespace raptor
@@ -91,37 +179,73 @@ namespace raptor
                 tap_amg = -1;
                 weights = NULL;
                 store_residuals = true;
-                track_times = false;
-                setup_times = NULL;
-                solve_times = NULL;
                 sparsify_tol = 0.0;
                 solve_tol = 1e-07;
                 max_iterations = 100;
+                sell_solve = false;
+                mixed_precision = false;
+                neighbor_collectives = false;
+                persistent_comm = false;
+                allow_resetup = false;
+                agglomerate_rows = 0;
+                agglomerated = false;
+                idle_level = 0;
+                coarse_solver = DenseLU;
+                coarse_iterations = 20;
+                coarse_tol = 1e-10;
+                coarse_setup_time = 0.0;
+                coarse_solve_time = 0.0;
+                coarse_LU = NULL;
+                fine_op = NULL;
+                node_comm = RAPtor_MPI_COMM_NULL;
+                leader_comm = RAPtor_MPI_COMM_NULL;
             }
 
             virtual ~ParMultilevel()
             {
-                if (num_levels > 0)
-                {
-                    if (levels[num_levels-1]->A->local_num_rows)
-                    {
-                        RAPtor_MPI_Comm_free(&coarse_comm);
-                    }
-                }
+                clear_hierarchy();
+
+                delete[] weights;
+            }
+            
+            virtual void setup(ParCSRMatrix* Af) = 0;
+
+            void setup_matrix_free(ParStencilOperator* op)
+            {
+                ParCSRMatrix* Af = op->to_ParCSR();
+                setup(Af);
+                delete Af;
+                fine_op = op;
+
+                // The solve phase applies op on the fine level, so only
+                // the sizes, column maps, and communication package of
+                // levels[0]->A are kept (on_proc and off_proc are empty)
+                ParCSRMatrix* A = levels[0]->A;
+                delete A->on_proc;
+                delete A->off_proc;
+                A->on_proc = new CSRMatrix(A->local_num_rows, A->on_proc_num_cols);
+                A->off_proc = new CSRMatrix(A->local_num_rows, A->off_proc_num_cols);
+            }
+
+            virtual void resetup(ParCSRMatrix* Af)
+            {
+                resetup_helper(Af);
+            }
+
+            // Remove all levels and the coarse solver
+            void clear_hierarchy()
+            {
+                free_coarse_solver();
 
                 for (std::vector<ParLevel*>::iterator it = levels.begin();
                         it != levels.end(); ++it)
                 {
                     delete *it;
                 }
-
-                delete[] weights;
-
-                delete[] setup_times;
-                delete[] solve_times;
+                levels.clear();
+                num_levels = 0;
+                fine_op = NULL;
             }
-            
-            virtual void setup(ParCSRMatrix* Af) = 0;
 
             void setup_helper(ParCSRMatrix* Af)
             {
@@ -129,12 +253,10 @@ namespace raptor
                 RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
                 RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
                 int last_level = 0;
+                agglomerated = false;
+                fine_op = NULL;
 
-                if (track_times)
-                {
-                    setup_times = new double[5 * max_levels]();
-                    init_profile();
-                }
+                ProfileScope setup_scope("setup");
 
                 // Add original, fine level to hierarchy
                 levels.emplace_back(new ParLevel());
@@ -171,46 +293,104 @@ namespace raptor
                 while (levels[last_level]->A->global_num_rows > max_coarse && 
                         (max_levels == -1 || (int) levels.size() < max_levels))
                 {
+                    profile_begin("level", last_level);
+
+                    if (neighbor_collectives)
+                        levels[last_level]->A->init_neighbor_comm();
+
                     extend_hierarchy();
 
-                    if (track_times)
-                    {
-                        finalize_profile();
-                        setup_times[5*last_level] = total_t;
-                        setup_times[5*last_level + 1] = collective_t;
-                        setup_times[5*last_level + 2] = p2p_t;
-                        setup_times[5*last_level + 3] = vec_t;
-                        setup_times[5*last_level + 4] = mat_t;
-                        init_profile();
-                    }
+                    if (agglomerate_rows > 0)
+                        agglomerate_level(last_level + 1);
+
+                    profile_end();
 
                     last_level++;
                 }
 
                 num_levels = levels.size();
-                if (Af->local_num_rows) 
+                delete[] weights;
+                weights = NULL;
+
+                // Set up solver for the coarsest level
+                profile_begin("level", num_levels - 1);
+                profile_begin("coarse setup");
+                setup_coarse_solver();
+                profile_end();
+                profile_end();
+
+                profile_begin("init solve phase");
+                init_solve_phase();
+                profile_end();
+            } 
+
+
+            // Prepare level communication and storage for the solve phase
+            void init_solve_phase()
+            {
+                // Processes holding no rows of a level and of every
+                // coarser level skip these levels in the cycle, unless
+                // collective communication is used on them
+                idle_level = num_levels;
+                if (!neighbor_collectives && coarse_solver != CoarseCG)
                 {
-                    delete[] weights;
-                    weights = NULL;
+                    for (int i = num_levels - 1; i > 0; i--)
+                    {
+                        if (levels[i]->A->local_num_rows 
+                                || (tap_amg >= 0 && tap_amg <= i))
+                            break;
+                        idle_level = i;
+                    }
                 }
 
-                // Duplicate coarsest level across all processes that hold any
-                // rows of A_c
-                duplicate_coarse();
+                // Exchange solve phase vectors with neighborhood collectives
+                if (neighbor_collectives)
+                {
+                    for (int i = 0; i < num_levels; i++)
+                    {
+                        levels[i]->A->init_neighbor_comm();
+                        if (levels[i]->P)
+                            levels[i]->P->init_neighbor_comm();
+                    }
+                }
 
-                if (track_times)
+                // Store coarse operators and interpolation in single
+                // precision for the solve phase
+                if (mixed_precision)
                 {
-                    finalize_profile();
-                    setup_times[5*(num_levels-1)] += total_t;
-                    setup_times[5*(num_levels-1) + 1] += collective_t;
-                    setup_times[5*(num_levels-1) + 2] += p2p_t;
-                    setup_times[5*(num_levels-1) + 3] += vec_t;
-                    setup_times[5*(num_levels-1) + 4] += mat_t;
-
-                    solve_times = new double[5 * num_levels]();
+                    for (int i = 0; i < num_levels; i++)
+                    {
+                        if (i > 0)
+                            levels[i]->A->to_single_precision();
+                        if (levels[i]->P)
+                            levels[i]->P->to_single_precision();
+                    }
                 }
-            } 
 
+                // Reuse persistent requests for double halo exchanges
+                // during the solve phase
+                if (persistent_comm)
+                {
+                    for (int i = 0; i < num_levels; i++)
+                    {
+                        if (!levels[i]->A->float_comm)
+                            levels[i]->A->init_persistent_comm();
+                        if (levels[i]->P && !levels[i]->P->float_comm)
+                            levels[i]->P->init_persistent_comm();
+                    }
+                }
+
+                // Convert level matrices to SELL-C-sigma for the solve phase
+                if (sell_solve)
+                {
+                    for (int i = 0; i < num_levels; i++)
+                    {
+                        levels[i]->A->on_proc_to_SELL();
+                        if (levels[i]->P)
+                            levels[i]->P->on_proc_to_SELL();
+                    }
+                }
+            }
 
             void form_rand_weights(int local_n, int first_n)
             {
@@ -226,16 +406,114 @@ namespace raptor
                 
             virtual void extend_hierarchy() = 0;
 
-            void duplicate_coarse()
+            void resetup_helper(ParCSRMatrix* Af);
+
+            void agglomerate_level(int level);
+
+            // Redistribute any per-row data of the solver from the rows 
+            // of A to those of Ac, the same matrix agglomerated onto 
+            // fewer processes (called by agglomerate_level)
+            virtual void agglomerate_data(ParCSRMatrix* A, ParCSRMatrix* Ac)
+            {
+
+            }
+
+            // Move block_size values per row of A to the rows of Ac, 
+            // where both hold the same rows in global order
+            template <typename T>
+            void agglomerate_values(aligned_vector<T>& vals, int block_size,
+                    ParCSRMatrix* A, ParCSRMatrix* Ac, RAPtor_MPI_Datatype type)
             {
                 int rank, num_procs;
                 RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
                 RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
 
-                int last_level = num_levels - 1;
-                ParCSRMatrix* Ac = levels[last_level]->A;
-                aligned_vector<int> proc_sizes(num_procs);
-                aligned_vector<int> active_procs;
+                aligned_vector<int> sizes(num_procs);
+                aligned_vector<int> new_sizes(num_procs);
+                RAPtor_MPI_Allgather(&(A->local_num_rows), 1, RAPtor_MPI_INT, 
+                        sizes.data(), 1, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                RAPtor_MPI_Allgather(&(Ac->local_num_rows), 1, RAPtor_MPI_INT, 
+                        new_sizes.data(), 1, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+
+                int first = 0, new_first = 0;
+                for (int i = 0; i < rank; i++)
+                {
+                    first += sizes[i];
+                    new_first += new_sizes[i];
+                }
+                int last = first + A->local_num_rows;
+                int new_last = new_first + Ac->local_num_rows;
+
+                // Overlap of local rows with those of each process, 
+                // before and after agglomeration
+                aligned_vector<int> send_sizes(num_procs, 0);
+                aligned_vector<int> send_displs(num_procs, 0);
+                aligned_vector<int> recv_sizes(num_procs, 0);
+                aligned_vector<int> recv_displs(num_procs, 0);
+                int proc_first = 0, proc_new_first = 0;
+                for (int i = 0; i < num_procs; i++)
+                {
+                    int lo = std::max(first, proc_new_first);
+                    int hi = std::min(last, proc_new_first + new_sizes[i]);
+                    if (hi > lo)
+                    {
+                        send_sizes[i] = (hi - lo) * block_size;
+                        send_displs[i] = (lo - first) * block_size;
+                    }
+
+                    lo = std::max(new_first, proc_first);
+                    hi = std::min(new_last, proc_first + sizes[i]);
+                    if (hi > lo)
+                    {
+                        recv_sizes[i] = (hi - lo) * block_size;
+                        recv_displs[i] = (lo - new_first) * block_size;
+                    }
+
+                    proc_first += sizes[i];
+                    proc_new_first += new_sizes[i];
+                }
+
+                aligned_vector<T> new_vals(Ac->local_num_rows * block_size);
+                RAPtor_MPI_Alltoallv(vals.data(), send_sizes.data(), 
+                        send_displs.data(), type, new_vals.data(), recv_sizes.data(),
+                        recv_displs.data(), type, RAPtor_MPI_COMM_WORLD);
+                vals.swap(new_vals);
+            }
+
+            // Recompute values of P on a level from the new values of A,
+            // keeping its sparsity pattern (called by resetup)
+            virtual void update_interpolation(int level)
+            {
+
+            }
+
+            // Form the Galerkin product P^T*A*P of a level.  If 
+            // allow_resetup, the symbolic structure of A*P and P^T*(AP)
+            // is kept, so that resetup only recomputes values.
+            ParCSRMatrix* form_coarse_operator(int level, bool tap_level)
+            {
+                ParLevel* l = levels[level];
+                if (!allow_resetup)
+                {
+                    return l->A->RAP(l->P, tap_level);
+                }
+
+                l->AP_plan = new ParMultPlan();
+                l->Ac_plan = new ParMultPlan();
+                l->AP = l->A->mult_symbolic(l->P, l->AP_plan, tap_level);
+                return l->P->mult_T_symbolic(l->AP, l->Ac_plan, tap_level);
+            }
+
+            // Create coarse_comm, containing every process that holds
+            // rows of the coarsest matrix
+            void create_coarse_comm(aligned_vector<int>& proc_sizes,
+                    aligned_vector<int>& active_procs)
+            {
+                int num_procs;
+                RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+                ParCSRMatrix* Ac = levels[num_levels - 1]->A;
+                proc_sizes.resize(num_procs);
                 RAPtor_MPI_Allgather(&(Ac->local_num_rows), 1, RAPtor_MPI_INT, proc_sizes.data(),
                         1, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
                 for (int i = 0; i < num_procs; i++)
@@ -253,6 +531,32 @@ namespace raptor
                 RAPtor_MPI_Comm_create_group(RAPtor_MPI_COMM_WORLD, active_group, 0, &coarse_comm);
                 RAPtor_MPI_Group_free(&world_group);
                 RAPtor_MPI_Group_free(&active_group);
+            }
+
+            void setup_coarse_solver();
+            void free_coarse_solver();
+            void coarse_solve(ParVector& x, ParVector& b);
+            void setup_sparse_coarse();
+            void setup_node_coarse();
+            void setup_cg_coarse();
+            void dense_coarse_solve(ParVector& x, ParVector& b);
+            void sparse_coarse_solve(ParVector& x, ParVector& b);
+            void node_coarse_solve(ParVector& x, ParVector& b);
+            void cg_coarse_solve(ParVector& x, ParVector& b);
+
+            // Duplicate coarsest level across all processes that hold any
+            // rows of A_c (DenseLU)
+            void duplicate_coarse()
+            {
+                int rank, num_procs;
+                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+                RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+                int last_level = num_levels - 1;
+                ParCSRMatrix* Ac = levels[last_level]->A;
+                aligned_vector<int> proc_sizes;
+                aligned_vector<int> active_procs;
+                create_coarse_comm(proc_sizes, active_procs);
 
                 if (Ac->local_num_rows)
                 {
@@ -277,15 +581,15 @@ namespace raptor
                         coarse_displs[i+1] = coarse_displs[i] + coarse_sizes[i]; 
                     }
 
-                    aligned_vector<int> global_row_indices(coarse_displs[num_active]);
+                    aligned_vector<index_t> global_row_indices(coarse_displs[num_active]);
 
-                    RAPtor_MPI_Allgatherv(Ac->local_row_map.data(), Ac->local_num_rows, RAPtor_MPI_INT,
+                    RAPtor_MPI_Allgatherv(Ac->local_row_map.data(), Ac->local_num_rows, RAPtor_MPI_INDEX_T,
                             global_row_indices.data(), coarse_sizes.data(), 
-                            coarse_displs.data(), RAPtor_MPI_INT, coarse_comm);
+                            coarse_displs.data(), RAPtor_MPI_INDEX_T, coarse_comm);
     
-                    std::map<int, int> global_to_local;
+                    IntMap global_to_local(global_row_indices.size());
                     int ctr = 0;
-                    for (aligned_vector<int>::iterator it = global_row_indices.begin();
+                    for (aligned_vector<index_t>::iterator it = global_row_indices.begin();
                             it != global_row_indices.end(); ++it)
                     {
                         global_to_local[*it] = ctr++;
@@ -300,7 +604,7 @@ namespace raptor
                         for (int j = start; j < end; j++)
                         {
                             global_col = Ac->on_proc_column_map[Ac->on_proc->idx2[j]];
-                            local_col = global_to_local[global_col];
+                            local_col = global_to_local.find(global_col);
                             A_coarse_lcl[i*coarse_n + local_col] = Ac->on_proc->vals[j];
                         }
 
@@ -309,7 +613,7 @@ namespace raptor
                         for (int j = start; j < end; j++)
                         {
                             global_col = Ac->off_proc_column_map[Ac->off_proc->idx2[j]];
-                            local_col = global_to_local[global_col];
+                            local_col = global_to_local.find(global_col);
                             A_coarse_lcl[i*coarse_n + local_col] = Ac->off_proc->vals[j];
                         }
                     }
@@ -338,12 +642,81 @@ namespace raptor
                 }
             }
 
-            void cycle(ParVector& x, ParVector& b, int level = 0)
+            // Relaxes x at the given level (with fine_op on the fine
+            // level of a matrix-free hierarchy)
+            void relax(int level, ParVector& x, ParVector& b, bool tap_level)
             {
-                if (solve_times)
+                ParCSRMatrix* A = levels[level]->A;
+                ParVector& tmp = levels[level]->tmp;
+                ProfileScope relax_scope("relax");
+
+                if (level == 0 && fine_op)
+                {
+                    switch (relax_type)
+                    {
+                        case Jacobi:
+                            fine_op->jacobi(x, b, tmp, num_smooth_sweeps, 
+                                    relax_weight);
+                            break;
+                        case SOR:
+                        case HybridGS:
+                            fine_op->hybrid_gs(x, b, tmp, num_smooth_sweeps,
+                                    relax_weight);
+                            break;
+                        case SSOR:
+                        case HybridSGS:
+                            fine_op->hybrid_sgs(x, b, tmp, num_smooth_sweeps,
+                                    relax_weight);
+                            break;
+                        case L1Jacobi:
+                            fine_op->l1_jacobi(x, b, tmp, num_smooth_sweeps,
+                                    relax_weight);
+                            break;
+                    }
+                    return;
+                }
+
+                switch (relax_type)
                 {
-                    init_profile();
+                    case Jacobi:
+                        jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case SOR:
+                        sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case SSOR:
+                        ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case HybridGS:
+                        hybrid_gs(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case HybridSGS:
+                        hybrid_sgs(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case L1Jacobi:
+                        l1_jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
                 }
+            }
+
+            void fine_residual(ParVector& x, ParVector& b, ParVector& r)
+            {
+                ProfileScope residual_scope("residual");
+                if (fine_op) fine_op->residual(x, b, r);
+                else levels[0]->A->residual(x, b, r);
+            }
+
+            // The region of each level is closed while coarser levels
+            // are cycled, so that it holds only work on that level
+            void cycle(ParVector& x, ParVector& b, int level = 0)
+            {
+                profile_begin("level", level);
 
                 ParCSRMatrix* A = levels[level]->A;
                 ParCSRMatrix* P = levels[level]->P;
@@ -352,112 +725,45 @@ namespace raptor
 
                 if (level == num_levels - 1)
                 {
-                    if (A->local_num_rows)
-                    {
-                        int active_rank;
-                        RAPtor_MPI_Comm_rank(coarse_comm, &active_rank);
+                    profile_begin("coarse solve");
+                    coarse_solve(x, b);
+                    profile_end();
 
-                        char trans = 'N'; //No transpose
-                        int nhrs = 1; // Number of right hand sides
-                        int info; // result
-
-                        aligned_vector<double> b_data(coarse_n);
-                        RAPtor_MPI_Allgatherv(b.local.data(), b.local_n, RAPtor_MPI_DOUBLE, b_data.data(), 
-                                coarse_sizes.data(), coarse_displs.data(), 
-                                RAPtor_MPI_DOUBLE, coarse_comm);
-
-                        dgetrs_(&trans, &coarse_n, &nhrs, A_coarse.data(), &coarse_n, 
-                                LU_permute.data(), b_data.data(), &coarse_n, &info);
-                        for (int i = 0; i < b.local_n; i++)
-                        {
-                            x.local[i] = b_data[i + coarse_displs[active_rank]];
-                        }
-                    }
-
-                    if (solve_times)
-                    {
-                        finalize_profile();
-                        solve_times[5*level] += total_t;
-                        solve_times[5*level + 1] += collective_t;
-                        solve_times[5*level + 2] += p2p_t;
-                        solve_times[5*level + 3] += vec_t;
-                        solve_times[5*level + 4] += mat_t;
-                    }
+                    profile_end();
                 }
                 else
                 {
                     levels[level+1]->x.set_const_value(0.0);
                     
-                    // Relax
-                    switch (relax_type)
-                    {
-                        case Jacobi:
-                            jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SOR:
-                            sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SSOR:
-                            ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                    }
-
+                    relax(level, x, b, tap_level);
 
-                    A->residual(x, b, tmp, tap_level);
+                    profile_begin("residual");
+                    if (level == 0 && fine_op) fine_op->residual(x, b, tmp);
+                    else A->residual(x, b, tmp, tap_level);
+                    profile_end();
 
+                    profile_begin("restrict");
                     P->mult_T(tmp, levels[level+1]->b, tap_level);
+                    profile_end();
 
+                    profile_end();
+                    if (level + 1 < idle_level)
+                        cycle(levels[level+1]->x, levels[level+1]->b, level+1);
+                    profile_begin("level", level);
 
-                    if (solve_times)
-                    {
-                        finalize_profile();
-                        solve_times[5*level] += total_t;
-                        solve_times[5*level + 1] += collective_t;
-                        solve_times[5*level + 2] += p2p_t;
-                        solve_times[5*level + 3] += vec_t;
-                        solve_times[5*level + 4] += mat_t;
-                    }
-                    cycle(levels[level+1]->x, levels[level+1]->b, level+1);
-                    if (solve_times)
-                    {
-                        init_profile();
-                    }
-
-
+                    profile_begin("interpolate");
                     P->mult_append(levels[level+1]->x, x, tap_level);
+                    profile_end();
 
-                    switch (relax_type)
-                    {
-                        case Jacobi:
-                            jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SOR:
-                            sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SSOR:
-                            ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                     }
-                    if (solve_times)
-                    {
-                        finalize_profile();
-                        solve_times[5*level] += total_t;
-                        solve_times[5*level + 1] += collective_t;
-                        solve_times[5*level + 2] += p2p_t;
-                        solve_times[5*level + 3] += vec_t;
-                        solve_times[5*level + 4] += mat_t;
-                    }
+                    relax(level, x, b, tap_level);
+
+                    profile_end();
                 }
             }
 
             int solve(ParVector& sol, ParVector& rhs)
             {
+                ProfileScope solve_scope("solve");
                 double b_norm = rhs.norm(2);
                 double r_norm;
                 int iter = 0;
@@ -467,15 +773,9 @@ namespace raptor
                     residuals.resize(max_iterations + 1);
                 }
 
-                if (track_times)
-                {
-                    if (!solve_times) solve_times = new double[5*num_levels]();
-                    init_profile();
-                }
-
                 // Iterate until convergence or max iterations
                 ParVector resid(rhs.global_n, rhs.local_n);
-                levels[0]->A->residual(sol, rhs, resid);
+                fine_residual(sol, rhs, resid);
                 if (fabs(b_norm) > zero_tol)
                 {
                     r_norm = resid.norm(2) / b_norm;
@@ -489,27 +789,12 @@ namespace raptor
                     residuals[iter] = r_norm;
                 }
 
-                if (track_times)
-                {
-                    finalize_profile();
-                    solve_times[0] += total_t;
-                    solve_times[1] += collective_t;
-                    solve_times[2] += p2p_t;
-                    solve_times[3] += vec_t;
-                    solve_times[4] += mat_t;
-                }
-
                 while (r_norm > solve_tol && iter < max_iterations)
                 {
                     cycle(sol, rhs, 0);
 
-                    if (track_times)
-                    {
-                        init_profile();
-                    }
-
                     iter++;
-                    levels[0]->A->residual(sol, rhs, resid);
+                    fine_residual(sol, rhs, resid);
                     if (fabs(b_norm) > zero_tol)
                     {
                         r_norm = resid.norm(2) / b_norm;
@@ -522,21 +807,15 @@ namespace raptor
                     {
                         residuals[iter] = r_norm;
                     }
-                    if (track_times)
-                    {
-                        finalize_profile();
-                        solve_times[0] += total_t;
-                        solve_times[1] += collective_t;
-                        solve_times[2] += p2p_t;
-                        solve_times[3] += vec_t;
-                        solve_times[4] += mat_t;
-                    }
                 }
 
 
                 return iter;
             }
 
+            void save_hierarchy(const char* fname);
+            int load_hierarchy(const char* fname);
+
             void print_hierarchy()
             {
                 int rank;
@@ -556,12 +835,37 @@ namespace raptor
                     RAPtor_MPI_Reduce(&lcl_nnz, &nnz, 1, RAPtor_MPI_LONG, RAPtor_MPI_SUM, 0, RAPtor_MPI_COMM_WORLD);
                     if (rank == 0)
                     {
-                        printf("%d\t%d\t%d\t%lu\n", i, 
-                                Al->global_num_rows, Al->global_num_cols, nnz);
+                        printf("%d\t%ld\t%ld\t%ld\n", i, 
+                                (long) Al->global_num_rows, (long) Al->global_num_cols, nnz);
                     }
                 }
             }
 
+            /**************************************************************
+            *****   Communication Volume
+            **************************************************************
+            ***** get_comm_volume adds the messages and bytes this 
+            ***** process has communicated through the packages of a
+            ***** level (those of A and P, and of fine_op on the finest
+            ***** level) to sends and recvs, counting packages shared
+            ***** between matrices once.  print_comm_volume prints the
+            ***** max and total inter-node and intra-node sends of each
+            ***** level over all processes, and reset_comm_volume clears
+            ***** the counts (e.g. after setup, to report a solve alone).
+            *****
+            ***** Parameters (get_comm_volume)
+            ***** -------------
+            ***** level : int
+            *****    Level of the hierarchy
+            ***** sends : CommVolume&
+            *****    Volume to which sent messages are added
+            ***** recvs : CommVolume&
+            *****    Volume to which received messages are added
+            **************************************************************/
+            void get_comm_volume(int level, CommVolume& sends, CommVolume& recvs);
+            void print_comm_volume();
+            void reset_comm_volume();
+
             void print_residuals(int iter)
             {
                 int rank;
@@ -575,49 +879,6 @@ namespace raptor
                 }
             }
 
-            void print_times(double* times, const char* phase)
-            {
-                if (times == NULL) return;
-
-                int rank;
-                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-
-                double max_t;
-                for (int i = 0; i < num_levels; i++)
-                {
-                    if (rank == 0) printf("Level %d\n", i);
-
-                    RAPtor_MPI_Reduce(&times[5*i], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
-                    if (rank == 0 && max_t > 0) printf("%s Total Time: %e\n", phase, max_t);
-
-                    RAPtor_MPI_Reduce(&times[5*i+1], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
-                    if (rank == 0 && max_t > 0) printf("%s Collective Time: %e\n", phase, max_t);
-
-                    RAPtor_MPI_Reduce(&times[5*i+2], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
-                    if (rank == 0 && max_t > 0) printf("%s P2P Time: %e\n", phase, max_t);
-
-                    RAPtor_MPI_Reduce(&times[5*i+3], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
-                    if (rank == 0 && max_t > 0) printf("%s Vec Comm Time: %e\n", phase, max_t);
-
-                    RAPtor_MPI_Reduce(&times[5*i+4], &max_t, 1, RAPtor_MPI_DOUBLE, 
-                            RAPtor_MPI_MAX, 0, RAPtor_MPI_COMM_WORLD);
-                    if (rank == 0 && max_t > 0) printf("%s Mat Comm Time: %e\n", phase, max_t);
-                }
-            }
-
-            void print_setup_times()
-            {
-                print_times(setup_times, "Setup");
-            }
-            void print_solve_times()
-            {
-                print_times(solve_times, "Solve");
-            }
-
             aligned_vector<double>& get_residuals()
             {
                 return residuals;
@@ -638,6 +899,20 @@ namespace raptor
             double solve_tol;
 
             bool store_residuals;
+            bool sell_solve;
+            bool mixed_precision;
+            bool neighbor_collectives;
+            bool persistent_comm;
+            bool allow_resetup;
+            int agglomerate_rows;
+            bool agglomerated;
+            int idle_level;
+
+            coarse_solve_t coarse_solver;
+            int coarse_iterations;
+            double coarse_tol;
+            double coarse_setup_time;
+            double coarse_solve_time;
 
             double* weights;
             aligned_vector<double> residuals;
@@ -646,16 +921,31 @@ namespace raptor
             aligned_vector<int> LU_permute;
             int num_levels;
             int num_variables;
-            
-            bool track_times;
-            double* setup_times;
-            double* solve_times;
 
             int coarse_n;
             aligned_vector<double> A_coarse;
             aligned_vector<int> coarse_sizes;
             aligned_vector<int> coarse_displs;
             RAPtor_MPI_Comm coarse_comm;
+
+            // SparseLU factors, with L (unit diagonal) and U stored in 
+            // each row, and the position of each diagonal
+            CSRMatrix* coarse_LU;
+            aligned_vector<int> coarse_LU_diag;
+
+            // NodeLU communicators, sizes on this node, and offset of 
+            // local rows in the coarse system
+            RAPtor_MPI_Comm node_comm;
+            RAPtor_MPI_Comm leader_comm;
+            aligned_vector<int> node_sizes;
+            aligned_vector<int> node_displs;
+            int coarse_offset;
+
+            // CoarseCG inverse diagonal
+            aligned_vector<double> coarse_inv_diag;
+
+            // Matrix-free fine level operator (setup_matrix_free)
+            ParStencilOperator* fine_op;
     };
 }
 #endif
@@ -0,0 +1,143 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Norm of A*v, with v[i] = position of row i in global row order
+double global_index_norm(ParCSRMatrix* A)
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    int first = 0;
+    MPI_Exscan(&(A->local_num_rows), &first, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0) first = 0;
+
+    ParVector v(A->global_num_rows, A->local_num_rows);
+    ParVector Av(A->global_num_rows, A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+        v[i] = first + i;
+    A->mult(v, Av);
+    return Av.norm(2);
+}
+
+void test_agglomerate(ParMultilevel* ml, ParMultilevel* ml_agg, ParCSRMatrix* A,
+        int agglomerate_rows)
+{
+    int num_procs;
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+
+    ml->max_coarse = 20;
+    ml->setup(A);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+
+    ml_agg->max_coarse = 20;
+    ml_agg->agglomerate_rows = agglomerate_rows;
+    ml_agg->setup(A);
+
+    // Levels are agglomerated once rows per active process fall
+    // below agglomerate_rows, and stay on the same number of processes
+    // or fewer
+    bool first_agg = true;
+    int prev_active = num_procs;
+    for (int i = 0; i < ml_agg->num_levels; i++)
+    {
+        ParCSRMatrix* Al = ml_agg->levels[i]->A;
+        int active = Al->local_num_rows > 0;
+        MPI_Allreduce(MPI_IN_PLACE, &active, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        ASSERT_LE(active, prev_active);
+
+        int n = Al->local_num_rows;
+        MPI_Allreduce(MPI_IN_PLACE, &n, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        ASSERT_EQ(n, Al->global_num_rows);
+
+        if (active < prev_active)
+        {
+            int max_active = Al->global_num_rows / agglomerate_rows;
+            if (max_active < 1) max_active = 1;
+            ASSERT_LE(active, max_active);
+
+            // The first agglomerated level holds the same operator,
+            // with the same global row order, as without agglomeration
+            if (first_agg && i < ml->num_levels)
+            {
+                ParCSRMatrix* Al_ref = ml->levels[i]->A;
+                ASSERT_EQ(Al->global_num_rows, Al_ref->global_num_rows);
+                ASSERT_NEAR(global_index_norm(Al), global_index_norm(Al_ref),
+                        1e-06 * global_index_norm(Al_ref));
+                first_agg = false;
+            }
+        }
+        prev_active = active;
+
+        if (i < ml_agg->num_levels - 1)
+        {
+            ParCSRMatrix* P = ml_agg->levels[i]->P;
+            ASSERT_EQ(P->on_proc_num_cols, ml_agg->levels[i+1]->A->local_num_rows);
+        }
+    }
+    if (num_procs > 1)
+    {
+        ASSERT_FALSE(first_agg);
+    }
+
+    // Agglomerated hierarchy converges as quickly (within a few
+    // iterations) as the original
+    x.set_const_value(0.0);
+    int iter_agg = ml_agg->solve(x, b);
+    aligned_vector<double>& res_agg = ml_agg->get_residuals();
+    ASSERT_LT(res_agg[iter_agg], ml_agg->solve_tol);
+    ASSERT_LE(iter_agg, iter + 3);
+
+    delete ml;
+    delete ml_agg;
+}
+
+TEST(ParAgglomerateTest, TestsInMultilevel)
+{
+    int grid[3] = {12, 12, 12};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    // Ruge-Stuben, with dense LU on the coarsest level
+    test_agglomerate(new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR),
+            new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR), A, 64);
+
+    // Ruge-Stuben, with CG on the coarsest level (every process
+    // takes part in every level)
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical,
+            Classical, SOR);
+    ParMultilevel* ml_agg = new ParRugeStubenSolver(0.25, Falgout, ModClassical,
+            Classical, SOR);
+    ml->coarse_solver = CoarseCG;
+    ml->coarse_iterations = 100;
+    ml_agg->coarse_solver = CoarseCG;
+    ml_agg->coarse_iterations = 100;
+    test_agglomerate(ml, ml_agg, A, 100);
+
+    // Smoothed aggregation
+    test_agglomerate(new ParSmoothedAggregationSolver(0.0),
+            new ParSmoothedAggregationSolver(0.0), A, 64);
+
+    delete A;
+
+} // end of TEST(ParAgglomerateTest, TestsInMultilevel) //
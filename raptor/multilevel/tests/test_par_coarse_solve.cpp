@@ -0,0 +1,72 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    // Two processes per node, so that NodeLU forms multiple groups
+    setenv("PPN", "2", 1);
+
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+
+TEST(ParCoarseSolveTest, TestsInMultilevel)
+{
+    int grid[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+
+    // Reference solve with dense LU on the coarsest level
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->max_coarse = 200;
+    ml->setup(A);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double> res = ml->get_residuals();
+
+    coarse_solve_t coarse_solvers[3] = {SparseLU, NodeLU, CoarseCG};
+    for (int s = 0; s < 3; s++)
+    {
+        ParMultilevel* ml_c = new ParRugeStubenSolver(0.25, HMIS, Extended, 
+                Classical, SOR);
+        ml_c->max_coarse = 200;
+        ml_c->coarse_solver = coarse_solvers[s];
+        ml_c->coarse_iterations = 200;
+        ml_c->coarse_tol = 1e-12;
+        ml_c->setup(A);
+        ASSERT_EQ(ml_c->num_levels, ml->num_levels);
+
+        x.set_const_value(0.0);
+        int iter_c = ml_c->solve(x, b);
+        aligned_vector<double>& res_c = ml_c->get_residuals();
+        ASSERT_EQ(iter, iter_c);
+        for (int i = 0; i < iter; i++)
+            ASSERT_NEAR(res[i], res_c[i], 1e-08);
+
+        // Coarse solves are timed on every process holding coarse rows
+        ASSERT_GE(ml_c->coarse_setup_time, 0.0);
+        if (ml_c->levels[ml_c->num_levels - 1]->A->local_num_rows)
+            ASSERT_GT(ml_c->coarse_solve_time, 0.0);
+
+        delete ml_c;
+    }
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParCoarseSolveTest, TestsInMultilevel) //
@@ -0,0 +1,98 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+
+TEST(ParHierarchyIOTest, TestsInMultilevel)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    const char* fname = "par_hierarchy_io.bin";
+
+    int grid[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+
+    // Setup, solve, and save hierarchy
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->setup(A);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double> res = ml->get_residuals();
+    int num_levels = ml->num_levels;
+    ml->save_hierarchy(fname);
+
+    // Load hierarchy in place of setup, and compare solves
+    ParMultilevel* ml_io = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ASSERT_EQ(ml_io->load_hierarchy(fname), 0);
+    ASSERT_EQ(ml_io->num_levels, num_levels);
+    for (int i = 0; i < num_levels; i++)
+    {
+        ParCSRMatrix* Al = ml->levels[i]->A;
+        ParCSRMatrix* Al_io = ml_io->levels[i]->A;
+        ASSERT_EQ(Al->global_num_rows, Al_io->global_num_rows);
+        ASSERT_EQ(Al->local_num_rows, Al_io->local_num_rows);
+        ASSERT_EQ(Al->local_nnz, Al_io->local_nnz);
+        ASSERT_EQ(Al->off_proc_num_cols, Al_io->off_proc_num_cols);
+        ASSERT_EQ(Al->comm->send_data->size_msgs, Al_io->comm->send_data->size_msgs);
+        ASSERT_EQ(Al->comm->recv_data->size_msgs, Al_io->comm->recv_data->size_msgs);
+        if (i < num_levels - 1)
+        {
+            ASSERT_EQ(ml->levels[i]->P->local_nnz, ml_io->levels[i]->P->local_nnz);
+            ASSERT_EQ(ml->levels[i]->P->global_num_cols, 
+                    ml_io->levels[i]->P->global_num_cols);
+        }
+    }
+
+    x.set_const_value(0.0);
+    int iter_io = ml_io->solve(x, b);
+    aligned_vector<double>& res_io = ml_io->get_residuals();
+    ASSERT_EQ(iter, iter_io);
+    for (int i = 0; i < iter; i++)
+        ASSERT_NEAR(res[i], res_io[i], 1e-14);
+    delete ml_io;
+
+    // Loading a hierarchy with solve phase options applied
+    ml_io = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml_io->sell_solve = true;
+    ASSERT_EQ(ml_io->load_hierarchy(fname), 0);
+    ASSERT_EQ(ml_io->levels[0]->A->on_proc->format(), SELL);
+    x.set_const_value(0.0);
+    iter_io = ml_io->solve(x, b);
+    ASSERT_EQ(iter, iter_io);
+    delete ml_io;
+
+    // Files that are not hierarchies are rejected
+    ml_io = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ASSERT_EQ(ml_io->load_hierarchy("../../../../test_data/aniso.mtx"), -1);
+    ASSERT_EQ(ml_io->load_hierarchy("missing_hierarchy.bin"), -1);
+    delete ml_io;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) remove(fname);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParHierarchyIOTest, TestsInMultilevel) //
@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+
+TEST(ParMixedAMGTest, TestsInMultilevel)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int grid[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector b_float(A->global_num_rows, A->local_num_rows);
+
+    // Single precision SpMVs match double within float rounding
+    ParCSRMatrix* A_float = A->copy();
+    A_float->to_single_precision();
+    ASSERT_EQ(A_float->on_proc->format(), FCSR);
+    ASSERT_EQ(A_float->off_proc->format(), FCSR);
+    for (int i = 0; i < A->local_num_rows; i++)
+        x.local[i] = (((A->partition->first_local_row + i) * 13) % 7) - 3.0;
+    A->mult(x, b);
+    A_float->mult(x, b_float);
+    for (int i = 0; i < A->local_num_rows; i++)
+        ASSERT_NEAR(b[i], b_float[i], 1e-5 * (1.0 + fabs(b[i])));
+    A->residual(x, b, b_float);
+    A_float->residual(x, b, b_float);
+    for (int i = 0; i < A->local_num_rows; i++)
+        ASSERT_NEAR(b_float[i], 0.0, 1e-5 * (1.0 + fabs(b[i])));
+    A->mult_T(x, b);
+    A_float->mult_T(x, b_float);
+    for (int i = 0; i < A->local_num_rows; i++)
+        ASSERT_NEAR(b[i], b_float[i], 1e-5 * (1.0 + fabs(b[i])));
+    delete A_float;
+
+    // Solve with double precision hierarchy
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->setup(A);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    delete ml;
+
+    // Solve with coarse operators and interpolation in single precision
+    ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->mixed_precision = true;
+    ml->setup(A);
+    ASSERT_EQ(ml->levels[0]->A->on_proc->format(), CSR);
+    ASSERT_FALSE(ml->levels[0]->A->float_comm);
+    for (int i = 0; i < ml->num_levels; i++)
+    {
+        if (i > 0)
+        {
+            ASSERT_EQ(ml->levels[i]->A->on_proc->format(), FCSR);
+            ASSERT_TRUE(ml->levels[i]->A->float_comm);
+        }
+        if (i < ml->num_levels - 1)
+        {
+            ASSERT_EQ(ml->levels[i]->P->on_proc->format(), FCSR);
+            ASSERT_EQ(ml->levels[i]->P->off_proc->format(), FCSR);
+        }
+    }
+    x.set_const_value(0.0);
+    int mixed_iter = ml->solve(x, b);
+
+    // Fine level residual is in double, so the solve reaches the same
+    // tolerance in (nearly) the same number of iterations
+    ASSERT_LE(mixed_iter, iter + 1);
+    aligned_vector<double>& mixed_res = ml->get_residuals();
+    ASSERT_LT(mixed_res[mixed_iter], ml->solve_tol);
+    for (int i = 0; i < A->local_num_rows; i++)
+        ASSERT_NEAR(x[i], 1.0, 1e-4);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParMixedAMGTest, TestsInMultilevel) //
@@ -0,0 +1,85 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+
+TEST(ParNeighborAMGTest, TestsInMultilevel)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int grid[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    // Solve with point-to-point communication
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->setup(A);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double> res = ml->get_residuals();
+    int num_levels = ml->num_levels;
+    delete ml;
+
+    // Setup and solve with neighborhood collectives
+    ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->neighbor_collectives = true;
+    ml->setup(A);
+    ASSERT_EQ(ml->num_levels, num_levels);
+    for (int i = 0; i < ml->num_levels; i++)
+    {
+        ASSERT_TRUE(dynamic_cast<NeighborComm*>(ml->levels[i]->A->comm) != NULL);
+        if (i < ml->num_levels - 1)
+            ASSERT_TRUE(dynamic_cast<NeighborComm*>(ml->levels[i]->P->comm) != NULL);
+    }
+    x.set_const_value(0.0);
+    int nbr_iter = ml->solve(x, b);
+    aligned_vector<double>& nbr_res = ml->get_residuals();
+
+    ASSERT_EQ(iter, nbr_iter);
+    for (int i = 0; i < iter; i++)
+        ASSERT_NEAR(res[i], nbr_res[i], 1e-10 + 1e-06 * res[i]);
+    delete ml;
+
+    // Solve with persistent point-to-point requests
+    ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->persistent_comm = true;
+    ml->setup(A);
+    for (int i = 0; i < ml->num_levels; i++)
+    {
+        ASSERT_TRUE(((ParComm*) ml->levels[i]->A->comm)->persistent);
+        if (i < ml->num_levels - 1)
+            ASSERT_TRUE(((ParComm*) ml->levels[i]->P->comm)->persistent);
+    }
+    x.set_const_value(0.0);
+    int pers_iter = ml->solve(x, b);
+    aligned_vector<double>& pers_res = ml->get_residuals();
+
+    ASSERT_EQ(iter, pers_iter);
+    for (int i = 0; i < iter; i++)
+        ASSERT_NEAR(res[i], pers_res[i], 1e-10);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParNeighborAMGTest, TestsInMultilevel) //
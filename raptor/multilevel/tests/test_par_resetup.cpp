@@ -0,0 +1,175 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+#include "tests/par_compare.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Copy of A with a shifted diagonal, which leaves classical strength
+// (and so the coarsening) unchanged but changes interpolation weights
+ParCSRMatrix* shift_diagonal(ParCSRMatrix* A)
+{
+    ParCSRMatrix* A2 = A->copy();
+    for (int i = 0; i < A2->local_num_rows; i++)
+    {
+        int row = A2->local_row_map[i];
+        for (int j = A2->on_proc->idx1[i]; j < A2->on_proc->idx1[i+1]; j++)
+        {
+            if (A2->on_proc_column_map[A2->on_proc->idx2[j]] == row)
+                A2->on_proc->vals[j] += 0.1 * (row % 7);
+        }
+    }
+    return A2;
+}
+
+void compare_hierarchies(ParMultilevel* ml, ParMultilevel* ml_new,
+        ParVector& x, ParVector& b)
+{
+    ASSERT_EQ(ml->num_levels, ml_new->num_levels);
+    for (int i = 0; i < ml->num_levels; i++)
+    {
+        compare(ml->levels[i]->A, ml_new->levels[i]->A);
+        if (i < ml->num_levels - 1)
+            compare(ml->levels[i]->P, ml_new->levels[i]->P);
+    }
+
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double> res = ml->get_residuals();
+    x.set_const_value(0.0);
+    int iter_new = ml_new->solve(x, b);
+    aligned_vector<double>& res_new = ml_new->get_residuals();
+    ASSERT_EQ(iter, iter_new);
+    for (int i = 0; i < iter; i++)
+        ASSERT_NEAR(res[i], res_new[i], 1e-10);
+}
+
+TEST(ParResetupTest, TestsInMultilevel)
+{
+    int grid[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+    ParCSRMatrix* A2 = shift_diagonal(A);
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    A2->mult(x, b);
+
+    interp_t interp_types[3] = {Direct, ModClassical, Extended};
+    for (int t = 0; t < 3; t++)
+    {
+        // Setup with A, then refresh values for A2
+        ParMultilevel* ml = new ParRugeStubenSolver(0.25, PMIS, interp_types[t],
+                Classical, SOR);
+        ml->allow_resetup = true;
+        ml->setup(A);
+        int num_levels = ml->num_levels;
+        std::vector<CommPkg*> comms(num_levels);
+        for (int i = 0; i < num_levels; i++)
+            comms[i] = ml->levels[i]->A->comm;
+        ml->resetup(A2);
+
+        // Structure and communication packages are kept
+        ASSERT_EQ(ml->num_levels, num_levels);
+        for (int i = 0; i < num_levels; i++)
+            ASSERT_EQ(ml->levels[i]->A->comm, comms[i]);
+
+        // Coarsening of A2 matches that of A on the fine level, so the
+        // first interpolation and coarse operator match a full setup
+        // (extended interpolation is filtered by value, so a full setup
+        // may keep a different pattern)
+        ParMultilevel* ml_new = new ParRugeStubenSolver(0.25, PMIS, interp_types[t],
+                Classical, SOR);
+        ml_new->allow_resetup = true;
+        ml_new->setup(A2);
+        compare(ml->levels[0]->A, ml_new->levels[0]->A);
+        if (interp_types[t] != Extended)
+        {
+            compare(ml->levels[0]->P, ml_new->levels[0]->P);
+            compare(ml->levels[1]->A, ml_new->levels[1]->A);
+        }
+        x.set_const_value(0.0);
+        ASSERT_LT(ml->solve(x, b), ml->max_iterations);
+        delete ml_new;
+
+        // Refreshing with A again reproduces the original setup
+        ml->resetup(A);
+        ml_new = new ParRugeStubenSolver(0.25, PMIS, interp_types[t],
+                Classical, SOR);
+        ml_new->allow_resetup = true;
+        ml_new->setup(A);
+        compare_hierarchies(ml, ml_new, x, b);
+
+        delete ml_new;
+        delete ml;
+    }
+
+    // Node-aware communication on all levels
+    ParMultilevel* ml_tap = new ParRugeStubenSolver(0.25, PMIS, ModClassical,
+            Classical, SOR);
+    ml_tap->allow_resetup = true;
+    ml_tap->tap_amg = 0;
+    ml_tap->setup(A);
+    ml_tap->resetup(A2);
+    ml_tap->resetup(A);
+    ParMultilevel* ml_tap_new = new ParRugeStubenSolver(0.25, PMIS, ModClassical,
+            Classical, SOR);
+    ml_tap_new->allow_resetup = true;
+    ml_tap_new->tap_amg = 0;
+    ml_tap_new->setup(A);
+    compare_hierarchies(ml_tap, ml_tap_new, x, b);
+    delete ml_tap_new;
+    delete ml_tap;
+
+    // Without allow_resetup, resetup performs a full setup
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->setup(A);
+    ml->resetup(A2);
+    ParMultilevel* ml_new = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml_new->setup(A2);
+    compare_hierarchies(ml, ml_new, x, b);
+    delete ml_new;
+    delete ml;
+
+    // A pattern change that keeps the number of nonzeros (moving one
+    // entry of the first local row to a new column) performs a full setup
+    ParCSRMatrix* A3 = A2->copy();
+    if (A3->local_num_rows)
+    {
+        int last_col = A3->on_proc_num_cols - 1;
+        int start = A3->on_proc->idx1[0];
+        int end = A3->on_proc->idx1[1];
+        bool found = false;
+        for (int j = start; j < end; j++)
+            if (A3->on_proc->idx2[j] == last_col) found = true;
+        if (!found) A3->on_proc->idx2[end - 1] = last_col;
+    }
+    ml = new ParRugeStubenSolver(0.25, PMIS, ModClassical, Classical, SOR);
+    ml->allow_resetup = true;
+    ml->setup(A2);
+    ml->resetup(A3);
+    ml_new = new ParRugeStubenSolver(0.25, PMIS, ModClassical, Classical, SOR);
+    ml_new->allow_resetup = true;
+    ml_new->setup(A3);
+    compare_hierarchies(ml, ml_new, x, b);
+    delete ml_new;
+    delete ml;
+    delete A3;
+
+    delete A2;
+    delete A;
+
+} // end of TEST(ParResetupTest, TestsInMultilevel) //
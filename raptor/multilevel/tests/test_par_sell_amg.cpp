@@ -0,0 +1,65 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+
+TEST(ParSELLAMGTest, TestsInMultilevel)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int grid[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    // Solve with CSR level matrices
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->setup(A);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    int iter = ml->solve(x, b);
+    aligned_vector<double> res = ml->get_residuals();
+    delete ml;
+
+    // Solve with SELL-C-sigma level matrices
+    ml = new ParRugeStubenSolver(0.25, HMIS, Extended, Classical, SOR);
+    ml->sell_solve = true;
+    ml->setup(A);
+    for (int i = 0; i < ml->num_levels; i++)
+    {
+        ASSERT_EQ(ml->levels[i]->A->on_proc->format(), SELL);
+        if (i < ml->num_levels - 1)
+            ASSERT_EQ(ml->levels[i]->P->on_proc->format(), SELL);
+    }
+    x.set_const_value(0.0);
+    int sell_iter = ml->solve(x, b);
+    aligned_vector<double>& sell_res = ml->get_residuals();
+
+    ASSERT_EQ(iter, sell_iter);
+    for (int i = 0; i < iter; i++)
+        ASSERT_NEAR(res[i], sell_res[i], 1e-10 + 1e-06 * res[i]);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(ParSELLAMGTest, TestsInMultilevel) //
+
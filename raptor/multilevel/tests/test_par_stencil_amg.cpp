@@ -0,0 +1,82 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+TEST(ParStencilAMGTest, TestsInMultilevel)
+{
+    int grid[3] = {12, 12, 12};
+    double* stencil = laplace_stencil_27pt();
+    ParStencilOperator* op = new ParStencilOperator(stencil, grid, 3);
+    delete[] stencil;
+    ParCSRMatrix* A = op->to_ParCSR();
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    op->mult(x, b);
+
+    relax_t relax_types[3] = {Jacobi, HybridSGS, L1Jacobi};
+    for (int t = 0; t < 3; t++)
+    {
+        // Hierarchy from the materialized matrix, and the same
+        // hierarchy solving with the stencil on the fine level
+        ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended,
+                Classical, relax_types[t]);
+        ml->setup(A);
+        ParMultilevel* ml_op = new ParRugeStubenSolver(0.25, HMIS, Extended,
+                Classical, relax_types[t]);
+        ml_op->setup_matrix_free(op);
+        ASSERT_EQ(ml->num_levels, ml_op->num_levels);
+        ASSERT_EQ(ml->levels[0]->A->local_nnz, ml_op->levels[0]->A->local_nnz);
+        ASSERT_EQ(ml_op->levels[0]->A->on_proc->nnz, 0);
+        ASSERT_EQ(ml_op->levels[0]->A->off_proc->nnz, 0);
+
+        x.set_const_value(0.0);
+        int iter = ml->solve(x, b);
+        aligned_vector<double> res = ml->get_residuals();
+        x.set_const_value(0.0);
+        int iter_op = ml_op->solve(x, b);
+        aligned_vector<double>& res_op = ml_op->get_residuals();
+        ASSERT_EQ(iter, iter_op);
+        for (int i = 0; i <= iter; i++)
+            ASSERT_NEAR(res[i], res_op[i], 1e-8);
+
+        // A saved matrix-free hierarchy holds the fine level nonzeros
+        if (t == 0)
+        {
+            const char* fname = "par_stencil_amg.bin";
+            ml_op->save_hierarchy(fname);
+            ParMultilevel* ml_io = new ParRugeStubenSolver(0.25, HMIS, Extended,
+                    Classical, relax_types[t]);
+            ASSERT_EQ(ml_io->load_hierarchy(fname), 0);
+            ASSERT_EQ(ml_io->levels[0]->A->local_nnz, ml->levels[0]->A->local_nnz);
+            x.set_const_value(0.0);
+            ASSERT_EQ(ml_io->solve(x, b), iter);
+            delete ml_io;
+            MPI_Barrier(MPI_COMM_WORLD);
+            int rank;
+            MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+            if (rank == 0) remove(fname);
+        }
+
+        delete ml_op;
+        delete ml;
+    }
+
+    delete A;
+    delete op;
+
+} // end of TEST(ParStencilAMGTest, TestsInMultilevel) //
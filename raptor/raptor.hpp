@@ -5,6 +5,7 @@
 
 // Define types such as int and double sizes
 #include "core/types.hpp"
+#include "core/threads.hpp"
 
 // Data about topology and matrix partitions
 #ifndef NO_MPI
@@ -19,6 +20,7 @@
 #ifndef NO_MPI
     #include "core/par_matrix.hpp"
     #include "core/par_vector.hpp"
+    #include "core/par_stencil_operator.hpp"
 #endif 
 
 // Communication classes
@@ -688,7 +688,6 @@ void update_off_proc_dist2_weights(const ParCSRMatrix* S,
     aligned_vector<int> off_indices;
     aligned_vector<int> on_proc_col_to_coarse;
     aligned_vector<int> off_proc_col_to_coarse;
-    std::map<int, int> map_to_local;
     
     aligned_vector<int> c_dep_cache;
     if (S->off_proc_num_cols)
@@ -696,12 +695,6 @@ void update_off_proc_dist2_weights(const ParCSRMatrix* S,
         c_dep_cache.resize(S->off_proc_num_cols, Unassigned);
     }
 
-    // Map global off_proc columns to local indices
-    for (int i = 0; i < S->off_proc_num_cols; i++)
-    {
-        map_to_local[S->off_proc_column_map[i]] = i;
-    }
-
     // Map index i in on(/off)_proc_num_cols to coarse_list
     if (S->on_proc_num_cols)
     {
@@ -933,7 +926,7 @@ int find_off_proc_states(CommPkg* comm,
 
 void find_off_proc_new_coarse(const ParCSRMatrix* S,
         CommPkg* comm,
-        const std::map<int, int>& global_to_local,
+        const IntMap& global_to_local,
         const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
         const int* part_to_col,
@@ -1016,11 +1009,10 @@ void find_off_proc_new_coarse(const ParCSRMatrix* S,
                 }
                 else
                 {
-                    std::map<int, int>::const_iterator ptr = 
-                    global_to_local.find(global_col);
-                    if (ptr != global_to_local.end())
+                    int local_col = global_to_local.find(global_col);
+                    if (local_col >= 0)
                     {
-                        off_proc_col_coarse.emplace_back(ptr->second + S->on_proc_num_cols);
+                        off_proc_col_coarse.emplace_back(local_col + S->on_proc_num_cols);
                     }   
                 }
             }
@@ -1149,11 +1141,10 @@ void find_off_proc_new_coarse(const ParCSRMatrix* S,
                         }
                         else
                         {
-                            std::map<int, int>::const_iterator ptr = 
-                            global_to_local.find(global_col);
-                            if (ptr != global_to_local.end())
+                            int local_col = global_to_local.find(global_col);
+                            if (local_col >= 0)
                             {
-                                off_proc_col_coarse.emplace_back(ptr->second + S->on_proc_num_cols);
+                                off_proc_col_coarse.emplace_back(local_col + S->on_proc_num_cols);
                             }   
                         }
                     }
@@ -1412,7 +1403,7 @@ void cljp_main_loop(ParCSRMatrix* S,
     aligned_vector<int> off_proc_col_coarse;
     aligned_vector<int> off_proc_weight_updates;
     aligned_vector<int> off_proc_col_ptr;
-    std::map<int, int> global_to_local;
+    IntMap global_to_local(S->off_proc_num_cols);
     aligned_vector<int> new_coarse_list;
     aligned_vector<int> off_new_coarse_list;
     aligned_vector<int> unassigned;
@@ -281,14 +281,14 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
         const double filter_threshold, 
-        bool tap_interp, int num_variables, int* variables)
+        bool tap_interp, int num_variables, int* variables, bool form_comm)
 {
     int start, end, idx, idx_k;
     int ctr, end_S;
     int start_k, end_k;
     int col, global_col;
     int col_k, col_P;
-    int global_num_cols;
+    index_t global_num_cols;
     int on_proc_cols, off_proc_cols;
     int sign;
     int row_start_on, row_start_off;
@@ -305,8 +305,6 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         mat_comm = A->tap_mat_comm;
     }
 
-    std::set<int> global_set;
-    std::map<int, int> global_to_local;
     aligned_vector<int> off_proc_column_map;
     aligned_vector<int> off_variables;
 
@@ -421,7 +419,7 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     {
         if (off_proc_states[i] == Selected)
         {
-            global_set.insert(S->off_proc_column_map[i]);
+            off_proc_column_map.emplace_back(S->off_proc_column_map[i]);
         }
     }
     for (int i = 0; i < S->off_proc_num_cols; i++)
@@ -432,21 +430,22 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
             end = A_recv_off_ptr[i+1];
             for (int j = start; j < end; j++)
             {
-                global_set.insert(recv_mat->idx2[A_recv_off_idx[j]]);
+                off_proc_column_map.emplace_back(recv_mat->idx2[A_recv_off_idx[j]]);
             }
         }
     }
-    for (std::set<int>::iterator it = global_set.begin(); it != global_set.end(); ++it)
-    {
-        global_to_local[*it] = off_proc_column_map.size();
-        off_proc_column_map.push_back(*it);
-    }
+    sort_unique(off_proc_column_map);
     off_proc_cols = off_proc_column_map.size();
 
+    IntMap global_to_local(off_proc_cols);
+    for (int i = 0; i < off_proc_cols; i++)
+    {
+        global_to_local[off_proc_column_map[i]] = i;
+    }
     for (aligned_vector<int>::iterator it = A_recv_off_idx.begin(); 
             it != A_recv_off_idx.end(); ++it)
     {
-        recv_mat->idx2[*it] = global_to_local[recv_mat->idx2[*it]];
+        recv_mat->idx2[*it] = global_to_local.find(recv_mat->idx2[*it]);
     }
 
     // Initialize P
@@ -470,8 +469,8 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     }
     // Initialize AllReduce to determine global num cols
     RAPtor_MPI_Request reduce_request;
-    int reduce_buf = on_proc_cols;
-    RAPtor_MPI_Iallreduce(&(reduce_buf), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, 
+    index_t reduce_buf = on_proc_cols;
+    RAPtor_MPI_Iallreduce(&(reduce_buf), &global_num_cols, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, 
             RAPtor_MPI_COMM_WORLD, &reduce_request);
    
     ParCSRMatrix* P = new ParCSRMatrix(A->partition, A->global_num_rows, -1, 
@@ -969,11 +968,11 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     P->off_proc->n_cols = P->off_proc_num_cols;
     P->on_proc->n_cols = P->on_proc_num_cols;
 
-    if (tap_interp)
+    if (form_comm && tap_interp)
     {
         P->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
     }
-    else
+    else if (form_comm)
     {
         P->comm = new ParComm(P->partition, P->off_proc_column_map,
                 P->on_proc_column_map, 9243, RAPtor_MPI_COMM_WORLD);
@@ -991,7 +990,7 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
 ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states, 
-        bool tap_interp, int num_variables, int* variables)
+        bool tap_interp, int num_variables, int* variables, bool form_comm)
 {
     int rank;
     RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
@@ -1001,8 +1000,8 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
     int end_S;
     int col, col_k;
     int ctr, idx;
-    int global_col, sign;
-    int global_num_cols;
+    int global_col, local_col, sign;
+    index_t global_num_cols;
     int row_start_on, row_start_off;
     double diag, val, val_k;
     double weak_sum, coarse_sum;
@@ -1064,7 +1063,8 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
             off_proc_cols++;
         }
     }
-    RAPtor_MPI_Allreduce(&(on_proc_cols), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    global_num_cols = on_proc_cols;
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &global_num_cols, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
    
     ParCSRMatrix* P = new ParCSRMatrix(A->partition, A->global_num_rows, global_num_cols, 
             A->local_num_rows, on_proc_cols, off_proc_cols);
@@ -1122,8 +1122,8 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
 
     // Change off_proc_cols to local (remove cols not on rank)
     ctr = 0;
-    std::map<int, int> global_to_local;
-    for (aligned_vector<int>::iterator it = A->off_proc_column_map.begin();
+    IntMap global_to_local(A->off_proc_num_cols);
+    for (aligned_vector<index_t>::iterator it = A->off_proc_column_map.begin();
             it != A->off_proc_column_map.end(); ++it)
     {
         global_to_local[*it] = ctr++;
@@ -1137,10 +1137,10 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         for (int j = start; j < end; j++)
         {
             global_col = recv_off->idx2[j];
-            std::map<int, int>::iterator it = global_to_local.find(global_col);
-            if (it != global_to_local.end())
+            local_col = global_to_local.find(global_col);
+            if (local_col >= 0)
             {
-                recv_off->idx2[ctr] = it->second;
+                recv_off->idx2[ctr] = local_col;
                 recv_off->vals[ctr++] = recv_off->vals[j];
             }
         }
@@ -1434,11 +1434,11 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
     P->off_proc->n_cols = P->off_proc_num_cols;
     P->on_proc->n_cols = P->on_proc_num_cols;
 
-    if (tap_interp)
+    if (form_comm && tap_interp)
     {
         P->update_tap_comm(S, on_proc_col_to_new, off_proc_col_to_new);
     }
-    else
+    else if (form_comm)
     {
         P->comm = new ParComm(S->comm, on_proc_col_to_new, off_proc_col_to_new);
     }
@@ -1453,10 +1453,10 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
 ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states, 
-        bool tap_interp)
+        bool tap_interp, bool form_comm)
 {
     int start, end, col;
-    int global_num_cols;
+    index_t global_num_cols;
     int ctr;
     double sum_strong_pos, sum_strong_neg;
     double sum_all_pos, sum_all_neg;
@@ -1535,7 +1535,8 @@ ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
             off_proc_cols++;
         }
     }
-    RAPtor_MPI_Allreduce(&(on_proc_cols), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    global_num_cols = on_proc_cols;
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &global_num_cols, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
    
     ParCSRMatrix* P = new ParCSRMatrix(S->partition, S->global_num_rows, global_num_cols, 
             S->local_num_rows, on_proc_cols, off_proc_cols);
@@ -1740,11 +1741,11 @@ ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
     P->off_proc->n_cols = P->off_proc_num_cols;
     P->on_proc->n_cols = P->on_proc_num_cols;
 
-    if (tap_interp)
+    if (form_comm && tap_interp)
     {
         P->update_tap_comm(S, on_proc_col_to_new, off_proc_col_to_new);
     }
-    else
+    else if (form_comm)
     {
         P->comm = new ParComm(S->comm, on_proc_col_to_new, off_proc_col_to_new);
     }
@@ -11,17 +11,19 @@ using namespace raptor;
 ParCSRMatrix* direct_interpolation(ParCSRMatrix* A, 
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
-        bool tap_amg = false);
+        bool tap_amg = false, bool form_comm = true);
 
 ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
-        bool tap_amg = false, int num_variables = 1, int* variables = NULL);
+        bool tap_amg = false, int num_variables = 1, int* variables = NULL,
+        bool form_comm = true);
 
 ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const aligned_vector<int>& states,
         const aligned_vector<int>& off_proc_states,
         const double filter_threshold = 0.3,
-        bool tap_amg = false, int num_variables = 1, int* variables = NULL);
+        bool tap_amg = false, int num_variables = 1, int* variables = NULL,
+        bool form_comm = true);
 
 #endif
@@ -41,6 +41,19 @@ namespace raptor
             if (num_variables > 1) delete[] variables;
             variables = NULL;
         }
+
+        void resetup(ParCSRMatrix* Af)
+        {
+            if (num_variables > 1 && variables == NULL)
+            {
+                form_variable_list(Af, num_variables);
+            }
+
+            resetup_helper(Af);
+
+            if (num_variables > 1) delete[] variables;
+            variables = NULL;
+        }
        
         void form_variable_list(const ParCSRMatrix* A, const int num_variables)
         {
@@ -62,16 +75,20 @@ namespace raptor
             ParCSRMatrix* A = levels[level_ctr]->A;
             ParCSRMatrix* S;
             ParCSRMatrix* P;
-            ParCSRMatrix* AP;
 
             aligned_vector<int> states;
             aligned_vector<int> off_proc_states;
 
             // Form strength of connection
+            profile_begin("strength");
+            profile_add_nnz(A->local_nnz);
             S = A->strength(strength_type, strong_threshold, tap_level, 
                     num_variables, variables);
+            profile_end();
 
             // Form CF Splitting
+            profile_begin("split");
+            profile_add_nnz(S->local_nnz);
             switch (coarsen_type)
             {
                 case RS:
@@ -102,25 +119,83 @@ namespace raptor
                             weights);
                     break;
             }
+            profile_end();
 
             // Form modified classical interpolation
+            profile_begin("interp");
+            profile_add_nnz(A->local_nnz + S->local_nnz);
+            P = interpolation(A, S, states, off_proc_states, tap_level);
+            levels[level_ctr]->P = P;
+            coarsen_variables(A, states);
+            profile_end();
+
+            // Form coarse grid operator
+            levels.emplace_back(new ParLevel());
+
+            profile_begin("RAP");
+            profile_add_nnz(A->local_nnz + 2.0 * P->local_nnz);
+            A = form_coarse_operator(level_ctr, tap_level);
+            profile_end();
+
+            A->sort();
+            A->on_proc->move_diag();
+
+            level_ctr++;
+            levels[level_ctr]->A = A;
+            A->comm = new ParComm(A->partition, A->off_proc_column_map,
+                    A->on_proc_column_map, levels[level_ctr-1]->A->comm->key,
+                    levels[level_ctr-1]->A->comm->mpi_comm);
+            levels[level_ctr]->x.resize(A->global_num_rows, A->local_num_rows);
+            levels[level_ctr]->b.resize(A->global_num_rows, A->local_num_rows);
+            levels[level_ctr]->tmp.resize(A->global_num_rows, A->local_num_rows);
+            levels[level_ctr]->P = NULL;
+
+            if (tap_amg >= 0 && tap_amg <= level_ctr)
+            {
+                levels[level_ctr]->A->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+            }
+
+            // Keep coarsening for resetup
+            if (allow_resetup)
+            {
+                levels[level_ctr-1]->S = S;
+                levels[level_ctr-1]->states.swap(states);
+                levels[level_ctr-1]->off_proc_states.swap(off_proc_states);
+            }
+            else
+            {
+                delete S;
+            }
+        }    
+
+        ParCSRMatrix* interpolation(ParCSRMatrix* A, ParCSRMatrix* S,
+                const aligned_vector<int>& states,
+                const aligned_vector<int>& off_proc_states,
+                bool tap_level, bool form_comm = true)
+        {
+            ParCSRMatrix* P = NULL;
             switch (interp_type)
             {
                 case Direct:
                     P = direct_interpolation(A, S, states, off_proc_states, 
-                            tap_level);
+                            tap_level, form_comm);
                     break;
                 case ModClassical:
                     P = mod_classical_interpolation(A, S, states, off_proc_states, 
-                            tap_level, num_variables, variables);
+                            tap_level, num_variables, variables, form_comm);
                     break;
                 case Extended:
                     P = extended_interpolation(A, S, states, off_proc_states, 
-                            interp_filter, tap_level, num_variables, variables);
+                            interp_filter, tap_level, num_variables, variables,
+                            form_comm);
                     break;
             }
-            levels[level_ctr]->P = P;
+            return P;
+        }
 
+        // Restrict variable list to coarse points
+        void coarsen_variables(ParCSRMatrix* A, const aligned_vector<int>& states)
+        {
             if (num_variables > 1)
             {
                 int ctr = 0;
@@ -132,34 +207,38 @@ namespace raptor
                     }
                 }
             }
+        }
 
-            // Form coarse grid operator
-            levels.emplace_back(new ParLevel());
+        // Move the variable of each coarse row with an agglomerated level
+        void agglomerate_data(ParCSRMatrix* A, ParCSRMatrix* Ac)
+        {
+            if (num_variables <= 1) return;
 
-            AP = A->mult(levels[level_ctr]->P, tap_level);
-            A = AP->mult_T(P, tap_level);
+            aligned_vector<int> vars(A->local_num_rows);
+            std::copy(variables, variables + A->local_num_rows, vars.begin());
+            agglomerate_values(vars, 1, A, Ac, RAPtor_MPI_INT);
 
-            A->sort();
-            A->on_proc->move_diag();
+            delete[] variables;
+            variables = new int[Ac->local_num_rows];
+            std::copy(vars.begin(), vars.end(), variables);
+        }
 
-            level_ctr++;
-            levels[level_ctr]->A = A;
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map, levels[level_ctr-1]->A->comm->key,
-                    levels[level_ctr-1]->A->comm->mpi_comm);
-            levels[level_ctr]->x.resize(A->global_num_rows, A->local_num_rows);
-            levels[level_ctr]->b.resize(A->global_num_rows, A->local_num_rows);
-            levels[level_ctr]->tmp.resize(A->global_num_rows, A->local_num_rows);
-            levels[level_ctr]->P = NULL;
+        void update_interpolation(int level)
+        {
+            ParLevel* l = levels[level];
+            bool tap_level = tap_amg >= 0 && tap_amg <= level;
 
-            if (tap_amg >= 0 && tap_amg <= level_ctr)
-            {
-                levels[level_ctr]->A->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
-            }
+            // Strong connections keep their pattern, with new values of A
+            l->S->copy_values(l->A);
 
-            delete AP;
-            delete S;
-        }    
+            // New weights in the existing sparsity pattern of P
+            ParCSRMatrix* P = interpolation(l->A, l->S, l->states, 
+                    l->off_proc_states, tap_level, false);
+            l->P->copy_values(P);
+            delete P;
+
+            coarsen_variables(l->A, l->states);
+        }
 
         coarsen_t coarsen_type;
         interp_t interp_type;
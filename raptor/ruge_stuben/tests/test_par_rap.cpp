@@ -27,6 +27,9 @@ TEST(TestParRAP, TestsInRuge_Stuben)
     ParCSRMatrix* AP;
     ParCSCMatrix* P_csc;
     ParCSRMatrix* Ac_rap;
+    ParCSRMatrix* Ac_fused;
+    ParMultPlan* AP_plan;
+    ParMultPlan* Ac_plan;
 
     const char* A0_fn = "../../../../test_data/rss_A0.pm";
     const char* A1_fn = "../../../../test_data/rss_A1.pm";
@@ -42,6 +45,66 @@ TEST(TestParRAP, TestsInRuge_Stuben)
     Ac = AP->mult_T(P_csc);
     Ac_rap = readParMatrix(A1_fn);
     compare(Ac, Ac_rap);
+
+    // Fused Galerkin product matches
+    Ac_fused = A->RAP(P);
+    compare(Ac_fused, Ac_rap);
+    delete Ac_fused;
+
+    // Split symbolic/numeric products match, and numeric phase
+    // refills values for a matrix with the same sparsity
+    AP_plan = new ParMultPlan();
+    Ac_plan = new ParMultPlan();
+    delete AP;
+    AP = A->mult_symbolic(P, AP_plan);
+    Ac_fused = AP->mult_T_symbolic(P, Ac_plan);
+    compare(Ac_fused, Ac_rap);
+    for (aligned_vector<double>::iterator it = A->on_proc->vals.begin();
+            it != A->on_proc->vals.end(); ++it)
+        *it *= 2.0;
+    for (aligned_vector<double>::iterator it = A->off_proc->vals.begin();
+            it != A->off_proc->vals.end(); ++it)
+        *it *= 2.0;
+    for (aligned_vector<double>::iterator it = Ac_rap->on_proc->vals.begin();
+            it != Ac_rap->on_proc->vals.end(); ++it)
+        *it *= 2.0;
+    for (aligned_vector<double>::iterator it = Ac_rap->off_proc->vals.begin();
+            it != Ac_rap->off_proc->vals.end(); ++it)
+        *it *= 2.0;
+    A->mult_numeric(P, AP, AP_plan);
+    AP->mult_T_numeric(P, Ac_fused, Ac_plan);
+    compare(Ac_fused, Ac_rap);
+    delete Ac_fused;
+    delete Ac_plan;
+    delete AP_plan;
+
+    // Split symbolic/numeric products match, and numeric phase
+    // refills values for a matrix with the same sparsity
+    AP_plan = new ParMultPlan();
+    Ac_plan = new ParMultPlan();
+    delete AP;
+    AP = A->mult_symbolic(P, AP_plan);
+    Ac_fused = AP->mult_T_symbolic(P, Ac_plan);
+    compare(Ac_fused, Ac_rap);
+    for (aligned_vector<double>::iterator it = A->on_proc->vals.begin();
+            it != A->on_proc->vals.end(); ++it)
+        *it *= 2.0;
+    for (aligned_vector<double>::iterator it = A->off_proc->vals.begin();
+            it != A->off_proc->vals.end(); ++it)
+        *it *= 2.0;
+    for (aligned_vector<double>::iterator it = Ac_rap->on_proc->vals.begin();
+            it != Ac_rap->on_proc->vals.end(); ++it)
+        *it *= 2.0;
+    for (aligned_vector<double>::iterator it = Ac_rap->off_proc->vals.begin();
+            it != Ac_rap->off_proc->vals.end(); ++it)
+        *it *= 2.0;
+    A->mult_numeric(P, AP, AP_plan);
+    AP->mult_T_numeric(P, Ac_fused, Ac_plan);
+    compare(Ac_fused, Ac_rap);
+    delete Ac_fused;
+    delete Ac_plan;
+    delete AP_plan;
+
     delete Ac_rap;
     delete Ac;
     delete P_csc;
@@ -57,6 +120,12 @@ TEST(TestParRAP, TestsInRuge_Stuben)
     Ac = AP->mult_T(P_csc);
     Ac_rap = readParMatrix(A2_fn);
     compare(Ac, Ac_rap);
+
+    // Fused Galerkin product matches
+    Ac_fused = A->RAP(P);
+    compare(Ac_fused, Ac_rap);
+    delete Ac_fused;
+
     delete Ac_rap;
     delete Ac;
     delete P_csc;
@@ -37,6 +37,24 @@ TEST(TestRAP, TestsInRuge_Stuben)
     Ac = AP->mult_T(P_csc);
     Ac_rap = readMatrix(A1_fn);
     compare(Ac, Ac_rap);
+    delete Ac;
+
+    // Two-pass products match, and numeric pass refills values
+    delete AP;
+    AP = A->spgemm_symbolic(P);
+    A->spgemm_numeric(P, AP);
+    Ac = AP->spgemm_T_symbolic(P_csc);
+    AP->spgemm_T_numeric(P_csc, Ac);
+    compare(Ac, Ac_rap);
+    for (aligned_vector<double>::iterator it = A->vals.begin();
+            it != A->vals.end(); ++it)
+        *it *= 2.0;
+    for (aligned_vector<double>::iterator it = Ac_rap->vals.begin();
+            it != Ac_rap->vals.end(); ++it)
+        *it *= 2.0;
+    A->spgemm_numeric(P, AP);
+    AP->spgemm_T_numeric(P_csc, Ac);
+    compare(Ac, Ac_rap);
     delete Ac_rap;
     delete Ac;
     delete P_csc;
@@ -52,6 +70,24 @@ TEST(TestRAP, TestsInRuge_Stuben)
     Ac = AP->mult_T(P_csc);
     Ac_rap = readMatrix(A2_fn);
     compare(Ac, Ac_rap);
+    delete Ac;
+
+    // Two-pass products match, and numeric pass refills values
+    delete AP;
+    AP = A->spgemm_symbolic(P);
+    A->spgemm_numeric(P, AP);
+    Ac = AP->spgemm_T_symbolic(P_csc);
+    AP->spgemm_T_numeric(P_csc, Ac);
+    compare(Ac, Ac_rap);
+    for (aligned_vector<double>::iterator it = A->vals.begin();
+            it != A->vals.end(); ++it)
+        *it *= 2.0;
+    for (aligned_vector<double>::iterator it = Ac_rap->vals.begin();
+            it != Ac_rap->vals.end(); ++it)
+        *it *= 2.0;
+    A->spgemm_numeric(P, AP);
+    AP->spgemm_T_numeric(P_csc, Ac);
+    compare(Ac, Ac_rap);
     delete Ac_rap;
     delete Ac;
     delete P_csc;
@@ -61,6 +61,13 @@ TEST(TestTAPRAP, TestsInRuge_Stuben)
     delete Ac;
     delete AP;
 
+    // Fused Galerkin product matches
+    Ac = A->RAP(P, true);
+    Ac_rap = readParMatrix(A1_fn);
+    compare(Ac, Ac_rap);
+    delete Ac_rap;
+    delete Ac;
+
     delete P_csc;
     delete P;
     delete A;
@@ -90,6 +97,13 @@ TEST(TestTAPRAP, TestsInRuge_Stuben)
     delete Ac;
     delete AP;
 
+    // Fused Galerkin product matches
+    Ac = A->RAP(P, true);
+    Ac_rap = readParMatrix(A2_fn);
+    compare(Ac, Ac_rap);
+    delete Ac_rap;
+    delete Ac;
+
     delete P_csc;
     delete P;
     delete A;
@@ -29,9 +29,18 @@ Matrix* Matrix::subtract(CSRMatrix* B)
 }
 
 
+// Form C with the same block layout as A (block values are stored
+// contiguously, b_size values per nonzero)
+CSRMatrix* new_add_result(const CSRMatrix* A)
+{
+    if (A->b_rows > 1 || A->b_cols > 1)
+        return new BSRMatrix(A->n_rows, A->n_cols, A->b_rows, A->b_cols, 2*A->nnz);
+    return new CSRMatrix(A->n_rows, A->n_cols, 2*A->nnz);
+}
+
 CSRMatrix* CSRMatrix::add(CSRMatrix* B, bool remove_dup)
 {
-    CSRMatrix* C = new CSRMatrix(n_rows, n_cols, 2*nnz);
+    CSRMatrix* C = new_add_result(this);
     add_append(B, C, remove_dup);
     return C;
 }
@@ -43,7 +52,7 @@ void CSRMatrix::add_append(CSRMatrix* B, CSRMatrix* C, bool remove_dup)
     C->resize(n_rows, n_cols);
     int C_nnz = nnz + B->nnz;
     C->idx2.resize(C_nnz);
-    C->vals.resize(C_nnz);
+    C->vals.resize(C_nnz * b_size);
 
     C_nnz = 0;
     C->idx1[0] = 0;
@@ -54,9 +63,9 @@ void CSRMatrix::add_append(CSRMatrix* B, CSRMatrix* C, bool remove_dup)
         std::copy(idx2.begin() + start,
                 idx2.begin() + end,
                 C->idx2.begin() + C_nnz);
-        std::copy(vals.begin() + start,
-                vals.begin() + end,
-                C->vals.begin() + C_nnz);
+        std::copy(vals.begin() + start * b_size,
+                vals.begin() + end * b_size,
+                C->vals.begin() + C_nnz * b_size);
         C_nnz += (end - start);
 
         start = B->idx1[i];
@@ -64,9 +73,9 @@ void CSRMatrix::add_append(CSRMatrix* B, CSRMatrix* C, bool remove_dup)
         std::copy(B->idx2.begin() + start,
                 B->idx2.begin() + end,
                 C->idx2.begin() + C_nnz);
-        std::copy(B->vals.begin() + start,
-                B->vals.begin() + end,
-                C->vals.begin() + C_nnz);
+        std::copy(B->vals.begin() + start * b_size,
+                B->vals.begin() + end * b_size,
+                C->vals.begin() + C_nnz * b_size);
         C_nnz += (end - start);
 
         C->idx1[i+1] = C_nnz;
@@ -84,7 +93,7 @@ CSRMatrix* CSRMatrix::subtract(CSRMatrix* B)
     assert(n_rows == B->n_rows);
     assert(n_cols == B->n_cols);
 
-    CSRMatrix* C = new CSRMatrix(n_rows, n_cols, 2*nnz);
+    CSRMatrix* C = new_add_result(this);
     C->idx1[0] = 0;
     for (int i = 0; i < n_rows; i++)
     {
@@ -93,14 +102,16 @@ CSRMatrix* CSRMatrix::subtract(CSRMatrix* B)
         for (int j = start; j < end; j++)
         {
             C->idx2.emplace_back(idx2[j]);
-            C->vals.emplace_back(vals[j]);
+            for (int k = 0; k < b_size; k++)
+                C->vals.emplace_back(vals[j*b_size + k]);
         }
         start = B->idx1[i];
         end = B->idx1[i+1];
         for (int j = start; j < end; j++)
         {
             C->idx2.emplace_back(B->idx2[j]);
-            C->vals.emplace_back(-B->vals[j]);
+            for (int k = 0; k < b_size; k++)
+                C->vals.emplace_back(-B->vals[j*b_size + k]);
         }
         C->idx1[i+1] = C->idx2.size();
     }
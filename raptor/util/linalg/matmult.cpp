@@ -1,6 +1,9 @@
 #include "core/matrix.hpp"
 
 using namespace raptor;
+
+// Create C for C = A*B or C = A^T*B, returning the list C's values
+// are appended to (vals for CSR, block_vals for BSR)
 aligned_vector<double>& form_new(const CSRMatrix* A, const CSRMatrix* B, 
         CSRMatrix** C_ptr, aligned_vector<double>& A_vals)
 {
@@ -8,8 +11,8 @@ aligned_vector<double>& form_new(const CSRMatrix* A, const CSRMatrix* B,
     *C_ptr = C;
     return C->vals;
 }
-aligned_vector<double*>& form_new(const CSRMatrix* A, const CSRMatrix* B, 
-        CSRMatrix** C_ptr, aligned_vector<double*>& A_vals)
+BlockArray& form_new(const CSRMatrix* A, const CSRMatrix* B, 
+        CSRMatrix** C_ptr, BlockArray& A_vals)
 {
     BSRMatrix* C = new BSRMatrix(A->n_rows, B->n_cols, 
             A->b_rows, B->b_cols);
@@ -23,8 +26,8 @@ aligned_vector<double>& form_new(const CSCMatrix* A, const CSRMatrix* B,
     *C_ptr = C;
     return C->vals;
 }
-aligned_vector<double*>& form_new(const CSCMatrix* A, const CSRMatrix* B,
-        CSRMatrix** C_ptr, aligned_vector<double*>& A_vals)
+BlockArray& form_new(const CSCMatrix* A, const CSRMatrix* B,
+        CSRMatrix** C_ptr, BlockArray& A_vals)
 {
     BSRMatrix* C = new BSRMatrix(A->n_cols, B->n_cols,
             A->b_cols, B->b_cols);
@@ -32,55 +35,30 @@ aligned_vector<double*>& form_new(const CSCMatrix* A, const CSRMatrix* B,
     return C->block_vals;
 }
 
-void init_sums(aligned_vector<double>& sums, int size, int b_size)
-{
-    sums.resize(size, 0);
-}
-void init_sums(aligned_vector<double*>& sums, int size, int b_size)
-{
-    for (int i = 0; i < size; i++)
-    {
-        sums.emplace_back(new double[b_size]);
-        for (int j = 0; j < b_size; j++)
-            sums[i][j] = 0.0;
-    }
-}
-
-void zero_sum(double* sum, int b_size)
+// Append the (single or block) sum to C's values
+void append_sum(aligned_vector<double>& C_vals, const double* sum)
 {
-    *sum = 0;
+    C_vals.emplace_back(*sum);
 }
-void zero_sum(double** sum, int b_size)
+void append_sum(BlockArray& C_vals, const double* sum)
 {
-    (*sum) = new double[b_size];
-    for (int i = 0; i < b_size; i++)
-        (*sum)[i] = 0;
-}
-
-void finalize_sums(aligned_vector<double>& sums)
-{
-    return;
-}
-void finalize_sums(aligned_vector<double*>& sums)
-{
-    for (aligned_vector<double*>::iterator it = sums.begin();
-            it != sums.end(); ++it)
-        delete[] *it;
+    C_vals.emplace_back(sum);
 }
 
+// Sums are stored contiguously, with s_size = C->b_size values
+// per column of C, so no per-block allocations are needed
 template <typename T>
 CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B, 
-        aligned_vector<T>& A_vals, aligned_vector<T>& B_vals,
-        int* B_to_C = NULL)
+        T& A_vals, T& B_vals, int* B_to_C = NULL)
 {
-    aligned_vector<int> next(B->n_cols, -1);
-    aligned_vector<T> sums;
-    init_sums(sums, B->n_cols, B->b_size);
-
     CSRMatrix* C = NULL;
-    aligned_vector<T>& C_vals = form_new(A, B, &C, A_vals);
+    T& C_vals = form_new(A, B, &C, A_vals);
     C->reserve_size(1.5*A->nnz);
 
+    int s_size = C->b_size;
+    aligned_vector<int> next(B->n_cols, -1);
+    aligned_vector<double> sums(B->n_cols * s_size, 0.0);
+
     C->idx1[0] = 0;
     for (int i = 0; i < A->n_rows; i++)
     {
@@ -91,13 +69,13 @@ CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B,
         for (int j = row_start_A; j < row_end_A; j++)
         {
             int col_A = A->idx2[j];
-            T val_A = A_vals[j];
+            auto val_A = A_vals[j];
             int row_start_B = B->idx1[col_A];
             int row_end_B = B->idx1[col_A+1];
             for (int k = row_start_B; k < row_end_B; k++)
             {
                 int col_B = B->idx2[k];
-                A->mult_vals(val_A, B_vals[k], &sums[col_B],
+                A->mult_vals(val_A, B_vals[k], &sums[col_B*s_size],
                         A->b_rows, B->b_cols, A->b_cols);
                 if (next[col_B] == -1)
                 {
@@ -109,7 +87,8 @@ CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B,
         }
         for (int j = 0; j < length; j++)
         {
-            double val = A->abs_val(sums[head]);
+            double* sum = &sums[head*s_size];
+            double val = C->abs_val(sum);
             if (val > zero_tol)
             {
                 if (B_to_C) 
@@ -120,34 +99,31 @@ CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B,
                 {
                     C->idx2.emplace_back(head);
                 }
-                C_vals.emplace_back(sums[head]);
+                append_sum(C_vals, sum);
             }
             int tmp = head;
             head = next[head];
             next[tmp] = -1;
-            zero_sum(&sums[tmp], A->b_size);
+            std::fill(sum, sum + s_size, 0.0);
         }
         C->idx1[i+1] = C->idx2.size();
     }
     C->nnz = C->idx2.size();
 
-    finalize_sums(sums);
-
     return C;
 }
 
 template <typename T>
 CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
-        aligned_vector<T>& A_vals, aligned_vector<T>& B_vals,
-        int* C_map = NULL)
+        T& A_vals, T& B_vals, index_t* C_map = NULL)
 {
     CSRMatrix* C;
-    aligned_vector<T>& C_vals = form_new(A, B, &C, A_vals);
+    T& C_vals = form_new(A, B, &C, A_vals);
     C->reserve_size(1.5*B->nnz);
 
+    int s_size = C->b_size;
     aligned_vector<int> next(B->n_cols, -1); 
-    aligned_vector<T> sums;
-    init_sums(sums, B->n_cols, A->b_size);
+    aligned_vector<double> sums(B->n_cols * s_size, 0.0);
 
     C->idx1[0] = 0;
     for (int i = 0; i < A->n_cols; i++)
@@ -159,13 +135,13 @@ CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
         for (int j = row_start_AT; j < row_end_AT; j++)
         {
             int col_AT = A->idx2[j];
-            T val_AT = A_vals[j];
+            auto val_AT = A_vals[j];
             int row_start = B->idx1[col_AT];
             int row_end = B->idx1[col_AT+1];
             for (int k = row_start; k < row_end; k++)
             {
                 int col = B->idx2[k];
-                A->mult_T_vals(val_AT, B_vals[k], &sums[col],
+                A->mult_T_vals(val_AT, B_vals[k], &sums[col*s_size],
                         A->b_cols, B->b_cols, A->b_rows);
                 if (next[col] == -1)
                 {
@@ -177,7 +153,8 @@ CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
         }
         for (int j = 0; j < length; j++)
         {
-            if (A->abs_val(sums[head]) > zero_tol)
+            double* sum = &sums[head*s_size];
+            if (C->abs_val(sum) > zero_tol)
             {
                 if (C_map)
                 {
@@ -187,19 +164,17 @@ CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
                 {
                     C->idx2.emplace_back(head);
                 }
-                C_vals.emplace_back(sums[head]);
+                append_sum(C_vals, sum);
             }
             int tmp = head;
             head = next[head];
             next[tmp] = -1;
-            zero_sum(&sums[tmp], A->b_size);
+            std::fill(sum, sum + s_size, 0.0);
         }
         C->idx1[i+1] = C->idx2.size();
     }
     C->nnz = C->idx2.size();
 
-    finalize_sums(sums);
-
     return C;
 }
 
@@ -223,18 +198,18 @@ CSRMatrix* Matrix::mult(COOMatrix* B, int* B_to_C)
     return C;
 }
 
-CSRMatrix* Matrix::mult_T(CSCMatrix* A, int* C_map)
+CSRMatrix* Matrix::mult_T(CSCMatrix* A, index_t* C_map)
 {
     return spgemm_T(A, C_map);
 }
-CSRMatrix* Matrix::mult_T(CSRMatrix* A, int* C_map)
+CSRMatrix* Matrix::mult_T(CSRMatrix* A, index_t* C_map)
 {
     CSCMatrix* A_csc = A->to_CSC();
     CSRMatrix* C = spgemm_T(A_csc, C_map);
     delete A_csc;
     return C;
 }
-CSRMatrix* Matrix::mult_T(COOMatrix* A, int* C_map)
+CSRMatrix* Matrix::mult_T(COOMatrix* A, index_t* C_map)
 {
     CSCMatrix* A_csc = A->to_CSC();
     CSRMatrix* C = spgemm_T(A_csc, C_map);
@@ -288,17 +263,17 @@ BSRMatrix* BSCMatrix::spgemm(CSRMatrix* B, int* B_to_C)
 }
 
 
-CSRMatrix* CSRMatrix::spgemm_T(CSCMatrix* A, int* C_map)
+CSRMatrix* CSRMatrix::spgemm_T(CSCMatrix* A, index_t* C_map)
 {
     return spgemm_T_helper(A, this, A->vals, vals, C_map);
 }
-BSRMatrix* BSRMatrix::spgemm_T(CSCMatrix* A, int* C_map)
+BSRMatrix* BSRMatrix::spgemm_T(CSCMatrix* A, index_t* C_map)
 {
     BSCMatrix* A_bsc = (BSCMatrix*) A;
     return (BSRMatrix*) spgemm_T_helper(A_bsc, this, 
             A_bsc->block_vals, block_vals, C_map);
 }
-CSRMatrix* COOMatrix::spgemm_T(CSCMatrix* A, int* C_map)
+CSRMatrix* COOMatrix::spgemm_T(CSCMatrix* A, index_t* C_map)
 {
     CSRMatrix* B_csr = to_CSR();
     CSRMatrix* C = spgemm_T_helper(A, B_csr, A->vals, 
@@ -306,7 +281,7 @@ CSRMatrix* COOMatrix::spgemm_T(CSCMatrix* A, int* C_map)
     delete B_csr;
     return C;
 }
-BSRMatrix* BCOOMatrix::spgemm_T(CSCMatrix* A, int* C_map)
+BSRMatrix* BCOOMatrix::spgemm_T(CSCMatrix* A, index_t* C_map)
 {
     BSCMatrix* A_bsc = (BSCMatrix*) A;
     BSRMatrix* B_bsr = (BSRMatrix*) to_BSR();
@@ -315,7 +290,7 @@ BSRMatrix* BCOOMatrix::spgemm_T(CSCMatrix* A, int* C_map)
     delete B_bsr;
     return C;
 }
-CSRMatrix* CSCMatrix::spgemm_T(CSCMatrix* A, int* C_map)
+CSRMatrix* CSCMatrix::spgemm_T(CSCMatrix* A, index_t* C_map)
 {
     CSRMatrix* B_csr = to_CSR();
     CSRMatrix* C = spgemm_T_helper(A, B_csr, A->vals, 
@@ -323,7 +298,7 @@ CSRMatrix* CSCMatrix::spgemm_T(CSCMatrix* A, int* C_map)
     delete B_csr;
     return C;
 }
-BSRMatrix* BSCMatrix::spgemm_T(CSCMatrix* A, int* C_map)
+BSRMatrix* BSCMatrix::spgemm_T(CSCMatrix* A, index_t* C_map)
 {
     BSCMatrix* A_bsc = (BSCMatrix*) A;
     BSRMatrix* B_bsr = (BSRMatrix*) to_BSR();
@@ -332,3 +307,209 @@ BSRMatrix* BSCMatrix::spgemm_T(CSCMatrix* A, int* C_map)
     delete B_bsr;
     return C;
 }
+
+// Two-pass SpGEMM, with rows of C formed from rows of B selected by
+// (ptr, idx), the rows of A (or columns of A^T).  The symbolic pass 
+// counts the structural nonzeros in each row of C, so that C is 
+// allocated once, and then fills column indices.  No entries are
+// dropped, so the structure holds for any values of A and B.
+CSRMatrix* spgemm_symbolic_helper(const int n_rows, const aligned_vector<int>& ptr,
+        const aligned_vector<int>& idx, const CSRMatrix* B)
+{
+    CSRMatrix* C = new CSRMatrix(n_rows, B->n_cols);
+    aligned_vector<int> marker(B->n_cols, -1);
+
+    // Count nonzeros in each row of C
+    C->idx1[0] = 0;
+    for (int i = 0; i < n_rows; i++)
+    {
+        int row_nnz = 0;
+        for (int j = ptr[i]; j < ptr[i+1]; j++)
+        {
+            int row_B = idx[j];
+            for (int k = B->idx1[row_B]; k < B->idx1[row_B+1]; k++)
+            {
+                int col_B = B->idx2[k];
+                if (marker[col_B] != i)
+                {
+                    marker[col_B] = i;
+                    row_nnz++;
+                }
+            }
+        }
+        C->idx1[i+1] = C->idx1[i] + row_nnz;
+    }
+    C->nnz = C->idx1[n_rows];
+    C->idx2.resize(C->nnz);
+    C->vals.resize(C->nnz, 0.0);
+
+    // Fill column indices of C
+    std::fill(marker.begin(), marker.end(), -1);
+    for (int i = 0; i < n_rows; i++)
+    {
+        int ctr = C->idx1[i];
+        for (int j = ptr[i]; j < ptr[i+1]; j++)
+        {
+            int row_B = idx[j];
+            for (int k = B->idx1[row_B]; k < B->idx1[row_B+1]; k++)
+            {
+                int col_B = B->idx2[k];
+                if (marker[col_B] != i)
+                {
+                    marker[col_B] = i;
+                    C->idx2[ctr++] = col_B;
+                }
+            }
+        }
+    }
+
+    return C;
+}
+
+// Numeric pass : refill values of C, which must hold the structure
+// formed by the symbolic pass (columns within a row may since have
+// been reordered, e.g. by sort() or move_diag())
+void spgemm_numeric_helper(const int n_rows, const aligned_vector<int>& ptr,
+        const aligned_vector<int>& idx, const aligned_vector<double>& vals,
+        const CSRMatrix* B, CSRMatrix* C)
+{
+    aligned_vector<int> pos(B->n_cols, -1);
+
+    for (int i = 0; i < n_rows; i++)
+    {
+        int row_start = C->idx1[i];
+        int row_end = C->idx1[i+1];
+        for (int j = row_start; j < row_end; j++)
+        {
+            pos[C->idx2[j]] = j;
+            C->vals[j] = 0.0;
+        }
+        for (int j = ptr[i]; j < ptr[i+1]; j++)
+        {
+            int row_B = idx[j];
+            double val = vals[j];
+            for (int k = B->idx1[row_B]; k < B->idx1[row_B+1]; k++)
+            {
+                C->vals[pos[B->idx2[k]]] += val * B->vals[k];
+            }
+        }
+        for (int j = row_start; j < row_end; j++)
+        {
+            pos[C->idx2[j]] = -1;
+        }
+    }
+}
+
+CSRMatrix* CSRMatrix::spgemm_symbolic(CSRMatrix* B)
+{
+    return spgemm_symbolic_helper(n_rows, idx1, idx2, B);
+}
+void CSRMatrix::spgemm_numeric(CSRMatrix* B, CSRMatrix* C)
+{
+    spgemm_numeric_helper(n_rows, idx1, idx2, vals, B, C);
+}
+CSRMatrix* CSRMatrix::spgemm_T_symbolic(CSCMatrix* A)
+{
+    return spgemm_symbolic_helper(A->n_cols, A->idx1, A->idx2, this);
+}
+void CSRMatrix::spgemm_T_numeric(CSCMatrix* A, CSRMatrix* C)
+{
+    spgemm_numeric_helper(A->n_cols, A->idx1, A->idx2, A->vals, this, C);
+}
+
+// Two-pass triple product C = R^T*A*B.  Row j of C sums, over the
+// nonzeros R_ij in column j of R, R_ij times row i of A*B, which is
+// formed again for each of them rather than stored.
+CSRMatrix* CSRMatrix::rap_symbolic(CSCMatrix* R, CSRMatrix* B)
+{
+    int n_rows = R->n_cols;
+    CSRMatrix* C = new CSRMatrix(n_rows, B->n_cols);
+    aligned_vector<int> marker(B->n_cols, -1);
+
+    // Count nonzeros in each row of C
+    C->idx1[0] = 0;
+    for (int i = 0; i < n_rows; i++)
+    {
+        int row_nnz = 0;
+        for (int j = R->idx1[i]; j < R->idx1[i+1]; j++)
+        {
+            int row_A = R->idx2[j];
+            for (int k = idx1[row_A]; k < idx1[row_A+1]; k++)
+            {
+                int row_B = idx2[k];
+                for (int l = B->idx1[row_B]; l < B->idx1[row_B+1]; l++)
+                {
+                    int col_B = B->idx2[l];
+                    if (marker[col_B] != i)
+                    {
+                        marker[col_B] = i;
+                        row_nnz++;
+                    }
+                }
+            }
+        }
+        C->idx1[i+1] = C->idx1[i] + row_nnz;
+    }
+    C->nnz = C->idx1[n_rows];
+    C->idx2.resize(C->nnz);
+    C->vals.resize(C->nnz, 0.0);
+
+    // Fill column indices of C
+    std::fill(marker.begin(), marker.end(), -1);
+    for (int i = 0; i < n_rows; i++)
+    {
+        int ctr = C->idx1[i];
+        for (int j = R->idx1[i]; j < R->idx1[i+1]; j++)
+        {
+            int row_A = R->idx2[j];
+            for (int k = idx1[row_A]; k < idx1[row_A+1]; k++)
+            {
+                int row_B = idx2[k];
+                for (int l = B->idx1[row_B]; l < B->idx1[row_B+1]; l++)
+                {
+                    int col_B = B->idx2[l];
+                    if (marker[col_B] != i)
+                    {
+                        marker[col_B] = i;
+                        C->idx2[ctr++] = col_B;
+                    }
+                }
+            }
+        }
+    }
+
+    return C;
+}
+void CSRMatrix::rap_numeric(CSCMatrix* R, CSRMatrix* B, CSRMatrix* C)
+{
+    aligned_vector<int> pos(B->n_cols, -1);
+
+    for (int i = 0; i < C->n_rows; i++)
+    {
+        int row_start = C->idx1[i];
+        int row_end = C->idx1[i+1];
+        for (int j = row_start; j < row_end; j++)
+        {
+            pos[C->idx2[j]] = j;
+            C->vals[j] = 0.0;
+        }
+        for (int j = R->idx1[i]; j < R->idx1[i+1]; j++)
+        {
+            int row_A = R->idx2[j];
+            double val_R = R->vals[j];
+            for (int k = idx1[row_A]; k < idx1[row_A+1]; k++)
+            {
+                int row_B = idx2[k];
+                double val = val_R * vals[k];
+                for (int l = B->idx1[row_B]; l < B->idx1[row_B+1]; l++)
+                {
+                    C->vals[pos[B->idx2[l]]] += val * B->vals[l];
+                }
+            }
+        }
+        for (int j = row_start; j < row_end; j++)
+        {
+            pos[C->idx2[j]] = -1;
+        }
+    }
+}
@@ -232,6 +232,633 @@ ParCSRMatrix* ParCSRMatrix::tap_mult_T(ParCSCMatrix* A)
     return C;
 }
 
+/**************************************************************
+ *****   Split Symbolic / Numeric Products
+ **************************************************************
+ ***** Rows of intermediate products are held in a combined
+ ***** local column space, in which on_proc column c is c and
+ ***** off_proc column c is on_proc_num_cols + c.  Values are
+ ***** added into C by column, so C's rows may be reordered (e.g.
+ ***** sort() or move_diag()) between numeric phases.
+ **************************************************************/
+
+// Communication package for rows of B in A*B, or partial products
+// in A^T*B, initialized if necessary
+CommPkg* mult_comm(ParCSRMatrix* A, bool tap)
+{
+    if (tap)
+    {
+        if (A->tap_mat_comm == NULL)
+        {
+            A->tap_mat_comm = new TAPComm(A->partition, A->off_proc_column_map,
+                    A->on_proc_column_map, false);
+        }
+        return A->tap_mat_comm;
+    }
+
+    if (A->comm == NULL)
+    {
+        A->comm = new ParComm(A->partition, A->off_proc_column_map,
+                A->on_proc_column_map);
+    }
+    return A->comm;
+}
+
+// Rows of A in a combined column space, with off_proc column c 
+// mapped to on_proc_num_cols + off_map[c] (or + c if no off_map)
+CSRMatrix* combine_cols(ParCSRMatrix* A, int n_cols, const int* off_map = NULL)
+{
+    int n_on = A->on_proc_num_cols;
+    int col;
+    CSRMatrix* A_on = (CSRMatrix*) A->on_proc;
+    CSRMatrix* A_off = (CSRMatrix*) A->off_proc;
+
+    CSRMatrix* C = new CSRMatrix(A->local_num_rows, n_cols, A->local_nnz);
+    C->idx1[0] = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        for (int j = A_on->idx1[i]; j < A_on->idx1[i+1]; j++)
+        {
+            C->idx2.emplace_back(A_on->idx2[j]);
+            C->vals.emplace_back(A_on->vals[j]);
+        }
+        for (int j = A_off->idx1[i]; j < A_off->idx1[i+1]; j++)
+        {
+            col = A_off->idx2[j];
+            if (off_map) col = off_map[col];
+            C->idx2.emplace_back(n_on + col);
+            C->vals.emplace_back(A_off->vals[j]);
+        }
+        C->idx1[i+1] = C->idx2.size();
+    }
+    C->nnz = C->idx2.size();
+
+    return C;
+}
+
+// Append received rows, with global columns, to rows in the combined
+// column space of C.  Columns of C->on_proc are those of A.
+void append_recv_rows(CSRMatrix* rows, CSRMatrix* recv_mat, ParMatrix* A,
+        const IntMap& global_to_C)
+{
+    int n_on = A->on_proc_num_cols;
+    int first_col = A->partition->first_local_col;
+    int last_col = A->partition->last_local_col;
+    int global_col;
+
+    int* part_to_col = A->map_partition_to_local();
+    rows->idx2.reserve(rows->nnz + recv_mat->nnz);
+    rows->vals.reserve(rows->nnz + recv_mat->nnz);
+    for (int i = 0; i < recv_mat->n_rows; i++)
+    {
+        for (int j = recv_mat->idx1[i]; j < recv_mat->idx1[i+1]; j++)
+        {
+            global_col = recv_mat->idx2[j];
+            if (global_col < first_col || global_col > last_col)
+            {
+                rows->idx2.emplace_back(n_on + global_to_C.find(global_col));
+            }
+            else
+            {
+                rows->idx2.emplace_back(part_to_col[global_col - first_col]);
+            }
+            rows->vals.emplace_back(recv_mat->vals[j]);
+        }
+        rows->idx1.emplace_back(rows->idx2.size());
+    }
+    rows->n_rows += recv_mat->n_rows;
+    rows->nnz = rows->idx2.size();
+    delete[] part_to_col;
+}
+
+// Rows with columns in the combined space of A, mapped to the 
+// combined space of C (off_to_C maps A's off_proc columns to C's)
+CSRMatrix* remap_cols(CSRMatrix* rows, int n_on, int n_cols,
+        const aligned_vector<int>& off_to_C)
+{
+    CSRMatrix* C = new CSRMatrix(rows->n_rows, n_cols);
+    std::copy(rows->idx1.begin(), rows->idx1.end(), C->idx1.begin());
+    C->idx2.resize(rows->nnz);
+    C->vals.resize(rows->nnz);
+    for (int i = 0; i < rows->nnz; i++)
+    {
+        int col = rows->idx2[i];
+        if (col >= n_on) col = n_on + off_to_C[col - n_on];
+        C->idx2[i] = col;
+        C->vals[i] = rows->vals[i];
+    }
+    C->nnz = rows->nnz;
+    return C;
+}
+
+// Structure of the union of rows in A and B
+CSRMatrix* union_pattern(CSRMatrix* A, CSRMatrix* B)
+{
+    CSRMatrix* C = new CSRMatrix(A->n_rows, A->n_cols);
+    aligned_vector<int> marker(A->n_cols, -1);
+
+    C->idx1[0] = 0;
+    for (int i = 0; i < A->n_rows; i++)
+    {
+        for (int j = A->idx1[i]; j < A->idx1[i+1]; j++)
+        {
+            if (marker[A->idx2[j]] != i)
+            {
+                marker[A->idx2[j]] = i;
+                C->idx2.emplace_back(A->idx2[j]);
+            }
+        }
+        for (int j = B->idx1[i]; j < B->idx1[i+1]; j++)
+        {
+            if (marker[B->idx2[j]] != i)
+            {
+                marker[B->idx2[j]] = i;
+                C->idx2.emplace_back(B->idx2[j]);
+            }
+        }
+        C->idx1[i+1] = C->idx2.size();
+    }
+    C->nnz = C->idx2.size();
+    C->vals.resize(C->nnz, 0.0);
+
+    return C;
+}
+
+// Form on_proc and off_proc structure of C from rows in its 
+// combined column space, with all values set to zero
+void split_pattern(ParCSRMatrix* C, CSRMatrix* pattern)
+{
+    int n_on = C->on_proc_num_cols;
+    CSRMatrix* C_on = (CSRMatrix*) C->on_proc;
+    CSRMatrix* C_off = (CSRMatrix*) C->off_proc;
+
+    int on_nnz = 0;
+    for (int i = 0; i < pattern->nnz; i++)
+    {
+        if (pattern->idx2[i] < n_on) on_nnz++;
+    }
+    int off_nnz = pattern->nnz - on_nnz;
+
+    C_on->n_rows = C->local_num_rows;
+    C_on->n_cols = n_on;
+    C_on->idx1.resize(C->local_num_rows + 1);
+    C_on->idx2.resize(on_nnz);
+    C_on->vals.resize(on_nnz);
+    C_off->n_rows = C->local_num_rows;
+    C_off->n_cols = C->off_proc_num_cols;
+    C_off->idx1.resize(C->local_num_rows + 1);
+    C_off->idx2.resize(off_nnz);
+    C_off->vals.resize(off_nnz);
+
+    int on_ctr = 0;
+    int off_ctr = 0;
+    C_on->idx1[0] = 0;
+    C_off->idx1[0] = 0;
+    for (int i = 0; i < C->local_num_rows; i++)
+    {
+        for (int j = pattern->idx1[i]; j < pattern->idx1[i+1]; j++)
+        {
+            int col = pattern->idx2[j];
+            if (col < n_on)
+            {
+                C_on->idx2[on_ctr++] = col;
+            }
+            else
+            {
+                C_off->idx2[off_ctr++] = col - n_on;
+            }
+        }
+        C_on->idx1[i+1] = on_ctr;
+        C_off->idx1[i+1] = off_ctr;
+    }
+    C_on->nnz = on_nnz;
+    C_off->nnz = off_nnz;
+    C->local_nnz = on_nnz + off_nnz;
+    std::fill(C_on->vals.begin(), C_on->vals.end(), 0.0);
+    std::fill(C_off->vals.begin(), C_off->vals.end(), 0.0);
+}
+
+// Add values of rows, in the combined column space of C, to C
+void scatter_vals(ParCSRMatrix* C, CSRMatrix* rows)
+{
+    int n_on = C->on_proc_num_cols;
+    int col;
+    CSRMatrix* C_on = (CSRMatrix*) C->on_proc;
+    CSRMatrix* C_off = (CSRMatrix*) C->off_proc;
+    aligned_vector<int> pos(n_on + C->off_proc_num_cols, -1);
+
+    for (int i = 0; i < C->local_num_rows; i++)
+    {
+        for (int j = C_on->idx1[i]; j < C_on->idx1[i+1]; j++)
+        {
+            pos[C_on->idx2[j]] = j;
+        }
+        for (int j = C_off->idx1[i]; j < C_off->idx1[i+1]; j++)
+        {
+            pos[n_on + C_off->idx2[j]] = j;
+        }
+
+        for (int j = rows->idx1[i]; j < rows->idx1[i+1]; j++)
+        {
+            col = rows->idx2[j];
+            if (col < n_on)
+            {
+                C_on->vals[pos[col]] += rows->vals[j];
+            }
+            else
+            {
+                C_off->vals[pos[col]] += rows->vals[j];
+            }
+        }
+    }
+}
+
+// Set values of C to zero, keeping its structure
+void zero_vals(ParCSRMatrix* C)
+{
+    std::fill(C->on_proc->vals.begin(), C->on_proc->vals.end(), 0.0);
+    std::fill(C->off_proc->vals.begin(), C->off_proc->vals.end(), 0.0);
+}
+
+ParCSRMatrix* ParCSRMatrix::mult_symbolic(ParCSRMatrix* B, ParMultPlan* plan, bool tap)
+{
+    int global_col;
+    CommPkg* mat_comm = mult_comm(this, tap);
+    aligned_vector<char> send_buffer;
+
+    // Initialize C (matrix to be returned)
+    ParCSRMatrix* C = init_matrix(this, B);
+
+    // Communicate rows of B
+    mat_comm->init_par_mat_comm(B, send_buffer);
+    CSRMatrix* recv_mat = mat_comm->complete_mat_comm();
+
+    // Set dimensions of C
+    C->global_num_rows = global_num_rows;
+    C->global_num_cols = B->global_num_cols;
+    C->local_num_rows = local_num_rows;
+    C->on_proc_column_map = B->get_on_proc_column_map();
+    C->local_row_map = get_local_row_map();
+    C->on_proc_num_cols = C->on_proc_column_map.size();
+
+    // Off_proc columns of C : those of B and of received rows
+    for (int i = 0; i < recv_mat->nnz; i++)
+    {
+        global_col = recv_mat->idx2[i];
+        if (global_col < B->partition->first_local_col ||
+                global_col > B->partition->last_local_col)
+        {
+            C->off_proc_column_map.emplace_back(global_col);
+        }
+    }
+    std::copy(B->off_proc_column_map.begin(), B->off_proc_column_map.end(),
+            std::back_inserter(C->off_proc_column_map));
+    sort_unique(C->off_proc_column_map);
+    C->off_proc_num_cols = C->off_proc_column_map.size();
+
+    plan->global_to_C.clear();
+    plan->global_to_C.reserve(C->off_proc_num_cols);
+    for (int i = 0; i < C->off_proc_num_cols; i++)
+    {
+        plan->global_to_C[C->off_proc_column_map[i]] = i;
+    }
+    plan->off_to_C.resize(B->off_proc_num_cols);
+    for (int i = 0; i < B->off_proc_num_cols; i++)
+    {
+        plan->off_to_C[i] = plan->global_to_C.find(B->off_proc_column_map[i]);
+    }
+
+    // A (with off_proc columns indexing received rows) times local 
+    // rows of B stacked on received rows
+    CSRMatrix* A_stack = combine_cols(this, on_proc_num_cols + off_proc_num_cols);
+    CSRMatrix* B_stack = combine_cols(B, C->on_proc_num_cols + C->off_proc_num_cols,
+            plan->off_to_C.data());
+    append_recv_rows(B_stack, recv_mat, B, plan->global_to_C);
+    delete recv_mat;
+
+    delete plan->pattern;
+    plan->pattern = A_stack->spgemm_symbolic(B_stack);
+    A_stack->spgemm_numeric(B_stack, plan->pattern);
+    delete A_stack;
+    delete B_stack;
+
+    split_pattern(C, plan->pattern);
+    scatter_vals(C, plan->pattern);
+
+    return C;
+}
+
+void ParCSRMatrix::mult_numeric(ParCSRMatrix* B, ParCSRMatrix* C, ParMultPlan* plan, bool tap)
+{
+    CommPkg* mat_comm = mult_comm(this, tap);
+    aligned_vector<char> send_buffer;
+
+    // Communicate rows of B, forming local part of stacked A meanwhile
+    mat_comm->init_par_mat_comm(B, send_buffer);
+    CSRMatrix* A_stack = combine_cols(this, on_proc_num_cols + off_proc_num_cols);
+    CSRMatrix* B_stack = combine_cols(B, C->on_proc_num_cols + C->off_proc_num_cols,
+            plan->off_to_C.data());
+    CSRMatrix* recv_mat = mat_comm->complete_mat_comm();
+    append_recv_rows(B_stack, recv_mat, B, plan->global_to_C);
+    delete recv_mat;
+
+    A_stack->spgemm_numeric(B_stack, plan->pattern);
+    delete A_stack;
+    delete B_stack;
+
+    zero_vals(C);
+    scatter_vals(C, plan->pattern);
+}
+
+ParCSRMatrix* ParCSRMatrix::mult_T_symbolic(ParCSRMatrix* A, ParMultPlan* plan, bool tap)
+{
+    int global_col, col;
+    int n_on = on_proc_num_cols;
+    CommPkg* mat_comm = mult_comm(A, tap);
+    aligned_vector<char> send_buffer;
+
+    // Initialize C (matrix to be returned)
+    ParCSRMatrix* C = init_matrix(this, A);
+
+    // Partial products for rows of C held by other processes, with
+    // columns sent as global indices
+    CSRMatrix* M = combine_cols(this, n_on + off_proc_num_cols);
+    CSCMatrix* A_on = A->on_proc->to_CSC();
+    CSCMatrix* A_off = A->off_proc->to_CSC();
+    delete plan->send_pattern;
+    plan->send_pattern = M->spgemm_T_symbolic(A_off);
+    M->spgemm_T_numeric(A_off, plan->send_pattern);
+    aligned_vector<int> send_cols(plan->send_pattern->nnz);
+    for (int i = 0; i < plan->send_pattern->nnz; i++)
+    {
+        col = plan->send_pattern->idx2[i];
+        send_cols[i] = col < n_on ? on_proc_column_map[col] 
+            : off_proc_column_map[col - n_on];
+    }
+    mat_comm->init_mat_comm_T(send_buffer, plan->send_pattern->idx1, send_cols,
+            plan->send_pattern->vals);
+
+    // Local products while partial products are in flight
+    delete plan->pattern;
+    plan->pattern = M->spgemm_T_symbolic(A_on);
+    M->spgemm_T_numeric(A_on, plan->pattern);
+    delete M;
+    delete A_on;
+    delete A_off;
+
+    CSRMatrix* recv_mat = mat_comm->complete_mat_comm_T(A->on_proc_num_cols);
+
+    // Set dimensions of C
+    C->global_num_rows = A->global_num_cols;
+    C->global_num_cols = global_num_cols;
+    C->local_num_rows = A->on_proc_num_cols;
+    C->on_proc_column_map = get_on_proc_column_map();
+    C->local_row_map = A->get_on_proc_column_map();
+    C->on_proc_num_cols = C->on_proc_column_map.size();
+
+    // Off_proc columns of C : those appearing in local products and 
+    // in received rows
+    for (int i = 0; i < plan->pattern->nnz; i++)
+    {
+        col = plan->pattern->idx2[i];
+        if (col >= n_on)
+        {
+            C->off_proc_column_map.emplace_back(off_proc_column_map[col - n_on]);
+        }
+    }
+    for (int i = 0; i < recv_mat->nnz; i++)
+    {
+        global_col = recv_mat->idx2[i];
+        if (global_col < partition->first_local_col ||
+                global_col > partition->last_local_col)
+        {
+            C->off_proc_column_map.emplace_back(global_col);
+        }
+    }
+    sort_unique(C->off_proc_column_map);
+    C->off_proc_num_cols = C->off_proc_column_map.size();
+
+    plan->global_to_C.clear();
+    plan->global_to_C.reserve(C->off_proc_num_cols);
+    for (int i = 0; i < C->off_proc_num_cols; i++)
+    {
+        plan->global_to_C[C->off_proc_column_map[i]] = i;
+    }
+    plan->off_to_C.resize(off_proc_num_cols);
+    for (int i = 0; i < off_proc_num_cols; i++)
+    {
+        plan->off_to_C[i] = plan->global_to_C.find(off_proc_column_map[i]);
+    }
+
+    // Combine local products and received rows
+    int n_cols = C->on_proc_num_cols + C->off_proc_num_cols;
+    CSRMatrix* local_C = remap_cols(plan->pattern, n_on, n_cols, plan->off_to_C);
+    CSRMatrix* recv_C = new CSRMatrix(0, n_cols);
+    append_recv_rows(recv_C, recv_mat, this, plan->global_to_C);
+    delete recv_mat;
+
+    CSRMatrix* pattern = union_pattern(local_C, recv_C);
+    split_pattern(C, pattern);
+    scatter_vals(C, local_C);
+    scatter_vals(C, recv_C);
+    delete pattern;
+    delete local_C;
+    delete recv_C;
+
+    return C;
+}
+
+void ParCSRMatrix::mult_T_numeric(ParCSRMatrix* A, ParCSRMatrix* C, ParMultPlan* plan, bool tap)
+{
+    int col;
+    int n_on = on_proc_num_cols;
+    CommPkg* mat_comm = mult_comm(A, tap);
+    aligned_vector<char> send_buffer;
+
+    // Partial products for rows of C held by other processes
+    CSRMatrix* M = combine_cols(this, n_on + off_proc_num_cols);
+    CSCMatrix* A_on = A->on_proc->to_CSC();
+    CSCMatrix* A_off = A->off_proc->to_CSC();
+    M->spgemm_T_numeric(A_off, plan->send_pattern);
+    aligned_vector<int> send_cols(plan->send_pattern->nnz);
+    for (int i = 0; i < plan->send_pattern->nnz; i++)
+    {
+        col = plan->send_pattern->idx2[i];
+        send_cols[i] = col < n_on ? on_proc_column_map[col] 
+            : off_proc_column_map[col - n_on];
+    }
+    mat_comm->init_mat_comm_T(send_buffer, plan->send_pattern->idx1, send_cols,
+            plan->send_pattern->vals);
+
+    // Local products while partial products are in flight
+    M->spgemm_T_numeric(A_on, plan->pattern);
+    delete M;
+    delete A_on;
+    delete A_off;
+
+    int n_cols = C->on_proc_num_cols + C->off_proc_num_cols;
+    CSRMatrix* local_C = remap_cols(plan->pattern, n_on, n_cols, plan->off_to_C);
+    zero_vals(C);
+    scatter_vals(C, local_C);
+    delete local_C;
+
+    CSRMatrix* recv_mat = mat_comm->complete_mat_comm_T(A->on_proc_num_cols);
+    CSRMatrix* recv_C = new CSRMatrix(0, n_cols);
+    append_recv_rows(recv_C, recv_mat, this, plan->global_to_C);
+    scatter_vals(C, recv_C);
+    delete recv_mat;
+    delete recv_C;
+}
+
+ParCSRMatrix* ParCSRMatrix::RAP(ParCSRMatrix* P, bool tap)
+{
+    int global_col, col;
+    int n_on = P->on_proc_num_cols;
+
+    // Check that communication packages have been initialized
+    // (P keeps its communicator, rather than forming one for a
+    // temporary ParCSC copy on every call)
+    CommPkg* A_comm = mult_comm(this, tap);
+    CommPkg* P_comm = mult_comm(P, tap);
+
+    aligned_vector<char> send_buffer;
+    aligned_vector<char> send_buffer_T;
+
+    // Send rows of P corresponding to off_proc columns of A
+    A_comm->init_par_mat_comm(P, send_buffer);
+
+    // Local work while rows of P are in flight : A in its combined
+    // column space, and transposes of local blocks of P
+    CSRMatrix* A_stack = combine_cols(this, on_proc_num_cols + off_proc_num_cols);
+    CSCMatrix* P_on = P->on_proc->to_CSC();
+    CSCMatrix* P_off = P->off_proc->to_CSC();
+
+    CSRMatrix* recv_mat = A_comm->complete_mat_comm();
+
+    // Off_proc columns of AP : those of P and of received rows
+    aligned_vector<index_t> AP_off_map;
+    for (int i = 0; i < recv_mat->nnz; i++)
+    {
+        global_col = recv_mat->idx2[i];
+        if (global_col < P->partition->first_local_col ||
+                global_col > P->partition->last_local_col)
+        {
+            AP_off_map.emplace_back(global_col);
+        }
+    }
+    std::copy(P->off_proc_column_map.begin(), P->off_proc_column_map.end(),
+            std::back_inserter(AP_off_map));
+    sort_unique(AP_off_map);
+    int AP_off_num_cols = AP_off_map.size();
+
+    IntMap global_to_AP(AP_off_num_cols);
+    for (int i = 0; i < AP_off_num_cols; i++)
+    {
+        global_to_AP[AP_off_map[i]] = i;
+    }
+    aligned_vector<int> P_to_AP(P->off_proc_num_cols);
+    for (int i = 0; i < P->off_proc_num_cols; i++)
+    {
+        P_to_AP[i] = global_to_AP.find(P->off_proc_column_map[i]);
+    }
+
+    // Local rows of P stacked on received rows, so that row c of 
+    // P_stack is the row of P for column c of A_stack
+    CSRMatrix* P_stack = combine_cols(P, n_on + AP_off_num_cols, P_to_AP.data());
+    append_recv_rows(P_stack, recv_mat, P, global_to_AP);
+    delete recv_mat;
+
+    // Send P_off^T*A*P to processes holding those coarse rows, with
+    // columns as global indices
+    CSRMatrix* send_mat = A_stack->rap_symbolic(P_off, P_stack);
+    A_stack->rap_numeric(P_off, P_stack, send_mat);
+    aligned_vector<int> send_cols(send_mat->nnz);
+    for (int i = 0; i < send_mat->nnz; i++)
+    {
+        col = send_mat->idx2[i];
+        send_cols[i] = col < n_on ? P->on_proc_column_map[col]
+            : AP_off_map[col - n_on];
+    }
+    P_comm->init_mat_comm_T(send_buffer_T, send_mat->idx1, send_cols,
+            send_mat->vals);
+    delete send_mat;
+
+    // Local work while partial products are in flight : P_on^T*A*P
+    CSRMatrix* local_mat = A_stack->rap_symbolic(P_on, P_stack);
+    A_stack->rap_numeric(P_on, P_stack, local_mat);
+    delete A_stack;
+    delete P_stack;
+    delete P_on;
+    delete P_off;
+
+    CSRMatrix* recv_mat_T = P_comm->complete_mat_comm_T(P->on_proc_num_cols);
+
+    // Initialize C (matrix to be returned), and set dimensions
+    ParCSRMatrix* C = init_mat(P);
+    C->global_num_rows = P->global_num_cols;
+    C->global_num_cols = P->global_num_cols;
+    C->local_num_rows = P->on_proc_num_cols;
+    C->on_proc_column_map = P->get_on_proc_column_map();
+    C->local_row_map = P->get_on_proc_column_map();
+    C->on_proc_num_cols = C->on_proc_column_map.size();
+
+    // Off_proc columns of C : those appearing in local products and
+    // in received rows
+    for (int i = 0; i < local_mat->nnz; i++)
+    {
+        col = local_mat->idx2[i];
+        if (col >= n_on)
+        {
+            C->off_proc_column_map.emplace_back(AP_off_map[col - n_on]);
+        }
+    }
+    for (int i = 0; i < recv_mat_T->nnz; i++)
+    {
+        global_col = recv_mat_T->idx2[i];
+        if (global_col < P->partition->first_local_col ||
+                global_col > P->partition->last_local_col)
+        {
+            C->off_proc_column_map.emplace_back(global_col);
+        }
+    }
+    sort_unique(C->off_proc_column_map);
+    C->off_proc_num_cols = C->off_proc_column_map.size();
+
+    IntMap global_to_C(C->off_proc_num_cols);
+    for (int i = 0; i < C->off_proc_num_cols; i++)
+    {
+        global_to_C[C->off_proc_column_map[i]] = i;
+    }
+    aligned_vector<int> AP_to_C(AP_off_num_cols, -1);
+    for (int i = 0; i < local_mat->nnz; i++)
+    {
+        col = local_mat->idx2[i];
+        if (col >= n_on && AP_to_C[col - n_on] < 0)
+        {
+            AP_to_C[col - n_on] = global_to_C.find(AP_off_map[col - n_on]);
+        }
+    }
+
+    // Combine local products and received rows, sizing C once
+    int n_cols = C->on_proc_num_cols + C->off_proc_num_cols;
+    CSRMatrix* local_C = remap_cols(local_mat, n_on, n_cols, AP_to_C);
+    CSRMatrix* recv_C = new CSRMatrix(0, n_cols);
+    append_recv_rows(recv_C, recv_mat_T, P, global_to_C);
+    delete local_mat;
+    delete recv_mat_T;
+
+    CSRMatrix* pattern = union_pattern(local_C, recv_C);
+    split_pattern(C, pattern);
+    scatter_vals(C, local_C);
+    scatter_vals(C, recv_C);
+    delete pattern;
+    delete local_C;
+    delete recv_C;
+
+    // Return matrix containing product
+    return C;
+}
+
 ParMatrix* ParMatrix::mult(ParCSRMatrix* B, bool tap)
 {
     int rank;
@@ -299,12 +926,12 @@ void ParCSRMatrix::mult_helper(ParCSRMatrix* B, ParCSRMatrix* C,
     delete[] part_to_col;
 
     // Calculate global_to_C and B_to_C column maps
-    std::map<int, int> global_to_C;
+    IntMap global_to_C(recv_off->idx2.size() + B->off_proc_num_cols);
     aligned_vector<int> B_to_C(B->off_proc_num_cols);
 
     std::copy(recv_off->idx2.begin(), recv_off->idx2.end(),
             std::back_inserter(C->off_proc_column_map));
-    for (aligned_vector<int>::iterator it = B->off_proc_column_map.begin();
+    for (aligned_vector<index_t>::iterator it = B->off_proc_column_map.begin();
             it != B->off_proc_column_map.end(); ++it)
     {
         C->off_proc_column_map.emplace_back(*it);
@@ -313,7 +940,7 @@ void ParCSRMatrix::mult_helper(ParCSRMatrix* B, ParCSRMatrix* C,
 
     int prev_col = -1;
     C->off_proc_num_cols = 0;
-    for (aligned_vector<int>::iterator it = C->off_proc_column_map.begin();
+    for (aligned_vector<index_t>::iterator it = C->off_proc_column_map.begin();
             it != C->off_proc_column_map.end(); ++it)
     {
         if (*it != prev_col)
@@ -328,12 +955,12 @@ void ParCSRMatrix::mult_helper(ParCSRMatrix* B, ParCSRMatrix* C,
     for (int i = 0; i < B->off_proc_num_cols; i++)
     {
         global_col = B->off_proc_column_map[i];
-        B_to_C[i] = global_to_C[global_col];
+        B_to_C[i] = global_to_C.find(global_col);
     }
     for (aligned_vector<int>::iterator it = recv_off->idx2.begin(); 
             it != recv_off->idx2.end(); ++it)
     {
-        *it = global_to_C[*it];
+        *it = global_to_C.find(*it);
     }
 
     for (aligned_vector<int>::iterator it = C_on_off->idx2.begin();
@@ -384,7 +1011,7 @@ CSRMatrix* ParCSRMatrix::mult_T_partial(ParCSCMatrix* A)
     return mult_T_partial((CSCMatrix*) A->off_proc); 
 }
 
-void ParCSRMatrix::mult_T_combine(ParCSCMatrix* P, ParCSRMatrix* C, CSRMatrix* recv_mat,
+void ParCSRMatrix::mult_T_combine(ParMatrix* P, ParCSRMatrix* C, CSRMatrix* recv_mat,
         CSRMatrix* C_on_on, CSRMatrix* C_off_on)
 { 
     int start, end, ctr;
@@ -460,43 +1087,32 @@ void ParCSRMatrix::mult_T_combine(ParCSCMatrix* P, ParCSRMatrix* C, CSRMatrix* r
      * Form off_proc
      ******************************/
     // Calculate global_to_C and map_to_C column maps
-    std::map<int, int> global_to_C;
     aligned_vector<int> map_to_C;
     if (off_proc_num_cols)
     {
         map_to_C.reserve(off_proc_num_cols);
     }
 
-    // Create set of global columns in B_off_proc and recv_mat
-    std::set<int> C_col_set;
-    for (aligned_vector<int>::iterator it = recv_off->idx2.begin(); 
-            it != recv_off->idx2.end(); ++it)
-    {
-        C_col_set.insert(*it);
-    }
-    for (aligned_vector<int>::iterator it = off_proc_column_map.begin(); 
-            it != off_proc_column_map.end(); ++it)
-    {
-        C_col_set.insert(*it);
-    }
+    // Create sorted list of global columns in B_off_proc and recv_mat
+    C->off_proc_column_map.reserve(recv_off->idx2.size() + off_proc_column_map.size());
+    std::copy(recv_off->idx2.begin(), recv_off->idx2.end(),
+            std::back_inserter(C->off_proc_column_map));
+    std::copy(off_proc_column_map.begin(), off_proc_column_map.end(),
+            std::back_inserter(C->off_proc_column_map));
+    sort_unique(C->off_proc_column_map);
+    C->off_proc_num_cols = C->off_proc_column_map.size();
 
-    C->off_proc_num_cols = C_col_set.size();
-    if (C->off_proc_num_cols)
-    {
-        C->off_proc_column_map.reserve(C->off_proc_num_cols);
-    }
-    for (std::set<int>::iterator it = C_col_set.begin(); 
-            it != C_col_set.end(); ++it)
+    IntMap global_to_C(C->off_proc_num_cols);
+    for (int i = 0; i < C->off_proc_num_cols; i++)
     {
-        global_to_C[*it] = C->off_proc_column_map.size();
-        C->off_proc_column_map.emplace_back(*it);
+        global_to_C[C->off_proc_column_map[i]] = i;
     }
 
     // Map local off_proc_cols to C->off_proc_column_map
-    for (aligned_vector<int>::iterator it = off_proc_column_map.begin();
+    for (aligned_vector<index_t>::iterator it = off_proc_column_map.begin();
             it != off_proc_column_map.end(); ++it)
     {
-        col_C = global_to_C[*it];
+        col_C = global_to_C.find(*it);
         map_to_C.emplace_back(col_C);
     }
 
@@ -504,7 +1120,7 @@ void ParCSRMatrix::mult_T_combine(ParCSCMatrix* P, ParCSRMatrix* C, CSRMatrix* r
     for (aligned_vector<int>::iterator it = recv_off->idx2.begin();
             it != recv_off->idx2.end(); ++it)
     {
-        *it = global_to_C[*it];
+        *it = global_to_C.find(*it);
     }
 
     recv_off->n_cols = C->off_proc_num_cols;
@@ -4,6 +4,67 @@
 #include "core/types.hpp"
 #include "util/linalg/par_relax.hpp"
 #include "core/par_matrix.hpp"
+#include "core/threads.hpp"
+
+// Records the flops and nonzeros touched by num_passes passes
+// over the rows of A
+void profile_relax(ParCSRMatrix* A, int num_passes)
+{
+    if (profile)
+    {
+        profile_add_flops(2.0 * num_passes * A->local_nnz);
+        profile_add_nnz(((double) num_passes) * A->local_nnz);
+    }
+}
+
+// Communicates off-process values of x, in single precision
+// if A is a mixed precision level
+void communicate_x(ParCSRMatrix* A, ParVector& x, CommPkg* comm)
+{
+    if (A->float_comm) comm->communicate_float(x);
+    else comm->communicate(x);
+}
+
+// Starts and completes the same exchange, so that work can be
+// overlapped with communication
+void init_x_comm(ParCSRMatrix* A, ParVector& x, CommPkg* comm)
+{
+    if (A->float_comm) comm->init_float_comm(x.local.data(), 1);
+    else comm->init_comm(x);
+}
+
+aligned_vector<double>& complete_x_comm(ParCSRMatrix* A, CommPkg* comm)
+{
+    if (A->float_comm) return comm->complete_float_comm(1);
+    return comm->complete_comm<double>();
+}
+
+// Communication package used to relax A, formed if needed
+CommPkg* relax_comm(ParCSRMatrix* A, bool tap)
+{
+    if (tap)
+    {
+        if (!A->tap_comm) 
+        {
+            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
+                    A->on_proc_column_map);
+        }
+        return A->tap_comm;
+    }
+
+    if (!A->comm) 
+    {
+        A->comm = new ParComm(A->partition, A->off_proc_column_map,
+                A->on_proc_column_map);
+    }
+    return A->comm;
+}
+
+// Single precision values of a CSRFloatMatrix
+const float* float_vals(Matrix* A)
+{
+    return ((CSRFloatMatrix*) A)->float_vals.data();
+}
 
 /**************************************************************
  *****   Hybrid Gauss-Seidel / Jacobi Parallel Relaxation
@@ -17,6 +78,10 @@
  ***** -------------
  ***** A : Matrix*
  *****    Matrix to relax over
+ ***** on_vals : T*
+ *****    Values of A->on_proc (float on mixed precision levels)
+ ***** off_vals : T*
+ *****    Values of A->off_proc (float on mixed precision levels)
  ***** x : data_t*
  *****    Vector to be relaxed, will contain result
  ***** y : data_t*
@@ -26,7 +91,9 @@
  ***** dist_x : data_t*
  *****    Vector of distant x-values recvd from other processes
  **************************************************************/
-void SOR_forward(ParCSRMatrix* A, ParVector& x, const ParVector& y, 
+template <typename T>
+void SOR_forward(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, const ParVector& y, 
         const aligned_vector<double>& dist_x, double omega)
 {
     int start_on, end_on;
@@ -43,14 +110,14 @@ void SOR_forward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
         end_on = A->on_proc->idx1[i+1];
         if (A->on_proc->idx2[start_on] == i)
         {
-            diag = A->on_proc->vals[start_on];
+            diag = on_vals[start_on];
             start_on++;
         }        
         else continue;
         for (int j = start_on; j < end_on; j++)
         {
             col = A->on_proc->idx2[j];
-            row_sum += A->on_proc->vals[j] * x[col];
+            row_sum += on_vals[j] * x[col];
         }
         start_on = end_on;
 
@@ -58,7 +125,7 @@ void SOR_forward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
         for (int j = start_off; j < end_off; j++)
         {
             col = A->off_proc->idx2[j];
-            row_sum += A->off_proc->vals[j] * dist_x[col];
+            row_sum += off_vals[j] * dist_x[col];
         }
         start_off = end_off;
 
@@ -67,7 +134,9 @@ void SOR_forward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
     }
 }
 
-void SOR_backward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
+template <typename T>
+void SOR_backward(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, const ParVector& y,
         const aligned_vector<double>& dist_x, double omega)
 {
     int start, end, col;
@@ -81,14 +150,14 @@ void SOR_backward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
         end = A->on_proc->idx1[i+1];
         if (A->on_proc->idx2[start] == i)
         {
-            diag = A->on_proc->vals[start];
+            diag = on_vals[start];
             start++;
         }        
         else continue;
         for (int j = start; j < end; j++)
         {
             col = A->on_proc->idx2[j];
-            row_sum += A->on_proc->vals[j] * x[col];
+            row_sum += on_vals[j] * x[col];
         }
 
         start = A->off_proc->idx1[i];
@@ -96,88 +165,280 @@ void SOR_backward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
         for (int j = start; j < end; j++)
         {
             col = A->off_proc->idx2[j];
-            row_sum += A->off_proc->vals[j] * dist_x[col];
+            row_sum += off_vals[j] * dist_x[col];
         }
 
         x[i] = ((1.0 - omega)*x[i]) + (omega*((y[i] - row_sum) / diag));
     }
 }
 
-void jacobi_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm)
+/**************************************************************
+ *****   Threaded Hybrid Relaxation
+ **************************************************************
+ ***** Rows of A are split across threads (thread_row_bound), and
+ ***** each sweep starts the exchange of off-process values of x,
+ ***** relaxes interior rows (those with no off_proc entries) while
+ ***** messages are in flight, and relaxes the remaining boundary
+ ***** rows once the distant values have arrived.  Communication is
+ ***** completed by the master thread.
+ *****
+ ***** hybrid_gs_helper performs Gauss-Seidel over the rows of each
+ ***** thread, and block Jacobi across threads (columns owned by 
+ ***** another thread use values from the start of the pass).
+ ***** jacobi_helper forms the scaled residual of every row before
+ ***** updating x, scaling by a_ii, or for l1 Jacobi by the l1 
+ ***** norm of the row, a_ii + sum_{j != i} |a_ij|.
+ **************************************************************/
+template <typename F>
+void relax_threads(int n_threads, F func)
 {
-    A->on_proc->sort();
-    A->off_proc->sort();
-    A->on_proc->move_diag();
-  
-    int start, end, col;
-    double diag, row_sum;
+#ifdef USING_OPENMP
+    if (n_threads > 1)
+    {
+#pragma omp parallel num_threads(n_threads)
+        func(omp_get_thread_num(), omp_get_num_threads());
+        return;
+    }
+#endif
+    func(0, 1);
+}
+
+inline void relax_barrier(int n_t)
+{
+#ifdef USING_OPENMP
+    if (n_t > 1)
+    {
+#pragma omp barrier
+    }
+#endif
+}
+
+// Gauss-Seidel update of row i, using x_old for columns of A->on_proc
+// outside of [lo, hi)
+template <typename T>
+inline void gs_row(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        int i, int lo, int hi, double* x, const double* x_old, 
+        const double* b, const double* dist_x, double omega)
+{
+    int start = A->on_proc->idx1[i];
+    int end = A->on_proc->idx1[i+1];
+    if (start == end || A->on_proc->idx2[start] != i) return;
+
+    double diag = on_vals[start];
+    double row_sum = 0;
+    for (int j = start + 1; j < end; j++)
+    {
+        int col = A->on_proc->idx2[j];
+        if (col >= lo && col < hi)
+            row_sum += on_vals[j] * x[col];
+        else
+            row_sum += on_vals[j] * x_old[col];
+    }
+
+    start = A->off_proc->idx1[i];
+    end = A->off_proc->idx1[i+1];
+    for (int j = start; j < end; j++)
+    {
+        row_sum += off_vals[j] * dist_x[A->off_proc->idx2[j]];
+    }
+
+    x[i] = ((1.0 - omega)*x[i]) + (omega*((b[i] - row_sum) / diag));
+}
+
+template <typename T>
+void hybrid_gs_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, CommPkg* comm, bool symmetric)
+{
+    int n = A->local_num_rows;
+    const int* rowptr = A->on_proc->idx1.data();
+    const int* off_rowptr = A->off_proc->idx1.data();
+    int n_threads = kernel_num_threads(A->local_nnz);
+
+    double* x_vals = x.local.data();
+    const double* b_vals = b.local.data();
+    double* x_copy = tmp.local.data();
+    const double* x_old = x_vals;
+    if (n_threads > 1)
+    {
+        x_old = x_copy;
+    }
 
     for (int iter = 0; iter < num_sweeps; iter++)
     {
-        comm->communicate(x);
-        aligned_vector<double>& dist_x = comm->get_buffer<double>();
-        for (int i = 0; i < A->local_num_rows; i++)
+        init_x_comm(A, x, comm);
+
+        relax_threads(n_threads, [&](int tid, int n_t)
         {
-            tmp[i] = x[i];
-        }
+            int lo = thread_row_bound(rowptr, n, n_t, tid);
+            int hi = thread_row_bound(rowptr, n, n_t, tid+1);
 
-        for (int i = 0; i < A->local_num_rows; i++)
-        {    
-            diag = 0;
-            row_sum = 0;
+            // Values of x at start of pass, read by other threads
+            if (x_old != x_vals)
+            {
+                for (int i = lo; i < hi; i++) 
+                    x_copy[i] = x_vals[i];
+            }
+            relax_barrier(n_t);
 
-            start = A->on_proc->idx1[i]+1;
-            end = A->on_proc->idx1[i+1];
-            for (int j = start; j < end; j++)
+            // Forward pass, interior rows then boundary rows
+            for (int i = lo; i < hi; i++)
             {
-                col = A->on_proc->idx2[j];
-                row_sum += A->on_proc->vals[j] * tmp[col];
+                if (off_rowptr[i+1] == off_rowptr[i])
+                    gs_row(A, on_vals, off_vals, i, lo, hi, x_vals, x_old,
+                            b_vals, NULL, omega);
             }
+        });
 
-            start = A->off_proc->idx1[i];
-            end = A->off_proc->idx1[i+1];
-            for (int j = start; j < end; j++)
+        const double* dist_x = complete_x_comm(A, comm).data();
+
+        relax_threads(n_threads, [&](int tid, int n_t)
+        {
+            int lo = thread_row_bound(rowptr, n, n_t, tid);
+            int hi = thread_row_bound(rowptr, n, n_t, tid+1);
+
+            for (int i = lo; i < hi; i++)
             {
-                col = A->off_proc->idx2[j];
-                row_sum += A->off_proc->vals[j] * dist_x[col];
+                if (off_rowptr[i+1] > off_rowptr[i])
+                    gs_row(A, on_vals, off_vals, i, lo, hi, x_vals, x_old,
+                            b_vals, dist_x, omega);
             }
+            if (!symmetric) return;
 
-            if (fabs(diag) > zero_tol)
+            // Backward pass, in reverse order of the forward pass
+            relax_barrier(n_t);
+            if (x_old != x_vals)
             {
-                x[i] = ((1.0 - omega)*tmp[i]) + (omega*((b[i] - row_sum) / diag));
+                for (int i = lo; i < hi; i++) 
+                    x_copy[i] = x_vals[i];
             }
-        }
+            relax_barrier(n_t);
+            for (int i = hi - 1; i >= lo; i--)
+            {
+                if (off_rowptr[i+1] > off_rowptr[i])
+                    gs_row(A, on_vals, off_vals, i, lo, hi, x_vals, x_old,
+                            b_vals, dist_x, omega);
+            }
+            for (int i = hi - 1; i >= lo; i--)
+            {
+                if (off_rowptr[i+1] == off_rowptr[i])
+                    gs_row(A, on_vals, off_vals, i, lo, hi, x_vals, x_old,
+                            b_vals, dist_x, omega);
+            }
+        });
     }
 }
 
-void sor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm)
+// Residual of row i, scaled by a_ii (or l1 norm of row)
+template <typename T>
+inline double jacobi_row(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        int i, const double* x, const double* b, const double* dist_x, bool l1)
 {
-    A->on_proc->sort();
-    A->off_proc->sort();
-    A->on_proc->move_diag();
+    int start = A->on_proc->idx1[i];
+    int end = A->on_proc->idx1[i+1];
+    if (start == end || A->on_proc->idx2[start] != i) return 0.0;
 
-    for (int iter = 0; iter < num_sweeps; iter++)
+    double diag = on_vals[start];
+    double row_sum = diag * x[i];
+    double l1_sum = 0;
+    for (int j = start + 1; j < end; j++)
+    {
+        row_sum += on_vals[j] * x[A->on_proc->idx2[j]];
+        l1_sum += fabs(on_vals[j]);
+    }
+
+    start = A->off_proc->idx1[i];
+    end = A->off_proc->idx1[i+1];
+    for (int j = start; j < end; j++)
     {
-        comm->communicate(x);
-        SOR_forward(A, x, b, comm->get_buffer<double>(), omega);
+        row_sum += off_vals[j] * dist_x[A->off_proc->idx2[j]];
+        l1_sum += fabs(off_vals[j]);
     }
+
+    if (l1) diag += l1_sum;
+    if (fabs(diag) < zero_tol) return 0.0;
+    return (b[i] - row_sum) / diag;
 }
 
+template <typename T>
+void jacobi_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, CommPkg* comm, bool l1)
+{
+    int n = A->local_num_rows;
+    const int* rowptr = A->on_proc->idx1.data();
+    const int* off_rowptr = A->off_proc->idx1.data();
+    int n_threads = kernel_num_threads(A->local_nnz);
+
+    double* x_vals = x.local.data();
+    double* r_vals = tmp.local.data();
+    const double* b_vals = b.local.data();
+
+    for (int iter = 0; iter < num_sweeps; iter++)
+    {
+        init_x_comm(A, x, comm);
+
+        relax_threads(n_threads, [&](int tid, int n_t)
+        {
+            int lo = thread_row_bound(rowptr, n, n_t, tid);
+            int hi = thread_row_bound(rowptr, n, n_t, tid+1);
+
+            // Scaled residual of interior rows, then boundary rows
+            for (int i = lo; i < hi; i++)
+            {
+                if (off_rowptr[i+1] == off_rowptr[i])
+                    r_vals[i] = jacobi_row(A, on_vals, off_vals, i, x_vals,
+                            b_vals, NULL, l1);
+            }
+        });
+
+        const double* dist_x = complete_x_comm(A, comm).data();
+
+        relax_threads(n_threads, [&](int tid, int n_t)
+        {
+            int lo = thread_row_bound(rowptr, n, n_t, tid);
+            int hi = thread_row_bound(rowptr, n, n_t, tid+1);
+
+            for (int i = lo; i < hi; i++)
+            {
+                if (off_rowptr[i+1] > off_rowptr[i])
+                    r_vals[i] = jacobi_row(A, on_vals, off_vals, i, x_vals,
+                            b_vals, dist_x, l1);
+            }
 
-void ssor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+            // Update x once every residual is formed
+            relax_barrier(n_t);
+            for (int i = lo; i < hi; i++)
+            {
+                x_vals[i] += omega * r_vals[i];
+            }
+        });
+    }
+}
+
+template <typename T>
+void sor_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b, ParVector& tmp, 
         int num_sweeps, double omega, CommPkg* comm)
 {
-    A->on_proc->sort();
-    A->off_proc->sort();
-    A->on_proc->move_diag();
+    for (int iter = 0; iter < num_sweeps; iter++)
+    {
+        communicate_x(A, x, comm);
+        SOR_forward(A, on_vals, off_vals, x, b, comm->get_buffer<double>(), omega);
+    }
+}
+
 
+template <typename T>
+void ssor_helper(ParCSRMatrix* A, const T* on_vals, const T* off_vals,
+        ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, CommPkg* comm)
+{
     for (int iter = 0; iter < num_sweeps; iter++)
     {
-        comm->communicate(x);
-        SOR_forward(A, x, b, comm->get_buffer<double>(), omega);
-        SOR_backward(A, x, b, comm->get_buffer<double>(), omega);
+        communicate_x(A, x, comm);
+        SOR_forward(A, on_vals, off_vals, x, b, comm->get_buffer<double>(), omega);
+        SOR_backward(A, on_vals, off_vals, x, b, comm->get_buffer<double>(), omega);
     }
 }
 
@@ -196,82 +457,102 @@ void ssor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
 void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
         int num_sweeps, double omega, bool tap)
 {
-    CommPkg* comm;
-    if (tap)
-    {
-        if (!A->tap_comm) 
-        {
-            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
-        }
-        comm = A->tap_comm;
-    }
-    else
-    {
-        if (!A->comm) 
-        {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
-        }
-        comm = A->comm;
-    }
+    CommPkg* comm = relax_comm(A, tap);
+    profile_relax(A, num_sweeps);
+
+    A->on_proc->sort();
+    A->off_proc->sort();
+    A->on_proc->move_diag();
 
-    jacobi_helper(A, x, b, tmp, num_sweeps, omega, comm);
+    if (A->on_proc->format() == FCSR)
+        jacobi_helper(A, float_vals(A->on_proc), float_vals(A->off_proc),
+                x, b, tmp, num_sweeps, omega, comm, false);
+    else
+        jacobi_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+                x, b, tmp, num_sweeps, omega, comm, false);
 }
 void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
         int num_sweeps, double omega, bool tap)
 {
-    CommPkg* comm;
-    if (tap)
-    {
-        if (!A->tap_comm) 
-        {
-            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
-        }
-        comm = A->tap_comm;
-    }
-    else
-    {
-        if (!A->comm) 
-        {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
-        }
-        comm = A->comm;
-    }
+    CommPkg* comm = relax_comm(A, tap);
+    profile_relax(A, num_sweeps);
+
+    A->on_proc->sort();
+    A->off_proc->sort();
+    A->on_proc->move_diag();
 
-    sor_helper(A, x, b, tmp, num_sweeps, omega, comm);
+    if (A->on_proc->format() == FCSR)
+        sor_helper(A, float_vals(A->on_proc), float_vals(A->off_proc),
+                x, b, tmp, num_sweeps, omega, comm);
+    else
+        sor_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+                x, b, tmp, num_sweeps, omega, comm);
 }
 void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
         int num_sweeps, double omega, bool tap)
 {
-    CommPkg* comm;
-    if (tap)
-    {
-        if (!A->tap_comm) 
-        {
-            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
-        }
-        comm = A->tap_comm;
-    }
-    else
-    {
-        if (!A->comm) 
-        {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
-        }
-        comm = A->comm;
-    }
+    CommPkg* comm = relax_comm(A, tap);
+    profile_relax(A, 2 * num_sweeps);
 
-    ssor_helper(A, x, b, tmp, num_sweeps, omega, comm);
-}
+    A->on_proc->sort();
+    A->off_proc->sort();
+    A->on_proc->move_diag();
 
+    if (A->on_proc->format() == FCSR)
+        ssor_helper(A, float_vals(A->on_proc), float_vals(A->off_proc),
+                x, b, tmp, num_sweeps, omega, comm);
+    else
+        ssor_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+                x, b, tmp, num_sweeps, omega, comm);
+}
+void hybrid_gs(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, bool tap)
+{
+    CommPkg* comm = relax_comm(A, tap);
+    profile_relax(A, num_sweeps);
 
+    A->on_proc->sort();
+    A->off_proc->sort();
+    A->on_proc->move_diag();
 
+    if (A->on_proc->format() == FCSR)
+        hybrid_gs_helper(A, float_vals(A->on_proc), float_vals(A->off_proc),
+                x, b, tmp, num_sweeps, omega, comm, false);
+    else
+        hybrid_gs_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+                x, b, tmp, num_sweeps, omega, comm, false);
+}
+void hybrid_sgs(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, bool tap)
+{
+    CommPkg* comm = relax_comm(A, tap);
+    profile_relax(A, 2 * num_sweeps);
 
+    A->on_proc->sort();
+    A->off_proc->sort();
+    A->on_proc->move_diag();
 
+    if (A->on_proc->format() == FCSR)
+        hybrid_gs_helper(A, float_vals(A->on_proc), float_vals(A->off_proc),
+                x, b, tmp, num_sweeps, omega, comm, true);
+    else
+        hybrid_gs_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+                x, b, tmp, num_sweeps, omega, comm, true);
+}
+void l1_jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, bool tap)
+{
+    CommPkg* comm = relax_comm(A, tap);
+    profile_relax(A, num_sweeps);
 
+    A->on_proc->sort();
+    A->off_proc->sort();
+    A->on_proc->move_diag();
 
+    if (A->on_proc->format() == FCSR)
+        jacobi_helper(A, float_vals(A->on_proc), float_vals(A->off_proc),
+                x, b, tmp, num_sweeps, omega, comm, true);
+    else
+        jacobi_helper(A, A->on_proc->vals.data(), A->off_proc->vals.data(),
+                x, b, tmp, num_sweeps, omega, comm, true);
+}
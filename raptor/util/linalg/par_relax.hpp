@@ -19,6 +19,15 @@ void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
 void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
         int num_sweeps = 1, double omega = 1.0, bool tap = false);
 
+// Threaded smoothers: rows are split across threads, and the halo
+// exchange is overlapped with relaxation of interior rows
+void hybrid_gs(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps = 1, double omega = 1.0, bool tap = false);
+void hybrid_sgs(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps = 1, double omega = 1.0, bool tap = false);
+void l1_jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps = 1, double omega = 1.0, bool tap = false);
+
 
 
 #endif
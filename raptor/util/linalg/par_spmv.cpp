@@ -9,6 +9,16 @@
 
 using namespace raptor;
 
+// Records the flops and nonzeros touched by one product with A
+static void profile_spmv(ParMatrix* A)
+{
+    if (profile)
+    {
+        profile_add_flops(2.0 * A->local_nnz);
+        profile_add_nnz(A->local_nnz);
+    }
+}
+
 /**************************************************************
  *****   Parallel Matrix-Vector Multiplication
  **************************************************************
@@ -24,6 +34,8 @@ using namespace raptor;
  **************************************************************/
 void ParMatrix::mult(ParVector& x, ParVector& b, bool tap)
 {
+    profile_spmv(this);
+
     if (tap)
     {
         this->tap_mult(x, b);
@@ -38,7 +50,8 @@ void ParMatrix::mult(ParVector& x, ParVector& b, bool tap)
 
     // Initialize Isends and Irecvs to communicate
     // values of x
-    comm->init_comm(x, off_proc->b_cols);
+    if (float_comm) comm->init_float_comm(x.local.data(), off_proc->b_cols);
+    else comm->init_comm(x, off_proc->b_cols);
 
     // Multiply the diagonal portion of the matrix,
     // setting b = A_diag*x_local
@@ -48,7 +61,9 @@ void ParMatrix::mult(ParVector& x, ParVector& b, bool tap)
     }
 
     // Wait for Isends and Irecvs to complete
-    aligned_vector<double>& x_tmp = comm->complete_comm<double>(off_proc->b_cols);
+    aligned_vector<double>& x_tmp = float_comm
+        ? comm->complete_float_comm(off_proc->b_cols)
+        : comm->complete_comm<double>(off_proc->b_cols);
 
     // Multiply remaining columns, appending to previous
     // solution in b (b += A_offd * x_distant)
@@ -68,7 +83,8 @@ void ParMatrix::tap_mult(ParVector& x, ParVector& b)
 
     // Initialize Isends and Irecvs to communicate
     // values of x
-    tap_comm->init_comm(x, off_proc->b_cols);
+    if (float_comm) tap_comm->init_float_comm(x.local.data(), off_proc->b_cols);
+    else tap_comm->init_comm(x, off_proc->b_cols);
 
     // Multiply the diagonal portion of the matrix,
     // setting b = A_diag*x_local
@@ -78,7 +94,9 @@ void ParMatrix::tap_mult(ParVector& x, ParVector& b)
     }
 
     // Wait for Isends and Irecvs to complete
-    aligned_vector<double>& x_tmp = tap_comm->complete_comm<double>(off_proc->b_cols);
+    aligned_vector<double>& x_tmp = float_comm
+        ? tap_comm->complete_float_comm(off_proc->b_cols)
+        : tap_comm->complete_comm<double>(off_proc->b_cols);
 
     // Multiply remaining columns, appending to previous
     // solution in b (b += A_offd * x_distant)
@@ -90,6 +108,8 @@ void ParMatrix::tap_mult(ParVector& x, ParVector& b)
 
 void ParMatrix::mult_append(ParVector& x, ParVector& b, bool tap)
 {
+    profile_spmv(this);
+
     if (tap)
     {
         this->tap_mult_append(x, b);
@@ -104,7 +124,8 @@ void ParMatrix::mult_append(ParVector& x, ParVector& b, bool tap)
 
     // Initialize Isends and Irecvs to communicate
     // values of x
-    comm->init_comm(x, off_proc->b_cols);
+    if (float_comm) comm->init_float_comm(x.local.data(), off_proc->b_cols);
+    else comm->init_comm(x, off_proc->b_cols);
 
     // Multiply the diagonal portion of the matrix,
     // setting b = A_diag*x_local
@@ -114,7 +135,9 @@ void ParMatrix::mult_append(ParVector& x, ParVector& b, bool tap)
     }
 
     // Wait for Isends and Irecvs to complete
-    aligned_vector<double>& x_tmp = comm->complete_comm<double>(off_proc->b_cols);
+    aligned_vector<double>& x_tmp = float_comm
+        ? comm->complete_float_comm(off_proc->b_cols)
+        : comm->complete_comm<double>(off_proc->b_cols);
 
     // Multiply remaining columns, appending to previous
     // solution in b (b += A_offd * x_distant)
@@ -134,7 +157,8 @@ void ParMatrix::tap_mult_append(ParVector& x, ParVector& b)
 
     // Initialize Isends and Irecvs to communicate
     // values of x
-    tap_comm->init_comm(x, off_proc->b_cols);
+    if (float_comm) tap_comm->init_float_comm(x.local.data(), off_proc->b_cols);
+    else tap_comm->init_comm(x, off_proc->b_cols);
 
     // Multiply the diagonal portion of the matrix,
     // setting b = A_diag*x_local
@@ -144,7 +168,9 @@ void ParMatrix::tap_mult_append(ParVector& x, ParVector& b)
     }
 
     // Wait for Isends and Irecvs to complete
-    aligned_vector<double>& x_tmp = tap_comm->complete_comm<double>(off_proc->b_cols);
+    aligned_vector<double>& x_tmp = float_comm
+        ? tap_comm->complete_float_comm(off_proc->b_cols)
+        : tap_comm->complete_comm<double>(off_proc->b_cols);
 
     // Multiply remaining columns, appending to previous
     // solution in b (b += A_offd * x_distant)
@@ -156,6 +182,8 @@ void ParMatrix::tap_mult_append(ParVector& x, ParVector& b)
 
 void ParMatrix::mult_T(ParVector& x, ParVector& b, bool tap)
 {
+    profile_spmv(this);
+
     if (tap)
     {
         this->tap_mult_T(x, b);
@@ -176,14 +204,16 @@ void ParMatrix::mult_T(ParVector& x, ParVector& b, bool tap)
 
     off_proc->mult_T(x.local, x_tmp);
 
-    comm->init_comm_T(x_tmp, off_proc->b_cols);
+    if (float_comm) comm->init_float_comm_T(x_tmp.data(), off_proc->b_cols);
+    else comm->init_comm_T(x_tmp, off_proc->b_cols);
 
     if (local_num_rows)
     {
         on_proc->mult_T(x.local, b.local);
     }
 
-    comm->complete_comm_T<double>(b.local.values, off_proc->b_cols);
+    if (float_comm) comm->complete_float_comm_T(b.local.values, off_proc->b_cols);
+    else comm->complete_comm_T<double>(b.local.values, off_proc->b_cols);
 }
 
 void ParMatrix::tap_mult_T(ParVector& x, ParVector& b)
@@ -202,18 +232,22 @@ void ParMatrix::tap_mult_T(ParVector& x, ParVector& b)
 
     off_proc->mult_T(x.local, x_tmp);
 
-    tap_comm->init_comm_T(x_tmp, off_proc->b_cols);
+    if (float_comm) tap_comm->init_float_comm_T(x_tmp.data(), off_proc->b_cols);
+    else tap_comm->init_comm_T(x_tmp, off_proc->b_cols);
 
     if (local_num_rows)
     {
         on_proc->mult_T(x.local, b.local);
     }
 
-    tap_comm->complete_comm_T<double>(b.local.values, off_proc->b_cols);
+    if (float_comm) tap_comm->complete_float_comm_T(b.local.values, off_proc->b_cols);
+    else tap_comm->complete_comm_T<double>(b.local.values, off_proc->b_cols);
 }
 
 void ParMatrix::residual(ParVector& x, ParVector& b, ParVector& r, bool tap)
 {
+    profile_spmv(this);
+
     if (tap) 
     {
         this->tap_residual(x, b, r);
@@ -228,7 +262,8 @@ void ParMatrix::residual(ParVector& x, ParVector& b, ParVector& r, bool tap)
 
     // Initialize Isends and Irecvs to communicate
     // values of x
-    comm->init_comm(x, off_proc->b_cols);
+    if (float_comm) comm->init_float_comm(x.local.data(), off_proc->b_cols);
+    else comm->init_comm(x, off_proc->b_cols);
 
     std::copy(b.local.values.begin(), b.local.values.end(), 
             r.local.values.begin());
@@ -241,7 +276,9 @@ void ParMatrix::residual(ParVector& x, ParVector& b, ParVector& r, bool tap)
     }
 
     // Wait for Isends and Irecvs to complete
-    aligned_vector<double>& x_tmp = comm->complete_comm<double>(off_proc->b_cols);
+    aligned_vector<double>& x_tmp = float_comm
+        ? comm->complete_float_comm(off_proc->b_cols)
+        : comm->complete_comm<double>(off_proc->b_cols);
 
     // Multiply remaining columns, appending to previous
     // solution in b (b += A_offd * x_distant)
@@ -261,7 +298,8 @@ void ParMatrix::tap_residual(ParVector& x, ParVector& b, ParVector& r)
 
     // Initialize Isends and Irecvs to communicate
     // values of x
-    tap_comm->init_comm(x, off_proc->b_cols);
+    if (float_comm) tap_comm->init_float_comm(x.local.data(), off_proc->b_cols);
+    else tap_comm->init_comm(x, off_proc->b_cols);
 
     std::copy(b.local.values.begin(), b.local.values.end(), r.local.values.begin());
 
@@ -273,7 +311,9 @@ void ParMatrix::tap_residual(ParVector& x, ParVector& b, ParVector& r)
     }
 
     // Wait for Isends and Irecvs to complete
-    aligned_vector<double>& x_tmp = tap_comm->complete_comm<double>(off_proc->b_cols);
+    aligned_vector<double>& x_tmp = float_comm
+        ? tap_comm->complete_float_comm(off_proc->b_cols)
+        : tap_comm->complete_comm<double>(off_proc->b_cols);
 
     // Multiply remaining columns, appending to previous
     // solution in b (b += A_offd * x_distant)
@@ -36,9 +36,9 @@ void make_contiguous(ParCSRMatrix* A)
 
     aligned_vector<MPI_Request> recv_requests;
 
-    std::map<int, int> global_to_local;
+    IntMap global_to_local(A->off_proc_num_cols);
     ctr = 0;
-    for (aligned_vector<int>::const_iterator it = A->off_proc_column_map.begin();  
+    for (aligned_vector<index_t>::const_iterator it = A->off_proc_column_map.begin();  
             it != A->off_proc_column_map.end(); ++it)
     {
         global_to_local[*it] = ctr++;
@@ -252,7 +252,7 @@ void make_contiguous(ParCSRMatrix* A)
                 orig_col = send_buffer[j];
                 assumed_col = orig_col - assumed_first_col;
                 new_col = assumed_col_to_new[assumed_col];
-                local_col = global_to_local[orig_col];
+                local_col = global_to_local.find(orig_col);
                 A->off_proc_column_map[local_col] = new_col;
             }
         }
@@ -325,7 +325,7 @@ void make_contiguous(ParCSRMatrix* A)
             {
                 orig_col = send_buffer[j];
                 new_col = recv_buffer[j];
-                local_col = global_to_local[orig_col];
+                local_col = global_to_local.find(orig_col);
                 A->off_proc_column_map[local_col] = new_col;
             }
         }
@@ -408,7 +408,7 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, aligned_vector
     int proc, proc_idx;
     int idx, ctr;
     int num_rows, first_row;
-    int start, end, col;
+    int start, end, col, local_col;
     int row_size;
     int send_row_size;
     int num_sends;
@@ -475,57 +475,45 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, aligned_vector
         send_row_buffer[2*idx+1] = row_size;
     }
    
-    aligned_vector<int> send_sizes(num_procs, 0);
-    for (int i = 0; i < num_sends; i++)
-    {
-        proc = send_procs[i];
-        start = send_ptr[i];
-        end = send_ptr[i+1];
-        send_sizes[proc] = 2*(end - start);
-    }
-    RAPtor_MPI_Allreduce(MPI_IN_PLACE, send_sizes.data(), num_procs, MPI_INT,
-            MPI_SUM, MPI_COMM_WORLD);
-    int size_recvs = send_sizes[rank];
-
-    // Send to proc p the rows and row sizes that will be sent next
-    for (int i = 0; i < num_sends; i++)
-    {
-        proc = send_procs[i];
-        start = send_ptr[i];
-        end = send_ptr[i+1];
-        RAPtor_MPI_Isend(&(send_row_buffer[2*start]), 2*(end - start), RAPtor_MPI_INT, proc,
-                row_key, RAPtor_MPI_COMM_WORLD, &send_requests[i]);
-    }
+    // Send to proc p the rows and row sizes that will be sent next,
+    // discovering the procs that send to this rank with NBX
+    aligned_vector<int> send_row_ptr(num_sends + 1);
+    aligned_vector<int> recv_row_ptr(1, 0);
+    for (int i = 0; i <= num_sends; i++)
+    {
+        send_row_ptr[i] = 2*send_ptr[i];
+    }
+    nbx_exchange(num_sends, send_procs.data(), send_row_ptr.data(), 
+            send_row_buffer.data(), recv_procs, recv_row_ptr, recv_row_buffer,
+            row_key, RAPtor_MPI_COMM_WORLD);
+
+    // Order received rows by sending process, so that the new
+    // row order does not depend on message arrival order
+    aligned_vector<int> recv_order(recv_procs.size());
+    std::iota(recv_order.begin(), recv_order.end(), 0);
+    std::sort(recv_order.begin(), recv_order.end(),
+            [&](int i, int j)
+            {
+                return recv_procs[i] < recv_procs[j];
+            });
 
     int recv_size = 0;
-    ctr = 0;
-    row_size = 0;
     recv_ptr.push_back(0);
-    recv_row_buffer.resize(size_recvs);
-    while (ctr < size_recvs)
+    for (int i = 0; i < recv_procs.size(); i++)
     {
-        RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, row_key, RAPtor_MPI_COMM_WORLD, &recv_status);
-        proc = recv_status.MPI_SOURCE;
-        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INT, &count);
-        RAPtor_MPI_Recv(recv_row_buffer.data(), count, RAPtor_MPI_INT, proc, row_key,
-            RAPtor_MPI_COMM_WORLD, &recv_status);
-        ctr += count;
-        for (int i = 0; i < count; i+= 2)
+        start = recv_row_ptr[recv_order[i]];
+        end = recv_row_ptr[recv_order[i]+1];
+        for (int j = start; j < end; j += 2)
         {
-            row_size = recv_row_buffer[i+1];
-            recv_rows.push_back(recv_row_buffer[i]);
+            row_size = recv_row_buffer[j+1];
+            recv_rows.push_back(recv_row_buffer[j]);
             recv_row_sizes.push_back(row_size);
             recv_size += row_size;
         }
-        recv_procs.push_back(proc);
         recv_ptr.push_back(recv_size);
     }
-   
-    if (num_sends)
-    {
-        RAPtor_MPI_Waitall(num_sends, send_requests.data(), 
-                RAPtor_MPI_STATUSES_IGNORE);
-    }
+    std::sort(recv_procs.begin(), recv_procs.end());
+
     int num_recvs = recv_procs.size();
     num_rows = recv_rows.size();
     recv_requests.resize(num_recvs);
@@ -616,7 +604,7 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, aligned_vector
 
     // Create row_ptr
     // Add values/indices to appropriate positions
-    std::map<int, int> on_proc_to_local;
+    IntMap on_proc_to_local(num_rows);
     for(int i = 0; i < num_rows; i++)
     {
        on_proc_to_local[recv_rows[i]] = i;
@@ -636,9 +624,10 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, aligned_vector
             col = recv_buffer[ctr].index;
             val = recv_buffer[ctr++].val;
 
-            if (on_proc_to_local.find(col) != on_proc_to_local.end())
+            local_col = on_proc_to_local.find(col);
+            if (local_col >= 0)
             {
-                A_part->on_proc->idx2.emplace_back(on_proc_to_local[col]);
+                A_part->on_proc->idx2.emplace_back(local_col);
                 A_part->on_proc->vals.emplace_back(val);
             }
             else
@@ -654,28 +643,22 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, aligned_vector
     A_part->off_proc->nnz = A_part->off_proc->idx2.size();
     A_part->local_nnz = A_part->on_proc->nnz + A_part->off_proc->nnz;
 
-    aligned_vector<int> off_proc_cols;
+    aligned_vector<index_t> off_proc_cols;
     std::copy(A_part->off_proc->idx2.begin(), A_part->off_proc->idx2.end(),
             std::back_inserter(off_proc_cols));
-    std::sort(off_proc_cols.begin(), off_proc_cols.end());
-    int prev_col = -1;
-    std::map<int, int> global_to_local;
-    for (aligned_vector<int>::iterator it = off_proc_cols.begin(); 
-            it != off_proc_cols.end(); ++it)
-    {
-        if (*it != prev_col)
-        {
-            global_to_local[*it] = A_part->off_proc_column_map.size();
-            A_part->off_proc_column_map.emplace_back(*it);
-            prev_col = *it;
-        }
-    }
+    sort_unique(off_proc_cols);
+    A_part->off_proc_column_map.swap(off_proc_cols);
     A_part->off_proc_num_cols = A_part->off_proc_column_map.size();
 
+    IntMap global_to_local(A_part->off_proc_num_cols);
+    for (int i = 0; i < A_part->off_proc_num_cols; i++)
+    {
+        global_to_local[A_part->off_proc_column_map[i]] = i;
+    }
     for (aligned_vector<int>::iterator it = A_part->off_proc->idx2.begin();
             it != A_part->off_proc->idx2.end(); ++it)
     {
-        *it = global_to_local[*it];
+        *it = global_to_local.find(*it);
     }
 
     new_local_rows.resize(A_part->on_proc_num_cols);
@@ -2,12 +2,13 @@
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 
 #include "core/matrix.hpp"
+#include "core/threads.hpp"
 
 using namespace raptor;
 
 // COOMatrix SpMV Methods (or BCOO)
 template <typename T>
-void COO_append(const COOMatrix* A, const aligned_vector<T>& vals,
+void COO_append(const COOMatrix* A, const T& vals,
         const double* x, double* b)
 {
     for (int i = 0; i < A->nnz; i++)
@@ -16,7 +17,7 @@ void COO_append(const COOMatrix* A, const aligned_vector<T>& vals,
     }
 }
 template <typename T>
-void COO_append_T(const COOMatrix* A, const aligned_vector<T>& vals,
+void COO_append_T(const COOMatrix* A, const T& vals,
         const double* x, double* b)
 {
     for (int i = 0; i < A->nnz; i++)
@@ -25,7 +26,7 @@ void COO_append_T(const COOMatrix* A, const aligned_vector<T>& vals,
     }
 }
 template <typename T>
-void COO_append_neg(const COOMatrix* A, const aligned_vector<T>& vals,
+void COO_append_neg(const COOMatrix* A, const T& vals,
         const double* x, double* b)
 {
     for (int i = 0; i < A->nnz; i++)
@@ -34,7 +35,7 @@ void COO_append_neg(const COOMatrix* A, const aligned_vector<T>& vals,
     }
 }
 template <typename T>
-void COO_append_neg_T(const COOMatrix* A, const aligned_vector<T>& vals,
+void COO_append_neg_T(const COOMatrix* A, const T& vals,
         const double* x, double* b)
 {
     for (int i = 0; i < A->nnz; i++)
@@ -48,155 +49,732 @@ void COO_append_neg_T(const COOMatrix* A, const aligned_vector<T>& vals,
 
 
 // CSRMatrix SpMV Methods (or BSR)
-// Optimized CSR and BSR standard SpMVs
-void CSR_spmv(const CSRMatrix* A, const double* x, double* b)
+// Rows of local CSR matrices are split across threads (when built
+// WITH_OPENMP), balancing nonzeros per thread.  Row-wise kernels
+// write disjoint rows of b, while transpose kernels accumulate into
+// thread-local copies of b that are summed afterwards.
+// thread_ranges splits [0, n) by pointer array ptr (idx1 for CSR,
+// slice_ptr for SELL), calling func(first, last) on each thread.
+template <typename F>
+void thread_ranges(const int* ptr, int n, int nnz, F func)
 {
-    int start, end;
-    double val;
-    for (int i = 0; i < A->n_rows; i++)
+#ifdef USING_OPENMP
+    int n_threads = kernel_num_threads(nnz);
+    if (n_threads > 1)
     {
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        val = 0;
-        for (int j = start; j < end; j++)
+#pragma omp parallel num_threads(n_threads)
         {
-            val += A->vals[j] * x[A->idx2[j]];
+            int tid = omp_get_thread_num();
+            int n_t = omp_get_num_threads();
+            func(thread_row_bound(ptr, n, n_t, tid),
+                    thread_row_bound(ptr, n, n_t, tid+1));
         }
-        b[i] = val;
+        return;
     }
+#endif
+    func(0, n);
 }
 
-void CSR_residual(const CSRMatrix* A, const double* x, 
-        const double* b, double* r)
+// The thread-local copies of b are kept in a scratch buffer owned by
+// the calling thread, which is only reallocated when it must grow
+template <typename F>
+void thread_ranges_T(const int* ptr, int n, int nnz, int size, double* b, F func)
 {
-    int start, end;
-    double val;
-    for (int i = 0; i < A->n_rows; i++)
+#ifdef USING_OPENMP
+    int n_threads = kernel_num_threads(nnz);
+    if (n_threads > 1)
     {
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        val = b[i];
-        for (int j = start; j < end; j++)
+        static thread_local aligned_vector<double> scratch;
+        if ((long) scratch.size() < (long) n_threads * size)
         {
-            val -= A->vals[j] * x[A->idx2[j]];
+            scratch.resize((long) n_threads * size);
         }
-        r[i] = val;
+        double* b_tmp = scratch.data();
+#pragma omp parallel num_threads(n_threads)
+        {
+            int tid = omp_get_thread_num();
+            int n_t = omp_get_num_threads();
+            double* b_local = b_tmp + (long) tid * size;
+            for (int i = 0; i < size; i++)
+            {
+                b_local[i] = 0.0;
+            }
+            func(thread_row_bound(ptr, n, n_t, tid),
+                    thread_row_bound(ptr, n, n_t, tid+1),
+                    b_local);
+#pragma omp barrier
+#pragma omp for schedule(static)
+            for (int i = 0; i < size; i++)
+            {
+                double val = 0.0;
+                for (int t = 0; t < n_t; t++)
+                {
+                    val += b_tmp[(long) t * size + i];
+                }
+                b[i] += val;
+            }
+        }
+        return;
     }
+#endif
+    func(0, n, b);
 }
 
+template <typename F>
+void CSR_thread_rows(const CSRMatrix* A, F func)
+{
+    thread_ranges(A->idx1.data(), A->n_rows, A->nnz, func);
+}
 
-void CSR_append(const CSRMatrix* A, const double* x, double* b)
+template <typename F>
+void CSR_thread_rows_T(const CSRMatrix* A, double* b, F func)
 {
-    int start, end;
-    double val;
-    for (int i = 0; i < A->n_rows; i++)
+    thread_ranges_T(A->idx1.data(), A->n_rows, A->nnz,
+            A->n_cols * A->b_cols, b, func);
+}
+
+// Optimized CSR and BSR standard SpMVs
+template <typename T>
+void CSR_spmv(const CSRMatrix* A, const T& vals, const double* x, double* b)
+{
+    CSR_thread_rows(A, [&](int first, int last)
     {
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        val = 0;
-        for (int j = start; j < end; j++)
+        int start, end;
+        double val;
+        for (int i = first; i < last; i++)
         {
-            val += A->vals[j] * x[A->idx2[j]];
+            start = A->idx1[i];
+            end = A->idx1[i+1];
+            val = 0;
+            for (int j = start; j < end; j++)
+            {
+                val += vals[j] * x[A->idx2[j]];
+            }
+            b[i] = val;
         }
-        b[i] += val;
-    }
+    });
 }
 
 template <typename T>
-void BSR_append(const CSRMatrix* A, const aligned_vector<T>& vals,
+void CSR_residual(const CSRMatrix* A, const T& vals, const double* x, 
+        const double* b, double* r)
+{
+    CSR_thread_rows(A, [&](int first, int last)
+    {
+        int start, end;
+        double val;
+        for (int i = first; i < last; i++)
+        {
+            start = A->idx1[i];
+            end = A->idx1[i+1];
+            val = b[i];
+            for (int j = start; j < end; j++)
+            {
+                val -= vals[j] * x[A->idx2[j]];
+            }
+            r[i] = val;
+        }
+    });
+}
+
+
+template <typename T>
+void CSR_append(const CSRMatrix* A, const T& vals, const double* x, double* b)
+{
+    CSR_thread_rows(A, [&](int first, int last)
+    {
+        int start, end;
+        double val;
+        for (int i = first; i < last; i++)
+        {
+            start = A->idx1[i];
+            end = A->idx1[i+1];
+            val = 0;
+            for (int j = start; j < end; j++)
+            {
+                val += vals[j] * x[A->idx2[j]];
+            }
+            b[i] += val;
+        }
+    });
+}
+
+template <typename T>
+void BSR_append(const CSRMatrix* A, const T& vals,
         const double* x, double* b)
 {
-    int start, end;
-    for (int i = 0; i < A->n_rows; i++)
+    CSR_thread_rows(A, [&](int first, int last)
     {
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        for (int j = start; j < end; j++)
+        int start, end;
+        for (int i = first; i < last; i++)
         {
-            A->append(i, A->idx2[j], b, x, vals[j]);
+            start = A->idx1[i];
+            end = A->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                A->append(i, A->idx2[j], b, x, vals[j]);
+            }
         }
-    }
+    });
 }
 
 void BSR_spmv(const BSRMatrix* A, const double* x, double* b)
 {
-    int start, end, idx;
-    int first_row, first_col;
-    double val;
-    double* block_val;
-    for (int i = 0; i < A->n_rows; i++)
+    CSR_thread_rows(A, [&](int first, int last)
     {
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        first_row = i*A->b_rows;
-        for (int row = 0; row < A->b_rows; row++)
+        int start, end, idx;
+        int first_row, first_col;
+        double val;
+        const double* block_val;
+        for (int i = first; i < last; i++)
         {
-            val = 0;
-            idx = row * A->b_cols;
+            start = A->idx1[i];
+            end = A->idx1[i+1];
+            first_row = i*A->b_rows;
+            for (int row = 0; row < A->b_rows; row++)
+            {
+                val = 0;
+                idx = row * A->b_cols;
+                for (int j = start; j < end; j++)
+                {
+                    first_col = A->idx2[j]*A->b_cols;
+                    block_val = A->block_vals[j];
+                    for (int col = 0; col < A->b_cols; col++)
+                    {
+                        val += (block_val[idx + col] * x[first_col + col]);
+                    }
+                }
+                b[first_row + row] = val;
+            }
+        }
+    });
+}
+template <typename T>
+void CSR_append_T(const CSRMatrix* A, const T& vals,
+        const double* x, double* b)
+{
+    CSR_thread_rows_T(A, b, [&](int first, int last, double* b_local)
+    {
+        int start, end;
+        for (int i = first; i < last; i++)
+        {
+            start = A->idx1[i];
+            end = A->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                A->append_T(i, A->idx2[j], b_local, x, vals[j]);
+            }
+        }
+    });
+}
+template <typename T>
+void CSR_append_neg(const CSRMatrix* A, const T& vals,
+        const double* x, double* b)
+{
+    CSR_thread_rows(A, [&](int first, int last)
+    {
+        int start, end;
+        for (int i = first; i < last; i++)
+        {
+            start = A->idx1[i];
+            end = A->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                A->append_neg(i, A->idx2[j], b, x, vals[j]);
+            }
+        }
+    });
+}
+template <typename T>
+void CSR_append_neg_T(const CSRMatrix* A, const T& vals,
+        const double* x, double* b)
+{
+    CSR_thread_rows_T(A, b, [&](int first, int last, double* b_local)
+    {
+        int start, end;
+        for (int i = first; i < last; i++)
+        {
+            start = A->idx1[i];
+            end = A->idx1[i+1];
             for (int j = start; j < end; j++)
             {
-                first_col = A->idx2[j]*A->b_cols;
-                block_val = A->block_vals[j];
-                for (int col = 0; col < A->b_cols; col++)
+                A->append_neg_T(i, A->idx2[j], b_local, x, vals[j]);
+            }
+        }
+    });
+}
+
+
+
+// Fixed block size BSR kernels
+// Square blocks of size 2, 3, 4 and 6 (the common block sizes of
+// vector-valued PDEs) use kernels with the block size as a template
+// parameter, so the block loops are fully unrolled and vectorized.
+// Each kernel is compiled for AVX-512, AVX2 and the default target,
+// and the widest variant the CPU supports is selected at run time.
+// All other block sizes use the generic BSR methods above.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RAPTOR_KERNEL_TARGETS
+#define RAPTOR_KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define RAPTOR_KERNEL_INLINE inline
+#endif
+
+// b[rows] = b_in[rows] +/- A[rows]*x  (b_in == NULL for b_in = 0)
+typedef void (*BSR_rows_func)(const CSRMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b);
+// b += / -= A[rows]^T * x
+typedef void (*BSR_rows_T_func)(const CSRMatrix* A, int first, int last,
+        const double* x, double* b);
+
+template <int B, bool neg>
+RAPTOR_KERNEL_INLINE void BSR_fixed_rows(const CSRMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b)
+{
+    const int* rowptr = A->idx1.data();
+    const int* cols = A->idx2.data();
+    const double* vals = A->vals.data();
+    for (int i = first; i < last; i++)
+    {
+        double sum[B];
+        for (int row = 0; row < B; row++)
+        {
+            sum[row] = b_in ? b_in[i*B + row] : 0.0;
+        }
+        for (int j = rowptr[i]; j < rowptr[i+1]; j++)
+        {
+            const double* block_val = vals + j*B*B;
+            const double* x_val = x + cols[j]*B;
+            for (int row = 0; row < B; row++)
+            {
+                double val = 0.0;
+                for (int col = 0; col < B; col++)
                 {
-                    val += (block_val[idx + col] * x[first_col + col]);
+                    val += block_val[row*B + col] * x_val[col];
                 }
+                if (neg) sum[row] -= val;
+                else sum[row] += val;
             }
-            b[first_row + row] = val;
+        }
+        for (int row = 0; row < B; row++)
+        {
+            b[i*B + row] = sum[row];
         }
     }
 }
-template <typename T>
-void CSR_append_T(const CSRMatrix* A, const aligned_vector<T>& vals,
+
+template <int B, bool neg>
+RAPTOR_KERNEL_INLINE void BSR_fixed_rows_T(const CSRMatrix* A, int first, int last,
         const double* x, double* b)
 {
-    int start, end;
-    for (int i = 0; i < A->n_rows; i++)
+    const int* rowptr = A->idx1.data();
+    const int* cols = A->idx2.data();
+    const double* vals = A->vals.data();
+    for (int i = first; i < last; i++)
     {
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        for (int j = start; j < end; j++)
+        const double* x_val = x + i*B;
+        for (int j = rowptr[i]; j < rowptr[i+1]; j++)
         {
-            A->append_T(i, A->idx2[j], b, x, vals[j]);
+            const double* block_val = vals + j*B*B;
+            double* b_val = b + cols[j]*B;
+            for (int col = 0; col < B; col++)
+            {
+                double val = 0.0;
+                for (int row = 0; row < B; row++)
+                {
+                    val += block_val[row*B + col] * x_val[row];
+                }
+                if (neg) b_val[col] -= val;
+                else b_val[col] += val;
+            }
         }
     }
 }
-template <typename T>
-void CSR_append_neg(const CSRMatrix* A, const aligned_vector<T>& vals,
+
+template <int B, bool neg>
+void BSR_rows_default(const CSRMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b)
+{
+    BSR_fixed_rows<B, neg>(A, first, last, x, b_in, b);
+}
+template <int B, bool neg>
+void BSR_rows_T_default(const CSRMatrix* A, int first, int last,
         const double* x, double* b)
 {
-    int start, end;
-    for (int i = 0; i < A->n_rows; i++)
+    BSR_fixed_rows_T<B, neg>(A, first, last, x, b);
+}
+
+#ifdef RAPTOR_KERNEL_TARGETS
+template <int B, bool neg>
+__attribute__((target("avx2,fma")))
+void BSR_rows_avx2(const CSRMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b)
+{
+    BSR_fixed_rows<B, neg>(A, first, last, x, b_in, b);
+}
+template <int B, bool neg>
+__attribute__((target("avx2,fma")))
+void BSR_rows_T_avx2(const CSRMatrix* A, int first, int last,
+        const double* x, double* b)
+{
+    BSR_fixed_rows_T<B, neg>(A, first, last, x, b);
+}
+template <int B, bool neg>
+__attribute__((target("avx512f,avx512vl,avx2,fma")))
+void BSR_rows_avx512(const CSRMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b)
+{
+    BSR_fixed_rows<B, neg>(A, first, last, x, b_in, b);
+}
+template <int B, bool neg>
+__attribute__((target("avx512f,avx512vl,avx2,fma")))
+void BSR_rows_T_avx512(const CSRMatrix* A, int first, int last,
+        const double* x, double* b)
+{
+    BSR_fixed_rows_T<B, neg>(A, first, last, x, b);
+}
+#endif
+
+// Widest instruction set supported by this CPU (checked once)
+enum kernel_isa {isa_default, isa_avx2, isa_avx512};
+kernel_isa get_kernel_isa()
+{
+#ifdef RAPTOR_KERNEL_TARGETS
+    static kernel_isa isa = []()
     {
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        for (int j = start; j < end; j++)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl"))
+            return isa_avx512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return isa_avx2;
+        return isa_default;
+    }();
+    return isa;
+#else
+    return isa_default;
+#endif
+}
+
+template <int B, bool neg>
+BSR_rows_func BSR_select_rows()
+{
+#ifdef RAPTOR_KERNEL_TARGETS
+    switch (get_kernel_isa())
+    {
+        case isa_avx512: return BSR_rows_avx512<B, neg>;
+        case isa_avx2: return BSR_rows_avx2<B, neg>;
+        default: break;
+    }
+#endif
+    return BSR_rows_default<B, neg>;
+}
+template <int B, bool neg>
+BSR_rows_T_func BSR_select_rows_T()
+{
+#ifdef RAPTOR_KERNEL_TARGETS
+    switch (get_kernel_isa())
+    {
+        case isa_avx512: return BSR_rows_T_avx512<B, neg>;
+        case isa_avx2: return BSR_rows_T_avx2<B, neg>;
+        default: break;
+    }
+#endif
+    return BSR_rows_T_default<B, neg>;
+}
+
+// Returns fixed block size kernel for A, or NULL if there is none
+template <bool neg>
+BSR_rows_func BSR_fixed_func(const CSRMatrix* A)
+{
+    if (A->b_rows != A->b_cols) return NULL;
+    switch (A->b_rows)
+    {
+        case 2: return BSR_select_rows<2, neg>();
+        case 3: return BSR_select_rows<3, neg>();
+        case 4: return BSR_select_rows<4, neg>();
+        case 6: return BSR_select_rows<6, neg>();
+    }
+    return NULL;
+}
+template <bool neg>
+BSR_rows_T_func BSR_fixed_func_T(const CSRMatrix* A)
+{
+    if (A->b_rows != A->b_cols) return NULL;
+    switch (A->b_rows)
+    {
+        case 2: return BSR_select_rows_T<2, neg>();
+        case 3: return BSR_select_rows_T<3, neg>();
+        case 4: return BSR_select_rows_T<4, neg>();
+        case 6: return BSR_select_rows_T<6, neg>();
+    }
+    return NULL;
+}
+
+// Multiply rows of A with fixed block size kernel func,
+// threaded in the same way as the CSR kernels
+void BSR_fixed_mult(const CSRMatrix* A, BSR_rows_func func,
+        const double* x, const double* b_in, double* b)
+{
+    CSR_thread_rows(A, [&](int first, int last)
+    {
+        func(A, first, last, x, b_in, b);
+    });
+}
+void BSR_fixed_mult_T(const CSRMatrix* A, BSR_rows_T_func func,
+        const double* x, double* b)
+{
+    CSR_thread_rows_T(A, b, [&](int first, int last, double* b_local)
+    {
+        func(A, first, last, x, b_local);
+    });
+}
+
+
+// SELLMatrix SpMV Methods
+// Each slice of C rows is multiplied column-wise, so the C rows of
+// a slice are processed together in SIMD lanes.  Slice sizes 4, 8
+// and 16 use kernels with C as a template parameter, compiled for
+// each instruction set in the same way as the fixed size BSR
+// kernels.  Other slice sizes use SELL_slices_generic.
+typedef void (*SELL_slices_func)(const SELLMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b);
+typedef void (*SELL_slices_T_func)(const SELLMatrix* A, int first, int last,
+        const double* x, double* b);
+
+// b[rows] = b_in[rows] +/- A[rows]*x  (b_in == NULL for b_in = 0)
+template <int C, bool neg>
+RAPTOR_KERNEL_INLINE void SELL_fixed_slices(const SELLMatrix* A, int first,
+        int last, const double* x, const double* b_in, double* b)
+{
+    const int* ptr = A->slice_ptr.data();
+    const int* cols = A->slice_idx.data();
+    const double* vals = A->slice_vals.data();
+    const int* perm = A->row_perm.data();
+    int n_rows = A->n_rows;
+    for (int s = first; s < last; s++)
+    {
+        double sum[C];
+        for (int r = 0; r < C; r++)
         {
-            A->append_neg(i, A->idx2[j], b, x, vals[j]);
+            sum[r] = 0.0;
+        }
+        for (int j = ptr[s]; j < ptr[s+1]; j += C)
+        {
+            for (int r = 0; r < C; r++)
+            {
+                sum[r] += vals[j + r] * x[cols[j + r]];
+            }
+        }
+        int n = n_rows - s*C;
+        if (n > C) n = C;
+        for (int r = 0; r < n; r++)
+        {
+            int row = perm[s*C + r];
+            double val = b_in ? b_in[row] : 0.0;
+            if (neg) b[row] = val - sum[r];
+            else b[row] = val + sum[r];
         }
     }
 }
-template <typename T>
-void CSR_append_neg_T(const CSRMatrix* A, const aligned_vector<T>& vals,
+
+// b += / -= A[rows]^T * x
+template <int C, bool neg>
+RAPTOR_KERNEL_INLINE void SELL_fixed_slices_T(const SELLMatrix* A, int first,
+        int last, const double* x, double* b)
+{
+    const int* ptr = A->slice_ptr.data();
+    const int* cols = A->slice_idx.data();
+    const double* vals = A->slice_vals.data();
+    const int* perm = A->row_perm.data();
+    int n_rows = A->n_rows;
+    for (int s = first; s < last; s++)
+    {
+        double x_val[C];
+        int n = n_rows - s*C;
+        if (n > C) n = C;
+        for (int r = 0; r < C; r++)
+        {
+            x_val[r] = r < n ? x[perm[s*C + r]] : 0.0;
+            if (neg) x_val[r] = -x_val[r];
+        }
+        for (int j = ptr[s]; j < ptr[s+1]; j += C)
+        {
+            for (int r = 0; r < C; r++)
+            {
+                b[cols[j + r]] += vals[j + r] * x_val[r];
+            }
+        }
+    }
+}
+
+template <bool neg>
+void SELL_slices_generic(const SELLMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b)
+{
+    int C = A->slice_size;
+    aligned_vector<double> sum(C);
+    for (int s = first; s < last; s++)
+    {
+        for (int r = 0; r < C; r++)
+        {
+            sum[r] = 0.0;
+        }
+        for (int j = A->slice_ptr[s]; j < A->slice_ptr[s+1]; j += C)
+        {
+            for (int r = 0; r < C; r++)
+            {
+                sum[r] += A->slice_vals[j + r] * x[A->slice_idx[j + r]];
+            }
+        }
+        int n = A->n_rows - s*C;
+        if (n > C) n = C;
+        for (int r = 0; r < n; r++)
+        {
+            int row = A->row_perm[s*C + r];
+            double val = b_in ? b_in[row] : 0.0;
+            if (neg) b[row] = val - sum[r];
+            else b[row] = val + sum[r];
+        }
+    }
+}
+template <bool neg>
+void SELL_slices_T_generic(const SELLMatrix* A, int first, int last,
         const double* x, double* b)
 {
-    int start, end;
-    for (int i = 0; i < A->n_rows; i++)
+    int C = A->slice_size;
+    for (int s = first; s < last; s++)
     {
-        start = A->idx1[i];
-        end = A->idx1[i+1];
-        for (int j = start; j < end; j++)
+        int n = A->n_rows - s*C;
+        if (n > C) n = C;
+        for (int j = A->slice_ptr[s]; j < A->slice_ptr[s+1]; j += C)
         {
-            A->append_neg_T(i, A->idx2[j], b, x, vals[j]);
+            for (int r = 0; r < n; r++)
+            {
+                double val = A->slice_vals[j + r] * x[A->row_perm[s*C + r]];
+                if (neg) b[A->slice_idx[j + r]] -= val;
+                else b[A->slice_idx[j + r]] += val;
+            }
         }
     }
 }
 
+template <int C, bool neg>
+void SELL_slices_default(const SELLMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b)
+{
+    SELL_fixed_slices<C, neg>(A, first, last, x, b_in, b);
+}
+template <int C, bool neg>
+void SELL_slices_T_default(const SELLMatrix* A, int first, int last,
+        const double* x, double* b)
+{
+    SELL_fixed_slices_T<C, neg>(A, first, last, x, b);
+}
+
+#ifdef RAPTOR_KERNEL_TARGETS
+template <int C, bool neg>
+__attribute__((target("avx2,fma")))
+void SELL_slices_avx2(const SELLMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b)
+{
+    SELL_fixed_slices<C, neg>(A, first, last, x, b_in, b);
+}
+template <int C, bool neg>
+__attribute__((target("avx2,fma")))
+void SELL_slices_T_avx2(const SELLMatrix* A, int first, int last,
+        const double* x, double* b)
+{
+    SELL_fixed_slices_T<C, neg>(A, first, last, x, b);
+}
+template <int C, bool neg>
+__attribute__((target("avx512f,avx512vl,avx2,fma")))
+void SELL_slices_avx512(const SELLMatrix* A, int first, int last,
+        const double* x, const double* b_in, double* b)
+{
+    SELL_fixed_slices<C, neg>(A, first, last, x, b_in, b);
+}
+template <int C, bool neg>
+__attribute__((target("avx512f,avx512vl,avx2,fma")))
+void SELL_slices_T_avx512(const SELLMatrix* A, int first, int last,
+        const double* x, double* b)
+{
+    SELL_fixed_slices_T<C, neg>(A, first, last, x, b);
+}
+#endif
+
+template <int C, bool neg>
+SELL_slices_func SELL_select_slices()
+{
+#ifdef RAPTOR_KERNEL_TARGETS
+    switch (get_kernel_isa())
+    {
+        case isa_avx512: return SELL_slices_avx512<C, neg>;
+        case isa_avx2: return SELL_slices_avx2<C, neg>;
+        default: break;
+    }
+#endif
+    return SELL_slices_default<C, neg>;
+}
+template <int C, bool neg>
+SELL_slices_T_func SELL_select_slices_T()
+{
+#ifdef RAPTOR_KERNEL_TARGETS
+    switch (get_kernel_isa())
+    {
+        case isa_avx512: return SELL_slices_T_avx512<C, neg>;
+        case isa_avx2: return SELL_slices_T_avx2<C, neg>;
+        default: break;
+    }
+#endif
+    return SELL_slices_T_default<C, neg>;
+}
+
+template <bool neg>
+SELL_slices_func SELL_func(const SELLMatrix* A)
+{
+    switch (A->slice_size)
+    {
+        case 4: return SELL_select_slices<4, neg>();
+        case 8: return SELL_select_slices<8, neg>();
+        case 16: return SELL_select_slices<16, neg>();
+    }
+    return SELL_slices_generic<neg>;
+}
+template <bool neg>
+SELL_slices_T_func SELL_func_T(const SELLMatrix* A)
+{
+    switch (A->slice_size)
+    {
+        case 4: return SELL_select_slices_T<4, neg>();
+        case 8: return SELL_select_slices_T<8, neg>();
+        case 16: return SELL_select_slices_T<16, neg>();
+    }
+    return SELL_slices_T_generic<neg>;
+}
+
+void SELL_mult(const SELLMatrix* A, SELL_slices_func func,
+        const double* x, const double* b_in, double* b)
+{
+    thread_ranges(A->slice_ptr.data(), A->n_slices, A->nnz,
+            [&](int first, int last)
+            {
+                func(A, first, last, x, b_in, b);
+            });
+}
+void SELL_mult_T(const SELLMatrix* A, SELL_slices_T_func func,
+        const double* x, double* b)
+{
+    thread_ranges_T(A->slice_ptr.data(), A->n_slices, A->nnz, A->n_cols, b,
+            [&](int first, int last, double* b_local)
+            {
+                func(A, first, last, x, b_local);
+            });
+}
 
 
 // CSCMatrix SpMV Methods (or BSC)
 template <typename T>
-void CSC_append(const CSCMatrix* A, const aligned_vector<T>& vals,
+void CSC_append(const CSCMatrix* A, const T& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -211,7 +789,7 @@ void CSC_append(const CSCMatrix* A, const aligned_vector<T>& vals,
     }
 }
 template <typename T>
-void CSC_append_T(const CSCMatrix* A, const aligned_vector<T>& vals,
+void CSC_append_T(const CSCMatrix* A, const T& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -226,7 +804,7 @@ void CSC_append_T(const CSCMatrix* A, const aligned_vector<T>& vals,
     }
 }
 template <typename T>
-void CSC_append_neg(const CSCMatrix* A, const aligned_vector<T>& vals,
+void CSC_append_neg(const CSCMatrix* A, const T& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -241,7 +819,7 @@ void CSC_append_neg(const CSCMatrix* A, const aligned_vector<T>& vals,
     }
 }
 template <typename T>
-void CSC_append_neg_T(const CSCMatrix* A, const aligned_vector<T>& vals,
+void CSC_append_neg_T(const CSCMatrix* A, const T& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -318,11 +896,11 @@ void BCOOMatrix::spmv_residual(const double* x, const double* b, double* r) cons
 
 void CSRMatrix::spmv(const double* x, double* b) const
 {
-    CSR_spmv(this, x, b);
+    CSR_spmv(this, vals, x, b);
 }
 void CSRMatrix::spmv_append(const double* x, double* b) const
 {
-    CSR_append(this, x, b);
+    CSR_append(this, vals, x, b);
 }
 void CSRMatrix::spmv_append_T(const double* x, double* b) const
 {
@@ -338,30 +916,46 @@ void CSRMatrix::spmv_append_neg_T(const double* x, double* b) const
 }
 void CSRMatrix::spmv_residual(const double* x, const double* b, double* r) const
 {
-    CSR_residual(this, x, b, r);
+    CSR_residual(this, vals, x, b, r);
 }
 void BSRMatrix::spmv(const double* x, double* b) const
 {
-    BSR_spmv(this, x, b);
+    BSR_rows_func func = BSR_fixed_func<false>(this);
+    if (func) BSR_fixed_mult(this, func, x, NULL, b);
+    else BSR_spmv(this, x, b);
 }
 void BSRMatrix::spmv_append(const double* x,double* b) const
 {
-    BSR_append(this, block_vals, x, b);
+    BSR_rows_func func = BSR_fixed_func<false>(this);
+    if (func) BSR_fixed_mult(this, func, x, b, b);
+    else BSR_append(this, block_vals, x, b);
 }
 void BSRMatrix::spmv_append_T(const double* x,double* b) const
 {
-    CSR_append_T(this, block_vals, x, b);
+    BSR_rows_T_func func = BSR_fixed_func_T<false>(this);
+    if (func) BSR_fixed_mult_T(this, func, x, b);
+    else CSR_append_T(this, block_vals, x, b);
 }
 void BSRMatrix::spmv_append_neg(const double* x,double* b) const
 {
-    CSR_append_neg(this, block_vals, x, b);
+    BSR_rows_func func = BSR_fixed_func<true>(this);
+    if (func) BSR_fixed_mult(this, func, x, b, b);
+    else CSR_append_neg(this, block_vals, x, b);
 }
 void BSRMatrix::spmv_append_neg_T(const double* x,double* b) const
 {
-    CSR_append_neg_T(this, block_vals, x, b);
+    BSR_rows_T_func func = BSR_fixed_func_T<true>(this);
+    if (func) BSR_fixed_mult_T(this, func, x, b);
+    else CSR_append_neg_T(this, block_vals, x, b);
 }
 void BSRMatrix::spmv_residual(const double* x, const double* b, double* r) const
 {
+    BSR_rows_func func = BSR_fixed_func<true>(this);
+    if (func)
+    {
+        BSR_fixed_mult(this, func, x, b, r);
+        return;
+    }
     for (int i = 0; i < n_rows * b_rows; i++)
         r[i] = b[i];
     CSR_append_neg(this, block_vals, x, r);
@@ -369,6 +963,61 @@ void BSRMatrix::spmv_residual(const double* x, const double* b, double* r) const
 
 
 
+void SELLMatrix::spmv(const double* x, double* b) const
+{
+    SELL_mult(this, SELL_func<false>(this), x, NULL, b);
+}
+void SELLMatrix::spmv_append(const double* x, double* b) const
+{
+    SELL_mult(this, SELL_func<false>(this), x, b, b);
+}
+void SELLMatrix::spmv_append_T(const double* x, double* b) const
+{
+    SELL_mult_T(this, SELL_func_T<false>(this), x, b);
+}
+void SELLMatrix::spmv_append_neg(const double* x, double* b) const
+{
+    SELL_mult(this, SELL_func<true>(this), x, b, b);
+}
+void SELLMatrix::spmv_append_neg_T(const double* x, double* b) const
+{
+    SELL_mult_T(this, SELL_func_T<true>(this), x, b);
+}
+void SELLMatrix::spmv_residual(const double* x, const double* b, double* r) const
+{
+    SELL_mult(this, SELL_func<true>(this), x, b, r);
+}
+
+
+
+// Single precision values, accumulated in double
+void CSRFloatMatrix::spmv(const double* x, double* b) const
+{
+    CSR_spmv(this, float_vals, x, b);
+}
+void CSRFloatMatrix::spmv_append(const double* x, double* b) const
+{
+    CSR_append(this, float_vals, x, b);
+}
+void CSRFloatMatrix::spmv_append_T(const double* x, double* b) const
+{
+    CSR_append_T(this, float_vals, x, b);
+}
+void CSRFloatMatrix::spmv_append_neg(const double* x, double* b) const
+{
+    CSR_append_neg(this, float_vals, x, b);
+}
+void CSRFloatMatrix::spmv_append_neg_T(const double* x, double* b) const
+{
+    CSR_append_neg_T(this, float_vals, x, b);
+}
+void CSRFloatMatrix::spmv_residual(const double* x, const double* b, double* r) const
+{
+    CSR_residual(this, float_vals, x, b, r);
+}
+
+
+
 void CSCMatrix::spmv(const double* x, double* b) const
 {
     for (int i = 0; i < n_rows; i++)
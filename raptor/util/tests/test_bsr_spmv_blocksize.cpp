@@ -0,0 +1,126 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+
+} // end of main() //
+
+// Form block matrix with b_rows x b_cols blocks, and a scalar CSR copy
+void form_block_matrix(int n, int b_rows, int b_cols,
+        BSRMatrix** B_ptr, CSRMatrix** A_ptr)
+{
+    int b_size = b_rows * b_cols;
+    aligned_vector<double> block(b_size);
+
+    BCOOMatrix* B_coo = new BCOOMatrix(n, n, b_rows, b_cols);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            if (i != j && (i * 31 + j * 17) % 5) continue;
+            for (int k = 0; k < b_size; k++)
+                block[k] = ((i * 7 + j * 3 + k * 5) % 11) - 5.0;
+            B_coo->add_value(i, j, block.data());
+        }
+    }
+    BSRMatrix* B = (BSRMatrix*) B_coo->to_CSR();
+    delete B_coo;
+
+    *B_ptr = B;
+    *A_ptr = B->to_CSR();
+}
+
+void compare_block_spmv(int n, int b_rows, int b_cols)
+{
+    BSRMatrix* B;
+    CSRMatrix* A;
+    form_block_matrix(n, b_rows, b_cols, &B, &A);
+    ASSERT_EQ(B->b_rows, b_rows);
+    ASSERT_EQ(A->n_rows, n * b_rows);
+
+    int n_rows = n * b_rows;
+    int n_cols = n * b_cols;
+    Vector x(n_cols);
+    Vector x_T(n_rows);
+    Vector b(n_rows);
+    Vector b_T(n_cols);
+    Vector b_A(n_rows);
+    Vector b_A_T(n_cols);
+    for (int i = 0; i < n_cols; i++)
+        x[i] = ((i * 13) % 7) - 3.0;
+    for (int i = 0; i < n_rows; i++)
+        x_T[i] = ((i * 5) % 9) - 4.0;
+
+    // b <- A*x
+    A->mult(x, b_A);
+    B->mult(x, b);
+    for (int i = 0; i < n_rows; i++)
+        ASSERT_NEAR(b[i], b_A[i], 1e-10);
+
+    // b <- b + A*x
+    A->mult_append(x, b_A);
+    B->mult_append(x, b);
+    for (int i = 0; i < n_rows; i++)
+        ASSERT_NEAR(b[i], b_A[i], 1e-10);
+
+    // b <- b - A*x
+    A->mult_append_neg(x, b_A);
+    A->mult_append_neg(x, b_A);
+    B->mult_append_neg(x, b);
+    B->mult_append_neg(x, b);
+    for (int i = 0; i < n_rows; i++)
+        ASSERT_NEAR(b[i], b_A[i], 1e-10);
+
+    // r <- b - A*x
+    x_T.copy(b);
+    A->residual(x, x_T, b_A);
+    B->residual(x, x_T, b);
+    for (int i = 0; i < n_rows; i++)
+        ASSERT_NEAR(b[i], b_A[i], 1e-10);
+
+    // b <- A^T*x
+    A->mult_T(x_T, b_A_T);
+    B->mult_T(x_T, b_T);
+    for (int i = 0; i < n_cols; i++)
+        ASSERT_NEAR(b_T[i], b_A_T[i], 1e-10);
+
+    // b <- b + A^T*x, b <- b - 2*A^T*x
+    A->mult_append_T(x_T, b_A_T);
+    B->mult_append_T(x_T, b_T);
+    A->mult_append_neg_T(x_T, b_A_T);
+    A->mult_append_neg_T(x_T, b_A_T);
+    B->mult_append_neg_T(x_T, b_T);
+    B->mult_append_neg_T(x_T, b_T);
+    for (int i = 0; i < n_cols; i++)
+        ASSERT_NEAR(b_T[i], b_A_T[i], 1e-10);
+
+    delete A;
+    delete B;
+}
+
+TEST(BlockSizeBSRSpMVTest, TestsInUtil)
+{
+    // Fixed size kernels
+    compare_block_spmv(50, 2, 2);
+    compare_block_spmv(50, 3, 3);
+    compare_block_spmv(50, 4, 4);
+    compare_block_spmv(50, 6, 6);
+
+    // Large enough to be split across threads
+    compare_block_spmv(2000, 3, 3);
+
+    // Generic block kernels
+    compare_block_spmv(50, 5, 5);
+    compare_block_spmv(50, 2, 3);
+
+} // end of TEST(BlockSizeBSRSpMVTest, TestsInUtil) //
+
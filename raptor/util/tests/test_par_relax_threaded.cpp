@@ -0,0 +1,110 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+typedef void (*relax_func)(ParCSRMatrix*, ParVector&, ParVector&, ParVector&,
+        int, double, bool);
+
+// Relaxes A*x = b from x = 0, returning the final residual norm
+double relax_norm(ParCSRMatrix* A, ParVector& x, ParVector& b, relax_func relax,
+        int num_sweeps, double omega)
+{
+    ParVector tmp(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(0.0);
+    relax(A, x, b, tmp, num_sweeps, omega, false);
+    A->residual(x, b, r);
+    return r.norm(2);
+}
+
+TEST(ParThreadedRelaxTest, TestsInUtil)
+{
+    int num_procs;
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int grid[3] = {15, 15, 15};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector x_serial(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        b[i] = 1.0 / (A->partition->first_local_row + i + 1);
+    }
+    double b_norm = b.norm(2);
+
+    // Single threaded hybrid Gauss-Seidel on one process is SOR
+    set_num_threads(1);
+    if (num_procs == 1)
+    {
+        relax_norm(A, x_serial, b, sor, 2, 1.0);
+        relax_norm(A, x, b, hybrid_gs, 2, 1.0);
+        for (int i = 0; i < A->local_num_rows; i++)
+            ASSERT_NEAR(x[i], x_serial[i], 1e-12);
+
+        relax_norm(A, x_serial, b, ssor, 2, 1.0);
+        relax_norm(A, x, b, hybrid_sgs, 2, 1.0);
+        for (int i = 0; i < A->local_num_rows; i++)
+            ASSERT_NEAR(x[i], x_serial[i], 1e-12);
+    }
+
+    // Jacobi updates are independent of the number of threads
+    relax_norm(A, x_serial, b, jacobi, 3, 2.0/3);
+    set_num_threads(4);
+    relax_norm(A, x, b, jacobi, 3, 2.0/3);
+    for (int i = 0; i < A->local_num_rows; i++)
+        ASSERT_NEAR(x[i], x_serial[i], 1e-12);
+
+    set_num_threads(1);
+    relax_norm(A, x_serial, b, l1_jacobi, 3, 1.0);
+    set_num_threads(4);
+    relax_norm(A, x, b, l1_jacobi, 3, 1.0);
+    for (int i = 0; i < A->local_num_rows; i++)
+        ASSERT_NEAR(x[i], x_serial[i], 1e-12);
+
+    // Every smoother reduces the residual, with one or many threads
+    relax_func funcs[3] = {hybrid_gs, hybrid_sgs, l1_jacobi};
+    for (int n_threads = 1; n_threads <= 4; n_threads *= 4)
+    {
+        set_num_threads(n_threads);
+        for (int f = 0; f < 3; f++)
+        {
+            double norm_1 = relax_norm(A, x, b, funcs[f], 1, 1.0);
+            double norm_5 = relax_norm(A, x, b, funcs[f], 5, 1.0);
+            ASSERT_LT(norm_1, b_norm);
+            ASSERT_LT(norm_5, norm_1);
+        }
+    }
+
+    // AMG converges with the threaded smoothers
+    relax_t relax_types[3] = {HybridGS, HybridSGS, L1Jacobi};
+    for (int r = 0; r < 3; r++)
+    {
+        ParMultilevel* ml = new ParRugeStubenSolver(0.25, HMIS, Extended,
+                Classical, relax_types[r]);
+        ml->setup(A);
+        int iter = ml->solve(x, b);
+        aligned_vector<double>& res = ml->get_residuals();
+        ASSERT_LT(res[iter], ml->solve_tol);
+        delete ml;
+    }
+
+    set_num_threads(1);
+
+    delete A;
+    delete[] stencil;
+} // end of TEST(ParThreadedRelaxTest, TestsInUtil) //
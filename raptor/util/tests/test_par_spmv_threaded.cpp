@@ -0,0 +1,79 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+TEST(ParThreadedSpMVTest, TestsInUtil)
+{
+    int grid[3] = {15, 15, 15};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+
+    ParVector x(A->global_num_cols, A->on_proc_num_cols);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    ParVector b_serial(A->global_num_rows, A->local_num_rows);
+    ParVector r_serial(A->global_num_rows, A->local_num_rows);
+    ParVector x_serial(A->global_num_cols, A->on_proc_num_cols);
+
+    for (int i = 0; i < A->on_proc_num_cols; i++)
+    {
+        x[i] = A->partition->first_local_col + i;
+    }
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        b[i] = 1.0 / (A->partition->first_local_row + i + 1);
+    }
+
+    // Serial reference results
+    set_num_threads(1);
+    A->mult(x, b_serial);
+    A->residual(x, b, r_serial);
+    A->mult_T(b, x_serial);
+
+    // Threaded results must match (up to summation order)
+    set_num_threads(4);
+    ParVector b_thr(A->global_num_rows, A->local_num_rows);
+    A->mult(x, b_thr);
+    A->residual(x, b, r);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        ASSERT_NEAR(b_thr[i], b_serial[i], 1e-10 * fabs(b_serial[i]) + 1e-10);
+        ASSERT_NEAR(r[i], r_serial[i], 1e-10 * fabs(r_serial[i]) + 1e-10);
+    }
+
+    ParVector x_thr(A->global_num_cols, A->on_proc_num_cols);
+    A->mult_T(b, x_thr);
+    for (int i = 0; i < A->on_proc_num_cols; i++)
+    {
+        ASSERT_NEAR(x_thr[i], x_serial[i], 1e-10 * fabs(x_serial[i]) + 1e-10);
+    }
+
+    // Thread row bounds cover all rows, in order
+    int n_rows = A->on_proc->n_rows;
+    int prev = 0;
+    for (int t = 0; t <= 4; t++)
+    {
+        int bound = thread_row_bound(A->on_proc->idx1.data(), n_rows, 4, t);
+        ASSERT_GE(bound, prev);
+        prev = bound;
+    }
+    ASSERT_EQ(prev, n_rows);
+
+    set_num_threads(1);
+
+    delete A;
+    delete[] stencil;
+} // end of TEST(ParThreadedSpMVTest, TestsInUtil) //
+
@@ -0,0 +1,127 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+
+} // end of main() //
+
+void compare_sell_spmv(CSRMatrix* A, int slice_size, int sigma)
+{
+    SELLMatrix* S = new SELLMatrix(A, slice_size, sigma);
+    ASSERT_EQ(S->format(), SELL);
+    ASSERT_EQ(S->n_rows, A->n_rows);
+    ASSERT_EQ(S->nnz, A->nnz);
+
+    Vector x(A->n_cols);
+    Vector x_T(A->n_rows);
+    Vector b(A->n_rows);
+    Vector b_A(A->n_rows);
+    Vector b_T(A->n_cols);
+    Vector b_A_T(A->n_cols);
+    for (int i = 0; i < A->n_cols; i++)
+        x[i] = ((i * 13) % 7) - 3.0;
+    for (int i = 0; i < A->n_rows; i++)
+        x_T[i] = ((i * 5) % 9) - 4.0;
+
+    // b <- A*x, b <- b + A*x, b <- b - 2*A*x
+    A->mult(x, b_A);
+    S->mult(x, b);
+    for (int i = 0; i < A->n_rows; i++)
+        ASSERT_NEAR(b[i], b_A[i], 1e-10);
+    A->mult_append(x, b_A);
+    S->mult_append(x, b);
+    A->mult_append_neg(x, b_A);
+    A->mult_append_neg(x, b_A);
+    S->mult_append_neg(x, b);
+    S->mult_append_neg(x, b);
+    for (int i = 0; i < A->n_rows; i++)
+        ASSERT_NEAR(b[i], b_A[i], 1e-10);
+
+    // r <- b - A*x
+    A->residual(x, x_T, b_A);
+    S->residual(x, x_T, b);
+    for (int i = 0; i < A->n_rows; i++)
+        ASSERT_NEAR(b[i], b_A[i], 1e-10);
+
+    // b <- A^T*x, b <- b + A^T*x, b <- b - 2*A^T*x
+    A->mult_T(x_T, b_A_T);
+    S->mult_T(x_T, b_T);
+    for (int i = 0; i < A->n_cols; i++)
+        ASSERT_NEAR(b_T[i], b_A_T[i], 1e-10);
+    A->mult_append_T(x_T, b_A_T);
+    S->mult_append_T(x_T, b_T);
+    A->mult_append_neg_T(x_T, b_A_T);
+    A->mult_append_neg_T(x_T, b_A_T);
+    S->mult_append_neg_T(x_T, b_T);
+    S->mult_append_neg_T(x_T, b_T);
+    for (int i = 0; i < A->n_cols; i++)
+        ASSERT_NEAR(b_T[i], b_A_T[i], 1e-10);
+
+    // Converting back to CSR returns original matrix
+    CSRMatrix* A_csr = S->to_CSR();
+    ASSERT_EQ(A_csr->format(), CSR);
+    ASSERT_EQ(A_csr->nnz, A->nnz);
+    for (int i = 0; i < A->n_rows + 1; i++)
+        ASSERT_EQ(A_csr->idx1[i], A->idx1[i]);
+    for (int i = 0; i < A->nnz; i++)
+    {
+        ASSERT_EQ(A_csr->idx2[i], A->idx2[i]);
+        ASSERT_NEAR(A_csr->vals[i], A->vals[i], 1e-15);
+    }
+
+    // Slices are updated when CSR arrays are reordered
+    SELLMatrix* S_copy = S->copy();
+    S_copy->sorted = false;
+    S_copy->diag_first = false;
+    S_copy->sort();
+    S_copy->move_diag();
+    S_copy->mult(x, b);
+    A->mult(x, b_A);
+    for (int i = 0; i < A->n_rows; i++)
+        ASSERT_NEAR(b[i], b_A[i], 1e-10);
+
+    delete A_csr;
+    delete S_copy;
+    delete S;
+}
+
+TEST(SELLSpMVTest, TestsInUtil)
+{
+    int grid[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    CSRMatrix* A_sten = stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    compare_sell_spmv(A_sten, 8, 128);
+    compare_sell_spmv(A_sten, 4, 1);
+    compare_sell_spmv(A_sten, 16, 64);
+    compare_sell_spmv(A_sten, 5, 20);
+
+    // Rectangular matrix with varying row lengths (and empty rows)
+    CSRMatrix* A_rect = new CSRMatrix(203, 150);
+    for (int i = 0; i < 203; i++)
+    {
+        for (int j = 0; j < 150; j++)
+        {
+            if ((i * 7 + j * 11) % (i % 13 + 2) == 0 && i % 17)
+                A_rect->add_value(i, j, ((i + j) % 9) - 4.5);
+        }
+        A_rect->idx1[i+1] = A_rect->idx2.size();
+    }
+    A_rect->nnz = A_rect->idx2.size();
+
+    compare_sell_spmv(A_rect, 8, 128);
+    compare_sell_spmv(A_rect, 3, 3);
+
+    delete A_rect;
+    delete A_sten;
+
+} // end of TEST(SELLSpMVTest, TestsInUtil) //
+